@@ -465,10 +465,14 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/qgcunittest
 
     HEADERS += \
+        src/AnalyzeView/LogDownloadDataTest.h \
         src/Audio/AudioOutputTest.h \
         src/FactSystem/FactSystemTestBase.h \
         src/FactSystem/FactSystemTestGeneric.h \
         src/FactSystem/FactSystemTestPX4.h \
+        src/FactSystem/FactTelemetryTest.h \
+        src/FactSystem/ParameterCacheFileTest.h \
+        src/FactSystem/ParameterMetaDataBundleTest.h \
         src/FactSystem/ParameterManagerTest.h \
         src/MissionManager/CameraCalcTest.h \
         src/MissionManager/CameraSectionTest.h \
@@ -493,16 +497,26 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/VisualMissionItemTest.h \
         src/qgcunittest/GeoTest.h \
         src/qgcunittest/LinkManagerTest.h \
+        src/qgcunittest/LinkSendQueueTest.h \
+        src/qgcunittest/LogReplayRunnerTest.h \
+        src/qgcunittest/MAVLinkBlockParserTest.h \
+        src/qgcunittest/MAVLinkMessageDispatcherTest.h \
+        src/qgcunittest/MAVLinkReceiveQueueTest.h \
         src/qgcunittest/MavlinkLogTest.h \
         src/qgcunittest/MultiSignalSpy.h \
         src/qgcunittest/TCPLinkTest.h \
         src/qgcunittest/TCPLoopBackServer.h \
+        src/qgcunittest/UDPLinkTest.h \
         src/qgcunittest/UnitTest.h \
         src/Vehicle/FTPManagerTest.h \
         src/Vehicle/InitialConnectTest.h \
         src/Vehicle/RequestMessageTest.h \
         src/Vehicle/SendMavCommandWithHandlerTest.h \
         src/Vehicle/SendMavCommandWithSignallingTest.h \
+        src/Vehicle/TelemetryHistoryTest.h \
+        src/QtLocationPlugin/QGCMapEngineTest.h \
+        src/QtLocationPlugin/QGCTileCacheWorkerTest.h \
+        src/Terrain/TerrainTileTest.h \
         #src/qgcunittest/RadioConfigTest.h \
         #src/AnalyzeView/LogDownloadTest.h \
         #src/qgcunittest/FileDialogTest.h \
@@ -511,10 +525,14 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         #src/qgcunittest/MessageBoxTest.h \
 
     SOURCES += \
+        src/AnalyzeView/LogDownloadDataTest.cc \
         src/Audio/AudioOutputTest.cc \
         src/FactSystem/FactSystemTestBase.cc \
         src/FactSystem/FactSystemTestGeneric.cc \
         src/FactSystem/FactSystemTestPX4.cc \
+        src/FactSystem/FactTelemetryTest.cc \
+        src/FactSystem/ParameterCacheFileTest.cc \
+        src/FactSystem/ParameterMetaDataBundleTest.cc \
         src/FactSystem/ParameterManagerTest.cc \
         src/MissionManager/CameraCalcTest.cc \
         src/MissionManager/CameraSectionTest.cc \
@@ -539,10 +557,16 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/MissionManager/VisualMissionItemTest.cc \
         src/qgcunittest/GeoTest.cc \
         src/qgcunittest/LinkManagerTest.cc \
+        src/qgcunittest/LinkSendQueueTest.cc \
+        src/qgcunittest/LogReplayRunnerTest.cc \
+        src/qgcunittest/MAVLinkBlockParserTest.cc \
+        src/qgcunittest/MAVLinkMessageDispatcherTest.cc \
+        src/qgcunittest/MAVLinkReceiveQueueTest.cc \
         src/qgcunittest/MavlinkLogTest.cc \
         src/qgcunittest/MultiSignalSpy.cc \
         src/qgcunittest/TCPLinkTest.cc \
         src/qgcunittest/TCPLoopBackServer.cc \
+        src/qgcunittest/UDPLinkTest.cc \
         src/qgcunittest/UnitTest.cc \
         src/qgcunittest/UnitTestList.cc \
         src/Vehicle/FTPManagerTest.cc \
@@ -550,6 +574,10 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/Vehicle/RequestMessageTest.cc \
         src/Vehicle/SendMavCommandWithHandlerTest.cc \
         src/Vehicle/SendMavCommandWithSignallingTest.cc \
+        src/Vehicle/TelemetryHistoryTest.cc \
+        src/QtLocationPlugin/QGCMapEngineTest.cc \
+        src/QtLocationPlugin/QGCTileCacheWorkerTest.cc \
+        src/Terrain/TerrainTileTest.cc \
         #src/qgcunittest/RadioConfigTest.cc \
         #src/AnalyzeView/LogDownloadTest.cc \
         #src/qgcunittest/FileDialogTest.cc \
@@ -694,6 +722,7 @@ HEADERS += \
     src/Vehicle/MultiVehicleManager.h \
     src/Vehicle/StateMachine.h \
     src/Vehicle/TerrainFactGroup.h \
+    src/Vehicle/TelemetryHistory.h \
     src/Vehicle/TerrainProtocolHandler.h \
     src/Vehicle/TrajectoryPoints.h \
     src/Vehicle/Vehicle.h \
@@ -702,8 +731,13 @@ HEADERS += \
     src/comm/LinkConfiguration.h \
     src/comm/LinkInterface.h \
     src/comm/LinkManager.h \
+    src/comm/LinkSendQueue.h \
     src/comm/LogReplayLink.h \
+    src/comm/LogReplayRunner.h \
+    src/comm/MAVLinkBlockParser.h \
+    src/comm/MAVLinkMessageDispatcher.h \
     src/comm/MAVLinkProtocol.h \
+    src/comm/MAVLinkReceiveQueue.h \
     src/comm/QGCMAVLink.h \
     src/comm/TCPLink.h \
     src/comm/UDPLink.h \
@@ -913,6 +947,7 @@ SOURCES += \
     src/Vehicle/MultiVehicleManager.cc \
     src/Vehicle/StateMachine.cc \
     src/Vehicle/TerrainFactGroup.cc \
+    src/Vehicle/TelemetryHistory.cc \
     src/Vehicle/TerrainProtocolHandler.cc \
     src/Vehicle/TrajectoryPoints.cc \
     src/Vehicle/Vehicle.cc \
@@ -921,8 +956,13 @@ SOURCES += \
     src/comm/LinkConfiguration.cc \
     src/comm/LinkInterface.cc \
     src/comm/LinkManager.cc \
+    src/comm/LinkSendQueue.cc \
     src/comm/LogReplayLink.cc \
+    src/comm/LogReplayRunner.cc \
+    src/comm/MAVLinkBlockParser.cc \
+    src/comm/MAVLinkMessageDispatcher.cc \
     src/comm/MAVLinkProtocol.cc \
+    src/comm/MAVLinkReceiveQueue.cc \
     src/comm/QGCMAVLink.cc \
     src/comm/TCPLink.cc \
     src/comm/UDPLink.cc \
@@ -1179,6 +1219,9 @@ HEADERS += \
     src/FactSystem/FactMetaData.h \
     src/FactSystem/FactSystem.h \
     src/FactSystem/FactValueSliderListModel.h \
+    src/FactSystem/ParameterCacheFile.h \
+    src/FactSystem/ParameterIndexDownload.h \
+    src/FactSystem/ParameterMetaDataBundle.h \
     src/FactSystem/ParameterManager.h \
     src/FactSystem/SettingsFact.h \
 
@@ -1189,6 +1232,9 @@ SOURCES += \
     src/FactSystem/FactMetaData.cc \
     src/FactSystem/FactSystem.cc \
     src/FactSystem/FactValueSliderListModel.cc \
+    src/FactSystem/ParameterCacheFile.cc \
+    src/FactSystem/ParameterIndexDownload.cc \
+    src/FactSystem/ParameterMetaDataBundle.cc \
     src/FactSystem/ParameterManager.cc \
     src/FactSystem/SettingsFact.cc \
 
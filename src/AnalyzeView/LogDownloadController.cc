@@ -23,65 +23,159 @@
 #include <QSettings>
 #include <QUrl>
 #include <QBitArray>
+#include <QDataStream>
 #include <QtCore/qmath.h>
 
 #define kTimeOutMilliseconds 500
 #define kGUIRateMilliseconds 17
 #define kTableBins           512
 #define kChunkSize           (kTableBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)
+#define kMaxRequestSize      (128 * kChunkSize)
+#define kRequestMilliseconds 2000   // Amount of data to request at once, at the current download rate
+#define kMergeBins           64     // Received bins between two gaps which are requested again rather than splitting the request
+#define kBinTableMagic       0x4C424E54
+#define kBinTableSaveMilliseconds 1000
+#define kPartialFileSuffix   ".part"
 
 QGC_LOGGING_CATEGORY(LogDownloadLog, "LogDownloadLog")
 
-//-----------------------------------------------------------------------------
-struct LogDownloadData {
-    LogDownloadData(QGCLogEntry* entry);
-    QBitArray     chunk_table;
-    uint32_t      current_chunk;
-    QFile         file;
-    QString       filename;
-    uint          ID;
-    QGCLogEntry*  entry;
-    uint          written;
-    size_t        rate_bytes;
-    qreal         rate_avg;
-    QElapsedTimer elapsed;
+//----------------------------------------------------------------------------------------
+LogDownloadData::LogDownloadData(QGCLogEntry* entry_)
+    : bins_received(0)
+    , first_missing(0)
+    , request_start(0)
+    , request_end(0)
+    , file_map(nullptr)
+    , ID(entry_->id())
+    , entry(entry_)
+    , written(0)
+    , rate_bytes(0)
+    , rate_avg(0)
+{
+
+}
+
+LogDownloadData::~LogDownloadData()
+{
+    if (file_map) {
+        file.unmap(file_map);
+    }
+}
 
-    void advanceChunk()
-    {
-           current_chunk++;
-           chunk_table = QBitArray(chunkBins(), false);
+//----------------------------------------------------------------------------------------
+uint32_t
+LogDownloadData::numBins() const
+{
+    return qCeil(entry->size() / static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN));
+}
+
+//----------------------------------------------------------------------------------------
+bool
+LogDownloadData::writeData(uint32_t ofs, const uint8_t* data, uint8_t count)
+{
+    if (file_map) {
+        memcpy(file_map + ofs, data, count);
+        return true;
+    }
+    if (file.pos() != ofs && !file.seek(ofs)) {
+        qWarning() << "Error while seeking log file offset";
+        return false;
+    }
+    return file.write((const char*)data, count) == count;
+}
+
+//----------------------------------------------------------------------------------------
+bool
+LogDownloadData::loadBinTable()
+{
+    QFile tableFile(binTableFilename());
+    if (!tableFile.open(QIODevice::ReadOnly)) {
+        return false;
     }
 
-    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the current chunk
-    uint32_t chunkBins() const
-    {
-        return qMin(qCeil((entry->size() - current_chunk*kChunkSize)/static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)),
-                    kTableBins);
+    QDataStream ds(&tableFile);
+    quint32     magic;
+    quint32     logSize;
+    QBitArray   table;
+    ds >> magic >> logSize >> table;
+    if (ds.status() != QDataStream::Ok || magic != kBinTableMagic || logSize != entry->size() ||
+            static_cast<uint32_t>(table.size()) != numBins() || file.size() != entry->size()) {
+        qCDebug(LogDownloadLog) << "Ignoring bin table which does not match log" << tableFile.fileName();
+        return false;
     }
 
-    // The number of kChunkSize chunks in the file
-    uint32_t numChunks() const
-    {
-        return qCeil(entry->size() / static_cast<qreal>(kChunkSize));
+    bin_table       = table;
+    bins_received   = static_cast<uint32_t>(table.count(true));
+    written         = qMin(bins_received * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN, entry->size());
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadData::saveBinTable()
+{
+    QFile tableFile(binTableFilename());
+    if (!tableFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Unable to save log bin table" << tableFile.fileName() << tableFile.errorString();
+        return;
     }
 
-    // True if all bins in the chunk have been set to val
-    bool chunkEquals(const bool val) const
-    {
-        return chunk_table == QBitArray(chunk_table.size(), val);
+    // The table must never claim bins the log file does not have. Writes through the map are already in the
+    // shared page cache, buffered writes need to be flushed first.
+    if (!file_map) {
+        file.flush();
     }
 
-};
+    QDataStream ds(&tableFile);
+    ds << static_cast<quint32>(kBinTableMagic) << static_cast<quint32>(entry->size()) << bin_table;
+    bin_table_saved.start();
+}
 
 //----------------------------------------------------------------------------------------
-LogDownloadData::LogDownloadData(QGCLogEntry* entry_)
-    : ID(entry_->id())
-    , entry(entry_)
-    , written(0)
-    , rate_bytes(0)
-    , rate_avg(0)
+/// Sets [request_start, request_end) to the next range to ask the vehicle for, starting at the first missing bin and
+/// at most maxBins long. Short runs of received bins between gaps are requested again since that is cheaper than
+/// another round trip.
+void
+LogDownloadData::nextRequest(uint32_t maxBins)
 {
+    const uint32_t bins = numBins();
+
+    uint32_t start = first_missing;
+    while (start < bins && bin_table.testBit(start)) {
+        start++;
+    }
+    first_missing = start;
+
+    const uint32_t maxEnd = qMin(bins, start + maxBins);
+
+    //-- Extend the request over missing bins until the window is full or a long run of received bins is reached
+    uint32_t end = start + 1;
+    for (uint32_t bin = end; bin < maxEnd && bin - end <= kMergeBins; bin++) {
+        if (!bin_table.testBit(bin)) {
+            end = bin + 1;
+        }
+    }
+
+    request_start   = start;
+    request_end     = end;
+}
 
+//----------------------------------------------------------------------------------------
+/// Moves the completed log from its partial file to the final name
+bool
+LogDownloadData::finish()
+{
+    if (file_map) {
+        file.unmap(file_map);
+        file_map = nullptr;
+    }
+    file.close();
+    QFile::remove(binTableFilename());
+    if (!file.rename(final_path)) {
+        qWarning() << "Unable to rename downloaded log" << file.fileName() << "to" << final_path << file.errorString();
+        return false;
+    }
+    return true;
 }
 
 //----------------------------------------------------------------------------------------
@@ -330,75 +424,45 @@ LogDownloadController::_logData(UASInterface* uas, uint32_t ofs, uint16_t id, ui
         return;
     }
 
-    bool result = false;
-    uint32_t timeout_time = kTimeOutMilliseconds;
-    if(ofs <= _downloadData->entry->size()) {
-        const uint32_t chunk = ofs / kChunkSize;
-        if (chunk != _downloadData->current_chunk) {
-            qWarning() << "Ignored packet for out of order chunk actual:expected" << chunk << _downloadData->current_chunk;
-            return;
-        }
-        const uint16_t bin = (ofs - chunk*kChunkSize) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-        if (bin >= _downloadData->chunk_table.size()) {
-            qWarning() << "Out of range bin received";
-        } else
-            _downloadData->chunk_table.setBit(bin);
-        if (_downloadData->file.pos() != ofs) {
-            // Seek to correct position
-            if (!_downloadData->file.seek(ofs)) {
-                qWarning() << "Error while seeking log file offset";
-                return;
-            }
-        }
+    if(ofs + count > _downloadData->entry->size()) {
+        qWarning() << "Received log offset greater than expected";
+        _downloadData->entry->setStatus(tr("Error"));
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
 
-        //-- Write chunk to file
-        if(_downloadData->file.write((const char*)data, count)) {
-            _downloadData->written += count;
-            _downloadData->rate_bytes += count;
-            _updateDataRate();
-            result = true;
-            //-- reset retries
-            _retries = 0;
-            //-- Reset timer
-            _timer.start(timeout_time);
-            //-- Do we have it all?
-            if(_logComplete()) {
-                _downloadData->entry->setStatus(tr("Downloaded"));
-                //-- Check for more
-                _receivedAllData();
-            } else if (_chunkComplete()) {
-                _downloadData->advanceChunk();
-                _requestLogData(_downloadData->ID,
-                                _downloadData->current_chunk*kChunkSize,
-                                _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-            } else if (bin < _downloadData->chunk_table.size() - 1 && _downloadData->chunk_table.at(bin+1)) {
-                // Likely to be grabbing fragments and got to the end of a gap
-                _findMissingData();
-            }
-        } else {
+    const uint32_t bin = ofs / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    //-- Bins can arrive more than once when a request spans data which was already received
+    if (!_downloadData->bin_table.testBit(bin)) {
+        if (!_downloadData->writeData(ofs, data, count)) {
             qWarning() << "Error while writing log file chunk";
+            _downloadData->entry->setStatus(tr("Error"));
+            return;
         }
-    } else {
-        qWarning() << "Received log offset greater than expected";
+        _downloadData->bin_table.setBit(bin);
+        _downloadData->bins_received++;
+        _downloadData->written += count;
     }
-    if(!result) {
-        _downloadData->entry->setStatus(tr("Error"));
+    _downloadData->rate_bytes += count;
+    _updateDataRate();
+    //-- reset retries
+    _retries = 0;
+    //-- Reset timer
+    _timer.start(kTimeOutMilliseconds);
+    //-- Once the vehicle has sent the last bin of the current request (or we have it all) move on to the next one.
+    //-- Packets still in flight from a replaced request must not trigger yet another one.
+    if (_logComplete() || bin + 1 == _downloadData->request_end) {
+        _requestNextRange();
     }
 }
 
-
-//----------------------------------------------------------------------------------------
-bool
-LogDownloadController::_chunkComplete() const
-{
-    return _downloadData->chunkEquals(true);
-}
-
 //----------------------------------------------------------------------------------------
 bool
 LogDownloadController::_logComplete() const
 {
-    return _chunkComplete() && (_downloadData->current_chunk+1) == _downloadData->numChunks();
+    return _downloadData->bins_received == _downloadData->numBins();
 }
 
 //----------------------------------------------------------------------------------------
@@ -409,8 +473,7 @@ LogDownloadController::_receivedAllData()
     //-- Anything queued up for download?
     if(_prepareLogDownload()) {
         //-- Request Log
-        _requestLogData(_downloadData->ID, 0, _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-        _timer.start(kTimeOutMilliseconds);
+        _requestNextRange();
     } else {
         _resetSelection();
         _setDownloading(false);
@@ -421,11 +484,8 @@ LogDownloadController::_receivedAllData()
 void
 LogDownloadController::_findMissingData()
 {
-    if (_logComplete()) {
-         _receivedAllData();
-         return;
-    } else if (_chunkComplete()) {
-        _downloadData->advanceChunk();
+    if (!_downloadData) {
+        return;
     }
 
     _retries++;
@@ -442,24 +502,38 @@ LogDownloadController::_findMissingData()
 #endif
 
     _updateDataRate();
+    _requestNextRange();
+}
 
-    uint16_t start = 0, end = 0;
-    const int size = _downloadData->chunk_table.size();
-    for (; start < size; start++) {
-        if (!_downloadData->chunk_table.testBit(start)) {
-            break;
-        }
+//----------------------------------------------------------------------------------------
+/// The vehicle only works on one LOG_REQUEST_DATA at a time, a new request replaces the one in progress. So instead of
+/// queuing up small requests we size each request to keep the vehicle streaming for kRequestMilliseconds at the
+/// observed download rate. Lost packets leave gaps in the bin table which are picked up by later requests, short runs
+/// of received bins between gaps are requested again since that is cheaper than another round trip.
+void
+LogDownloadController::_requestNextRange()
+{
+    if (_logComplete()) {
+        _downloadData->entry->setStatus(_downloadData->finish() ? tr("Downloaded") : tr("Error"));
+        //-- Check for more
+        _receivedAllData();
+        return;
     }
 
-    for (end = start; end < size; end++) {
-        if (_downloadData->chunk_table.testBit(end)) {
-            break;
-        }
+    if (!_downloadData->bin_table_saved.isValid() || _downloadData->bin_table_saved.elapsed() >= kBinTableSaveMilliseconds) {
+        _downloadData->saveBinTable();
     }
 
-    const uint32_t pos = _downloadData->current_chunk*kChunkSize + start*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
-                   len = (end - start)*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-    _requestLogData(_downloadData->ID, pos, len, _retries);
+    const uint32_t requestSize = qBound(static_cast<uint32_t>(kChunkSize),
+                                        static_cast<uint32_t>(_downloadData->rate_avg * kRequestMilliseconds / 1000.0),
+                                        static_cast<uint32_t>(kMaxRequestSize));
+    _downloadData->nextRequest(requestSize / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
+
+    _requestLogData(_downloadData->ID,
+                    _downloadData->request_start * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
+                    (_downloadData->request_end - _downloadData->request_start) * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
+                    _retries);
+    _timer.start(kTimeOutMilliseconds);
 }
 
 //----------------------------------------------------------------------------------------
@@ -605,32 +679,46 @@ LogDownloadController::_prepareLogDownload()
     } else {
         _downloadData->filename += ".bin";
     }
-    _downloadData->file.setFileName(_downloadPath + _downloadData->filename);
-    //-- Append a number to the end if the filename already exists
-    if (_downloadData->file.exists()){
-        uint num_dups = 0;
-        QStringList filename_spl = _downloadData->filename.split('.');
-        do {
-            num_dups +=1;
-            _downloadData->file.setFileName(filename_spl[0] + '_' + QString::number(num_dups) + '.' + filename_spl[1]);
-        } while( _downloadData->file.exists());
+    //-- The log is downloaded to a partial file which is renamed once complete. Resume an interrupted download of
+    //-- the same log, otherwise append a number to the end if the filename already exists.
+    bool resume = false;
+    uint num_dups = 0;
+    QStringList filename_spl = _downloadData->filename.split('.');
+    forever {
+        _downloadData->final_path = _downloadPath + (num_dups ? filename_spl[0] + '_' + QString::number(num_dups) + '.' + filename_spl[1] : _downloadData->filename);
+        _downloadData->file.setFileName(_downloadData->final_path + kPartialFileSuffix);
+        if (_downloadData->file.exists() && _downloadData->loadBinTable()) {
+            resume = true;
+            break;
+        }
+        if (!_downloadData->file.exists() && !QFile::exists(_downloadData->final_path)) {
+            break;
+        }
+        num_dups++;
+    }
+    if (resume) {
+        qCDebug(LogDownloadLog) << "Resuming log download" << _downloadData->file.fileName() << _downloadData->bins_received << "of" << _downloadData->numBins() << "bins";
+    } else {
+        _downloadData->bin_table = QBitArray(_downloadData->numBins(), false);
     }
     //-- Create file
-    if (!_downloadData->file.open(QIODevice::WriteOnly)) {
+    if (!_downloadData->file.open(QIODevice::ReadWrite)) {
         qWarning() << "Failed to create log file:" <<  _downloadData->filename;
     } else {
         //-- Preallocate file
-        if(!_downloadData->file.resize(entry->size())) {
+        if(!resume && !_downloadData->file.resize(entry->size())) {
             qWarning() << "Failed to allocate space for log file:" <<  _downloadData->filename;
         } else {
-            _downloadData->current_chunk = 0;
-            _downloadData->chunk_table = QBitArray(_downloadData->chunkBins(), false);
+            //-- Data is written straight into the mapped file, falling back to seek/write if it can't be mapped
+            if (entry->size() > 0) {
+                _downloadData->file_map = _downloadData->file.map(0, entry->size());
+            }
             _downloadData->elapsed.start();
             result = true;
         }
     }
     if(!result) {
-        if (_downloadData->file.exists()) {
+        if (!resume && _downloadData->file.exists()) {
             _downloadData->file.remove();
         }
         _downloadData->entry->setStatus(tr("Error"));
@@ -688,8 +776,13 @@ LogDownloadController::cancel(void)
     }
     if(_downloadData) {
         _downloadData->entry->setStatus(tr("Canceled"));
-        if (_downloadData->file.exists()) {
-            _downloadData->file.remove();
+        if (_downloadData->bins_received == 0) {
+            if (_downloadData->file.exists()) {
+                _downloadData->file.remove();
+            }
+        } else {
+            //-- Keep what we have, downloading this log again to the same directory resumes from here
+            _downloadData->saveBinTable();
         }
         delete _downloadData;
         _downloadData = 0;
@@ -16,6 +16,8 @@
 #include <QAbstractListModel>
 #include <QLocale>
 #include <QElapsedTimer>
+#include <QBitArray>
+#include <QFile>
 
 #include <memory>
 
@@ -26,7 +28,6 @@ class  MultiVehicleManager;
 class  UASInterface;
 class  Vehicle;
 class  QGCLogEntry;
-struct LogDownloadData;
 
 Q_DECLARE_LOGGING_CATEGORY(LogDownloadLog)
 
@@ -108,6 +109,43 @@ private:
     QString     _status;
 };
 
+//-----------------------------------------------------------------------------
+struct LogDownloadData {
+    LogDownloadData(QGCLogEntry* entry);
+    ~LogDownloadData();
+    QBitArray     bin_table;        // One bit per MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bin of the log, set once received
+    uint32_t      bins_received;
+    uint32_t      first_missing;    // All bins before this one have been received
+    uint32_t      request_start;    // Bins [request_start, request_end) are being sent by the vehicle
+    uint32_t      request_end;
+    QFile         file;             // The log is downloaded to final_path + ".part"
+    uchar*        file_map;
+    QString       final_path;       // Where the log is moved once it is complete
+    QString       filename;
+    uint          ID;
+    QGCLogEntry*  entry;
+    uint          written;
+    size_t        rate_bytes;
+    qreal         rate_avg;
+    QElapsedTimer elapsed;
+    QElapsedTimer bin_table_saved;
+
+    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the file
+    uint32_t numBins() const;
+
+    // The bin table is kept next to a partially downloaded log so the download can be resumed
+    QString binTableFilename() const
+    {
+        return file.fileName() + QStringLiteral(".bins");
+    }
+
+    bool writeData(uint32_t ofs, const uint8_t* data, uint8_t count);
+    bool loadBinTable();
+    void saveBinTable();
+    void nextRequest(uint32_t maxBins);
+    bool finish();
+};
+
 //-----------------------------------------------------------------------------
 class LogDownloadController : public QObject
 {
@@ -145,13 +183,13 @@ private slots:
 
 private:
     bool _entriesComplete   ();
-    bool _chunkComplete     () const;
     bool _logComplete       () const;
     void _findMissingEntries();
     void _receivedAllEntries();
     void _receivedAllData   ();
     void _resetSelection    (bool canceled = false);
     void _findMissingData   ();
+    void _requestNextRange  ();
     void _requestLogList    (uint32_t start, uint32_t end);
     void _requestLogData    (uint16_t id, uint32_t offset, uint32_t count, int retryCount = 0);
     bool _prepareLogDownload();
@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogDownloadDataTest.h"
+#include "LogDownloadController.h"
+#include "QGCMAVLink.h"
+
+#include <QTemporaryDir>
+
+LogDownloadDataTest::LogDownloadDataTest(void)
+{
+
+}
+
+static const uint _binSize = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+
+/// Creates the partial log file the bin table is saved next to
+static bool _createLogFile(LogDownloadData& data, const QString& filename, qint64 size)
+{
+    data.file.setFileName(filename);
+    return data.file.open(QIODevice::ReadWrite) && data.file.resize(size);
+}
+
+void LogDownloadDataTest::_binTableRoundTrip_test(void)
+{
+    QTemporaryDir   tempDir;
+    QString         filename = tempDir.filePath("log_1.bin.part");
+    QGCLogEntry     entry(1, QDateTime(), 10 * _binSize + 5, true);
+
+    LogDownloadData saved(&entry);
+    QVERIFY(_createLogFile(saved, filename, entry.size()));
+    QCOMPARE(saved.numBins(), 11u);
+    saved.bin_table = QBitArray(static_cast<int>(saved.numBins()), false);
+    saved.bin_table.setBit(0);
+    saved.bin_table.setBit(3);
+    saved.bin_table.setBit(4);
+    saved.saveBinTable();
+    QVERIFY(QFile::exists(saved.binTableFilename()));
+
+    LogDownloadData loaded(&entry);
+    loaded.file.setFileName(filename);
+    QVERIFY(loaded.loadBinTable());
+    QCOMPARE(loaded.bin_table, saved.bin_table);
+    QCOMPARE(loaded.bins_received, 3u);
+    QCOMPARE(loaded.written, 3 * _binSize);
+}
+
+void LogDownloadDataTest::_binTableMismatch_test(void)
+{
+    QTemporaryDir   tempDir;
+    QString         filename = tempDir.filePath("log_1.bin.part");
+    QGCLogEntry     entry(1, QDateTime(), 10 * _binSize, true);
+
+    LogDownloadData saved(&entry);
+    QVERIFY(_createLogFile(saved, filename, entry.size()));
+    saved.bin_table = QBitArray(static_cast<int>(saved.numBins()), true);
+    saved.saveBinTable();
+
+    // Table saved for a log of a different size
+    QGCLogEntry     otherEntry(1, QDateTime(), 20 * _binSize, true);
+    LogDownloadData other(&otherEntry);
+    other.file.setFileName(filename);
+    QVERIFY(!other.loadBinTable());
+
+    // Log file which does not have the size of the log
+    QVERIFY(saved.file.resize(5 * _binSize));
+    LogDownloadData truncated(&entry);
+    truncated.file.setFileName(filename);
+    QVERIFY(!truncated.loadBinTable());
+    QVERIFY(saved.file.resize(entry.size()));
+
+    // Table which is not a bin table
+    QFile tableFile(saved.binTableFilename());
+    QVERIFY(tableFile.open(QIODevice::ReadWrite));
+    QVERIFY(tableFile.write("garbage", 7) == 7);
+    tableFile.close();
+    LogDownloadData corrupt(&entry);
+    corrupt.file.setFileName(filename);
+    QVERIFY(!corrupt.loadBinTable());
+
+    // No table at all
+    QVERIFY(QFile::remove(saved.binTableFilename()));
+    LogDownloadData missing(&entry);
+    missing.file.setFileName(filename);
+    QVERIFY(!missing.loadBinTable());
+}
+
+void LogDownloadDataTest::_nextRequest_test(void)
+{
+    QGCLogEntry     entry(1, QDateTime(), 300 * _binSize, true);
+    LogDownloadData data(&entry);
+
+    // Received: [0, 10) [20, 30) [40, 200)
+    data.bin_table = QBitArray(static_cast<int>(data.numBins()), false);
+    data.bin_table.fill(true, 0, 10);
+    data.bin_table.fill(true, 20, 30);
+    data.bin_table.fill(true, 40, 200);
+
+    // The short run of received bins between the first two gaps is requested again, the long one is not
+    data.nextRequest(1000);
+    QCOMPARE(data.first_missing, 10u);
+    QCOMPARE(data.request_start, 10u);
+    QCOMPARE(data.request_end, 40u);
+
+    // The request never extends past the window
+    data.nextRequest(15);
+    QCOMPARE(data.request_start, 10u);
+    QCOMPARE(data.request_end, 20u);
+
+    // Once the gaps are filled the request moves on to the next one
+    data.bin_table.fill(true, 10, 20);
+    data.bin_table.fill(true, 30, 40);
+    data.nextRequest(1000);
+    QCOMPARE(data.first_missing, 200u);
+    QCOMPARE(data.request_start, 200u);
+    QCOMPARE(data.request_end, 300u);
+
+    // A single missing bin at the end
+    data.bin_table.fill(true, 200, 299);
+    data.nextRequest(1000);
+    QCOMPARE(data.request_start, 299u);
+    QCOMPARE(data.request_end, 300u);
+}
@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// @file
+///     @brief LogDownloadData bin table and request range unit test
+
+class LogDownloadDataTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LogDownloadDataTest(void);
+
+private slots:
+    void _binTableRoundTrip_test    (void);
+    void _binTableMismatch_test     (void);
+    void _nextRequest_test          (void);
+};
@@ -30,6 +30,14 @@ QGCMAVLinkMessageField::QGCMAVLinkMessageField(QGCMAVLinkMessage *parent, QStrin
     qCDebug(MAVLinkInspectorLog) << "Field:" << name << type;
 }
 
+//-----------------------------------------------------------------------------
+QGCMAVLinkMessageField::~QGCMAVLinkMessageField()
+{
+    if(_historyTracked && _history) {
+        _history->untrackMessageField(_historyColumn);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCMAVLinkMessageField::addSeries(MAVLinkChartController* chart, QAbstractSeries* series)
@@ -37,8 +45,20 @@ QGCMAVLinkMessageField::addSeries(MAVLinkChartController* chart, QAbstractSeries
     if(!_pSeries) {
         _chart = chart;
         _pSeries = series;
+        //-- Samples go to the vehicle's telemetry history so other views can use them as well. The vehicle records
+        //   numeric fields itself, under the same column name any other view tracking the field uses.
+        Vehicle* vehicle = qgcApp()->toolbox()->multiVehicleManager()->getVehicleById(_msg->sysid());
+        if(!_history) {
+            _history = vehicle ? vehicle->telemetryHistory() : new TelemetryHistory(this);
+        }
+        if(vehicle && _history == vehicle->telemetryHistory()) {
+            _historyColumn = _history->trackMessageField(vehicle, _msg->id(), _name, _msg->cid());
+            _historyTracked = _historyColumn != -1;
+        }
+        if(!_historyTracked) {
+            _historyColumn = _history->column(TelemetryHistory::messageFieldColumnName(_msg->name(), _name, _msg->cid()));
+        }
         emit seriesChanged();
-        _dataIndex = 0;
         _msg->updateFieldSelection();
     }
 }
@@ -48,9 +68,16 @@ void
 QGCMAVLinkMessageField::delSeries()
 {
     if(_pSeries) {
-        _values.clear();
+        //-- Stop recording the field unless another view still tracks it
+        if(_historyTracked) {
+            if(_history) {
+                _history->untrackMessageField(_historyColumn);
+            }
+            _historyTracked = false;
+        }
+        _seriesPoints.clear();
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(_values);
+        lineSeries->replace(_seriesPoints);
         _pSeries = nullptr;
         _chart   = nullptr;
         emit seriesChanged();
@@ -93,40 +120,8 @@ QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
         _value = newValue;
         emit valueChanged();
     }
-    if(_pSeries && _chart) {
-        int count = _values.count();
-        //-- Arbitrary limit of 1 minute of data at 50Hz for now
-        if(count < (50 * 60)) {
-            QPointF p(QGC::bootTimeMilliseconds(), v);
-            _values.append(p);
-        } else {
-            if(_dataIndex >= count) _dataIndex = 0;
-            _values[_dataIndex].setX(QGC::bootTimeMilliseconds());
-            _values[_dataIndex].setY(v);
-            _dataIndex++;
-        }
-        //-- Auto Range
-        if(_chart->rangeYIndex() == 0) {
-            qreal vmin  = std::numeric_limits<qreal>::max();
-            qreal vmax  = std::numeric_limits<qreal>::min();
-            for(int i = 0; i < _values.count(); i++) {
-                qreal v = _values[i].y();
-                if(vmax < v) vmax = v;
-                if(vmin > v) vmin = v;
-            }
-            bool changed = false;
-            if(std::abs(_rangeMin - vmin) > 0.000001) {
-                _rangeMin = vmin;
-                changed = true;
-            }
-            if(std::abs(_rangeMax - vmax) > 0.000001) {
-                _rangeMax = vmax;
-                changed = true;
-            }
-            if(changed) {
-                _chart->updateYRange();
-            }
-        }
+    if(_pSeries && _chart && _history && !_historyTracked) {
+        _history->append(_historyColumn, static_cast<qint64>(QGC::bootTimeMilliseconds()), v);
     }
 }
 
@@ -134,18 +129,32 @@ QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
 void
 QGCMAVLinkMessageField::updateSeries()
 {
-    int count = _values.count();
-    if (count > 1) {
-        QList<QPointF> s;
-        s.reserve(count);
-        int idx = _dataIndex;
-        for(int i = 0; i < count; i++, idx++) {
-            if(idx >= count) idx = 0;
-            QPointF p(_values[idx]);
-            s.append(p);
-        }
+    if(!_history) {
+        return;
+    }
+    qint64 startMSecs = _chart->rangeXMin().toMSecsSinceEpoch();
+    qint64 endMSecs   = std::numeric_limits<qint64>::max();
+    _seriesPoints.clear();
+    if(_history->range(_historyColumn, startMSecs, endMSecs, _maxSeriesPoints, _seriesPoints) > 1) {
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(s);
+        lineSeries->replace(_seriesPoints);
+    }
+    //-- Auto Range over what is visible
+    qreal vmin;
+    qreal vmax;
+    if(_chart->rangeYIndex() == 0 && _history->minMax(_historyColumn, startMSecs, endMSecs, vmin, vmax)) {
+        bool changed = false;
+        if(std::abs(_rangeMin - vmin) > 0.000001) {
+            _rangeMin = vmin;
+            changed = true;
+        }
+        if(std::abs(_rangeMax - vmax) > 0.000001) {
+            _rangeMax = vmax;
+            changed = true;
+        }
+        if(changed) {
+            _chart->updateYRange();
+        }
     }
 }
 
@@ -721,7 +730,8 @@ MAVLinkInspectorController::MAVLinkInspectorController()
     connect(multiVehicleManager, &MultiVehicleManager::vehicleAdded,   this, &MAVLinkInspectorController::_vehicleAdded);
     connect(multiVehicleManager, &MultiVehicleManager::vehicleRemoved, this, &MAVLinkInspectorController::_vehicleRemoved);
     MAVLinkProtocol* mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
-    connect(mavlinkProtocol, &MAVLinkProtocol::messageReceived, this, &MAVLinkInspectorController::_receiveMessage);
+    mavlinkProtocol->messageDispatcher()->registerHandler(this, MAVLinkMessageDispatcher::anyId, MAVLinkMessageDispatcher::anyId, MAVLinkMessageDispatcher::anyId,
+                                                          [this](LinkInterface* link, const mavlink_message_t& message) { _receiveMessage(link, message); });
     connect(&_updateFrequencyTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshFrequency);
     _updateFrequencyTimer.start(1000);
     MultiVehicleManager *manager = qgcApp()->toolbox()->multiVehicleManager();
@@ -747,6 +757,7 @@ MAVLinkInspectorController::MAVLinkInspectorController()
 //-----------------------------------------------------------------------------
 MAVLinkInspectorController::~MAVLinkInspectorController()
 {
+    qgcApp()->toolbox()->mavlinkProtocol()->messageDispatcher()->unregisterHandlers(this);
     _charts.clearAndDeleteContents();
     _vehicles.clearAndDeleteContents();
 }
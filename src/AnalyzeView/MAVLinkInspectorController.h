@@ -15,8 +15,10 @@
 
 #include "MAVLinkProtocol.h"
 #include "Vehicle.h"
+#include "TelemetryHistory.h"
 
 #include <QObject>
+#include <QPointer>
 #include <QString>
 #include <QDebug>
 #include <QVariantList>
@@ -45,6 +47,7 @@ public:
     Q_PROPERTY(QAbstractSeries* series      READ series     NOTIFY seriesChanged)
 
     QGCMAVLinkMessageField(QGCMAVLinkMessage* parent, QString name, QString type);
+    ~QGCMAVLinkMessageField();
 
     QString         name            () { return _name;  }
     QString         label           ();
@@ -53,7 +56,6 @@ public:
     bool            selectable      () { return _selectable; }
     bool            selected        () { return _pSeries != nullptr; }
     QAbstractSeries*series          () { return _pSeries; }
-    QList<QPointF>* values          () { return &_values;}
     qreal           rangeMin        () { return _rangeMin; }
     qreal           rangeMax        () { return _rangeMax; }
     int             chartIndex      ();
@@ -75,14 +77,18 @@ private:
     QString     _name;
     QString     _value;
     bool        _selectable = true;
-    int         _dataIndex  = 0;
     qreal       _rangeMin   = 0;
     qreal       _rangeMax   = 0;
 
     QAbstractSeries*    _pSeries = nullptr;
     QGCMAVLinkMessage*  _msg     = nullptr;
     MAVLinkChartController*      _chart   = nullptr;
-    QList<QPointF>      _values;
+    QPointer<TelemetryHistory>   _history;              ///< Vehicle history, or a private one for non vehicle systems
+    int                 _historyColumn  = -1;
+    bool                _historyTracked = false;        ///< Samples are recorded by the vehicle history itself
+    QVector<QPointF>    _seriesPoints;
+
+    static const int    _maxSeriesPoints = 1000;        ///< Larger ranges are reduced to min/max pairs
 };
 
 //-----------------------------------------------------------------------------
@@ -104,6 +110,7 @@ public:
 
     quint32             id              () { return _message.msgid;  }
     quint8              cid             () { return _message.compid; }
+    quint8              sysid           () { return _message.sysid; }
     QString             name            () { return _name;  }
     qreal               messageHz       () { return _messageHz; }
     quint64             count           () { return _count; }
@@ -77,11 +77,14 @@ APMSensorsComponentController::APMSensorsComponentController(void)
         qWarning() << "Sensors component is missing";
     }
 
-    connect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messageReceived, this, &APMSensorsComponentController::_mavlinkMessageReceived);
+    qgcApp()->toolbox()->mavlinkProtocol()->messageDispatcher()->registerHandler(this, _vehicle->id(), MAVLinkMessageDispatcher::anyId,
+                                                                                 QList<int>({ MAVLINK_MSG_ID_COMMAND_ACK, MAVLINK_MSG_ID_MAG_CAL_PROGRESS, MAVLINK_MSG_ID_MAG_CAL_REPORT }),
+                                                                                 [this](LinkInterface* link, const mavlink_message_t& message) { _mavlinkMessageReceived(link, message); });
 }
 
 APMSensorsComponentController::~APMSensorsComponentController()
 {
+    qgcApp()->toolbox()->mavlinkProtocol()->messageDispatcher()->unregisterHandlers(this);
     _restorePreviousCompassCalFitness();
 }
 
@@ -845,10 +848,6 @@ void APMSensorsComponentController::_mavlinkMessageReceived(LinkInterface* link,
 {
     Q_UNUSED(link);
 
-    if (message.sysid != _vehicle->id()) {
-        return;
-    }
-
     switch (message.msgid) {
     case MAVLINK_MSG_ID_COMMAND_ACK:
         _handleCommandAck(message);
@@ -12,9 +12,11 @@
 #include "QGCMAVLink.h"
 #include "QGCApplication.h"
 #include "QGCCorePlugin.h"
+#include "FactGroup.h"
 
 #include <QtQml>
 #include <QQmlEngine>
+#include <QtNumeric>
 
 static const char* kMissingMetadata = "Meta data pointer missing";
 
@@ -28,6 +30,12 @@ Fact::Fact(QObject* parent)
     , _deferredValueChangeSignal(false)
     , _valueSliderModel         (nullptr)
     , _ignoreQGCRebootRequired  (false)
+    , _telemetryValue           (0)
+    , _telemetryValueValid      (false)
+    , _telemetryValueBoxPending (false)
+    , _deferredRawValueChangeSignal(false)
+    , _factGroup                (nullptr)
+    , _factGroupIndex           (-1)
 {    
     FactMetaData* metaData = new FactMetaData(_type, this);
     setMetaData(metaData);
@@ -46,6 +54,12 @@ Fact::Fact(int componentId, QString name, FactMetaData::ValueType_t type, QObjec
     , _deferredValueChangeSignal(false)
     , _valueSliderModel         (nullptr)
     , _ignoreQGCRebootRequired  (false)
+    , _telemetryValue           (0)
+    , _telemetryValueValid      (false)
+    , _telemetryValueBoxPending (false)
+    , _deferredRawValueChangeSignal(false)
+    , _factGroup                (nullptr)
+    , _factGroupIndex           (-1)
 {
     FactMetaData* metaData = new FactMetaData(_type, this);
     setMetaData(metaData);
@@ -64,6 +78,12 @@ Fact::Fact(const QString& settingsGroup, FactMetaData* metaData, QObject* parent
     , _deferredValueChangeSignal(false)
     , _valueSliderModel         (nullptr)
     , _ignoreQGCRebootRequired  (false)
+    , _telemetryValue           (0)
+    , _telemetryValueValid      (false)
+    , _telemetryValueBoxPending (false)
+    , _deferredRawValueChangeSignal(false)
+    , _factGroup                (nullptr)
+    , _factGroupIndex           (-1)
 {
     qgcApp()->toolbox()->corePlugin()->adjustSettingMetaData(settingsGroup, *metaData);
     setMetaData(metaData, true /* setDefaultFromMetaData */);
@@ -73,6 +93,8 @@ Fact::Fact(const QString& settingsGroup, FactMetaData* metaData, QObject* parent
 
 Fact::Fact(const Fact& other, QObject* parent)
     : QObject(parent)
+    , _factGroup                (nullptr)
+    , _factGroupIndex           (-1)
 {
     *this = other;
 
@@ -89,12 +111,16 @@ const Fact& Fact::operator=(const Fact& other)
 {
     _name                       = other._name;
     _componentId                = other._componentId;
-    _rawValue                   = other._rawValue;
+    _rawValue                   = other.rawValue();
     _type                       = other._type;
     _sendValueChangedSignals    = other._sendValueChangedSignals;
     _deferredValueChangeSignal  = other._deferredValueChangeSignal;
     _valueSliderModel           = nullptr;
     _ignoreQGCRebootRequired    = other._ignoreQGCRebootRequired;
+    _telemetryValue             = other._telemetryValue;
+    _telemetryValueValid        = other._telemetryValueValid;
+    _telemetryValueBoxPending   = false;
+    _deferredRawValueChangeSignal = other._deferredRawValueChangeSignal;
     if (_metaData && other._metaData) {
         *_metaData = *other._metaData;
     } else {
@@ -112,6 +138,8 @@ void Fact::forceSetRawValue(const QVariant& value)
         
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
             _rawValue.setValue(typedValue);
+            _telemetryValueValid        = false;
+            _telemetryValueBoxPending   = false;
             _sendValueChangedSignal(cookedValue());
             //-- Must be in this order
             emit _containerRawValueChanged(rawValue());
@@ -129,8 +157,9 @@ void Fact::setRawValue(const QVariant& value)
         QString     errorString;
         
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
-            if (typedValue != _rawValue) {
+            if (typedValue != rawValue()) {
                 _rawValue.setValue(typedValue);
+                _telemetryValueValid = false;
                 _sendValueChangedSignal(cookedValue());
                 //-- Must be in this order
                 emit _containerRawValueChanged(rawValue());
@@ -179,8 +208,9 @@ void Fact::setEnumIndex(int index)
 
 void Fact::_containerSetRawValue(const QVariant& value)
 {
-    if(_rawValue != value) {
+    if(rawValue() != value) {
         _rawValue = value;
+        _telemetryValueValid = false;
         _sendValueChangedSignal(cookedValue());
         emit rawValueChanged(_rawValue);
     }
@@ -199,14 +229,75 @@ int Fact::componentId(void) const
     return _componentId;
 }
 
+QVariant Fact::rawValue(void) const
+{
+    if (_telemetryValueBoxPending) {
+        _boxTelemetryValue();
+    }
+    return _rawValue;
+}
+
 QVariant Fact::cookedValue(void) const
 {
     if (_metaData) {
-        return _metaData->rawTranslator()(_rawValue);
+        return _metaData->rawTranslator()(rawValue());
     } else {
         qWarning() << kMissingMetadata << name();
-        return _rawValue;
+        return rawValue();
+    }
+}
+
+void Fact::_setTelemetryValue(double value)
+{
+    if (_telemetryValueValid && (_telemetryValue == value || (qIsNaN(_telemetryValue) && qIsNaN(value)))) {
+        return;
+    }
+
+    _telemetryValue             = value;
+    _telemetryValueValid        = true;
+    _telemetryValueBoxPending   = true;
+
+    if (_sendValueChangedSignals) {
+        _deferredValueChangeSignal = false;
+        emit valueChanged(cookedValue());
+        emit rawValueChanged(_rawValue);
+    } else {
+        // Boxing and translation are left to whoever reads the value, the deferred signals included
+        _deferredRawValueChangeSignal = true;
+        _deferValueChangedSignal();
+    }
+}
+
+void Fact::_boxTelemetryValue(void) const
+{
+    switch (_type) {
+    case FactMetaData::valueTypeInt8:
+    case FactMetaData::valueTypeInt16:
+    case FactMetaData::valueTypeInt32:
+        _rawValue.setValue(static_cast<int>(qRound64(_telemetryValue)));
+        break;
+    case FactMetaData::valueTypeUint8:
+    case FactMetaData::valueTypeUint16:
+    case FactMetaData::valueTypeUint32:
+        _rawValue.setValue(static_cast<uint>(qRound64(_telemetryValue)));
+        break;
+    case FactMetaData::valueTypeFloat:
+        _rawValue.setValue(static_cast<float>(_telemetryValue));
+        break;
+    case FactMetaData::valueTypeBool:
+        _rawValue.setValue(_telemetryValue != 0);
+        break;
+    case FactMetaData::valueTypeInt64:
+        _rawValue.setValue(static_cast<qlonglong>(_telemetryValue));
+        break;
+    case FactMetaData::valueTypeUint64:
+        _rawValue.setValue(static_cast<qulonglong>(_telemetryValue));
+        break;
+    default:
+        _rawValue.setValue(_telemetryValue);
+        break;
     }
+    _telemetryValueBoxPending = false;
 }
 
 QString Fact::enumStringValue(void)
@@ -643,7 +734,17 @@ void Fact::_sendValueChangedSignal(QVariant value)
         emit valueChanged(value);
         _deferredValueChangeSignal = false;
     } else {
+        _deferValueChangedSignal();
+    }
+}
+
+void Fact::_deferValueChangedSignal(void)
+{
+    if (!_deferredValueChangeSignal) {
         _deferredValueChangeSignal = true;
+        if (_factGroup) {
+            _factGroup->_factValueChangeDeferred(_factGroupIndex);
+        }
     }
 }
 
@@ -653,6 +754,10 @@ void Fact::sendDeferredValueChangedSignal(void)
         _deferredValueChangeSignal = false;
         emit valueChanged(cookedValue());
     }
+    if (_deferredRawValueChangeSignal) {
+        _deferredRawValueChangeSignal = false;
+        emit rawValueChanged(rawValue());
+    }
 }
 
 QString Fact::enumOrValueString(void)
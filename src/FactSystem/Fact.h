@@ -23,6 +23,7 @@
 #include <QAbstractListModel>
 
 class FactValueSliderListModel;
+class FactGroup;
 
 /// @brief A Fact is used to hold a single value within the system.
 class Fact : public QObject
@@ -86,7 +87,7 @@ public:
     Q_INVOKABLE QVariant clamp(const QString& cookedValue);
 
     QVariant        cookedValue             (void) const;   /// Value after translation
-    QVariant        rawValue                (void) const { return _rawValue; }  /// value prior to translation, careful
+    QVariant        rawValue                (void) const;   /// value prior to translation, careful
     int             componentId             (void) const;
     int             decimalPlaces           (void) const;
     QVariant        rawDefaultValue         (void) const;
@@ -154,6 +155,9 @@ public:
     void clearDeferredValueChangeSignal(void) { _deferredValueChangeSignal = false; }
     void sendDeferredValueChangedSignal(void);
 
+    /// Used by FactGroup to be told about deferred value changed signals. Only a single group can track a Fact.
+    void _setFactGroup(FactGroup* factGroup, int factGroupIndex) { _factGroup = factGroup; _factGroupIndex = factGroupIndex; }
+
     // C++ methods
 
     /// Sets and sends new value to vehicle even if value is the same
@@ -168,6 +172,14 @@ public:
 
     //-- Value coming from Vehicle. This does NOT send a _containerRawValueChanged signal.
     void _containerSetRawValue(const QVariant& value);
+
+    /// Fast path for high rate telemetry from a trusted source such as a Vehicle message handler. The value is stored
+    /// natively without conversion or validation and is only boxed into a QVariant once it is read. Like
+    /// _containerSetRawValue this does NOT send a _containerRawValueChanged signal. When value changed signals are
+    /// deferred rawValueChanged is deferred as well. Not for use with string or custom Facts, 64 bit integers are
+    /// only exact up to 2^53.
+    template<typename T>
+    void setTelemetryValue(T value) { _setTelemetryValue(static_cast<double>(value)); }
     
     /// Generally you should not change the name of a fact. But if you know what you are doing, you can.
     void _setName(const QString& name) { _name = name; }
@@ -199,7 +211,10 @@ private slots:
     void _checkForRebootMessaging(void);
 
 private:
-    void _init(void);
+    void _init                  (void);
+    void _setTelemetryValue     (double value);
+    void _boxTelemetryValue     (void) const;
+    void _deferValueChangedSignal(void);
     
 protected:
     QString _variantToString(const QVariant& variant, int decimalPlaces) const;
@@ -207,13 +222,19 @@ protected:
 
     QString                     _name;
     int                         _componentId;
-    QVariant                    _rawValue;
+    mutable QVariant            _rawValue;                      ///< Stale while _telemetryValueBoxPending is set, use rawValue() to read
     FactMetaData::ValueType_t   _type;
     FactMetaData*               _metaData;
     bool                        _sendValueChangedSignals;
     bool                        _deferredValueChangeSignal;
     FactValueSliderListModel*   _valueSliderModel;
     bool                        _ignoreQGCRebootRequired;
+    double                      _telemetryValue;                ///< Current value when _telemetryValueValid is set
+    bool                        _telemetryValueValid;           ///< true: last value came through setTelemetryValue
+    mutable bool                _telemetryValueBoxPending;      ///< true: _telemetryValue has not been boxed into _rawValue yet
+    bool                        _deferredRawValueChangeSignal;
+    FactGroup*                  _factGroup;                     ///< Group which tracks deferred signals, nullptr for none
+    int                         _factGroupIndex;
 };
 
 #endif
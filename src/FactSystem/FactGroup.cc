@@ -17,15 +17,82 @@
 #include <QDebug>
 #include <QFile>
 #include <QQmlEngine>
+#include <QThread>
+#include <QtAlgorithms>
 
 QGC_LOGGING_CATEGORY(FactGroupLog, "FactGroupLog")
 
+FactGroupUpdateScheduler* FactGroupUpdateScheduler::_instance = nullptr;
+
+FactGroupUpdateScheduler::FactGroupUpdateScheduler(void)
+{
+    Q_ASSERT(!_instance);
+    _instance = this;
+    _timer.setSingleShot(true);
+    QObject::connect(&_timer, &QTimer::timeout, [this]() { _timeout(); });
+    _clock.start();
+}
+
+FactGroupUpdateScheduler::~FactGroupUpdateScheduler()
+{
+    for (FactGroup* factGroup: _pendingUpdates) {
+        factGroup->_updatePending = false;
+    }
+    _instance = nullptr;
+}
+
+void FactGroupUpdateScheduler::schedule(FactGroup* factGroup, int delayMSecs)
+{
+    // The timer belongs to the GUI thread, it can't be started from a vehicle's link thread
+    Q_ASSERT(QThread::currentThread() == _timer.thread());
+
+    factGroup->_updateDueMSecs = _clock.elapsed() + delayMSecs;
+    _pendingUpdates.insert(factGroup->_updateDueMSecs, factGroup);
+    _startTimer();
+}
+
+void FactGroupUpdateScheduler::remove(FactGroup* factGroup)
+{
+    _pendingUpdates.remove(factGroup->_updateDueMSecs, factGroup);
+    if (_pendingUpdates.isEmpty()) {
+        _timer.stop();
+    }
+}
+
+void FactGroupUpdateScheduler::_startTimer(void)
+{
+    if (_pendingUpdates.isEmpty()) {
+        _timer.stop();
+        return;
+    }
+
+    int timeoutMSecs = static_cast<int>(qMax(Q_INT64_C(0), _pendingUpdates.firstKey() - _clock.elapsed()));
+    if (!_timer.isActive() || timeoutMSecs < _timer.remainingTime()) {
+        _timer.start(timeoutMSecs);
+    }
+}
+
+void FactGroupUpdateScheduler::_timeout(void)
+{
+    qint64 flushMSecs = _clock.elapsed() + _coalesceMSecs;
+
+    // Updates can schedule or remove groups, so take one due group at a time
+    while (!_pendingUpdates.isEmpty() && _pendingUpdates.firstKey() <= flushMSecs) {
+        QMultiMap<qint64, FactGroup*>::iterator first = _pendingUpdates.begin();
+        FactGroup* factGroup = first.value();
+        _pendingUpdates.erase(first);
+        factGroup->_updatePending = false;
+        factGroup->_updateAllValues();
+    }
+
+    _startTimer();
+}
+
 FactGroup::FactGroup(int updateRateMsecs, const QString& metaDataFile, QObject* parent, bool ignoreCamelCase)
     : QObject(parent)
     , _updateRateMSecs(updateRateMsecs)
     , _ignoreCamelCase(ignoreCamelCase)
 {
-    _setupTimer();
     _nameToFactMetaDataMap = FactMetaData::createMapFromJsonFile(metaDataFile, this);
 }
 
@@ -34,23 +101,20 @@ FactGroup::FactGroup(int updateRateMsecs, QObject* parent, bool ignoreCamelCase)
     , _updateRateMSecs(updateRateMsecs)
     , _ignoreCamelCase(ignoreCamelCase)
 {
-    _setupTimer();
+
 }
 
-void FactGroup::_loadFromJsonArray(const QJsonArray jsonArray)
+FactGroup::~FactGroup()
 {
-    QMap<QString, QString> defineMap;
-    _nameToFactMetaDataMap = FactMetaData::createMapFromJsonArray(jsonArray, defineMap, this);
+    if (_updatePending && FactGroupUpdateScheduler::instance()) {
+        FactGroupUpdateScheduler::instance()->remove(this);
+    }
 }
 
-void FactGroup::_setupTimer()
+void FactGroup::_loadFromJsonArray(const QJsonArray jsonArray)
 {
-    if (_updateRateMSecs > 0) {
-        connect(&_updateTimer, &QTimer::timeout, this, &FactGroup::_updateAllValues);
-        _updateTimer.setSingleShot(false);
-        _updateTimer.setInterval(_updateRateMSecs);
-        _updateTimer.start();
-    }
+    QMap<QString, QString> defineMap;
+    _nameToFactMetaDataMap = FactMetaData::createMapFromJsonArray(jsonArray, defineMap, this);
 }
 
 Fact* FactGroup::getFact(const QString& name)
@@ -112,6 +176,16 @@ void FactGroup::_addFact(Fact* fact, const QString& name)
     }
     _nameToFactMap[name] = fact;
     _factNames.append(name);
+
+    if (_updateRateMSecs > 0) {
+        int factIndex = _facts.count();
+        _facts.append(fact);
+        _dirtyFactBits.resize((_facts.count() + 63) / 64);
+        fact->_setFactGroup(this, factIndex);
+        if (fact->deferredValueChangeSignal()) {
+            _factValueChangeDeferred(factIndex);
+        }
+    }
 }
 
 void FactGroup::_addFactGroup(FactGroup* factGroup, const QString& name)
@@ -124,24 +198,41 @@ void FactGroup::_addFactGroup(FactGroup* factGroup, const QString& name)
     _nameToFactGroupMap[name] = factGroup;
 }
 
+void FactGroup::_factValueChangeDeferred(int factIndex)
+{
+    _dirtyFactBits[factIndex >> 6] |= Q_UINT64_C(1) << (factIndex & 63);
+    if (!_updatePending) {
+        FactGroupUpdateScheduler* scheduler = FactGroupUpdateScheduler::instance();
+        if (scheduler) {
+            _updatePending = true;
+            scheduler->schedule(this, _updateRateMSecs);
+        } else {
+            // No application event loop to defer to
+            _updateAllValues();
+        }
+    }
+}
+
 void FactGroup::_updateAllValues(void)
 {
-    for(Fact* fact: _nameToFactMap) {
-        fact->sendDeferredValueChangedSignal();
+    for (int word=0; word<_dirtyFactBits.count(); word++) {
+        // Clear before signalling so Facts changed from within the signal handlers are picked up by the next update
+        quint64 dirtyBits = _dirtyFactBits[word];
+        _dirtyFactBits[word] = 0;
+        while (dirtyBits) {
+            int bit = static_cast<int>(qCountTrailingZeroBits(dirtyBits));
+            dirtyBits &= dirtyBits - 1;
+            _facts[word * 64 + bit]->sendDeferredValueChangedSignal();
+        }
     }
 }
 
 void FactGroup::setLiveUpdates(bool liveUpdates)
 {
-    if (_updateTimer.interval() == 0) {
+    if (_updateRateMSecs == 0) {
         return;
     }
 
-    if (liveUpdates) {
-        _updateTimer.stop();
-    } else {
-        _updateTimer.start();
-    }
     for(Fact* fact: _nameToFactMap) {
         fact->setSendValueChangedSignals(liveUpdates);
     }
@@ -17,9 +17,42 @@
 #include <QStringList>
 #include <QMap>
 #include <QTimer>
+#include <QVector>
+#include <QElapsedTimer>
 
 Q_DECLARE_LOGGING_CATEGORY(VehicleLog)
 
+class FactGroup;
+
+/// Single timer shared by all FactGroups of all vehicles. Only groups with dirty Facts are queued. Each is due one update
+/// rate after it first became dirty, and groups which are due close together are flushed in the same timeout.
+///
+/// QGCApplication creates the scheduler on the GUI thread, FactGroups with an update rate must only change from there.
+class FactGroupUpdateScheduler
+{
+public:
+    FactGroupUpdateScheduler(void);
+    ~FactGroupUpdateScheduler();
+
+    /// @return The application's scheduler, nullptr if there is none
+    static FactGroupUpdateScheduler* instance(void) { return _instance; }
+
+    void schedule   (FactGroup* factGroup, int delayMSecs);
+    void remove     (FactGroup* factGroup);
+
+private:
+    void _timeout   (void);
+    void _startTimer(void);
+
+    QTimer                          _timer;
+    QElapsedTimer                   _clock;
+    QMultiMap<qint64, FactGroup*>   _pendingUpdates;    ///< Keyed by due time, earliest first
+
+    static FactGroupUpdateScheduler* _instance;
+
+    static const int _coalesceMSecs = 10;   ///< Groups due within this window of the earliest one are flushed together
+};
+
 /// Used to group Facts together into an object hierarachy.
 class FactGroup : public QObject
 {
@@ -28,6 +61,7 @@ class FactGroup : public QObject
 public:
     FactGroup(int updateRateMsecs, const QString& metaDataFile, QObject* parent = nullptr, bool ignoreCamelCase = false);
     FactGroup(int updateRateMsecs, QObject* parent = nullptr, bool ignoreCamelCase = false);
+    ~FactGroup();
 
     Q_PROPERTY(QStringList factNames        READ factNames      CONSTANT)
     Q_PROPERTY(QStringList factGroupNames   READ factGroupNames CONSTANT)
@@ -44,7 +78,13 @@ public:
     QStringList factNames(void) const { return _factNames; }
     QStringList factGroupNames(void) const { return _nameToFactGroupMap.keys(); }
 
+    /// Called by a Fact of this group when it defers its value changed signal. Marks the Fact as dirty and schedules
+    /// an update on the shared update timer if one is not already pending.
+    void _factValueChangeDeferred(int factIndex);
+
 protected slots:
+    /// Sends the deferred value changed signals for the dirty Facts only. Called by the shared update timer about one
+    /// update rate after the first change.
     virtual void _updateAllValues(void);
 
 protected:
@@ -60,11 +100,15 @@ protected:
     QStringList                     _factNames;
 
 private:
-    void    _setupTimer (void);
     QString _camelCase  (const QString& text);
 
-    bool    _ignoreCamelCase = false;
-    QTimer  _updateTimer;
+    bool                _ignoreCamelCase    = false;
+    bool                _updatePending      = false;    ///< true: group is queued on the shared update timer
+    qint64              _updateDueMSecs     = 0;        ///< Key of the group in the scheduler's pending updates
+    QVector<Fact*>      _facts;                         ///< Indexed by the Fact's position in the dirty bitset
+    QVector<quint64>    _dirtyFactBits;                 ///< Facts which have a deferred value changed signal
+
+    friend class FactGroupUpdateScheduler;
 };
 
 #endif
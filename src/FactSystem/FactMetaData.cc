@@ -16,6 +16,8 @@
 #include <QtMath>
 #include <QJsonParseError>
 #include <QJsonArray>
+#include <QHash>
+#include <QMutex>
 
 #include <limits>
 #include <cmath>
@@ -1400,12 +1402,32 @@ QMap<QString, FactMetaData*> FactMetaData::createMapFromJsonFile(const QString&
 {
     QMap<QString, FactMetaData*> metaDataMap;
 
-    QString errorString;
-    int version;
-    QJsonObject jsonObject = JsonHelper::openInternalQGCJsonFile(jsonFilename, qgcFileType, 1, 1, version, errorString);
-    if (!errorString.isEmpty()) {
-        qWarning() << "Internal Error: " << errorString;
-        return metaDataMap;
+    // Internal json files don't change, so each is only read and parsed once. FactMetaData is still created per call
+    // since it belongs to the caller. The cache is shared by every thread which creates fact meta data.
+    static QMutex                       jsonObjectCacheMutex;
+    static QHash<QString, QJsonObject>  jsonObjectCache;
+
+    QString     errorString;
+    QJsonObject jsonObject;
+    bool        cached;
+
+    jsonObjectCacheMutex.lock();
+    cached = jsonObjectCache.contains(jsonFilename);
+    if (cached) {
+        jsonObject = jsonObjectCache.value(jsonFilename);
+    }
+    jsonObjectCacheMutex.unlock();
+
+    if (!cached) {
+        int version;
+        jsonObject = JsonHelper::openInternalQGCJsonFile(jsonFilename, qgcFileType, 1, 1, version, errorString);
+        if (!errorString.isEmpty()) {
+            qWarning() << "Internal Error: " << errorString;
+            return metaDataMap;
+        }
+        jsonObjectCacheMutex.lock();
+        jsonObjectCache.insert(jsonFilename, jsonObject);
+        jsonObjectCacheMutex.unlock();
     }
 
     QJsonArray factArray;
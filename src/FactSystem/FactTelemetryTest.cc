@@ -0,0 +1,228 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactTelemetryTest.h"
+#include "FactGroup.h"
+
+#include <QElapsedTimer>
+#include <QSignalSpy>
+
+FactTelemetryTest::FactTelemetryTest(void)
+{
+
+}
+
+void FactTelemetryTest::_boxing_test(void)
+{
+    Fact doubleFact (0, "double",   FactMetaData::valueTypeDouble);
+    Fact floatFact  (0, "float",    FactMetaData::valueTypeFloat);
+    Fact uintFact   (0, "uint",     FactMetaData::valueTypeUint8);
+    Fact intFact    (0, "int",      FactMetaData::valueTypeInt32);
+    Fact boolFact   (0, "bool",     FactMetaData::valueTypeBool);
+
+    doubleFact.setTelemetryValue(1.5);
+    floatFact.setTelemetryValue(2.5f);
+    uintFact.setTelemetryValue(static_cast<uint8_t>(200));
+    intFact.setTelemetryValue(-7);
+    boolFact.setTelemetryValue(true);
+
+    // Boxed values must be the same as setRawValue would have produced
+    QCOMPARE(doubleFact.rawValue().type(),  QVariant::Double);
+    QCOMPARE(doubleFact.rawValue().toDouble(), 1.5);
+    QCOMPARE(static_cast<int>(floatFact.rawValue().type()), static_cast<int>(QMetaType::Float));
+    QCOMPARE(floatFact.rawValue().toFloat(), 2.5f);
+    QCOMPARE(uintFact.rawValue().type(),    QVariant::UInt);
+    QCOMPARE(uintFact.rawValue().toUInt(),  200u);
+    QCOMPARE(intFact.rawValue().type(),     QVariant::Int);
+    QCOMPARE(intFact.rawValue().toInt(),    -7);
+    QCOMPARE(boolFact.rawValue().type(),    QVariant::Bool);
+    QCOMPARE(boolFact.rawValue().toBool(),  true);
+    QCOMPARE(doubleFact.cookedValue().toDouble(), 1.5);
+
+    doubleFact.setTelemetryValue(qQNaN());
+    QVERIFY(qIsNaN(doubleFact.rawValue().toDouble()));
+}
+
+void FactTelemetryTest::_signals_test(void)
+{
+    Fact        fact(0, "fact", FactMetaData::valueTypeDouble);
+    QSignalSpy  valueSpy(&fact, &Fact::valueChanged);
+    QSignalSpy  rawValueSpy(&fact, &Fact::rawValueChanged);
+    QSignalSpy  containerSpy(&fact, &Fact::_containerRawValueChanged);
+
+    fact.setTelemetryValue(1.0);
+    QCOMPARE(valueSpy.count(),      1);
+    QCOMPARE(rawValueSpy.count(),   1);
+    QCOMPARE(containerSpy.count(),  0);
+    QCOMPARE(valueSpy.takeFirst()[0].toDouble(), 1.0);
+    rawValueSpy.clear();
+
+    // Same value, NaN included, does not signal
+    fact.setTelemetryValue(1.0);
+    fact.setTelemetryValue(qQNaN());
+    fact.setTelemetryValue(qQNaN());
+    QCOMPARE(valueSpy.count(),      2);
+    valueSpy.clear();
+    rawValueSpy.clear();
+
+    // Deferred: nothing is boxed or signalled until the deferred signals go out
+    fact.setSendValueChangedSignals(false);
+    fact.setTelemetryValue(2.0);
+    fact.setTelemetryValue(3.0);
+    QCOMPARE(valueSpy.count(),      0);
+    QCOMPARE(rawValueSpy.count(),   0);
+    QVERIFY(fact.deferredValueChangeSignal());
+
+    fact.sendDeferredValueChangedSignal();
+    QCOMPARE(valueSpy.count(),      1);
+    QCOMPARE(rawValueSpy.count(),   1);
+    QCOMPARE(valueSpy.takeFirst()[0].toDouble(),    3.0);
+    QCOMPARE(rawValueSpy.takeFirst()[0].toDouble(), 3.0);
+
+    fact.sendDeferredValueChangedSignal();
+    QCOMPARE(valueSpy.count(),      0);
+    QCOMPARE(rawValueSpy.count(),   0);
+}
+
+void FactTelemetryTest::_mixedSetters_test(void)
+{
+    Fact        fact(0, "fact", FactMetaData::valueTypeDouble);
+    QSignalSpy  valueSpy(&fact, &Fact::valueChanged);
+
+    fact.setTelemetryValue(5.0);
+    fact.setRawValue(5.0);
+    QCOMPARE(valueSpy.count(), 1);
+
+    // A value set through the regular path must not be mistaken for the last telemetry value
+    fact.setRawValue(6.0);
+    fact.setTelemetryValue(5.0);
+    QCOMPARE(valueSpy.count(), 3);
+    QCOMPARE(fact.rawValue().toDouble(), 5.0);
+
+    Fact copy(fact);
+    QCOMPARE(copy.rawValue().toDouble(), 5.0);
+}
+
+/// FactGroup with public access to its Facts which counts its updates
+class UpdateCountFactGroup : public FactGroup
+{
+public:
+    UpdateCountFactGroup(int updateRateMSecs, int factCount)
+        : FactGroup(updateRateMSecs)
+    {
+        for (int i=0; i<factCount; i++) {
+            Fact* fact = new Fact(0, QStringLiteral("fact%1").arg(i), FactMetaData::valueTypeDouble, this);
+            facts.append(fact);
+            _addFact(fact, fact->name());
+        }
+    }
+
+    QList<Fact*>    facts;
+    int             updateCount = 0;
+
+protected:
+    void _updateAllValues(void) override
+    {
+        updateCount++;
+        FactGroup::_updateAllValues();
+    }
+};
+
+void FactTelemetryTest::_updateScheduler_test(void)
+{
+    const int updateRateMSecs = 50;
+
+    UpdateCountFactGroup group1(updateRateMSecs, 3);
+    UpdateCountFactGroup group2(updateRateMSecs, 2);
+    QSignalSpy fact0Spy(group1.facts[0], &Fact::valueChanged);
+    QSignalSpy fact1Spy(group1.facts[1], &Fact::valueChanged);
+    QSignalSpy fact2Spy(group1.facts[2], &Fact::valueChanged);
+    QSignalSpy group2Spy(group2.facts[0], &Fact::valueChanged);
+
+    // Changes are held until the update, however often they happen
+    for (int i=1; i<=10; i++) {
+        group1.facts[0]->setTelemetryValue(i);
+        group1.facts[1]->setRawValue(i * 2);
+    }
+    group2.facts[0]->setTelemetryValue(1.0);
+    QCOMPARE(fact0Spy.count(), 0);
+    QCOMPARE(fact1Spy.count(), 0);
+    QCOMPARE(group1.updateCount, 0);
+
+    // Groups which are due together are flushed together, each once, and only the dirty Facts signal
+    QTRY_COMPARE(group1.updateCount, 1);
+    QCOMPARE(group2.updateCount, 1);
+    QCOMPARE(fact0Spy.count(), 1);
+    QCOMPARE(fact0Spy.last()[0].toDouble(), 10.0);
+    QCOMPARE(fact1Spy.count(), 1);
+    QCOMPARE(fact1Spy.last()[0].toDouble(), 20.0);
+    QCOMPARE(fact2Spy.count(), 0);
+    QCOMPARE(group2Spy.count(), 1);
+
+    // Nothing dirty, no further updates
+    QTest::qWait(updateRateMSecs * 3);
+    QCOMPARE(group1.updateCount, 1);
+    QCOMPARE(group2.updateCount, 1);
+
+    // A change after the update is picked up by the next one
+    group1.facts[2]->setTelemetryValue(5.0);
+    QTRY_COMPARE(group1.updateCount, 2);
+    QCOMPARE(fact0Spy.count(), 1);
+    QCOMPARE(fact2Spy.count(), 1);
+    QCOMPARE(group2.updateCount, 1);
+
+    // A group deleted while its update is pending is taken off the scheduler
+    UpdateCountFactGroup* deletedGroup = new UpdateCountFactGroup(updateRateMSecs, 1);
+    deletedGroup->facts[0]->setTelemetryValue(1.0);
+    group1.facts[0]->setTelemetryValue(11.0);
+    delete deletedGroup;
+    QTRY_COMPARE(group1.updateCount, 3);
+    QCOMPARE(fact0Spy.count(), 2);
+}
+
+void FactTelemetryTest::_updateRateBenchmark_test(void)
+{
+    UT_BENCHMARK();
+
+    QList<Fact*> facts;
+    for (int i=0; i<_benchmarkFactCount; i++) {
+        Fact* fact = new Fact(0, QStringLiteral("fact%1").arg(i), i & 1 ? FactMetaData::valueTypeFloat : FactMetaData::valueTypeDouble, this);
+        // Same as a FactGroup with an update rate
+        fact->setSendValueChangedSignals(false);
+        facts.append(fact);
+    }
+
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int message=0; message<_benchmarkMessageCount; message++) {
+        for (int i=0; i<_benchmarkFactCount; i++) {
+            facts[i]->setRawValue(message + i * 0.5);
+        }
+    }
+    qint64 rawValueNSecs = timer.nsecsElapsed();
+
+    timer.start();
+    for (int message=0; message<_benchmarkMessageCount; message++) {
+        for (int i=0; i<_benchmarkFactCount; i++) {
+            facts[i]->setTelemetryValue(message + 1 + i * 0.5);
+        }
+    }
+    qint64 telemetryNSecs = timer.nsecsElapsed();
+
+    for (int i=0; i<_benchmarkFactCount; i++) {
+        QCOMPARE(facts[i]->rawValue().toDouble(), _benchmarkMessageCount + i * 0.5);
+        delete facts[i];
+    }
+
+    qint64 updateCount = static_cast<qint64>(_benchmarkMessageCount) * _benchmarkFactCount;
+    qDebug() << "Fact update benchmark updates" << updateCount;
+    qDebug() << "    setRawValue updates/sec" << static_cast<qint64>(updateCount / (rawValueNSecs / 1e9));
+    qDebug() << "    setTelemetryValue updates/sec" << static_cast<qint64>(updateCount / (telemetryNSecs / 1e9));
+}
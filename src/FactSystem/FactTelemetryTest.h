@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "Fact.h"
+
+/// @file
+///     @brief Fact::setTelemetryValue unit test, update rate benchmark against Fact::setRawValue and FactGroup update
+///             scheduling unit test
+
+class FactTelemetryTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    FactTelemetryTest(void);
+
+private slots:
+    void _boxing_test               (void);
+    void _signals_test              (void);
+    void _mixedSetters_test         (void);
+    void _updateScheduler_test      (void);
+    void _updateRateBenchmark_test  (void);
+
+private:
+    static const int _benchmarkFactCount    = 20;       ///< About what ESTIMATOR_STATUS sets per message
+    static const int _benchmarkMessageCount = 200000;
+};
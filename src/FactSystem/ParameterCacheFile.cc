@@ -0,0 +1,306 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterCacheFile.h"
+#include "Fact.h"
+
+#include <QSaveFile>
+
+#include <string.h>
+
+ParameterCacheFile::ParameterCacheFile(const QString& filename)
+    : _file     (filename)
+    , _map      (nullptr)
+    , _entries  (nullptr)
+    , _names    (nullptr)
+    , _count    (0)
+{
+
+}
+
+ParameterCacheFile::~ParameterCacheFile()
+{
+    close();
+}
+
+bool ParameterCacheFile::open(void)
+{
+    if (_map) {
+        return true;
+    }
+    if (!_file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    qint64 size = _file.size();
+    if (size >= static_cast<qint64>(sizeof(Header_t))) {
+        _map = _file.map(0, size);
+    }
+    if (!_map) {
+        close();
+        return false;
+    }
+
+    const Header_t* header      = reinterpret_cast<const Header_t*>(_map);
+    qint64          namesStart  = static_cast<qint64>(sizeof(Header_t)) + static_cast<qint64>(header->count) * static_cast<qint64>(sizeof(Entry_t));
+    if (header->magic != _magic || header->version != _version || namesStart + header->namesSize != size) {
+        qWarning() << "Ignoring invalid parameter cache" << _file.fileName();
+        close();
+        return false;
+    }
+
+    _entries    = reinterpret_cast<const Entry_t*>(_map + sizeof(Header_t));
+    _names      = reinterpret_cast<const char*>(_map + namesStart);
+    _count      = static_cast<int>(header->count);
+    for (int i=0; i<_count; i++) {
+        const Entry_t& entry = _entries[i];
+        if (static_cast<quint64>(entry.nameOffset) + entry.nameLength > header->namesSize ||
+                entry.valueType > FactMetaData::valueTypeDouble ||
+                FactMetaData::typeToSize(type(i)) > maxValueSize) {
+            qWarning() << "Ignoring corrupt parameter cache" << _file.fileName();
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ParameterCacheFile::close(void)
+{
+    if (_map) {
+        _file.unmap(_map);
+        _map = nullptr;
+    }
+    _file.close();
+    _entries    = nullptr;
+    _names      = nullptr;
+    _count      = 0;
+}
+
+QString ParameterCacheFile::name(int index) const
+{
+    return QString::fromLatin1(nameData(index), nameLength(index));
+}
+
+QVariant ParameterCacheFile::value(int index) const
+{
+    const quint8* data = valueData(index);
+
+    switch (type(index)) {
+    case FactMetaData::valueTypeUint8:
+        return QVariant(static_cast<uint>(*data));
+    case FactMetaData::valueTypeInt8:
+        return QVariant(static_cast<int>(*reinterpret_cast<const qint8*>(data)));
+    case FactMetaData::valueTypeUint16:
+    {
+        quint16 v;
+        memcpy(&v, data, sizeof(v));
+        return QVariant(static_cast<uint>(v));
+    }
+    case FactMetaData::valueTypeInt16:
+    {
+        qint16 v;
+        memcpy(&v, data, sizeof(v));
+        return QVariant(static_cast<int>(v));
+    }
+    case FactMetaData::valueTypeUint32:
+    {
+        quint32 v;
+        memcpy(&v, data, sizeof(v));
+        return QVariant(v);
+    }
+    case FactMetaData::valueTypeInt32:
+    {
+        qint32 v;
+        memcpy(&v, data, sizeof(v));
+        return QVariant(v);
+    }
+    case FactMetaData::valueTypeUint64:
+    {
+        quint64 v;
+        memcpy(&v, data, sizeof(v));
+        return QVariant(v);
+    }
+    case FactMetaData::valueTypeInt64:
+    {
+        qint64 v;
+        memcpy(&v, data, sizeof(v));
+        return QVariant(v);
+    }
+    case FactMetaData::valueTypeFloat:
+    {
+        float v;
+        memcpy(&v, data, sizeof(v));
+        return QVariant(v);
+    }
+    case FactMetaData::valueTypeDouble:
+    {
+        double v;
+        memcpy(&v, data, sizeof(v));
+        return QVariant(v);
+    }
+    default:
+        return QVariant();
+    }
+}
+
+int ParameterCacheFile::find(const QString& name) const
+{
+    const QByteArray key = name.toLatin1();
+
+    // Entries are sorted the same way QMap<QString> sorts the names when the cache is written
+    int low = 0;
+    int high = _count - 1;
+    while (low <= high) {
+        int mid     = (low + high) / 2;
+        int length  = nameLength(mid);
+        int result  = memcmp(nameData(mid), key.constData(), static_cast<size_t>(qMin(length, key.length())));
+        if (result == 0) {
+            result = length - key.length();
+        }
+        if (result == 0) {
+            return mid;
+        } else if (result < 0) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+bool ParameterCacheFile::updateValue(int index, FactMetaData::ValueType_t type, const QVariant& rawValue)
+{
+    if (!_map || type != this->type(index)) {
+        return false;
+    }
+
+    // The mapping is shared, so the change goes straight to the file
+    Entry_t* entry = const_cast<Entry_t*>(&_entries[index]);
+    _encodeValue(type, rawValue, entry->value);
+    return true;
+}
+
+void ParameterCacheFile::_encodeValue(FactMetaData::ValueType_t type, const QVariant& rawValue, quint8* data)
+{
+    // Converted by type rather than copied from QVariant::constData so a value held as a wider type can't overrun
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+    {
+        quint8 v = static_cast<quint8>(rawValue.toUInt());
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    case FactMetaData::valueTypeInt8:
+    {
+        qint8 v = static_cast<qint8>(rawValue.toInt());
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    case FactMetaData::valueTypeUint16:
+    {
+        quint16 v = static_cast<quint16>(rawValue.toUInt());
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    case FactMetaData::valueTypeInt16:
+    {
+        qint16 v = static_cast<qint16>(rawValue.toInt());
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    case FactMetaData::valueTypeUint32:
+    {
+        quint32 v = rawValue.toUInt();
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    case FactMetaData::valueTypeInt32:
+    {
+        qint32 v = rawValue.toInt();
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    case FactMetaData::valueTypeUint64:
+    {
+        quint64 v = rawValue.toULongLong();
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    case FactMetaData::valueTypeInt64:
+    {
+        qint64 v = rawValue.toLongLong();
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    case FactMetaData::valueTypeFloat:
+    {
+        float v = rawValue.toFloat();
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    case FactMetaData::valueTypeDouble:
+    {
+        double v = rawValue.toDouble();
+        memcpy(data, &v, sizeof(v));
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+bool ParameterCacheFile::write(const QString& filename, const QVariantMap& factMap)
+{
+    QVector<Entry_t>    entries;
+    QByteArray          names;
+
+    entries.reserve(factMap.count());
+    for (QVariantMap::const_iterator iter = factMap.constBegin(); iter != factMap.constEnd(); iter++) {
+        const Fact*     fact        = iter.value().value<Fact*>();
+        const QByteArray name       = iter.key().toLatin1();
+        size_t          valueSize   = FactMetaData::typeToSize(fact->type());
+        if (valueSize > maxValueSize || name.length() > 0xFFFF) {
+            qWarning() << "Parameter cache not written, unsupported parameter" << iter.key();
+            return false;
+        }
+
+        Entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.nameOffset    = static_cast<quint32>(names.length());
+        entry.nameLength    = static_cast<quint16>(name.length());
+        entry.valueType     = static_cast<quint8>(fact->type());
+        _encodeValue(fact->type(), fact->rawValue(), entry.value);
+        entries.append(entry);
+        names.append(name);
+    }
+
+    Header_t header;
+    header.magic        = _magic;
+    header.version      = _version;
+    header.count        = static_cast<quint32>(entries.count());
+    header.namesSize    = static_cast<quint32>(names.length());
+
+    // Written to the side and renamed over the old cache so existing mappings of it stay valid
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Unable to write parameter cache" << filename << file.errorString();
+        return false;
+    }
+    qint64 entriesSize = static_cast<qint64>(entries.count()) * static_cast<qint64>(sizeof(Entry_t));
+    if (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header) ||
+            file.write(reinterpret_cast<const char*>(entries.constData()), entriesSize) != entriesSize ||
+            file.write(names) != names.length() ||
+            !file.commit()) {
+        qWarning() << "Unable to write parameter cache" << filename << file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QFile>
+#include <QVariantMap>
+
+#include "FactMetaData.h"
+
+/// Memory mapped parameter cache of a single vehicle component.
+///
+/// Layout, in host byte order:
+///     Header_t
+///     Entry_t[count]      Sorted by name. Fixed size so a single value can be rewritten in place.
+///     Names               All names back to back, Latin1, each stored once.
+/// Reading walks the mapped entries directly, nothing is deserialized up front.
+class ParameterCacheFile
+{
+public:
+    ParameterCacheFile(const QString& filename);
+    ~ParameterCacheFile();
+
+    static const size_t maxValueSize = 8;
+
+    typedef struct {
+        quint32 magic;
+        quint32 version;
+        quint32 count;
+        quint32 namesSize;
+    } Header_t;
+
+    typedef struct {
+        quint32 nameOffset;             ///< From the start of the names block
+        quint16 nameLength;
+        quint8  valueType;              ///< FactMetaData::ValueType_t
+        quint8  reserved;
+        quint8  value[maxValueSize];    ///< Raw value in its FactMetaData::typeToSize native bytes, as the vehicle hashes it
+    } Entry_t;
+
+    /// Maps an existing cache file
+    ///     @return false: no cache file or not a valid one
+    bool open   (void);
+    void close  (void);
+    bool isOpen (void) const { return _map != nullptr; }
+
+    int                         count       (void) const { return _count; }
+    QString                     name        (int index) const;
+    const char*                 nameData    (int index) const { return _names + _entries[index].nameOffset; }
+    int                         nameLength  (int index) const { return _entries[index].nameLength; }
+    FactMetaData::ValueType_t   type        (int index) const { return static_cast<FactMetaData::ValueType_t>(_entries[index].valueType); }
+    const quint8*               valueData   (int index) const { return _entries[index].value; }
+    QVariant                    value       (int index) const;
+
+    /// @return Index of the named entry, -1 if not found
+    int find(const QString& name) const;
+
+    /// Rewrites the value of a single entry in place
+    ///     @return false: type differs from the cached type, the cache needs to be written again
+    bool updateValue(int index, FactMetaData::ValueType_t type, const QVariant& rawValue);
+
+    /// Writes a complete cache file
+    ///     @param factMap Parameter name to Fact*, as kept by ParameterManager
+    ///     @return false: write failed or a parameter can't be cached
+    static bool write(const QString& filename, const QVariantMap& factMap);
+
+private:
+    static void _encodeValue(FactMetaData::ValueType_t type, const QVariant& rawValue, quint8* data);
+
+    QFile           _file;
+    uchar*          _map;
+    const Entry_t*  _entries;
+    const char*     _names;
+    int             _count;
+
+    static const quint32 _magic     = 0x51504331;   ///< "QPC1"
+    static const quint32 _version   = 1;
+};
@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterCacheFileTest.h"
+#include "ParameterCacheFile.h"
+#include "Fact.h"
+
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <QDataStream>
+
+ParameterCacheFileTest::ParameterCacheFileTest(void)
+{
+
+}
+
+static void _addFact(QVariantMap& factMap, const QString& name, FactMetaData::ValueType_t type, const QVariant& rawValue, QObject* parent)
+{
+    Fact* fact = new Fact(1, name, type, parent);
+    fact->_containerSetRawValue(rawValue);
+    factMap[name] = QVariant::fromValue(fact);
+}
+
+void ParameterCacheFileTest::_writeRead_test(void)
+{
+    QTemporaryDir   tempDir;
+    QObject         parent;
+    QVariantMap     factMap;
+    QString         filename = tempDir.filePath("1_1.v3");
+
+    _addFact(factMap, "SYS_AUTOSTART",  FactMetaData::valueTypeInt32,   4001,                       &parent);
+    _addFact(factMap, "BAT_N_CELLS",    FactMetaData::valueTypeUint8,   4u,                         &parent);
+    _addFact(factMap, "MC_ROLL_P",      FactMetaData::valueTypeFloat,   6.5f,                       &parent);
+    _addFact(factMap, "RC1_MIN",        FactMetaData::valueTypeInt16,   -1000,                      &parent);
+    _addFact(factMap, "UAVCAN_NODE_ID", FactMetaData::valueTypeUint64,  Q_UINT64_C(0x123456789),    &parent);
+    _addFact(factMap, "EKF2_NOISE",     FactMetaData::valueTypeDouble,  0.25,                       &parent);
+    QVERIFY(ParameterCacheFile::write(filename, factMap));
+
+    ParameterCacheFile cacheFile(filename);
+    QVERIFY(cacheFile.open());
+    QCOMPARE(cacheFile.count(), factMap.count());
+
+    // Entries come back in the same order as the map
+    int index = 0;
+    for (const QString& name: factMap.keys()) {
+        Fact* fact = factMap[name].value<Fact*>();
+        QCOMPARE(cacheFile.name(index), name);
+        QCOMPARE(cacheFile.type(index), fact->type());
+        QCOMPARE(cacheFile.value(index), fact->rawValue());
+        QCOMPARE(cacheFile.find(name), index);
+        index++;
+    }
+    QCOMPARE(cacheFile.find("MISSING"), -1);
+    QCOMPARE(cacheFile.find("RC1_MI"), -1);
+    QCOMPARE(cacheFile.find("RC1_MIN_"), -1);
+
+    // Values are stored in their native size, as used for the vehicle parameter hash
+    index = cacheFile.find("RC1_MIN");
+    qint16 rcMin;
+    memcpy(&rcMin, cacheFile.valueData(index), sizeof(rcMin));
+    QCOMPARE(rcMin, static_cast<qint16>(-1000));
+}
+
+void ParameterCacheFileTest::_updateValue_test(void)
+{
+    QTemporaryDir   tempDir;
+    QObject         parent;
+    QVariantMap     factMap;
+    QString         filename = tempDir.filePath("1_1.v3");
+
+    _addFact(factMap, "MC_PITCH_P", FactMetaData::valueTypeFloat, 6.5f, &parent);
+    _addFact(factMap, "MC_ROLL_P",  FactMetaData::valueTypeFloat, 6.5f, &parent);
+    QVERIFY(ParameterCacheFile::write(filename, factMap));
+    qint64 size = QFileInfo(filename).size();
+
+    {
+        ParameterCacheFile cacheFile(filename);
+        QVERIFY(cacheFile.open());
+        int index = cacheFile.find("MC_ROLL_P");
+        QVERIFY(cacheFile.updateValue(index, FactMetaData::valueTypeFloat, 7.25f));
+        QCOMPARE(cacheFile.value(index), QVariant(7.25f));
+
+        // A type change can't be done in place
+        QVERIFY(!cacheFile.updateValue(index, FactMetaData::valueTypeInt32, 7));
+    }
+
+    // Update went straight to the file
+    QCOMPARE(QFileInfo(filename).size(), size);
+    ParameterCacheFile cacheFile(filename);
+    QVERIFY(cacheFile.open());
+    QCOMPARE(cacheFile.value(cacheFile.find("MC_ROLL_P")),  QVariant(7.25f));
+    QCOMPARE(cacheFile.value(cacheFile.find("MC_PITCH_P")), QVariant(6.5f));
+}
+
+void ParameterCacheFileTest::_invalidFile_test(void)
+{
+    QTemporaryDir   tempDir;
+    QString         filename = tempDir.filePath("1_1.v3");
+
+    QVERIFY(!ParameterCacheFile(filename).open());
+
+    // Cache from before the mapped format
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QDataStream ds(&file);
+    ds << QMap<QString, QPair<int, QVariant>>();
+    file.close();
+    QVERIFY(!ParameterCacheFile(filename).open());
+}
@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class ParameterCacheFileTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    ParameterCacheFileTest(void);
+
+private slots:
+    void _writeRead_test        (void);
+    void _updateValue_test      (void);
+    void _invalidFile_test      (void);
+};
@@ -0,0 +1,139 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterIndexDownload.h"
+
+ParameterIndexDownload::ParameterIndexDownload(void)
+    : _waitingCount     (0)
+    , _inFlightCount    (0)
+    , _nextIndex        (0)
+    , _window           (initialWindow)
+    , _answeredCount    (0)
+    , _growCount        (0)
+    , _lossRate         (0)
+    , _retrying         (false)
+{
+    _timer.setSingleShot(true);
+}
+
+void ParameterIndexDownload::reset(int paramCount)
+{
+    _received.fill(false, paramCount);
+    _inFlight.fill(false, paramCount);
+    _retryCount.fill(0, paramCount);
+    _waitingCount   = paramCount;
+    _inFlightCount  = 0;
+    _nextIndex      = 0;
+    _answeredCount  = 0;
+    _growCount      = 0;
+    _retrying       = false;
+
+    // The window carries over, it reflects the link and not the request
+}
+
+void ParameterIndexDownload::setAllReceived(void)
+{
+    _received.fill(true);
+    _inFlight.fill(false);
+    _waitingCount   = 0;
+    _inFlightCount  = 0;
+    _timer.stop();
+}
+
+QList<int> ParameterIndexDownload::waitingIndices(void) const
+{
+    QList<int> indices;
+
+    for (int i=0; i<_received.count(); i++) {
+        if (!_received.testBit(i)) {
+            indices.append(i);
+        }
+    }
+    return indices;
+}
+
+bool ParameterIndexDownload::received(int index)
+{
+    if (!isWaiting(index)) {
+        return false;
+    }
+
+    _received.setBit(index);
+    _waitingCount--;
+
+    if (_inFlight.testBit(index)) {
+        _inFlight.clearBit(index);
+        _inFlightCount--;
+        _answeredCount++;
+
+        // Grow once a full window has been answered without a timeout
+        if (++_growCount >= _window) {
+            _growCount = 0;
+            _window += (_window / 4) + 1;
+            if (_window > maxWindow) {
+                _window = maxWindow;
+            }
+        }
+    }
+
+    return true;
+}
+
+void ParameterIndexDownload::nextRequests(int maxRetries, QList<int>& requests, QList<int>& failed)
+{
+    if (!_retrying) {
+        return;
+    }
+
+    int count = _received.count();
+    for (int i=0; i<count && _waitingCount && _inFlightCount < _window; i++) {
+        int index = _nextIndex;
+        _nextIndex = (_nextIndex + 1) % count;
+
+        if (_received.testBit(index) || _inFlight.testBit(index)) {
+            continue;
+        }
+
+        if (_retryCount[index] < 0xFF) {
+            _retryCount[index]++;
+        }
+        if (_retryCount[index] > maxRetries) {
+            _received.setBit(index);
+            _waitingCount--;
+            failed.append(index);
+        } else {
+            _inFlight.setBit(index);
+            _inFlightCount++;
+            requests.append(index);
+        }
+    }
+}
+
+void ParameterIndexDownload::timeout(void)
+{
+    if (!_retrying) {
+        // Initial stream stalled
+        _retrying = true;
+        return;
+    }
+
+    int sentCount = _answeredCount + _inFlightCount;
+    if (sentCount) {
+        _lossRate   = static_cast<double>(_inFlightCount) / sentCount;
+        _window     = static_cast<int>(_window * (1.0 - _lossRate));
+        if (_window < minWindow) {
+            _window = minWindow;
+        }
+    }
+    _answeredCount  = 0;
+    _growCount      = 0;
+
+    _inFlight.fill(false);
+    _inFlightCount = 0;
+}
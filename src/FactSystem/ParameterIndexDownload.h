@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QBitArray>
+#include <QTimer>
+#include <QVector>
+
+/// Index based parameter download state of a single vehicle component.
+///
+/// The initial PARAM_REQUEST_LIST stream is tracked with one bit per parameter index. Once the stream stalls the
+/// missing indices are re-requested, with at most window() requests outstanding. The window grows while requests are
+/// answered and shrinks by the fraction lost when the timer expires, so each component adapts to its own loss rate
+/// and all components are re-requested concurrently.
+class ParameterIndexDownload
+{
+public:
+    ParameterIndexDownload(void);
+
+    static const int initialWindow  = 10;
+    static const int minWindow      = 2;
+    static const int maxWindow      = 64;
+
+    /// Marks all indices as waiting and stops retrying
+    void reset(int paramCount);
+
+    /// Marks all indices as received
+    void setAllReceived(void);
+
+    int     paramCount      (void) const { return _received.count(); }
+    int     waitingCount    (void) const { return _waitingCount; }
+    int     inFlightCount   (void) const { return _inFlightCount; }
+    bool    isWaiting       (int index) const { return index >= 0 && index < _received.count() && !_received.testBit(index); }
+    bool    retrying        (void) const { return _retrying; }
+    int     window          (void) const { return _window; }
+    double  lossRate        (void) const { return _lossRate; }
+    QTimer& timer           (void) { return _timer; }
+
+    /// @return Indices still waiting, for logging
+    QList<int> waitingIndices(void) const;
+
+    /// Marks the index as received
+    ///     @return true: index was still waiting
+    bool received(int index);
+
+    /// Picks the next indices to re-request until the window is full, nothing is picked before retrying starts. An index is given up on once it has been
+    /// requested more than maxRetries times, it then no longer counts as waiting.
+    ///     @param requests Indices to re-request
+    ///     @param failed Indices given up on
+    void nextRequests(int maxRetries, QList<int>& requests, QList<int>& failed);
+
+    /// Called when the timer expires. The first call starts retrying, later calls adapt the window to the requests
+    /// lost since the previous timeout. Outstanding requests are considered lost and are picked again.
+    void timeout(void);
+
+private:
+    QBitArray       _received;          ///< true: index received or given up on
+    QBitArray       _inFlight;          ///< true: index re-requested and not answered yet
+    QVector<quint8> _retryCount;
+    int             _waitingCount;
+    int             _inFlightCount;
+    int             _nextIndex;         ///< Where the next search for an index to request starts
+    int             _window;
+    int             _answeredCount;     ///< Re-requests answered since the last timeout
+    int             _growCount;         ///< Re-requests answered since the window last grew
+    double          _lossRate;          ///< Fraction of re-requests lost at the last timeout
+    bool            _retrying;
+    QTimer          _timer;
+};
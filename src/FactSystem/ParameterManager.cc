@@ -17,6 +17,8 @@
 #include "JsonHelper.h"
 #include "ComponentInformationManager.h"
 #include "CompInfoParam.h"
+#include "ParameterCacheFile.h"
+#include "ParameterIndexDownload.h"
 
 #include <QEasingCurve>
 #include <QFile>
@@ -88,7 +90,6 @@ ParameterManager::ParameterManager(Vehicle* vehicle)
     , _prevWaitingWriteParamNameCount   (0)
     , _initialRequestRetryCount         (0)
     , _disableAllRetries                (false)
-    , _indexBatchQueueActive            (false)
     , _totalParamCount                  (0)
 {
     _versionParam = vehicle->firmwarePlugin()->getVersionParam();
@@ -108,21 +109,25 @@ ParameterManager::ParameterManager(Vehicle* vehicle)
     _waitingParamTimeoutTimer.setInterval(3000);
     connect(&_waitingParamTimeoutTimer, &QTimer::timeout, this, &ParameterManager::_waitingParamTimeout);
 
-    connect(_vehicle->uas(), &UASInterface::parameterUpdate, this, &ParameterManager::_parameterUpdate);
+    _vehicle->messageDispatcher()->registerHandler(this, _vehicle->id(), MAVLinkMessageDispatcher::anyId, MAVLINK_MSG_ID_PARAM_VALUE,
+                                                   [this](LinkInterface* /*link*/, const mavlink_message_t& message) { _handleParamValue(message); });
 
     // Ensure the cache directory exists
     QFileInfo(QSettings().fileName()).dir().mkdir("ParamCache");
 }
 
+ParameterManager::~ParameterManager()
+{
+    qDeleteAll(_cacheFiles);
+    qDeleteAll(_indexDownloads);
+}
+
 void ParameterManager::_updateProgressBar(void)
 {
-    int waitingReadParamIndexCount = 0;
+    int waitingReadParamIndexCount = _waitingReadParamIndexCount();
     int waitingReadParamNameCount = 0;
     int waitingWriteParamCount = 0;
 
-    for (int compId: _waitingReadParamIndexMap.keys()) {
-        waitingReadParamIndexCount += _waitingReadParamIndexMap[compId].count();
-    }
     for(int compId: _waitingReadParamNameMap.keys()) {
         waitingReadParamNameCount += _waitingReadParamNameMap[compId].count();
     }
@@ -171,6 +176,51 @@ void ParameterManager::_updateProgressBar(void)
     }
 }
 
+void ParameterManager::_handleParamValue(const mavlink_message_t& message)
+{
+    mavlink_param_value_t   paramValue;
+    mavlink_param_union_t   paramUnion;
+    QVariant                value;
+
+    mavlink_msg_param_value_decode(&message, &paramValue);
+
+    // Construct a string stopping at the first NUL (0) character, else copy the whole byte array
+    QString parameterName(QByteArray(paramValue.param_id, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN));
+
+    paramUnion.param_float  = paramValue.param_value;
+    paramUnion.type         = paramValue.param_type;
+
+    switch (paramValue.param_type) {
+    case MAV_PARAM_TYPE_REAL32:
+        value = QVariant(paramUnion.param_float);
+        break;
+    case MAV_PARAM_TYPE_UINT8:
+        value = QVariant(paramUnion.param_uint8);
+        break;
+    case MAV_PARAM_TYPE_INT8:
+        value = QVariant(paramUnion.param_int8);
+        break;
+    case MAV_PARAM_TYPE_UINT16:
+        value = QVariant(paramUnion.param_uint16);
+        break;
+    case MAV_PARAM_TYPE_INT16:
+        value = QVariant(paramUnion.param_int16);
+        break;
+    case MAV_PARAM_TYPE_UINT32:
+        value = QVariant(paramUnion.param_uint32);
+        break;
+    case MAV_PARAM_TYPE_INT32:
+        value = QVariant(paramUnion.param_int32);
+        break;
+    default:
+        // 64 bit types don't fit in the message
+        qCritical() << "INVALID DATA TYPE USED AS PARAMETER VALUE: " << paramValue.param_type;
+        break;
+    }
+
+    _parameterUpdate(message.sysid, message.compid, parameterName, paramValue.param_count, paramValue.param_index, paramValue.param_type, value);
+}
+
 /// Called whenever a parameter is updated or first seen.
 void ParameterManager::_parameterUpdate(int vehicleId, int componentId, QString parameterName, int parameterCount, int parameterId, int mavType, QVariant value)
 {
@@ -198,7 +248,7 @@ void ParameterManager::_parameterUpdate(int vehicleId, int componentId, QString
     _initialRequestTimeoutTimer.stop();
 
 #if 0
-    if (!_initialLoadComplete && !_indexBatchQueueActive) {
+    if (!_initialLoadComplete && !(_indexDownloads.contains(componentId) && _indexDownloads[componentId]->retrying())) {
         // Handy for testing retry logic
         static int counter = 0;
         if (counter++ & 0x8) {
@@ -253,12 +303,10 @@ void ParameterManager::_parameterUpdate(int vehicleId, int componentId, QString
     }
 
     // If we've never seen this component id before, setup the wait lists.
-    if (!_waitingReadParamIndexMap.contains(componentId)) {
+    if (!_indexDownloads.contains(componentId)) {
         // Add all indices to the wait list, parameter index is 0-based
-        for (int waitingIndex=0; waitingIndex<parameterCount; waitingIndex++) {
-            // This will add the new component id, as well as the the new waiting index and set the retry count for that index to 0
-            _waitingReadParamIndexMap[componentId][waitingIndex] = 0;
-        }
+        _indexDownload(componentId)->reset(parameterCount);
+        _fillIndexDownload(componentId);
 
         // The read and write waiting lists for this component are initialized the empty
         _waitingReadParamNameMap[componentId] = QMap<QString, int>();
@@ -267,28 +315,29 @@ void ParameterManager::_parameterUpdate(int vehicleId, int componentId, QString
         qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Seeing component for first time - paramcount:" << parameterCount;
     }
 
+    ParameterIndexDownload* indexDownload = _indexDownloads[componentId];
+
     bool componentParamsComplete = false;
-    if (_waitingReadParamIndexMap[componentId].count() == 1) {
+    if (indexDownload->waitingCount() == 1) {
         // We need to know when we get the last param from a component in order to complete setup
         componentParamsComplete = true;
     }
 
-    if (!_waitingReadParamIndexMap[componentId].contains(parameterId) &&
+    if (!indexDownload->isWaiting(parameterId) &&
             !_waitingReadParamNameMap[componentId].contains(parameterName) &&
             !_waitingWriteParamNameMap[componentId].contains(parameterName)) {
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Unrequested param update" << parameterName;
     }
 
     // Remove this parameter from the waiting lists
-    if (_waitingReadParamIndexMap[componentId].contains(parameterId)) {
-        _waitingReadParamIndexMap[componentId].remove(parameterId);
-        _indexBatchQueue.removeOne(parameterId);
-        _fillIndexBatchQueue(false /* waitingParamTimeout */);
+    if (indexDownload->received(parameterId)) {
+        // Keeps this component's re-request window full, other components are not held up by it
+        _fillIndexDownload(componentId);
     }
     _waitingReadParamNameMap[componentId].remove(parameterName);
     _waitingWriteParamNameMap[componentId].remove(parameterName);
-    if (_waitingReadParamIndexMap[componentId].count()) {
-        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap:" << _waitingReadParamIndexMap[componentId];
+    if (indexDownload->waitingCount()) {
+        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "index download waiting:" << indexDownload->waitingCount() << "window:" << indexDownload->window();
     }
     if (_waitingReadParamNameMap[componentId].count()) {
         qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingReadParamNameMap" << _waitingReadParamNameMap[componentId];
@@ -299,13 +348,10 @@ void ParameterManager::_parameterUpdate(int vehicleId, int componentId, QString
 
     // Track how many parameters we are still waiting for
 
-    int waitingReadParamIndexCount = 0;
+    int waitingReadParamIndexCount = _waitingReadParamIndexCount();
     int waitingReadParamNameCount = 0;
     int waitingWriteParamNameCount = 0;
 
-    for(int waitingComponentId: _waitingReadParamIndexMap.keys()) {
-        waitingReadParamIndexCount += _waitingReadParamIndexMap[waitingComponentId].count();
-    }
     if (waitingReadParamIndexCount) {
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "waitingReadParamIndexCount:" << waitingReadParamIndexCount;
     }
@@ -325,11 +371,14 @@ void ParameterManager::_parameterUpdate(int vehicleId, int componentId, QString
     }
 
     int readWaitingParamCount = waitingReadParamIndexCount + waitingReadParamNameCount;
-    int totalWaitingParamCount = readWaitingParamCount + waitingWriteParamNameCount;
-    if (totalWaitingParamCount) {
+    int nameWaitingParamCount = waitingReadParamNameCount + waitingWriteParamNameCount;
+    if (nameWaitingParamCount) {
         // More params to wait for, restart timer
         _waitingParamTimeoutTimer.start();
-        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer: totalWaitingParamCount:" << totalWaitingParamCount;
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer: nameWaitingParamCount:" << nameWaitingParamCount;
+    } else if (waitingReadParamIndexCount) {
+        // Index based reads are timed by each component's download
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "Not restarting _waitingParamTimeoutTimer (index downloads active)";
     } else {
         if (!_mapParameterName2Variant.contains(_vehicle->defaultComponentId())) {
             // Still waiting for parameters from default component
@@ -427,6 +476,9 @@ void ParameterManager::_parameterUpdate(int vehicleId, int componentId, QString
         if (_prevWaitingReadParamIndexCount + _prevWaitingReadParamNameCount != 0 && readWaitingParamCount == 0) {
             // All reads just finished, update the cache
             _writeLocalParamCache(vehicleId, componentId);
+        } else if (_initialLoadComplete && readWaitingParamCount == 0) {
+            // Single value changed after the load, only that entry needs to be rewritten
+            _updateLocalParamCache(vehicleId, componentId, parameterName);
         }
     }
 
@@ -494,18 +546,22 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
     }
 
     // Reset index wait lists
+    QList<int> resetComponentIds;
     for (int cid: _paramCountMap.keys()) {
         // Add/Update all indices to the wait list, parameter index is 0-based
         if(componentId != MAV_COMP_ID_ALL && componentId != cid)
             continue;
-        for (int waitingIndex = 0; waitingIndex < _paramCountMap[cid]; waitingIndex++) {
-            // This will add a new waiting index if needed and set the retry count for that index to 0
-            _waitingReadParamIndexMap[cid][waitingIndex] = 0;
-        }
+        _indexDownload(cid)->reset(_paramCountMap[cid]);
+        resetComponentIds.append(cid);
     }
 
     _dataMutex.unlock();
 
+    // Missing indices are re-requested if the stream stalls, even if the request list itself is lost
+    for (int cid: resetComponentIds) {
+        _fillIndexDownload(cid);
+    }
+
     MAVLinkProtocol* mavlink = qgcApp()->toolbox()->mavlinkProtocol();
 
     mavlink_message_t msg;
@@ -672,57 +728,80 @@ int  ParameterManager::getComponentId(const QString& category)
     return (_componentCategoryHash.contains(category)) ? _componentCategoryHash.value(category) : _vehicle->defaultComponentId();
 }
 
-/// Requests missing index based parameters from the vehicle.
-///     @param waitingParamTimeout: true: being called due to timeout, false: being called to re-fill the batch queue
-/// return true: Parameters were requested, false: No more requests needed
-bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
+/// @return Index based download for the component, created if needed
+ParameterIndexDownload* ParameterManager::_indexDownload(int componentId)
 {
-    if (!_indexBatchQueueActive) {
-        return false;
+    ParameterIndexDownload* download = _indexDownloads.value(componentId);
+
+    if (!download) {
+        download = new ParameterIndexDownload();
+        connect(&download->timer(), &QTimer::timeout, this, [this, componentId]() { _indexDownloadTimeout(componentId); });
+        _indexDownloads[componentId] = download;
     }
+    return download;
+}
 
-    const int maxBatchSize = 10;
+/// Requests missing index based parameters from the vehicle until the component's window is full, then restarts its timer
+void ParameterManager::_fillIndexDownload(int componentId)
+{
+    ParameterIndexDownload* download = _indexDownloads[componentId];
+    QList<int>              requests;
+    QList<int>              failed;
 
-    if (waitingParamTimeout) {
-        // We timed out, clear the queue and try again
-        qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to timeout";
-        _indexBatchQueue.clear();
+    download->nextRequests(_disableAllRetries ? 0 : _maxInitialLoadRetrySingleParam, requests, failed);
+    for (int paramIndex: failed) {
+        // Give up on this index
+        _failedReadParamIndexMap[componentId] << paramIndex;
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << ")";
+    }
+    for (int paramIndex: requests) {
+        _readParameterRaw(componentId, "", paramIndex);
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "window:" << download->window() << ")";
+    }
+
+    if (download->waitingCount()) {
+        download->timer().start(download->retrying() ? _indexRetryTimeoutMSecs : _indexStreamTimeoutMSecs);
     } else {
-        qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to received parameter";
+        download->timer().stop();
     }
+}
 
-    for(int componentId: _waitingReadParamIndexMap.keys()) {
-        if (_waitingReadParamIndexMap[componentId].count()) {
-            qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap count" << _waitingReadParamIndexMap[componentId].count();
-            qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap" << _waitingReadParamIndexMap[componentId];
-        }
+void ParameterManager::_indexDownloadTimeout(int componentId)
+{
+    if (_logReplay) {
+        return;
+    }
 
-        for(int paramIndex: _waitingReadParamIndexMap[componentId].keys()) {
-            if (_indexBatchQueue.contains(paramIndex)) {
-                // Don't add more than once
-                continue;
-            }
+    ParameterIndexDownload* download = _indexDownloads[componentId];
 
-            if (_indexBatchQueue.count() > maxBatchSize) {
-                break;
-            }
+    _dataMutex.lock();
 
-            _waitingReadParamIndexMap[componentId][paramIndex]++;   // Bump retry count
-            if (_disableAllRetries || _waitingReadParamIndexMap[componentId][paramIndex] > _maxInitialLoadRetrySingleParam) {
-                // Give up on this index
-                _failedReadParamIndexMap[componentId] << paramIndex;
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
-                _waitingReadParamIndexMap[componentId].remove(paramIndex);
-            } else {
-                // Retry again
-                _indexBatchQueue.append(paramIndex);
-                _readParameterRaw(componentId, "", paramIndex);
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
-            }
+    download->timeout();
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Index download timeout - waiting:" << download->waitingCount() << "window:" << download->window() << "loss:" << download->lossRate();
+    qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Waiting indices" << download->waitingIndices();
+    _fillIndexDownload(componentId);
+    int waitingReadParamIndexCount = _waitingReadParamIndexCount();
+
+    _dataMutex.unlock();
+
+    if (waitingReadParamIndexCount == 0) {
+        // Remaining indices were given up on. Name based retries and the wait for the default component take over.
+        _updateProgressBar();
+        _checkInitialLoadComplete();
+        if (!_waitingParamTimeoutTimer.isActive()) {
+            _waitingParamTimeoutTimer.start();
         }
     }
+}
+
+int ParameterManager::_waitingReadParamIndexCount(void) const
+{
+    int waitingCount = 0;
 
-    return _indexBatchQueue.count() != 0;
+    for (const ParameterIndexDownload* download: _indexDownloads) {
+        waitingCount += download->waitingCount();
+    }
+    return waitingCount;
 }
 
 void ParameterManager::_waitingParamTimeout(void)
@@ -737,11 +816,9 @@ void ParameterManager::_waitingParamTimeout(void)
 
     qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "_waitingParamTimeout";
 
-    // Now that we have timed out for possibly the first time we can activate the index batch queue
-    _indexBatchQueueActive = true;
-
-    // First check for any missing parameters from the initial index based load
-    paramsRequested = _fillIndexBatchQueue(true /* waitingParamTimeout */);
+    // Missing parameters from the initial index based load are re-requested by each component's download. Name based
+    // retries wait until those are done.
+    paramsRequested = _waitingReadParamIndexCount() != 0;
 
     if (!paramsRequested && !_waitingForDefaultComponent && !_mapParameterName2Variant.contains(_vehicle->defaultComponentId())) {
         // Initial load is complete but we still don't have any default component params. Wait one more cycle to see if the
@@ -884,18 +961,34 @@ void ParameterManager::_writeParameterRaw(int componentId, const QString& paramN
 
 void ParameterManager::_writeLocalParamCache(int vehicleId, int componentId)
 {
-    CacheMapName2ParamTypeVal cacheMap;
+    // Drop the mapping of the previous cache, it is reopened on the next single value update
+    delete _cacheFiles.take(componentId);
 
-    for(const QString& paramName: _mapParameterName2Variant[componentId].keys()) {
-        const Fact *fact = _mapParameterName2Variant[componentId][paramName].value<Fact*>();
-        cacheMap[paramName] = ParamTypeVal(fact->type(), fact->rawValue());
-    }
+    ParameterCacheFile::write(parameterCacheFile(vehicleId, componentId), _mapParameterName2Variant[componentId]);
+
+    // Replaced by the mapped cache format
+    QFile::remove(parameterCacheDir().filePath(QString("%1_%2.v2").arg(vehicleId).arg(componentId)));
+}
 
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+void ParameterManager::_updateLocalParamCache(int vehicleId, int componentId, const QString& paramName)
+{
+    ParameterCacheFile* cacheFile = _cacheFiles.value(componentId);
+    if (!cacheFile) {
+        cacheFile = new ParameterCacheFile(parameterCacheFile(vehicleId, componentId));
+        if (!cacheFile->open()) {
+            // Nothing to update, the cache is written once a full set of parameters has been read
+            delete cacheFile;
+            return;
+        }
+        _cacheFiles[componentId] = cacheFile;
+    }
 
-    QDataStream ds(&cacheFile);
-    ds << cacheMap;
+    Fact* fact = _mapParameterName2Variant[componentId][paramName].value<Fact*>();
+    int index = cacheFile->find(paramName);
+    if (index == -1 || !cacheFile->updateValue(index, fact->type(), fact->rawValue())) {
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Rewriting parameter cache for" << paramName;
+        _writeLocalParamCache(vehicleId, componentId);
+    }
 }
 
 QDir ParameterManager::parameterCacheDir()
@@ -906,7 +999,7 @@ QDir ParameterManager::parameterCacheDir()
 
 QString ParameterManager::parameterCacheFile(int vehicleId, int componentId)
 {
-    return parameterCacheDir().filePath(QString("%1_%2.v2").arg(vehicleId).arg(componentId));
+    return parameterCacheDir().filePath(QString("%1_%2.v3").arg(vehicleId).arg(componentId));
 }
 
 void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVariant hash_value)
@@ -914,52 +1007,62 @@ void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVarian
     qCInfo(ParameterManagerLog) << "Attemping load from cache";
 
     uint32_t crc32_value = 0;
-    /* The datastructure of the cache table */
-    CacheMapName2ParamTypeVal cacheMap;
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    if (!cacheFile.exists()) {
-        /* no local cache, just wait for them to come in*/
-        return;
+    /* The cache is mapped, entries are read straight from the file */
+    ParameterCacheFile* cacheFile = _cacheFiles.value(componentId);
+    if (!cacheFile) {
+        cacheFile = new ParameterCacheFile(parameterCacheFile(vehicleId, componentId));
+        if (!cacheFile->open()) {
+            /* no local cache, just wait for them to come in*/
+            delete cacheFile;
+            return;
+        }
+        _cacheFiles[componentId] = cacheFile;
     }
-    cacheFile.open(QIODevice::ReadOnly);
-
-    /* Deserialize the parameter cache table */
-    QDataStream ds(&cacheFile);
-    ds >> cacheMap;
+    const QString cacheFileName = parameterCacheFile(vehicleId, componentId);
 
     // Load parameter meta data for the version number stored in cache.
     // We need meta data so we have access to the volatile bit
-    if (cacheMap.contains(_versionParam)) {
-        _parameterSetMajorVersion = cacheMap[_versionParam].second.toInt();
+    int versionIndex = _versionParam.isEmpty() ? -1 : cacheFile->find(_versionParam);
+    if (versionIndex != -1) {
+        _parameterSetMajorVersion = cacheFile->value(versionIndex).toInt();
     }
-    _vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->_parameterMajorVersionKnown(_parameterSetMajorVersion);
+    CompInfoParam* compInfoParam = _vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1);
+    compInfoParam->_parameterMajorVersionKnown(_parameterSetMajorVersion);
 
     /* compute the crc of the local cache to check against the remote */
 
-    for (const QString& name: cacheMap.keys()) {
-        if (_vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->_isParameterVolatile(name)) {
+    for (int i=0; i<cacheFile->count(); i++) {
+        const QString name = cacheFile->name(i);
+        if (compInfoParam->_isParameterVolatile(name)) {
             // Does not take part in CRC
             qCDebug(ParameterManagerLog) << "Volatile parameter" << name;
         } else {
-            const ParamTypeVal& paramTypeVal = cacheMap[name];
-            const void *vdat = paramTypeVal.second.constData();
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            crc32_value = QGC::crc32((const uint8_t *)qPrintable(name), name.length(),  crc32_value);
-            crc32_value = QGC::crc32((const uint8_t *)vdat, FactMetaData::typeToSize(fact_type), crc32_value);
+            crc32_value = QGC::crc32(reinterpret_cast<const uint8_t*>(cacheFile->nameData(i)), static_cast<unsigned>(cacheFile->nameLength(i)), crc32_value);
+            crc32_value = QGC::crc32(cacheFile->valueData(i), FactMetaData::typeToSize(cacheFile->type(i)), crc32_value);
         }
     }
 
     /* if the two param set hashes match, just load from the disk */
     if (crc32_value == hash_value.toUInt()) {
-        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
-
-        int count = cacheMap.count();
-        int index = 0;
-        for (const QString& name: cacheMap.keys()) {
-            const ParamTypeVal& paramTypeVal = cacheMap[name];
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            const int mavType = _factTypeToMavType(fact_type);
-            _parameterUpdate(vehicleId, componentId, name, count, index++, mavType, paramTypeVal.second);
+        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(QFileInfo(cacheFileName).absoluteFilePath());
+
+        if (!_paramCountMap.contains(componentId)) {
+            _loadCacheParameters(componentId, *cacheFile);
+        } else {
+            // Parameters for this component have already started to come in from the vehicle, so they have to go through
+            // the normal update path. Values are copied out first since completing the load rewrites the cache.
+            QList<ParamTypeVal> values;
+            QStringList         names;
+            for (int i=0; i<cacheFile->count(); i++) {
+                names.append(cacheFile->name(i));
+                values.append(ParamTypeVal(cacheFile->type(i), cacheFile->value(i)));
+            }
+            int count = names.count();
+            for (int index=0; index<count; index++) {
+                const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(values[index].first);
+                const int mavType = _factTypeToMavType(fact_type);
+                _parameterUpdate(vehicleId, componentId, names[index], count, index, mavType, values[index].second);
+            }
         }
 
         // Return the hash value to notify we don't want any more updates
@@ -1002,19 +1105,95 @@ void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVarian
     } else {
         // Cache parameter version may differ from vehicle parameter version so we can't trust information loaded from cache parameter version number
         _parameterSetMajorVersion = -1;
-        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
+        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(QFileInfo(cacheFileName).absoluteFilePath());
         if (ParameterManagerDebugCacheFailureLog().isDebugEnabled()) {
             _debugCacheCRC[componentId] = true;
-            _debugCacheMap[componentId] = cacheMap;
-            for (const QString& name: cacheMap.keys()) {
+            for (int i=0; i<cacheFile->count(); i++) {
+                const QString name = cacheFile->name(i);
+                _debugCacheMap[componentId][name] = ParamTypeVal(cacheFile->type(i), cacheFile->value(i));
                 _debugCacheParamSeen[componentId][name] = false;
             }
             qgcApp()->showAppMessage(tr("Parameter cache CRC match failed"));
         }
-        _vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->_clearPX4ParameterMetaData();
+        // The cache is rewritten once the parameters have been read from the vehicle
+        delete _cacheFiles.take(componentId);
+        compInfoParam->_clearPX4ParameterMetaData();
     }
 }
 
+/// Creates all the Facts for a component from a matching cache in one pass. Same end result as going through
+/// _parameterUpdate for each cached value, without the per parameter wait list and map updates.
+void ParameterManager::_loadCacheParameters(int componentId, const ParameterCacheFile& cacheFile)
+{
+    int             count = cacheFile.count();
+    QList<Fact*>    facts;
+
+    facts.reserve(count);
+
+    _initialRequestTimeoutTimer.stop();
+    _waitingParamTimeoutTimer.stop();
+
+    _dataMutex.lock();
+
+    _paramCountMap[componentId] = count;
+    _totalParamCount += count;
+
+    // Nothing left to wait for from this component
+    ParameterIndexDownload* indexDownload = _indexDownload(componentId);
+    indexDownload->reset(count);
+    indexDownload->setAllReceived();
+    _waitingReadParamNameMap[componentId] = QMap<QString, int>();
+    _waitingWriteParamNameMap[componentId] = QMap<QString, int>();
+
+    // Cache entries are sorted by name, so each insert lands at the end of the map
+    QVariantMap& factMap = _mapParameterName2Variant[componentId];
+    for (int i=0; i<count; i++) {
+        const QString name = cacheFile.name(i);
+        Fact* fact = new Fact(componentId, name, cacheFile.type(i), this);
+        factMap.insert(factMap.constEnd(), name, QVariant::fromValue(fact));
+
+        // We need to know when the fact changes from QML so that we can send the new value to the parameter manager
+        connect(fact, &Fact::_containerRawValueChanged, this, &ParameterManager::_valueUpdated);
+        facts.append(fact);
+    }
+
+    _dataMutex.unlock();
+
+    for (int i=0; i<count; i++) {
+        facts[i]->_containerSetRawValue(cacheFile.value(i));
+    }
+
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Loaded from cache - paramcount:" << count;
+
+    if (componentId == _vehicle->defaultComponentId()) {
+        // Meta data has to be there before the group map is setup
+        _addMetaDataToDefaultComponent();
+    }
+    _setupComponentCategoryMap(componentId);
+
+    // Other components may still be loading from the vehicle
+    int waitingReadParamIndexCount = _waitingReadParamIndexCount();
+    int waitingReadParamNameCount = 0;
+    int waitingWriteParamNameCount = 0;
+    for (int waitingComponentId: _waitingReadParamNameMap.keys()) {
+        waitingReadParamNameCount += _waitingReadParamNameMap[waitingComponentId].count();
+    }
+    for (int waitingComponentId: _waitingWriteParamNameMap.keys()) {
+        waitingWriteParamNameCount += _waitingWriteParamNameMap[waitingComponentId].count();
+    }
+    // Index based reads of other components are timed by their own downloads
+    if (waitingReadParamNameCount + waitingWriteParamNameCount ||
+            (waitingReadParamIndexCount == 0 && !_mapParameterName2Variant.contains(_vehicle->defaultComponentId()))) {
+        _waitingParamTimeoutTimer.start();
+    }
+    _prevWaitingReadParamIndexCount = waitingReadParamIndexCount;
+    _prevWaitingReadParamNameCount = waitingReadParamNameCount;
+    _prevWaitingWriteParamNameCount = waitingWriteParamNameCount;
+
+    _updateProgressBar();
+    _checkInitialLoadComplete();
+}
+
 QString ParameterManager::readParametersFromStream(QTextStream& stream)
 {
     QString missingErrors;
@@ -1207,11 +1386,9 @@ void ParameterManager::_checkInitialLoadComplete(void)
         return;
     }
 
-    for (int componentId: _waitingReadParamIndexMap.keys()) {
-        if (_waitingReadParamIndexMap[componentId].count()) {
-            // We are still waiting on some parameters, not done yet
-            return;
-        }
+    if (_waitingReadParamIndexCount()) {
+        // We are still waiting on some parameters, not done yet
+        return;
     }
 
     if (!_mapParameterName2Variant.contains(_vehicle->defaultComponentId())) {
@@ -23,6 +23,9 @@
 #include "QGCMAVLink.h"
 #include "Vehicle.h"
 
+class ParameterCacheFile;
+class ParameterIndexDownload;
+
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerVerbose1Log)
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerVerbose2Log)
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerDebugCacheFailureLog)
@@ -34,6 +37,7 @@ class ParameterManager : public QObject
 public:
     /// @param uas Uas which this set of facts is associated with
     ParameterManager(Vehicle* vehicle);
+    ~ParameterManager();
 
     Q_PROPERTY(bool     parametersReady     READ parametersReady    NOTIFY parametersReadyChanged)      ///< true: Parameters are ready for use
     Q_PROPERTY(bool     missingParameters   READ missingParameters  NOTIFY missingParametersChanged)    ///< true: Parameters are missing from firmware response, false: all parameters received from firmware
@@ -113,13 +117,16 @@ protected:
 private:
     static QVariant         _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool failOk = false);
 
+    void    _handleParamValue                   (const mavlink_message_t& message);
     int     _actualComponentId                  (int componentId);
     void    _setupComponentCategoryMap          (int componentId);
     void    _setupDefaultComponentCategoryMap   (void);
     void    _readParameterRaw                   (int componentId, const QString& paramName, int paramIndex);
     void    _writeParameterRaw                  (int componentId, const QString& paramName, const QVariant& value);
     void    _writeLocalParamCache               (int vehicleId, int componentId);
+    void    _updateLocalParamCache              (int vehicleId, int componentId, const QString& paramName);
     void    _tryCacheHashLoad                   (int vehicleId, int componentId, QVariant hash_value);
+    void    _loadCacheParameters                (int componentId, const ParameterCacheFile& cacheFile);
     void    _loadMetaData                       (void);
     void    _clearMetaData                      (void);
     void    _addMetaDataToDefaultComponent      (void);
@@ -127,7 +134,10 @@ private:
     void    _loadOfflineEditingParams           (void);
     QString _logVehiclePrefix                   (int componentId);
     void    _setLoadProgress                    (double loadProgress);
-    bool    _fillIndexBatchQueue                (bool waitingParamTimeout);
+    ParameterIndexDownload* _indexDownload      (int componentId);
+    void    _fillIndexDownload                  (int componentId);
+    void    _indexDownloadTimeout               (int componentId);
+    int     _waitingReadParamIndexCount         (void) const;
     void    _updateProgressBar                  (void);
 
     MAV_PARAM_TYPE _factTypeToMavType(FactMetaData::ValueType_t factType);
@@ -161,6 +171,8 @@ private:
     QMap<int /* component id */, CacheMapName2ParamTypeVal>                         _debugCacheMap;
     QMap<int /* component id */, QMap<QString /* param name */, bool /* seen */>>   _debugCacheParamSeen;
 
+    QMap<int /* component id */, ParameterCacheFile*> _cacheFiles;  ///< Mapped caches which single parameter changes are written to in place
+
     // Wait counts from previous parameter update cycle
     int _prevWaitingReadParamIndexCount;
     int _prevWaitingReadParamNameCount;
@@ -176,14 +188,14 @@ private:
     static const int    _maxReadWriteRetry = 5;                 ///< Maximum retries read/write
     bool                _disableAllRetries;                     ///< true: Don't retry any requests (used for testing)
 
-    bool        _indexBatchQueueActive; ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
-    QList<int>  _indexBatchQueue;       ///< The current queue of index re-requests
+    static const int    _indexStreamTimeoutMSecs = 3000;        ///< Initial PARAM_REQUEST_LIST stream is considered stalled after this
+    static const int    _indexRetryTimeoutMSecs = 1000;         ///< Outstanding index re-requests are considered lost after this
 
-    QMap<int, int>                  _paramCountMap;             ///< Key: Component id, Value: count of parameters in this component
-    QMap<int, QMap<int, int> >      _waitingReadParamIndexMap;  ///< Key: Component id, Value: Map { Key: parameter index still waiting for, Value: retry count }
-    QMap<int, QMap<QString, int> >  _waitingReadParamNameMap;   ///< Key: Component id, Value: Map { Key: parameter name still waiting for, Value: retry count }
-    QMap<int, QMap<QString, int> >  _waitingWriteParamNameMap;  ///< Key: Component id, Value: Map { Key: parameter name still waiting for, Value: retry count }
-    QMap<int, QList<int> >          _failedReadParamIndexMap;   ///< Key: Component id, Value: failed parameter index
+    QMap<int, int>                      _paramCountMap;             ///< Key: Component id, Value: count of parameters in this component
+    QMap<int, ParameterIndexDownload*>  _indexDownloads;            ///< Key: Component id, Value: index based download of this component, components are retried concurrently
+    QMap<int, QMap<QString, int> >      _waitingReadParamNameMap;   ///< Key: Component id, Value: Map { Key: parameter name still waiting for, Value: retry count }
+    QMap<int, QMap<QString, int> >      _waitingWriteParamNameMap;  ///< Key: Component id, Value: Map { Key: parameter name still waiting for, Value: retry count }
+    QMap<int, QList<int> >              _failedReadParamIndexMap;   ///< Key: Component id, Value: failed parameter index
 
     int _totalParamCount;                       ///< Number of parameters across all components
     int _waitingWriteParamBatchCount = 0;       ///< Number of parameters which are batched up waiting on write responses
@@ -12,6 +12,10 @@
 #include "MultiVehicleManager.h"
 #include "QGCApplication.h"
 #include "ParameterManager.h"
+#include "ParameterIndexDownload.h"
+
+#include <QElapsedTimer>
+#include <QSet>
 
 /// Test failure modes which should still lead to param load success
 void ParameterManagerTest::_noFailureWorker(MockConfiguration::FailureMode_t failureMode)
@@ -138,3 +142,95 @@ void ParameterManagerTest::_requestListMissingParamFail(void)
     // User should have been notified
     checkExpectedMessageBox();
 }
+
+void ParameterManagerTest::_indexDownloadWindow(void)
+{
+    ParameterIndexDownload  download;
+    QList<int>              requests;
+    QList<int>              failed;
+    QSet<int>               receivedIndices;
+
+    download.reset(100);
+    QCOMPARE(download.waitingCount(), 100);
+
+    // Nothing is re-requested while the initial stream is running
+    QVERIFY(download.received(0));
+    receivedIndices.insert(0);
+    QVERIFY(!download.received(0));
+    QVERIFY(!download.received(100));
+    download.nextRequests(5, requests, failed);
+    QVERIFY(requests.isEmpty());
+
+    // Once the stream stalls the window is filled with missing indices
+    download.timeout();
+    QVERIFY(download.retrying());
+    download.nextRequests(5, requests, failed);
+    QCOMPARE(requests.count(), static_cast<int>(ParameterIndexDownload::initialWindow));
+    QCOMPARE(requests.first(), 1);
+    QVERIFY(failed.isEmpty());
+
+    // A fully answered window grows the window
+    for (int index: requests) {
+        QVERIFY(download.received(index));
+        receivedIndices.insert(index);
+    }
+    QVERIFY(download.window() > ParameterIndexDownload::initialWindow);
+    QCOMPARE(download.inFlightCount(), 0);
+
+    // Half of the window lost shrinks it by half
+    requests.clear();
+    download.nextRequests(5, requests, failed);
+    int window = download.window();
+    QCOMPARE(requests.count(), window);
+    for (int i=0; i<requests.count() / 2; i++) {
+        QVERIFY(download.received(requests[i]));
+        receivedIndices.insert(requests[i]);
+    }
+    download.timeout();
+    QCOMPARE(download.window(), qMax(static_cast<int>(ParameterIndexDownload::minWindow), static_cast<int>(window * (1.0 - download.lossRate()))));
+    QVERIFY(download.window() < window);
+
+    // Indices are given up on after the max retries, after which nothing is waiting anymore
+    for (int i=0; i<1000 && download.waitingCount(); i++) {
+        requests.clear();
+        download.nextRequests(2, requests, failed);
+        download.timeout();
+    }
+    QCOMPARE(download.waitingCount(), 0);
+
+    // Every index which was not received has been given up on, each exactly once
+    QCOMPARE(failed.count(), 100 - receivedIndices.count());
+    for (int index=0; index<100; index++) {
+        QVERIFY2(failed.contains(index) != receivedIndices.contains(index), qPrintable(QStringLiteral("index %1").arg(index)));
+    }
+}
+
+void ParameterManagerTest::_loadBenchmark(void)
+{
+    UT_BENCHMARK();
+
+    const int rgLossPercent[] = { 0, 5, 20 };
+
+    _connectMockLink();
+
+    ParameterManager* parameterManager = _vehicle->parameterManager();
+
+    for (int lossPercent: rgLossPercent) {
+        QSignalSpy      spyProgress(parameterManager, &ParameterManager::loadProgressChanged);
+        QElapsedTimer   timer;
+
+        _mockLink->setLinkSimulation(_benchmarkLatencyMSecs, lossPercent);
+        timer.start();
+        parameterManager->refreshAllParameters();
+
+        // Progress goes back to 0 once every index has been received or given up on
+        do {
+            QVERIFY(spyProgress.wait(60000));
+        } while (spyProgress.last()[0].toFloat() != 0.0f);
+
+        qDebug() << "Loaded" << parameterManager->parameterNames(MAV_COMP_ID_AUTOPILOT1).count() << "parameters, latency" << _benchmarkLatencyMSecs << "loss" << lossPercent << "%:" << timer.elapsed() << "msecs";
+    }
+    _mockLink->setLinkSimulation(0, 0);
+
+    _disconnectMockLink();
+}
@@ -25,9 +25,13 @@ private slots:
     void _requestListNoResponse(void);
     void _requestListMissingParamSuccess(void);
     void _requestListMissingParamFail(void);
+    void _indexDownloadWindow(void);
+    void _loadBenchmark(void);
 
 private:
     void _noFailureWorker(MockConfiguration::FailureMode_t failureMode);
+
+    static const int _benchmarkLatencyMSecs = 10;
 };
 
 #endif
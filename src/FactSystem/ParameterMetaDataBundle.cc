@@ -0,0 +1,366 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterMetaDataBundle.h"
+#include "QGCLoggingCategory.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QSettings>
+#include <QVector>
+
+#include <algorithm>
+#include <string.h>
+
+QGC_LOGGING_CATEGORY(ParameterMetaDataBundleLog, "ParameterMetaDataBundleLog")
+
+static const char* kCacheDir = "ParamMetaData";
+
+ParameterMetaDataBundle::ParameterMetaDataBundle(void)
+    : _fileMap      (nullptr)
+    , _data         (nullptr)
+    , _entries      (nullptr)
+    , _pairTable    (nullptr)
+    , _strings      (nullptr)
+    , _stringsSize  (0)
+    , _pairCount    (0)
+    , _count        (0)
+{
+
+}
+
+ParameterMetaDataBundle::~ParameterMetaDataBundle()
+{
+    close();
+}
+
+bool ParameterMetaDataBundle::load(const QString& sourceFile, ParseFunction_t parse)
+{
+    const QString key       = sourceKey(sourceFile);
+    const QString filename  = cacheFilename(sourceFile);
+
+    if (open(filename, key)) {
+        qCDebug(ParameterMetaDataBundleLog) << "Mapped cached bundle" << filename << "for" << sourceFile;
+        return true;
+    }
+
+    QElapsedTimer   timer;
+    QList<Param_t>  params;
+
+    timer.start();
+    bool        parsed = parse(sourceFile, params);
+    QByteArray  bundle = build(key, params);
+    qCDebug(ParameterMetaDataBundleLog) << "Compiled" << params.count() << "parameters from" << sourceFile << "in" << timer.elapsed() << "msecs, bundle bytes:" << bundle.size();
+
+    // Partially parsed sources are not cached so the next load reports the same problems
+    if (parsed) {
+        // Written to the side and renamed over the old bundle so existing mappings of it stay valid
+        QFileInfo(filename).dir().mkpath(QStringLiteral("."));
+        QSaveFile file(filename);
+        if (file.open(QIODevice::WriteOnly) && file.write(bundle) == bundle.size() && file.commit()) {
+            if (open(filename, key)) {
+                return true;
+            }
+        } else {
+            qCWarning(ParameterMetaDataBundleLog) << "Unable to cache bundle" << filename << file.errorString();
+        }
+    }
+
+    return setData(bundle, key);
+}
+
+bool ParameterMetaDataBundle::open(const QString& filename, const QString& sourceKey)
+{
+    close();
+
+    _file.setFileName(filename);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 size = _file.size();
+    if (size >= static_cast<qint64>(sizeof(Header_t))) {
+        _fileMap = _file.map(0, size);
+    }
+    if (!_fileMap || !_map(_fileMap, size, sourceKey)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool ParameterMetaDataBundle::setData(const QByteArray& bundle, const QString& sourceKey)
+{
+    close();
+
+    _bytes = bundle;
+    if (!_map(reinterpret_cast<const uchar*>(_bytes.constData()), _bytes.size(), sourceKey)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void ParameterMetaDataBundle::close(void)
+{
+    if (_fileMap) {
+        _file.unmap(_fileMap);
+        _fileMap = nullptr;
+    }
+    _file.close();
+    _bytes.clear();
+    _data           = nullptr;
+    _entries        = nullptr;
+    _pairTable      = nullptr;
+    _strings        = nullptr;
+    _stringsSize    = 0;
+    _pairCount      = 0;
+    _count          = 0;
+}
+
+bool ParameterMetaDataBundle::_map(const uchar* data, qint64 size, const QString& sourceKey)
+{
+    if (size < static_cast<qint64>(sizeof(Header_t))) {
+        return false;
+    }
+
+    const Header_t* header      = reinterpret_cast<const Header_t*>(data);
+    qint64          pairsStart  = static_cast<qint64>(sizeof(Header_t)) + static_cast<qint64>(header->paramCount) * static_cast<qint64>(sizeof(Entry_t));
+    qint64          stringStart = pairsStart + static_cast<qint64>(header->pairCount) * static_cast<qint64>(sizeof(Pair_t));
+    if (header->magic != _magic || header->version != _version || stringStart + header->stringsSize != size) {
+        qCWarning(ParameterMetaDataBundleLog) << "Ignoring invalid bundle" << _file.fileName();
+        return false;
+    }
+
+    _data           = data;
+    _entries        = reinterpret_cast<const Entry_t*>(data + sizeof(Header_t));
+    _pairTable      = reinterpret_cast<const Pair_t*>(data + pairsStart);
+    _strings        = reinterpret_cast<const char*>(data + stringStart);
+    _stringsSize    = header->stringsSize;
+    _pairCount      = header->pairCount;
+    _count          = static_cast<int>(header->paramCount);
+
+    String_t keyString;
+    keyString.offset = header->sourceKeyOffset;
+    keyString.length = header->sourceKeyLength;
+    if (!_validString(keyString) || _string(keyString) != sourceKey) {
+        qCDebug(ParameterMetaDataBundleLog) << "Bundle is out of date" << _file.fileName();
+        return false;
+    }
+
+    for (int i=0; i<_count; i++) {
+        const Entry_t& entry = _entries[i];
+        for (int j=0; j<FieldCount; j++) {
+            if (!_validString(entry.fields[j])) {
+                qCWarning(ParameterMetaDataBundleLog) << "Ignoring corrupt bundle" << _file.fileName();
+                return false;
+            }
+        }
+        if (static_cast<quint64>(entry.firstPair) + entry.valueCount + entry.bitmaskCount > _pairCount) {
+            qCWarning(ParameterMetaDataBundleLog) << "Ignoring corrupt bundle" << _file.fileName();
+            return false;
+        }
+    }
+    for (quint32 i=0; i<_pairCount; i++) {
+        if (!_validString(_pairTable[i].first) || !_validString(_pairTable[i].second)) {
+            qCWarning(ParameterMetaDataBundleLog) << "Ignoring corrupt bundle" << _file.fileName();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ParameterMetaDataBundle::_validString(const String_t& string) const
+{
+    return static_cast<quint64>(string.offset) + string.length <= _stringsSize;
+}
+
+QString ParameterMetaDataBundle::_string(const String_t& string) const
+{
+    if (string.length == 0) {
+        return QString();
+    }
+    return QString::fromUtf8(_strings + string.offset, static_cast<int>(string.length));
+}
+
+ParameterMetaDataBundle::PairList_t ParameterMetaDataBundle::_pairs(int first, int count) const
+{
+    PairList_t pairs;
+
+    pairs.reserve(count);
+    for (int i=first; i<first+count; i++) {
+        pairs.append(QPair<QString, QString>(_string(_pairTable[i].first), _string(_pairTable[i].second)));
+    }
+    return pairs;
+}
+
+QString ParameterMetaDataBundle::field(int index, Field_t field) const
+{
+    return _string(_entries[index].fields[field]);
+}
+
+ParameterMetaDataBundle::PairList_t ParameterMetaDataBundle::values(int index) const
+{
+    const Entry_t& entry = _entries[index];
+    return _pairs(static_cast<int>(entry.firstPair), entry.valueCount);
+}
+
+ParameterMetaDataBundle::PairList_t ParameterMetaDataBundle::bitmask(int index) const
+{
+    const Entry_t& entry = _entries[index];
+    return _pairs(static_cast<int>(entry.firstPair) + entry.valueCount, entry.bitmaskCount);
+}
+
+int ParameterMetaDataBundle::_compare(int index, Field_t field, const QByteArray& key) const
+{
+    const String_t& string  = _entries[index].fields[field];
+    int             length  = static_cast<int>(string.length);
+    int             result  = memcmp(_strings + string.offset, key.constData(), static_cast<size_t>(qMin(length, key.length())));
+
+    return result == 0 ? length - key.length() : result;
+}
+
+int ParameterMetaDataBundle::find(const QString& scope, const QString& name) const
+{
+    const QByteArray scopeKey   = scope.toUtf8();
+    const QByteArray nameKey    = name.toUtf8();
+
+    // Entries are sorted by the UTF-8 bytes of scope then name when the bundle is built
+    int low = 0;
+    int high = _count - 1;
+    while (low <= high) {
+        int mid     = (low + high) / 2;
+        int result  = _compare(mid, FieldScope, scopeKey);
+        if (result == 0) {
+            result = _compare(mid, FieldName, nameKey);
+        }
+        if (result == 0) {
+            return mid;
+        } else if (result < 0) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+QByteArray ParameterMetaDataBundle::build(const QString& sourceKey, const QList<Param_t>& params)
+{
+    QHash<QString, String_t>    stringIndex;
+    QByteArray                  strings;
+    QVector<Entry_t>            entries;
+    QVector<Pair_t>             pairs;
+
+    // Categories, units, groups and common enum strings repeat across many parameters, they are only stored once
+    auto intern = [&stringIndex, &strings](const QString& string) -> String_t {
+        String_t result;
+        memset(&result, 0, sizeof(result));
+        if (!string.isEmpty()) {
+            QHash<QString, String_t>::const_iterator iter = stringIndex.constFind(string);
+            if (iter != stringIndex.constEnd()) {
+                return iter.value();
+            }
+            const QByteArray utf8 = string.toUtf8();
+            result.offset = static_cast<quint32>(strings.length());
+            result.length = static_cast<quint32>(utf8.length());
+            strings.append(utf8);
+            stringIndex[string] = result;
+        }
+        return result;
+    };
+
+    QVector<QByteArray> scopeKeys;
+    QVector<QByteArray> nameKeys;
+    QVector<int>        order;
+    scopeKeys.reserve(params.count());
+    nameKeys.reserve(params.count());
+    order.reserve(params.count());
+    for (int i=0; i<params.count(); i++) {
+        scopeKeys.append(params[i].fields[FieldScope].toUtf8());
+        nameKeys.append(params[i].fields[FieldName].toUtf8());
+        order.append(i);
+    }
+    std::sort(order.begin(), order.end(), [&scopeKeys, &nameKeys](int a, int b) {
+        if (scopeKeys[a] != scopeKeys[b]) {
+            return scopeKeys[a] < scopeKeys[b];
+        }
+        return nameKeys[a] < nameKeys[b];
+    });
+
+    entries.reserve(params.count());
+    for (int i: order) {
+        const Param_t& param = params[i];
+
+        Entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        for (int j=0; j<FieldCount; j++) {
+            entry.fields[j] = intern(param.fields[j]);
+        }
+        entry.flags         = param.flags;
+        entry.firstPair     = static_cast<quint32>(pairs.count());
+        entry.valueCount    = static_cast<quint16>(qMin(param.values.count(), 0xFFFF));
+        entry.bitmaskCount  = static_cast<quint16>(qMin(param.bitmask.count(), 0xFFFF));
+        for (int j=0; j<entry.valueCount; j++) {
+            pairs.append({ intern(param.values[j].first), intern(param.values[j].second) });
+        }
+        for (int j=0; j<entry.bitmaskCount; j++) {
+            pairs.append({ intern(param.bitmask[j].first), intern(param.bitmask[j].second) });
+        }
+        entries.append(entry);
+    }
+
+    String_t keyString = intern(sourceKey);
+
+    Header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic            = _magic;
+    header.version          = _version;
+    header.paramCount       = static_cast<quint32>(entries.count());
+    header.pairCount        = static_cast<quint32>(pairs.count());
+    header.stringsSize      = static_cast<quint32>(strings.length());
+    header.sourceKeyOffset  = keyString.offset;
+    header.sourceKeyLength  = keyString.length;
+
+    QByteArray bundle;
+    bundle.reserve(static_cast<int>(sizeof(header)) + entries.count() * static_cast<int>(sizeof(Entry_t)) + pairs.count() * static_cast<int>(sizeof(Pair_t)) + strings.length());
+    bundle.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    bundle.append(reinterpret_cast<const char*>(entries.constData()), entries.count() * static_cast<int>(sizeof(Entry_t)));
+    bundle.append(reinterpret_cast<const char*>(pairs.constData()), pairs.count() * static_cast<int>(sizeof(Pair_t)));
+    bundle.append(strings);
+    return bundle;
+}
+
+QString ParameterMetaDataBundle::sourceKey(const QString& sourceFile)
+{
+    QFileInfo info(sourceFile);
+
+    // Resource files change with the application, as may the parsers which fill the bundle
+    return QStringLiteral("%1|%2|%3|%4").arg(info.absoluteFilePath())
+            .arg(info.size())
+            .arg(info.lastModified().toMSecsSinceEpoch())
+            .arg(QCoreApplication::applicationVersion());
+}
+
+QString ParameterMetaDataBundle::cacheFilename(const QString& sourceFile)
+{
+    const QByteArray    hash    = QCryptographicHash::hash(QFileInfo(sourceFile).absoluteFilePath().toUtf8(), QCryptographicHash::Md5).toHex();
+    QDir                dir     = QFileInfo(QSettings().fileName()).dir();
+
+    return dir.absoluteFilePath(QStringLiteral("%1/%2.bundle").arg(kCacheDir).arg(QString::fromLatin1(hash)));
+}
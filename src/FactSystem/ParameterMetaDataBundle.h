@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QFile>
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QLoggingCategory>
+
+#include <functional>
+
+Q_DECLARE_LOGGING_CATEGORY(ParameterMetaDataBundleLog)
+
+/// Compiled, memory mapped form of a parameter meta data source file.
+///
+/// The firmware plugins parse their meta data XML once into a list of Param_t, which is compiled into a bundle and cached
+/// next to the settings file. Later loads of the same source map the cached bundle and skip parsing entirely. FactMetaData
+/// is not part of the bundle, the firmware plugins create it from the raw fields the first time a parameter is used.
+///
+/// Layout, in host byte order:
+///     Header_t
+///     Entry_t[paramCount]     Sorted by scope then name
+///     Pair_t[pairCount]       Enum values and bitmask bits of all entries
+///     Strings                 UTF-8, each distinct string stored once
+class ParameterMetaDataBundle
+{
+public:
+    ParameterMetaDataBundle(void);
+    ~ParameterMetaDataBundle();
+
+    enum Field_t {
+        FieldName,
+        FieldScope,             ///< Firmware specific subset of the source, for example an ArduPilot vehicle type
+        FieldType,
+        FieldCategory,
+        FieldGroup,
+        FieldShortDescription,
+        FieldLongDescription,
+        FieldUnits,
+        FieldMin,
+        FieldMax,
+        FieldDefaultValue,
+        FieldIncrement,
+        FieldDecimalPlaces,
+        FieldCount
+    };
+
+    enum Flags_t {
+        FlagRebootRequired  = 0x01,
+        FlagReadOnly        = 0x02,
+        FlagVolatile        = 0x04,
+        FlagBoolean         = 0x08,
+    };
+
+    typedef QList<QPair<QString, QString>> PairList_t;
+
+    /// Parameter meta data as read from the source file, values are kept as the source strings
+    typedef struct {
+        QString     fields[FieldCount];
+        quint32     flags = 0;  ///< Flags_t
+        PairList_t  values;     ///< Enum code, description
+        PairList_t  bitmask;    ///< Bit index, description
+    } Param_t;
+
+    typedef std::function<bool(const QString& sourceFile, QList<Param_t>& params)> ParseFunction_t;
+
+    /// Maps the cached bundle for the source file. If there is no valid cached bundle the source is parsed, the result
+    /// compiled and cached for the next load. A bundle which can't be cached is held in memory instead.
+    ///     @param parse Parses the source file, returns false if the source could not be fully read
+    ///     @return false: no meta data is available
+    bool load(const QString& sourceFile, ParseFunction_t parse);
+
+    /// Maps an existing bundle file
+    ///     @param sourceKey Must match the key the bundle was built with, see sourceKey
+    ///     @return false: no bundle file, not a valid one or built from a different source
+    bool open(const QString& filename, const QString& sourceKey);
+
+    /// Uses an in memory bundle as returned by build
+    bool setData(const QByteArray& bundle, const QString& sourceKey);
+
+    void close  (void);
+    bool isOpen (void) const { return _data != nullptr; }
+
+    int         count   (void) const { return _count; }
+    QString     field   (int index, Field_t field) const;
+    quint32     flags   (int index) const { return _entries[index].flags; }
+    PairList_t  values  (int index) const;
+    PairList_t  bitmask (int index) const;
+
+    /// @return Index of the named entry, -1 if not found
+    int find(const QString& scope, const QString& name) const;
+
+    /// Compiles the parameters into a bundle
+    static QByteArray build(const QString& sourceKey, const QList<Param_t>& params);
+
+    /// @return Key which changes whenever the source file or the application which parses it changes
+    static QString sourceKey(const QString& sourceFile);
+
+    /// @return Location of the cached bundle for the source file
+    static QString cacheFilename(const QString& sourceFile);
+
+private:
+    typedef struct {
+        quint32 magic;
+        quint32 version;
+        quint32 paramCount;
+        quint32 pairCount;
+        quint32 stringsSize;
+        quint32 sourceKeyOffset;
+        quint32 sourceKeyLength;
+        quint32 reserved;
+    } Header_t;
+
+    typedef struct {
+        quint32 offset;         ///< From the start of the strings block
+        quint32 length;
+    } String_t;
+
+    typedef struct {
+        String_t    fields[FieldCount];
+        quint32     flags;
+        quint32     firstPair;  ///< Values followed by bitmask bits
+        quint16     valueCount;
+        quint16     bitmaskCount;
+    } Entry_t;
+
+    typedef struct {
+        String_t first;
+        String_t second;
+    } Pair_t;
+
+    bool        _map        (const uchar* data, qint64 size, const QString& sourceKey);
+    bool        _validString(const String_t& string) const;
+    QString     _string     (const String_t& string) const;
+    PairList_t  _pairs      (int first, int count) const;
+    int         _compare    (int index, Field_t field, const QByteArray& key) const;
+
+    QFile           _file;
+    uchar*          _fileMap;
+    QByteArray      _bytes;
+    const uchar*    _data;
+    const Entry_t*  _entries;
+    const Pair_t*   _pairTable;
+    const char*     _strings;
+    quint32         _stringsSize;
+    quint32         _pairCount;
+    int             _count;
+
+    static const quint32 _magic     = 0x51504d42;   ///< "QPMB"
+    static const quint32 _version   = 1;
+};
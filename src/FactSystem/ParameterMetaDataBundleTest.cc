@@ -0,0 +1,203 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterMetaDataBundleTest.h"
+#include "ParameterMetaDataBundle.h"
+#include "PX4ParameterMetaData.h"
+
+#include <QTemporaryDir>
+
+ParameterMetaDataBundleTest::ParameterMetaDataBundleTest(void)
+{
+
+}
+
+static ParameterMetaDataBundle::Param_t _param(const QString& scope, const QString& name, const QString& longDescription)
+{
+    ParameterMetaDataBundle::Param_t param;
+
+    param.fields[ParameterMetaDataBundle::FieldScope]           = scope;
+    param.fields[ParameterMetaDataBundle::FieldName]            = name;
+    param.fields[ParameterMetaDataBundle::FieldType]            = QStringLiteral("INT32");
+    param.fields[ParameterMetaDataBundle::FieldCategory]        = QStringLiteral("Standard");
+    param.fields[ParameterMetaDataBundle::FieldLongDescription] = longDescription;
+    return param;
+}
+
+void ParameterMetaDataBundleTest::_buildFind_test(void)
+{
+    const QString                           key = QStringLiteral("key");
+    const QString                           longDescription(1000, 'x');
+    QList<ParameterMetaDataBundle::Param_t> params;
+
+    params.append(_param("libraries",   "RC1_MIN",      longDescription));
+    params.append(_param("ArduCopter",  "ATC_RAT_RLL",  longDescription));
+    params.append(_param("libraries",   "ATC_RAT_RLL",  longDescription));
+    params.append(_param("ArduCopter",  "FRAME_CLASS",  longDescription));
+    params[3].flags = ParameterMetaDataBundle::FlagRebootRequired;
+    params[3].fields[ParameterMetaDataBundle::FieldMin] = QStringLiteral("0");
+    params[3].values << QPair<QString, QString>("0", "Undefined") << QPair<QString, QString>("1", "Quad");
+    params[3].bitmask << QPair<QString, QString>("3", QString::fromUtf8("B\xc3\xbc"));
+
+    QByteArray bundleData = ParameterMetaDataBundle::build(key, params);
+
+    // Repeated strings are only stored once
+    QVERIFY(bundleData.size() < 2 * longDescription.length());
+
+    ParameterMetaDataBundle bundle;
+    QVERIFY(bundle.setData(bundleData, key));
+    QCOMPARE(bundle.count(), params.count());
+
+    // Same name in different scopes are different entries
+    int index = bundle.find("ArduCopter", "ATC_RAT_RLL");
+    QVERIFY(index != -1);
+    QCOMPARE(bundle.field(index, ParameterMetaDataBundle::FieldScope), QStringLiteral("ArduCopter"));
+    QVERIFY(bundle.find("libraries", "ATC_RAT_RLL") != index);
+    QVERIFY(bundle.find("libraries", "ATC_RAT_RLL") != -1);
+    QCOMPARE(bundle.find("libraries", "FRAME_CLASS"), -1);
+    QCOMPARE(bundle.find("ArduCopter", "FRAME_CLAS"), -1);
+    QCOMPARE(bundle.find("ArduCopter", "FRAME_CLASS_"), -1);
+    QCOMPARE(bundle.find(QString(), "RC1_MIN"), -1);
+
+    index = bundle.find("ArduCopter", "FRAME_CLASS");
+    QVERIFY(index != -1);
+    QCOMPARE(bundle.field(index, ParameterMetaDataBundle::FieldName),               QStringLiteral("FRAME_CLASS"));
+    QCOMPARE(bundle.field(index, ParameterMetaDataBundle::FieldType),               QStringLiteral("INT32"));
+    QCOMPARE(bundle.field(index, ParameterMetaDataBundle::FieldCategory),           QStringLiteral("Standard"));
+    QCOMPARE(bundle.field(index, ParameterMetaDataBundle::FieldLongDescription),    longDescription);
+    QCOMPARE(bundle.field(index, ParameterMetaDataBundle::FieldMin),                QStringLiteral("0"));
+    QVERIFY(bundle.field(index, ParameterMetaDataBundle::FieldMax).isEmpty());
+    QCOMPARE(bundle.flags(index), static_cast<quint32>(ParameterMetaDataBundle::FlagRebootRequired));
+    QCOMPARE(bundle.values(index), params[3].values);
+    QCOMPARE(bundle.bitmask(index), params[3].bitmask);
+    QVERIFY(bundle.values(bundle.find("libraries", "RC1_MIN")).isEmpty());
+}
+
+void ParameterMetaDataBundleTest::_load_test(void)
+{
+    QTemporaryDir   tempDir;
+    QString         sourceFile  = tempDir.filePath("ParameterMetaData.xml");
+    int             parseCount  = 0;
+
+    ParameterMetaDataBundle::ParseFunction_t parse = [&parseCount](const QString& /*sourceFile*/, QList<ParameterMetaDataBundle::Param_t>& params) {
+        parseCount++;
+        params.append(_param(QString(), "SYS_AUTOSTART", "Auto-start script index"));
+        return true;
+    };
+
+    QFile file(sourceFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("<parameters/>");
+    file.close();
+    QFile::remove(ParameterMetaDataBundle::cacheFilename(sourceFile));
+
+    // First load compiles and caches the bundle
+    {
+        ParameterMetaDataBundle bundle;
+        QVERIFY(bundle.load(sourceFile, parse));
+        QCOMPARE(parseCount, 1);
+        QVERIFY(bundle.find(QString(), "SYS_AUTOSTART") != -1);
+    }
+    QVERIFY(QFile::exists(ParameterMetaDataBundle::cacheFilename(sourceFile)));
+
+    // Later loads map the cached bundle
+    ParameterMetaDataBundle bundle;
+    QVERIFY(bundle.load(sourceFile, parse));
+    QCOMPARE(parseCount, 1);
+    QCOMPARE(bundle.field(bundle.find(QString(), "SYS_AUTOSTART"), ParameterMetaDataBundle::FieldLongDescription), QStringLiteral("Auto-start script index"));
+
+    // A changed source is parsed again
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("<parameters></parameters>");
+    file.close();
+    ParameterMetaDataBundle bundle2;
+    QVERIFY(bundle2.load(sourceFile, parse));
+    QCOMPARE(parseCount, 2);
+
+    // The existing mapping is unaffected by the bundle being replaced
+    QCOMPARE(bundle.count(), 1);
+    QCOMPARE(bundle.field(0, ParameterMetaDataBundle::FieldName), QStringLiteral("SYS_AUTOSTART"));
+
+    QFile::remove(ParameterMetaDataBundle::cacheFilename(sourceFile));
+}
+
+void ParameterMetaDataBundleTest::_invalidBundle_test(void)
+{
+    QTemporaryDir           tempDir;
+    QString                 filename = tempDir.filePath("Test.bundle");
+    ParameterMetaDataBundle bundle;
+
+    QVERIFY(!bundle.open(filename, "key"));
+
+    QList<ParameterMetaDataBundle::Param_t> params;
+    params.append(_param(QString(), "SYS_AUTOSTART", QString()));
+    QByteArray bundleData = ParameterMetaDataBundle::build("key", params);
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(bundleData);
+    file.close();
+    QVERIFY(bundle.open(filename, "key"));
+    QVERIFY(!bundle.open(filename, "otherKey"));
+    QVERIFY(!bundle.isOpen());
+
+    // Truncated
+    QVERIFY(!bundle.setData(bundleData.left(bundleData.size() - 1), "key"));
+
+    // String reference outside of the strings block
+    QByteArray corrupt = bundleData;
+    corrupt[static_cast<int>(sizeof(quint32) * 8)] = static_cast<char>(0xFF);
+    corrupt[static_cast<int>(sizeof(quint32) * 8) + 3] = static_cast<char>(0x7F);
+    QVERIFY(!bundle.setData(corrupt, "key"));
+}
+
+void ParameterMetaDataBundleTest::_px4MetaData_test(void)
+{
+    const QString metaDataFile = QStringLiteral(":/FirmwarePlugin/PX4/PX4ParameterFactMetaData.xml");
+
+    QFile::remove(ParameterMetaDataBundle::cacheFilename(metaDataFile));
+
+    // Meta data compiled from the XML must match meta data from the mapped bundle
+    PX4ParameterMetaData compiled;
+    compiled.loadParameterFactMetaDataFile(metaDataFile);
+    QVERIFY(QFile::exists(ParameterMetaDataBundle::cacheFilename(metaDataFile)));
+    PX4ParameterMetaData mapped;
+    mapped.loadParameterFactMetaDataFile(metaDataFile);
+
+    for (const QString& name: { QStringLiteral("COM_RC_LOSS_T"), QStringLiteral("COM_RC_OVERRIDE"), QStringLiteral("COM_RC_IN_MODE") }) {
+        FactMetaData* compiledMetaData  = compiled.getMetaDataForFact(name, MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32);
+        FactMetaData* mappedMetaData    = mapped.getMetaDataForFact(name, MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32);
+
+        QCOMPARE(mappedMetaData->name(),                compiledMetaData->name());
+        QCOMPARE(mappedMetaData->type(),                compiledMetaData->type());
+        QCOMPARE(mappedMetaData->group(),               compiledMetaData->group());
+        QCOMPARE(mappedMetaData->shortDescription(),    compiledMetaData->shortDescription());
+        QCOMPARE(mappedMetaData->longDescription(),     compiledMetaData->longDescription());
+        QCOMPARE(mappedMetaData->rawMin(),              compiledMetaData->rawMin());
+        QCOMPARE(mappedMetaData->rawMax(),              compiledMetaData->rawMax());
+        QCOMPARE(mappedMetaData->rawDefaultValue(),     compiledMetaData->rawDefaultValue());
+        QCOMPARE(mappedMetaData->enumStrings(),         compiledMetaData->enumStrings());
+        QCOMPARE(mappedMetaData->bitmaskStrings(),      compiledMetaData->bitmaskStrings());
+        QCOMPARE(mappedMetaData->bitmaskValues(),       compiledMetaData->bitmaskValues());
+
+        // Created once, on first use
+        QCOMPARE(mapped.getMetaDataForFact(name, MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32), mappedMetaData);
+    }
+
+    FactMetaData* metaData = mapped.getMetaDataForFact("COM_RC_LOSS_T", MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32);
+    QCOMPARE(metaData->type(),              FactMetaData::valueTypeFloat);
+    QCOMPARE(metaData->rawUnits(),          QStringLiteral("s"));
+    QCOMPARE(metaData->decimalPlaces(),     1);
+    QCOMPARE(metaData->rawDefaultValue(),   QVariant(0.5f));
+    QCOMPARE(metaData->rawMax(),            QVariant(35.0f));
+    QCOMPARE(mapped.getMetaDataForFact("COM_RC_OVERRIDE", MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32)->bitmaskStrings().count(), 2);
+
+    // Parameters missing from the meta data get generic meta data of the requested type
+    QCOMPARE(mapped.getMetaDataForFact("NOT_A_PARAM", MAV_TYPE_QUADROTOR, FactMetaData::valueTypeUint8)->type(), FactMetaData::valueTypeUint8);
+}
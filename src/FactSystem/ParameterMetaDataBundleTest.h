@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class ParameterMetaDataBundleTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    ParameterMetaDataBundleTest(void);
+
+private slots:
+    void _buildFind_test        (void);
+    void _load_test             (void);
+    void _invalidBundle_test    (void);
+    void _px4MetaData_test      (void);
+};
@@ -16,6 +16,7 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDebug>
+#include <QHash>
 #include <QStack>
 
 static const char* kInvalidConverstion = "Internal Error: No support for string parameters";
@@ -143,28 +144,39 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
     }
     _parameterMetaDataLoaded = true;
 
+    qCDebug(APMParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
+
+    // The XML is only parsed the first time this file is seen, after that the compiled bundle is mapped
+    _bundle.load(metaDataFile, [this](const QString& sourceFile, QList<ParameterMetaDataBundle::Param_t>& params) {
+        return _parseParameterXml(sourceFile, params);
+    });
+}
+
+/// Parses the meta data XML into raw parameter meta data for the bundle. Parameters are scoped by vehicle type, or
+/// "libraries" for the ones shared by all vehicles.
+///     @return false: file could not be fully read
+bool APMParameterMetaData::_parseParameterXml(const QString& metaDataFile, QList<ParameterMetaDataBundle::Param_t>& params)
+{
     QRegExp parameterCategories = QRegExp("ArduCopter|ArduPlane|APMrover2|ArduSub|AntennaTracker");
     QString currentCategory;
 
-    qCDebug(APMParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
-
     QFile xmlFile(metaDataFile);
-    Q_ASSERT(xmlFile.exists());
-
-    bool success = xmlFile.open(QIODevice::ReadOnly);
-    Q_UNUSED(success);
-    Q_ASSERT(success);
+    if (!xmlFile.open(QIODevice::ReadOnly)) {
+        qCWarning(APMParameterMetaDataLog) << "Unable to open parameter file:" << metaDataFile << xmlFile.errorString();
+        return false;
+    }
 
     QXmlStreamReader xml(xmlFile.readAll());
     xmlFile.close();
     if (xml.hasError()) {
         qCWarning(APMParameterMetaDataLog) << "Badly formed XML, reading failed: " << xml.errorString();
-        return;
+        return false;
     }
 
-    bool                badMetaData = true;
-    QStack<int>         xmlState;
-    APMFactMetaDataRaw* rawMetaData = nullptr;
+    bool                                badMetaData = true;
+    QStack<int>                         xmlState;
+    ParameterMetaDataBundle::Param_t*   rawMetaData = nullptr;
+    QMap<QString, QHash<QString, int>>  categoryNameToIndex;
 
     xmlState.push(XmlStateNone);
 
@@ -185,13 +197,13 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             } else if (elementName == "vehicles") {
                 if (xmlState.top() != XmlstateParamFileFound) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, vehicles matched";
-                    return;
+                    return false;
                 }
                 xmlState.push(XmlStateFoundVehicles);
             } else if (elementName == "libraries") {
                 if (xmlState.top() != XmlstateParamFileFound) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, libraries matched";
-                    return;
+                    return false;
                 }
                 currentCategory = "libraries";
                 xmlState.push(XmlStateFoundLibraries);
@@ -199,7 +211,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 if (xmlState.top() != XmlStateFoundVehicles && xmlState.top() != XmlStateFoundLibraries) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, parameters matched"
                                                        << "but we don't have proper vehicle or libraries yet";
-                    return;
+                    return false;
                 }
 
                 if (xml.attributes().hasAttribute("name")) {
@@ -216,7 +228,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                         qCDebug(APMParameterMetaDataVerboseLog) << "not interested in this block of parameters, skipping:" << nameValue;
                         if (skipXMLBlock(xml, "parameters")) {
                             qCWarning(APMParameterMetaDataLog) << "something wrong with the xml, skip of the xml failed";
-                            return;
+                            return false;
                         }
                         xml.readNext();
                         continue;
@@ -226,13 +238,13 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 if (xmlState.top() != XmlStateFoundParameters) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, element param matched"
                                                        << "while we are not yet in parameters";
-                    return;
+                    return false;
                 }
                 xmlState.push(XmlStateFoundParameter);
 
                 if (!xml.attributes().hasAttribute("name")) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, parameter attribute name missing";
-                    return;
+                    return false;
                 }
 
                 QString name = xml.attributes().value("name").toString();
@@ -256,30 +268,33 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                           << "group: " << group;
 
                 Q_ASSERT(!rawMetaData);
-                if (_vehicleTypeToParametersMap[currentCategory].contains(name)) {
+                QHash<QString, int>& nameToIndex = categoryNameToIndex[currentCategory];
+                if (nameToIndex.contains(name)) {
                     qCDebug(APMParameterMetaDataLog) << "Duplicate parameter found:" << name;
-                    rawMetaData = _vehicleTypeToParametersMap[currentCategory][name];
+                    rawMetaData = &params[nameToIndex[name]];
                 } else {
-                    rawMetaData = new APMFactMetaDataRaw(this);
-                    _vehicleTypeToParametersMap[currentCategory][name] = rawMetaData;
+                    nameToIndex[name] = params.count();
+                    params.append(ParameterMetaDataBundle::Param_t());
+                    rawMetaData = &params.last();
                     groupMembers[group] << name;
                 }
                 qCDebug(APMParameterMetaDataVerboseLog) << "inserting metadata for field" << name;
-                rawMetaData->name = name;
-                rawMetaData->category = category;
-                rawMetaData->group = group;
-                rawMetaData->shortDescription = shortDescription;
-                rawMetaData->longDescription = longDescription;
+                rawMetaData->fields[ParameterMetaDataBundle::FieldName]             = name;
+                rawMetaData->fields[ParameterMetaDataBundle::FieldScope]            = currentCategory;
+                rawMetaData->fields[ParameterMetaDataBundle::FieldCategory]         = category;
+                rawMetaData->fields[ParameterMetaDataBundle::FieldGroup]            = group;
+                rawMetaData->fields[ParameterMetaDataBundle::FieldShortDescription] = shortDescription;
+                rawMetaData->fields[ParameterMetaDataBundle::FieldLongDescription]  = longDescription;
             } else {
                 // We should be getting meta data now
                 if (xmlState.top() != XmlStateFoundParameter) {
                     qCWarning(APMParameterMetaDataLog) << "Badly formed XML, while reading parameter fields wrong state";
-                    return;
+                    return false;
                 }
                 if (!badMetaData) {
                     if (!parseParameterAttributes(xml, rawMetaData)) {
                         qCDebug(APMParameterMetaDataLog) << "Badly formed XML, failed to read parameter attributes";
-                        return;
+                        return false;
                     }
                     continue;
                 }
@@ -296,7 +311,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 xmlState.pop();
             } else if (elementName == "parameters") {
                 qCDebug(APMParameterMetaDataVerboseLog) << "end of parameters for category: " << currentCategory;
-                correctGroupMemberships(_vehicleTypeToParametersMap[currentCategory], groupMembers);
+                correctGroupMemberships(params, categoryNameToIndex[currentCategory], groupMembers);
                 groupMembers.clear();
                 xmlState.pop();
             } else if (elementName == "vehicles") {
@@ -306,15 +321,17 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         }
         xml.readNext();
     }
+
+    return true;
 }
 
-void APMParameterMetaData::correctGroupMemberships(ParameterNametoFactMetaDataMap& parameterToFactMetaDataMap,
+void APMParameterMetaData::correctGroupMemberships(QList<ParameterMetaDataBundle::Param_t>& params, const QHash<QString, int>& nameToIndex,
                                                    QMap<QString,QStringList>& groupMembers)
 {
     foreach(const QString& groupName, groupMembers.keys()) {
             if (groupMembers[groupName].count() == 1) {
                 foreach(const QString& parameter, groupMembers.value(groupName)) {
-                    parameterToFactMetaDataMap[parameter]->group = FactMetaData::defaultGroup();
+                    params[nameToIndex[parameter]].fields[ParameterMetaDataBundle::FieldGroup] = FactMetaData::defaultGroup();
                 }
             }
         }
@@ -330,7 +347,7 @@ bool APMParameterMetaData::skipXMLBlock(QXmlStreamReader& xml, const QString& bl
     return !xml.isEndDocument();
 }
 
-bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFactMetaDataRaw* rawMetaData)
+bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, ParameterMetaDataBundle::Param_t* rawMetaData)
 {
     QString elementName = xml.name().toString();
     QList<QPair<QString,QString> > values;
@@ -358,27 +375,29 @@ bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFa
 
                 // everything should be good. lets collect min and max
                 if (rangeList.count() == 2) {
-                    rawMetaData->min = rangeList.first().trimmed();
-                    rawMetaData->max = rangeList.last().trimmed();
+                    QString min = rangeList.first().trimmed();
+                    QString max = rangeList.last().trimmed();
 
                     // sanitize min and max off any comments that they may have
-                    if (rawMetaData->min.contains(' ')) {
-                        rawMetaData->min = rawMetaData->min.split(' ').first();
+                    if (min.contains(' ')) {
+                        min = min.split(' ').first();
                     }
-                    if(rawMetaData->max.contains(' ')) {
-                        rawMetaData->max = rawMetaData->max.split(' ').first();
+                    if(max.contains(' ')) {
+                        max = max.split(' ').first();
                     }
-                    qCDebug(APMParameterMetaDataVerboseLog) << "read field parameter " << "min: " << rawMetaData->min
-                                                     << "max: " << rawMetaData->max;
+                    rawMetaData->fields[ParameterMetaDataBundle::FieldMin] = min;
+                    rawMetaData->fields[ParameterMetaDataBundle::FieldMax] = max;
+                    qCDebug(APMParameterMetaDataVerboseLog) << "read field parameter " << "min: " << min
+                                                     << "max: " << max;
                 }
             } else if (attributeName == "Increment") {
                 QString increment = xml.readElementText();
                 qCDebug(APMParameterMetaDataVerboseLog) << "read Increment: " << increment;
-                rawMetaData->incrementSize = increment;
+                rawMetaData->fields[ParameterMetaDataBundle::FieldIncrement] = increment;
             } else if (attributeName == "Units") {
                 QString units = xml.readElementText();
                 qCDebug(APMParameterMetaDataVerboseLog) << "read Units: " << units;
-                rawMetaData->units = units;
+                rawMetaData->fields[ParameterMetaDataBundle::FieldUnits] = units;
             } else if (attributeName == "Bitmask") {
                 bool    parseError = false;
 
@@ -404,7 +423,7 @@ bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFa
             } else if (attributeName == "RebootRequired") {
                 QString strValue = xml.readElementText().trimmed();
                 if (strValue.compare("true", Qt::CaseInsensitive) == 0) {
-                    rawMetaData->rebootRequired = true;
+                    rawMetaData->flags |= ParameterMetaDataBundle::FlagRebootRequired;
                 }
             }
         } else if (elementName == "values") {
@@ -428,74 +447,81 @@ bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFa
 FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type)
 {
     const QString mavTypeString = mavTypeToString(vehicleType);
-    APMFactMetaDataRaw* rawMetaData = nullptr;
 
     // check if we have metadata for fact, use generic otherwise
-    if (_vehicleTypeToParametersMap[mavTypeString].contains(name)) {
-        rawMetaData = _vehicleTypeToParametersMap[mavTypeString][name];
-    } else if (_vehicleTypeToParametersMap["libraries"].contains(name)) {
-        rawMetaData = _vehicleTypeToParametersMap["libraries"][name];
+    int index = _bundle.find(mavTypeString, name);
+    if (index == -1) {
+        index = _bundle.find(QStringLiteral("libraries"), name);
     }
 
     FactMetaData *metaData = new FactMetaData(type, this);
 
     // we don't have data for this fact
-    if (!rawMetaData) {
+    if (index == -1) {
         metaData->setCategory(QStringLiteral("Advanced"));
         metaData->setGroup(_groupFromParameterName(name));
         qCDebug(APMParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
         return metaData;
     }
 
-    metaData->setName(rawMetaData->name);
-    metaData->setCategory(rawMetaData->category);
-    metaData->setGroup(rawMetaData->group);
-    metaData->setVehicleRebootRequired(rawMetaData->rebootRequired);
-
-    if (!rawMetaData->shortDescription.isEmpty()) {
-        metaData->setShortDescription(rawMetaData->shortDescription);
+    const QString                               shortDescription    = _bundle.field(index, ParameterMetaDataBundle::FieldShortDescription);
+    const QString                               longDescription     = _bundle.field(index, ParameterMetaDataBundle::FieldLongDescription);
+    const QString                               units               = _bundle.field(index, ParameterMetaDataBundle::FieldUnits);
+    const QString                               min                 = _bundle.field(index, ParameterMetaDataBundle::FieldMin);
+    const QString                               max                 = _bundle.field(index, ParameterMetaDataBundle::FieldMax);
+    const QString                               incrementSize       = _bundle.field(index, ParameterMetaDataBundle::FieldIncrement);
+    const ParameterMetaDataBundle::PairList_t   values              = _bundle.values(index);
+    const ParameterMetaDataBundle::PairList_t   bitmask             = _bundle.bitmask(index);
+
+    metaData->setName(_bundle.field(index, ParameterMetaDataBundle::FieldName));
+    metaData->setCategory(_bundle.field(index, ParameterMetaDataBundle::FieldCategory));
+    metaData->setGroup(_bundle.field(index, ParameterMetaDataBundle::FieldGroup));
+    metaData->setVehicleRebootRequired((_bundle.flags(index) & ParameterMetaDataBundle::FlagRebootRequired) != 0);
+
+    if (!shortDescription.isEmpty()) {
+        metaData->setShortDescription(shortDescription);
     }
 
-    if (!rawMetaData->longDescription.isEmpty()) {
-        metaData->setLongDescription(rawMetaData->longDescription);
+    if (!longDescription.isEmpty()) {
+        metaData->setLongDescription(longDescription);
     }
 
-    if (!rawMetaData->units.isEmpty()) {
-        metaData->setRawUnits(rawMetaData->units);
+    if (!units.isEmpty()) {
+        metaData->setRawUnits(units);
     }
 
-    if (!rawMetaData->min.isEmpty()) {
+    if (!min.isEmpty()) {
         QVariant varMin;
         QString errorString;
-        if (metaData->convertAndValidateRaw(rawMetaData->min, false /* validate as well */, varMin, errorString)) {
+        if (metaData->convertAndValidateRaw(min, false /* validate as well */, varMin, errorString)) {
             metaData->setRawMin(varMin);
         } else {
             qCDebug(APMParameterMetaDataLog) << "Invalid min value, name:" << metaData->name()
-                                             << " type:" << metaData->type() << " min:" << rawMetaData->min
+                                             << " type:" << metaData->type() << " min:" << min
                                              << " error:" << errorString;
         }
     }
 
-    if (!rawMetaData->max.isEmpty()) {
+    if (!max.isEmpty()) {
         QVariant varMax;
         QString errorString;
-        if (metaData->convertAndValidateRaw(rawMetaData->max, false /* validate as well */, varMax, errorString)) {
+        if (metaData->convertAndValidateRaw(max, false /* validate as well */, varMax, errorString)) {
             metaData->setRawMax(varMax);
         } else {
             qCDebug(APMParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:"
-                                             << metaData->type() << " max:" << rawMetaData->max
+                                             << metaData->type() << " max:" << max
                                              << " error:" << errorString;
         }
     }
 
-    if (rawMetaData->values.count() > 0) {
+    if (values.count() > 0) {
         QStringList     enumStrings;
         QVariantList    enumValues;
 
-        for (int i=0; i<rawMetaData->values.count(); i++) {
+        for (int i=0; i<values.count(); i++) {
             QVariant    enumValue;
             QString     errorString;
-            QPair<QString, QString> enumPair = rawMetaData->values[i];
+            QPair<QString, QString> enumPair = values[i];
 
             if (metaData->convertAndValidateRaw(enumPair.first, false /* validate */, enumValue, errorString)) {
                 enumValues << enumValue;
@@ -515,14 +541,14 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
         }
     }
 
-    if (rawMetaData->bitmask.count() > 0) {
+    if (bitmask.count() > 0) {
         QStringList     bitmaskStrings;
         QVariantList    bitmaskValues;
 
-        for (int i=0; i<rawMetaData->bitmask.count(); i++) {
+        for (int i=0; i<bitmask.count(); i++) {
             QVariant    bitmaskValue;
             QString     errorString;
-            QPair<QString, QString> bitmaskPair = rawMetaData->bitmask[i];
+            QPair<QString, QString> bitmaskPair = bitmask[i];
 
             bool ok = false;
             unsigned int bitSet = bitmaskPair.first.toUInt(&ok);
@@ -586,14 +612,14 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
         }
     }
 
-    if (!rawMetaData->incrementSize.isEmpty()) {
+    if (!incrementSize.isEmpty()) {
         double  increment;
         bool    ok;
-        increment = rawMetaData->incrementSize.toDouble(&ok);
+        increment = incrementSize.toDouble(&ok);
         if (ok) {
             metaData->setRawIncrement(increment);
         } else {
-            qCDebug(APMParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << rawMetaData->incrementSize;
+            qCDebug(APMParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << incrementSize;
         }
     }
 
@@ -13,44 +13,21 @@
 
 #include <QObject>
 #include <QMap>
+#include <QHash>
 #include <QPointer>
 #include <QXmlStreamReader>
 #include <QLoggingCategory>
 
 #include "FactSystem.h"
+#include "ParameterMetaDataBundle.h"
 #include "AutoPilotPlugin.h"
 #include "Vehicle.h"
 
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataLog)
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataVerboseLog)
 
-class APMFactMetaDataRaw : public QObject
-{
-    Q_OBJECT
-public:
-    APMFactMetaDataRaw(QObject *parent = nullptr)
-        : QObject(parent), rebootRequired(false)
-    { }
-
-    QString name;
-    QString category;
-    QString group;
-    QString shortDescription;
-    QString longDescription;
-    QString min;
-    QString max;
-    QString incrementSize;
-    QString units;
-    bool    rebootRequired;
-    QList<QPair<QString, QString> > values;
-    QList<QPair<QString, QString> > bitmask;
-};
-
-
 /// Collection of Parameter Facts for PX4 AutoPilot
 
-typedef QMap<QString, APMFactMetaDataRaw*> ParameterNametoFactMetaDataMap;
-
 class APMParameterMetaData : public QObject
 {
     Q_OBJECT
@@ -78,14 +55,14 @@ private:
 
     QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
     bool skipXMLBlock(QXmlStreamReader& xml, const QString& blockName);
-    bool parseParameterAttributes(QXmlStreamReader& xml, APMFactMetaDataRaw *rawMetaData);
-    void correctGroupMemberships(ParameterNametoFactMetaDataMap& parameterToFactMetaDataMap, QMap<QString,QStringList>& groupMembers);
+    bool _parseParameterXml(const QString& metaDataFile, QList<ParameterMetaDataBundle::Param_t>& params);
+    bool parseParameterAttributes(QXmlStreamReader& xml, ParameterMetaDataBundle::Param_t* rawMetaData);
+    void correctGroupMemberships(QList<ParameterMetaDataBundle::Param_t>& params, const QHash<QString, int>& nameToIndex, QMap<QString,QStringList>& groupMembers);
     QString mavTypeToString(MAV_TYPE vehicleTypeEnum);
     QString _groupFromParameterName(const QString& name);
 
     bool                                            _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
-    // FIXME: metadata is vehicle type specific now
-    QMap<QString, ParameterNametoFactMetaDataMap>   _vehicleTypeToParametersMap;                ///< Maps from a vehicle type to paramametertoFactMeta map>
+    ParameterMetaDataBundle                         _bundle;                                    ///< Raw meta data scoped by vehicle type or "libraries"
 };
 
 #endif
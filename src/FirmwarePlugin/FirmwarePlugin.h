@@ -209,6 +209,12 @@ public:
     ///     false: Do not send first item to vehicle, sequence numbers must be adjusted
     virtual bool sendHomePositionToVehicle(void);
 
+    /// Returns the number of mission items which can be in flight at once during mission item transfers.
+    ///     1: Lock step protocol, one item per round trip
+    ///     >1: Several MISSION_REQUESTs outstanding on reads and items sent ahead of their request on writes.
+    ///         The vehicle must tolerate both.
+    virtual int missionTransferWindow(Vehicle* /*vehicle*/) { return 1; }
+
     /// Returns the parameter which is used to identify the version number of parameter set
     virtual QString getVersionParam(void) { return QString(); }
 
@@ -19,6 +19,7 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDebug>
+#include <QHash>
 
 static const char* kInvalidConverstion = "Internal Error: No support for string parameters";
 
@@ -90,30 +91,42 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
 
     qCDebug(PX4ParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
 
-    QFile xmlFile(metaDataFile);
-
-    if (!xmlFile.exists()) {
+    if (!QFile::exists(metaDataFile)) {
         qWarning() << "Internal error: metaDataFile mission" << metaDataFile;
         return;
     }
-    
+
+    // The XML is only parsed the first time this file is seen, after that the compiled bundle is mapped
+    _bundle.load(metaDataFile, &PX4ParameterMetaData::_parseParameterXml);
+
+#ifdef GENERATE_PARAMETER_JSON
+    _generateParameterJson();
+#endif
+}
+
+/// Parses the meta data XML into raw parameter meta data for the bundle
+///     @return false: file could not be fully read
+bool PX4ParameterMetaData::_parseParameterXml(const QString& metaDataFile, QList<ParameterMetaDataBundle::Param_t>& params)
+{
+    QFile xmlFile(metaDataFile);
+
     if (!xmlFile.open(QIODevice::ReadOnly)) {
         qWarning() << "Internal error: Unable to open parameter file:" << metaDataFile << xmlFile.errorString();
-        return;
+        return false;
     }
     
     QXmlStreamReader xml(xmlFile.readAll());
     xmlFile.close();
     if (xml.hasError()) {
         qWarning() << "Badly formed XML" << xml.errorString();
-        return;
+        return false;
     }
     
-    QString         factGroup;
-    QString         errorString;
-    FactMetaData*   metaData = nullptr;
-    int             xmlState = XmlStateNone;
-    bool            badMetaData = true;
+    QString                             factGroup;
+    QHash<QString, int>                 nameToIndex;
+    ParameterMetaDataBundle::Param_t*   param = nullptr;
+    int                                 xmlState = XmlStateNone;
+    bool                                badMetaData = true;
     
     while (!xml.atEnd()) {
         if (xml.isStartElement()) {
@@ -122,14 +135,14 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             if (elementName == "parameters") {
                 if (xmlState != XmlStateNone) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 xmlState = XmlStateFoundParameters;
                 
             } else if (elementName == "version") {
                 if (xmlState != XmlStateFoundParameters) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 xmlState = XmlStateFoundVersion;
                 
@@ -138,12 +151,12 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 int intVersion = strVersion.toInt(&convertOk);
                 if (!convertOk) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 if (intVersion <= 2) {
                     // We can't read these old files
                     qDebug() << "Parameter version stamp too old, skipping load. Found:" << intVersion << "Want: 3 File:" << metaDataFile;
-                    return;
+                    return false;
                 }
                 
             } else if (elementName == "parameter_version_major") {
@@ -155,13 +168,13 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 if (xmlState != XmlStateFoundVersion) {
                     // We didn't get a version stamp, assume older version we can't read
                     qDebug() << "Parameter version stamp not found, skipping load" << metaDataFile;
-                    return;
+                    return false;
                 }
                 xmlState = XmlStateFoundGroup;
                 
                 if (!xml.attributes().hasAttribute("name")) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 factGroup = xml.attributes().value("name").toString();
                 qCDebug(PX4ParameterMetaDataLog) << "Found group: " << factGroup;
@@ -169,13 +182,13 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             } else if (elementName == "parameter") {
                 if (xmlState != XmlStateFoundGroup) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 xmlState = XmlStateFoundParameter;
                 
                 if (!xml.attributes().hasAttribute("name") || !xml.attributes().hasAttribute("type")) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
                 
                 QString name = xml.attributes().value("name").toString();
@@ -187,122 +200,94 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                     category = QStringLiteral("Standard");
                 }
 
-                bool volatileValue = false;
-                bool readOnly = false;
+                quint32 flags = 0;
                 QString volatileStr = xml.attributes().value("volatile").toString();
                 if (volatileStr.compare(QStringLiteral("true")) == 0) {
-                    volatileValue = true;
-                    readOnly = true;
-                }
-                if (!volatileValue) {
+                    flags |= ParameterMetaDataBundle::FlagVolatile | ParameterMetaDataBundle::FlagReadOnly;
+                } else {
                     QString readOnlyStr = xml.attributes().value("readonly").toString();
                     if (readOnlyStr.compare(QStringLiteral("true")) == 0) {
-                        readOnly = true;
+                        flags |= ParameterMetaDataBundle::FlagReadOnly;
                     }
                 }
 
                 qCDebug(PX4ParameterMetaDataLog) << "Found parameter name:" << name << " type:" << type << " default:" << strDefault;
 
-                // Convert type from string to FactMetaData::ValueType_t
+                // Validate the type now so a bad file is not cached, the FactMetaData is created from it later
                 bool unknownType;
-                FactMetaData::ValueType_t foundType = FactMetaData::stringToType(type, unknownType);
+                FactMetaData::stringToType(type, unknownType);
                 if (unknownType) {
                     qWarning() << "Parameter meta data with bad type:" << type << " name:" << name;
-                    return;
+                    return false;
                 }
                 
-                // Now that we know type we can create meta data object and add it to the system
-                metaData = new FactMetaData(foundType, this);
-                if (_mapParameterName2FactMetaData.contains(name)) {
+                if (nameToIndex.contains(name)) {
                     // We can't trust the meta data since we have dups
                     qCWarning(PX4ParameterMetaDataLog) << "Duplicate parameter found:" << name;
                     badMetaData = true;
                     // Reset to default meta data
-                    _mapParameterName2FactMetaData[name] = metaData;
+                    param = &params[nameToIndex[name]];
+                    *param = ParameterMetaDataBundle::Param_t();
+                    param->fields[ParameterMetaDataBundle::FieldName] = name;
+                    param->fields[ParameterMetaDataBundle::FieldType] = type;
                 } else {
-                    _mapParameterName2FactMetaData[name] = metaData;
-                    metaData->setName(name);
-                    metaData->setCategory(category);
-                    metaData->setGroup(factGroup);
-                    metaData->setReadOnly(readOnly);
-                    metaData->setVolatileValue(volatileValue);
-                    
-                    if (xml.attributes().hasAttribute("default") && !strDefault.isEmpty()) {
-                        QVariant varDefault;
-                        
-                        if (metaData->convertAndValidateRaw(strDefault, false, varDefault, errorString)) {
-                            metaData->setRawDefaultValue(varDefault);
-                        } else {
-                            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << name << " type:" << type << " default:" << strDefault << " error:" << errorString;
-                        }
-                    }
+                    nameToIndex[name] = params.count();
+                    params.append(ParameterMetaDataBundle::Param_t());
+                    param = &params.last();
+                    param->fields[ParameterMetaDataBundle::FieldName]           = name;
+                    param->fields[ParameterMetaDataBundle::FieldType]           = type;
+                    param->fields[ParameterMetaDataBundle::FieldCategory]       = category;
+                    param->fields[ParameterMetaDataBundle::FieldGroup]          = factGroup;
+                    param->fields[ParameterMetaDataBundle::FieldDefaultValue]   = strDefault;
+                    param->flags = flags;
                 }
                 
             } else {
                 // We should be getting meta data now
                 if (xmlState != XmlStateFoundParameter) {
                     qWarning() << "Badly formed XML";
-                    return;
+                    return false;
                 }
 
                 if (!badMetaData) {
-                    if (metaData) {
+                    if (param) {
                         if (elementName == "short_desc") {
                             QString text = xml.readElementText();
                             text = text.replace("\n", " ");
                             qCDebug(PX4ParameterMetaDataLog) << "Short description:" << text;
-                            metaData->setShortDescription(text);
+                            param->fields[ParameterMetaDataBundle::FieldShortDescription] = text;
 
                         } else if (elementName == "long_desc") {
                             QString text = xml.readElementText();
                             text = text.replace("\n", " ");
                             qCDebug(PX4ParameterMetaDataLog) << "Long description:" << text;
-                            metaData->setLongDescription(text);
+                            param->fields[ParameterMetaDataBundle::FieldLongDescription] = text;
 
                         } else if (elementName == "min") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Min:" << text;
-
-                            QVariant varMin;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
-                                metaData->setRawMin(varMin);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
-                            }
+                            param->fields[ParameterMetaDataBundle::FieldMin] = text;
 
                         } else if (elementName == "max") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Max:" << text;
-
-                            QVariant varMax;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
-                                metaData->setRawMax(varMax);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
-                            }
+                            param->fields[ParameterMetaDataBundle::FieldMax] = text;
 
                         } else if (elementName == "unit") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Unit:" << text;
-                            metaData->setRawUnits(text);
+                            param->fields[ParameterMetaDataBundle::FieldUnits] = text;
 
                         } else if (elementName == "decimal") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Decimal:" << text;
-
-                            bool convertOk;
-                            QVariant varDecimals = QVariant(text).toUInt(&convertOk);
-                            if (convertOk) {
-                                metaData->setDecimalPlaces(varDecimals.toInt());
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
-                            }
+                            param->fields[ParameterMetaDataBundle::FieldDecimalPlaces] = text;
 
                         } else if (elementName == "reboot_required") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "RebootRequired:" << text;
                             if (text.compare("true", Qt::CaseInsensitive) == 0) {
-                                metaData->setVehicleRebootRequired(true);
+                                param->flags |= ParameterMetaDataBundle::FlagRebootRequired;
                             }
 
                         } else if (elementName == "values") {
@@ -313,60 +298,26 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                             QString enumString = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
                                                              << "value desc:" << enumString << "code:" << enumValueStr;
+                            param->values.append(QPair<QString, QString>(enumValueStr, enumString));
 
-                            QVariant    enumValue;
-                            QString     errorString;
-                            if (metaData->convertAndValidateRaw(enumValueStr, false /* validate */, enumValue, errorString)) {
-                                metaData->addEnumInfo(enumString, enumValue);
-                            } else {
-                                qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
-                                                                 << " type:" << metaData->type() << " value:" << enumValueStr
-                                                                 << " error:" << errorString;
-                            }
                         } else if (elementName == "increment") {
-                            double  increment;
-                            bool    ok;
                             QString text = xml.readElementText();
-                            increment = text.toDouble(&ok);
-                            if (ok) {
-                                metaData->setRawIncrement(increment);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
-                            }
+                            qCDebug(PX4ParameterMetaDataLog) << "Increment:" << text;
+                            param->fields[ParameterMetaDataBundle::FieldIncrement] = text;
 
                         } else if (elementName == "boolean") {
-                            QVariant    enumValue;
-                            metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Enabled"), enumValue);
-                            metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Disabled"), enumValue);
+                            param->flags |= ParameterMetaDataBundle::FlagBoolean;
 
                         } else if (elementName == "bitmask") {
                             // doing nothing individual bits will follow anyway. May be used for sanity checking.
 
                         } else if (elementName == "bit") {
-                            bool ok = false;
-                            unsigned char bit = xml.attributes().value("index").toString().toUInt(&ok);
-                            if (ok) {
-                                QString bitDescription = xml.readElementText();
-                                qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
-                                                                 << "index:" << bit << "description:" << bitDescription;
-
-                                if (bit < 31) {
-                                    QVariant bitmaskRawValue = 1 << bit;
-                                    QVariant bitmaskValue;
-                                    QString errorString;
-                                    if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
-                                        metaData->addBitmaskInfo(bitDescription, bitmaskValue);
-                                    } else {
-                                        qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
-                                                                         << " type:" << metaData->type() << " value:" << bitmaskValue
-                                                                         << " error:" << errorString;
-                                    }
-                                } else {
-                                    qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
-                                }
-                            }
+                            QString bitIndex = xml.attributes().value("index").toString();
+                            QString bitDescription = xml.readElementText();
+                            qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
+                                                             << "index:" << bitIndex << "description:" << bitDescription;
+                            param->bitmask.append(QPair<QString, QString>(bitIndex, bitDescription));
+
                         } else {
                             qCDebug(PX4ParameterMetaDataLog) << "Unknown element in XML: " << elementName;
                         }
@@ -379,17 +330,8 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             QString elementName = xml.name().toString();
 
             if (elementName == "parameter") {
-                // Done loading this parameter, validate default value
-                if (metaData->defaultValueAvailable()) {
-                    QVariant var;
-
-                    if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
-                        qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
-                    }
-                }
-
                 // Reset for next parameter
-                metaData = nullptr;
+                param = nullptr;
                 badMetaData = false;
                 xmlState = XmlStateFoundGroup;
             } else if (elementName == "group") {
@@ -401,9 +343,161 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         xml.readNext();
     }
 
-#ifdef GENERATE_PARAMETER_JSON
-    _generateParameterJson();
-#endif
+    return true;
+}
+
+/// Creates the FactMetaData for a bundle entry, converting the raw strings to the parameter type
+///     @return nullptr: bad type
+FactMetaData* PX4ParameterMetaData::_createMetaData(int index)
+{
+    QString name = _bundle.field(index, ParameterMetaDataBundle::FieldName);
+    QString type = _bundle.field(index, ParameterMetaDataBundle::FieldType);
+    QString errorString;
+    QString text;
+
+    bool unknownType;
+    FactMetaData::ValueType_t foundType = FactMetaData::stringToType(type, unknownType);
+    if (unknownType) {
+        qWarning() << "Parameter meta data with bad type:" << type << " name:" << name;
+        return nullptr;
+    }
+
+    quint32 flags = _bundle.flags(index);
+
+    FactMetaData* metaData = new FactMetaData(foundType, this);
+    metaData->setName(name);
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldCategory);
+    if (!text.isEmpty()) {
+        metaData->setCategory(text);
+    }
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldGroup);
+    if (!text.isEmpty()) {
+        metaData->setGroup(text);
+    }
+    metaData->setReadOnly((flags & ParameterMetaDataBundle::FlagReadOnly) != 0);
+    metaData->setVolatileValue((flags & ParameterMetaDataBundle::FlagVolatile) != 0);
+
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldDefaultValue);
+    if (!text.isEmpty()) {
+        QVariant varDefault;
+
+        if (metaData->convertAndValidateRaw(text, false, varDefault, errorString)) {
+            metaData->setRawDefaultValue(varDefault);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << name << " type:" << type << " default:" << text << " error:" << errorString;
+        }
+    }
+
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldShortDescription);
+    if (!text.isEmpty()) {
+        metaData->setShortDescription(text);
+    }
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldLongDescription);
+    if (!text.isEmpty()) {
+        metaData->setLongDescription(text);
+    }
+
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldMin);
+    if (!text.isEmpty()) {
+        QVariant varMin;
+        if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
+            metaData->setRawMin(varMin);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
+        }
+    }
+
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldMax);
+    if (!text.isEmpty()) {
+        QVariant varMax;
+        if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
+            metaData->setRawMax(varMax);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
+        }
+    }
+
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldUnits);
+    if (!text.isEmpty()) {
+        metaData->setRawUnits(text);
+    }
+
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldDecimalPlaces);
+    if (!text.isEmpty()) {
+        bool convertOk;
+        QVariant varDecimals = QVariant(text).toUInt(&convertOk);
+        if (convertOk) {
+            metaData->setDecimalPlaces(varDecimals.toInt());
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
+        }
+    }
+
+    if (flags & ParameterMetaDataBundle::FlagRebootRequired) {
+        metaData->setVehicleRebootRequired(true);
+    }
+
+    for (const QPair<QString, QString>& enumPair: _bundle.values(index)) {
+        QVariant enumValue;
+        if (metaData->convertAndValidateRaw(enumPair.first, false /* validate */, enumValue, errorString)) {
+            metaData->addEnumInfo(enumPair.second, enumValue);
+        } else {
+            qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
+                                             << " type:" << metaData->type() << " value:" << enumPair.first
+                                             << " error:" << errorString;
+        }
+    }
+
+    text = _bundle.field(index, ParameterMetaDataBundle::FieldIncrement);
+    if (!text.isEmpty()) {
+        bool ok;
+        double increment = text.toDouble(&ok);
+        if (ok) {
+            metaData->setRawIncrement(increment);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
+        }
+    }
+
+    if (flags & ParameterMetaDataBundle::FlagBoolean) {
+        QVariant enumValue;
+        metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
+        metaData->addEnumInfo(tr("Enabled"), enumValue);
+        metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
+        metaData->addEnumInfo(tr("Disabled"), enumValue);
+    }
+
+    for (const QPair<QString, QString>& bitPair: _bundle.bitmask(index)) {
+        bool ok = false;
+        unsigned char bit = bitPair.first.toUInt(&ok);
+        if (!ok) {
+            continue;
+        }
+        if (bit < 31) {
+            QVariant bitmaskRawValue = 1 << bit;
+            QVariant bitmaskValue;
+            if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
+                metaData->addBitmaskInfo(bitPair.second, bitmaskValue);
+            } else {
+                qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
+                                                 << " type:" << metaData->type() << " value:" << bitmaskValue
+                                                 << " error:" << errorString;
+            }
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
+        }
+    }
+
+    // Validate default value against the final meta data
+    if (metaData->defaultValueAvailable()) {
+        QVariant var;
+
+        if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
+        }
+    }
+
+    return metaData;
 }
 
 #ifdef GENERATE_PARAMETER_JSON
@@ -420,6 +514,11 @@ void PX4ParameterMetaData::_generateParameterJson()
 {
     qCDebug(ParameterManagerLog) << "PX4ParameterMetaData::_generateParameterJson";
 
+    // Meta data is created lazily, make sure all of it is available
+    for (int i=0; i<_bundle.count(); i++) {
+        getMetaDataForFact(_bundle.field(i, ParameterMetaDataBundle::FieldName), MAV_TYPE_GENERIC, FactMetaData::valueTypeDouble);
+    }
+
     int indentLevel = 0;
     QFile jsonFile(QDir(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).absoluteFilePath("parameter.json"));
     jsonFile.open(QFile::WriteOnly | QFile::Truncate | QFile::Text);
@@ -495,8 +594,16 @@ FactMetaData* PX4ParameterMetaData::getMetaDataForFact(const QString& name, MAV_
     Q_UNUSED(vehicleType)
 
     if (!_mapParameterName2FactMetaData.contains(name)) {
-        qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
-        FactMetaData* metaData = new FactMetaData(type, this);
+        // Created on first use, most of the parameters in the meta data are never seen by a given vehicle
+        FactMetaData*   metaData    = nullptr;
+        int             index       = _bundle.find(QString(), name);
+        if (index != -1) {
+            metaData = _createMetaData(index);
+        }
+        if (!metaData) {
+            qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
+            metaData = new FactMetaData(type, this);
+        }
         _mapParameterName2FactMetaData[name] = metaData;
     }
 
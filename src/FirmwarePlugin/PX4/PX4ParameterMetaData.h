@@ -17,6 +17,7 @@
 #include <QLoggingCategory>
 
 #include "FactSystem.h"
+#include "ParameterMetaDataBundle.h"
 #include "AutoPilotPlugin.h"
 #include "Vehicle.h"
 
@@ -51,6 +52,8 @@ private:
     };    
 
     QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
+    FactMetaData* _createMetaData(int index);
+    static bool _parseParameterXml(const QString& metaDataFile, QList<ParameterMetaDataBundle::Param_t>& params);
     static void _outputFileWarning(const QString& metaDataFile, const QString& error1, const QString& error2);
 
 #ifdef GENERATE_PARAMETER_JSON
@@ -58,7 +61,8 @@ private:
 #endif
 
     bool                                _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
-    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData
+    ParameterMetaDataBundle             _bundle;                                    ///< Raw meta data for all parameters
+    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData, filled on first use
 };
 
 #endif
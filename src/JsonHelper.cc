@@ -240,10 +240,25 @@ bool JsonHelper::isJsonFile(const QString& fileName, QJsonDocument& jsonDoc, QSt
         errorString = tr("File open failed: file:error %1 %2").arg(jsonFile.fileName()).arg(jsonFile.errorString());
         return false;
     }
-    QByteArray jsonBytes = jsonFile.readAll();
-    jsonFile.close();
 
-    return isJsonFile(jsonBytes, jsonDoc, errorString);
+    return isJsonFile(jsonFile, jsonDoc, errorString);
+}
+
+bool JsonHelper::isJsonFile(QFile& file, QJsonDocument& jsonDoc, QString& errorString)
+{
+    qint64  size    = file.size();
+    uchar*  data    = size > 0 ? file.map(0, size) : nullptr;
+
+    if (!data) {
+        // Not mappable (sequential devices, some file systems), fall back to reading it in
+        return isJsonFile(file.readAll(), jsonDoc, errorString);
+    }
+
+    // The parser builds its own representation so the mapping is not needed once it is done
+    bool success = isJsonFile(QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<int>(size)), jsonDoc, errorString);
+    file.unmap(data);
+
+    return success;
 }
 
 bool JsonHelper::validateInternalQGCJsonFile(const QJsonObject& jsonObject,
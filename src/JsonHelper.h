@@ -18,6 +18,7 @@
 /// @author Don Gagne <don@thegagnes.com>
 
 class QmlObjectListModel;
+class QFile;
 
 /// @brief Json manipulation helper class.
 /// Primarily used for parsing and processing Fact metadata.
@@ -32,6 +33,13 @@ public:
                            QJsonDocument&       jsonDoc,        ///< returned json document
                            QString&             errorString);   ///< error on parse failure
 
+    /// Determines is the specified open file is a json file. The file is memory mapped when possible so large files
+    /// are parsed without first being copied into memory.
+    /// @return true: file is json, false: file is not json
+    static bool isJsonFile(QFile&               file,           ///< file open for reading
+                           QJsonDocument&       jsonDoc,        ///< returned json document
+                           QString&             errorString);   ///< error on parse failure
+
     /// Determines is the specified data is a json file
     /// @return true: file is json, false: file is not json
     static bool isJsonFile(const QByteArray&    bytes,          ///< json bytes
@@ -32,6 +32,7 @@
 #include "QGCCorePlugin.h"
 #include "TakeoffMissionItem.h"
 #include "PlanViewSettings.h"
+#include "TerrainQuery.h"
 
 #define UPDATE_TIMEOUT 5000 ///< How often we check for bounding box changes
 
@@ -759,13 +760,17 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
     }
     MissionSettingsItem* settingsItem = new MissionSettingsItem(_masterController, _flyView, visualItems);
     settingsItem->setCoordinate(homeCoordinate);
-    visualItems->insert(0, settingsItem);
     qCDebug(MissionControllerLog) << "plannedHomePosition" << homeCoordinate;
 
-    // Read mission items
+    // Read mission items. Items are collected and added to the model in a single insert instead of one model
+    // update per item.
 
     int nextSequenceNumber = 1; // Start with 1 since home is in 0
     const QJsonArray rgMissionItems(json[_jsonItemsKey].toArray());
+    QList<QObject*> loadedItems;
+    QHash<int, int> doJumpIdToSequenceNumber;
+    loadedItems.reserve(rgMissionItems.count() + 1);
+    loadedItems.append(settingsItem);
     for (int i=0; i<rgMissionItems.count(); i++) {
         // Convert to QJsonObject
         const QJsonValue& itemValue = rgMissionItems[i];
@@ -797,7 +802,10 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 qCDebug(MissionControllerLog) << "Loading simple item: nextSequenceNumber:command" << nextSequenceNumber << simpleItem->command();
                 nextSequenceNumber = simpleItem->lastSequenceNumber() + 1;
-                visualItems->append(simpleItem);
+                if (!doJumpIdToSequenceNumber.contains(simpleItem->missionItem().doJumpId())) {
+                    doJumpIdToSequenceNumber[simpleItem->missionItem().doJumpId()] = simpleItem->sequenceNumber();
+                }
+                loadedItems.append(simpleItem);
             } else {
                 return false;
             }
@@ -818,7 +826,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = surveyItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "Survey load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(surveyItem);
+                loadedItems.append(surveyItem);
             } else if (complexItemType == FixedWingLandingComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading Fixed Wing Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
                 FixedWingLandingComplexItem* landingItem = new FixedWingLandingComplexItem(_masterController, _flyView, visualItems);
@@ -827,7 +835,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "FW Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(landingItem);
+                loadedItems.append(landingItem);
             } else if (complexItemType == VTOLLandingComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading VTOL Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
                 VTOLLandingComplexItem* landingItem = new VTOLLandingComplexItem(_masterController, _flyView, visualItems);
@@ -836,7 +844,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "VTOL Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(landingItem);
+                loadedItems.append(landingItem);
             } else if (complexItemType == StructureScanComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading Structure Scan: nextSequenceNumber" << nextSequenceNumber;
                 StructureScanComplexItem* structureItem = new StructureScanComplexItem(_masterController, _flyView, QString() /* kmlFile */, visualItems);
@@ -845,7 +853,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = structureItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "Structure Scan load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(structureItem);
+                loadedItems.append(structureItem);
             } else if (complexItemType == CorridorScanComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading Corridor Scan: nextSequenceNumber" << nextSequenceNumber;
                 CorridorScanComplexItem* corridorItem = new CorridorScanComplexItem(_masterController, _flyView, QString() /* kmlFile */, visualItems);
@@ -854,7 +862,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = corridorItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "Corridor Scan load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(corridorItem);
+                loadedItems.append(corridorItem);
             } else {
                 errorString = tr("Unsupported complex item type: %1").arg(complexItemType);
             }
@@ -864,27 +872,19 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
         }
     }
 
+    visualItems->append(loadedItems);
+
     // Fix up the DO_JUMP commands jump sequence number by finding the item with the matching doJumpId
     for (int i=0; i<visualItems->count(); i++) {
         if (visualItems->value<VisualMissionItem*>(i)->isSimpleItem()) {
             SimpleMissionItem* doJumpItem = visualItems->value<SimpleMissionItem*>(i);
             if (doJumpItem->command() == MAV_CMD_DO_JUMP) {
-                bool found = false;
                 int findDoJumpId = static_cast<int>(doJumpItem->missionItem().param1());
-                for (int j=0; j<visualItems->count(); j++) {
-                    if (visualItems->value<VisualMissionItem*>(j)->isSimpleItem()) {
-                        SimpleMissionItem* targetItem = visualItems->value<SimpleMissionItem*>(j);
-                        if (targetItem->missionItem().doJumpId() == findDoJumpId) {
-                            doJumpItem->missionItem().setParam1(targetItem->sequenceNumber());
-                            found = true;
-                            break;
-                        }
-                    }
-                }
-                if (!found) {
+                if (!doJumpIdToSequenceNumber.contains(findDoJumpId)) {
                     errorString = tr("Could not find doJumpId: %1").arg(findDoJumpId);
                     return false;
                 }
+                doJumpItem->missionItem().setParam1(doJumpIdToSequenceNumber[findDoJumpId]);
             }
         }
     }
@@ -1024,9 +1024,8 @@ bool MissionController::loadJsonFile(QFile& file, QString& errorString)
     QString         errorStr;
     QString         errorMessage = tr("Mission: %1");
     QJsonDocument   jsonDoc;
-    QByteArray      bytes = file.readAll();
 
-    if (!JsonHelper::isJsonFile(bytes, jsonDoc, errorStr)) {
+    if (!JsonHelper::isJsonFile(file, jsonDoc, errorStr)) {
         errorString = errorMessage.arg(errorStr);
         return false;
     }
@@ -1164,11 +1163,7 @@ FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemP
     connect(pair.first,  coord1AltNotifier,                             segment,    &FlightPathSegment::setCoord1AMSLAlt);
     connect(pair.second, coord2AltNotifier,                             segment,    &FlightPathSegment::setCoord2AMSLAlt);
 
-    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-
     connect(segment,    &FlightPathSegment::totalDistanceChanged,       this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
     connect(segment,    &FlightPathSegment::amslTerrainHeightsChanged,  this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
     connect(segment,    &FlightPathSegment::terrainCollisionChanged,    this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
 
@@ -1398,7 +1393,7 @@ void MissionController::_recalcFlightPathSegments(void)
     // Anything left in the old table is an obsolete line object that can go
     qDeleteAll(oldSegmentTable);
 
-    emit _recalcMissionFlightStatusSignal();
+    _setFlightStatusDirty(0);
 
     if (_waypointPath.count() == 0) {
         // MapPolyLine has a bug where if you change from a path which has elements to an empty path the line drawn
@@ -1472,43 +1467,94 @@ void MissionController::_addTimeDistance(bool vtolInHover, double hoverTime, dou
     }
 }
 
+void MissionController::_setFlightStatusDirty(int visualItemIndex)
+{
+    _flightStatusDirtyIndex = qMin(_flightStatusDirtyIndex, visualItemIndex);
+    emit _recalcMissionFlightStatusSignal();
+}
+
+void MissionController::_visualItemFlightStatusChanged(void)
+{
+    // Only the changed item and the items after it are affected
+    int visualItemIndex = _visualItems->indexOf(sender());
+    _setFlightStatusDirty(visualItemIndex == -1 ? 0 : visualItemIndex);
+}
+
+void MissionController::_missionFlightStatusChanged(void)
+{
+    _setFlightStatusDirty(0);
+}
+
 void MissionController::_recalcMissionFlightStatus()
 {
     if (!_visualItems->count()) {
         return;
     }
 
+    int startIndex = _flightStatusDirtyIndex;
+    _flightStatusDirtyIndex = _flightStatusClean;
+    if (_flightStatusCheckpoints.count() != _visualItems->count()) {
+        startIndex = 0;
+    }
+    if (startIndex >= _visualItems->count()) {
+        // Nothing changed since the last pass
+        return;
+    }
+
     bool                firstCoordinateItem =           true;
     VisualMissionItem*  lastFlyThroughVI =   qobject_cast<VisualMissionItem*>(_visualItems->get(0));
 
     bool homePositionValid = _settingsItem->coordinate().isValid();
 
-    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus";
-
-    // If home position is valid we can calculate distances between all waypoints.
-    // If home position is not valid we can only calculate distances between waypoints which are
-    // both relative altitude.
-
-    // No values for first item
-    lastFlyThroughVI->setAltDifference(0.0);
-    lastFlyThroughVI->setAzimuth(0.0);
-    lastFlyThroughVI->setDistance(0.0);
-
-    _minAMSLAltitude = _maxAMSLAltitude = _settingsItem->coordinate().altitude();
-
-    _resetMissionFlightStatus();
+    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus startIndex" << startIndex;
 
     bool   vtolInHover =                _missionContainsVTOLTakeoff;
     bool   linkStartToHome =            false;
     bool   foundRTL =                   false;
     bool   vehicleYawSpecificallySet =  false;
     double totalHorizontalDistance =    0;
+    double prevMinAMSLAltitude =        _minAMSLAltitude;
+    double prevMaxAMSLAltitude =        _maxAMSLAltitude;
 
-    for (int i=0; i<_visualItems->count(); i++) {
+    if (startIndex == 0) {
+        // If home position is valid we can calculate distances between all waypoints.
+        // If home position is not valid we can only calculate distances between waypoints which are
+        // both relative altitude.
+
+        // No values for first item
+        lastFlyThroughVI->setAltDifference(0.0);
+        lastFlyThroughVI->setAzimuth(0.0);
+        lastFlyThroughVI->setDistance(0.0);
+
+        _minAMSLAltitude = _maxAMSLAltitude = _settingsItem->coordinate().altitude();
+
+        _resetMissionFlightStatus();
+
+        _flightStatusCheckpoints.resize(_visualItems->count());
+    } else {
+        // Everything before the first changed item is still valid, pick up from where the last pass was at that point
+        const FlightStatusCheckpoint_t& checkpoint = _flightStatusCheckpoints[startIndex];
+
+        _missionFlightStatus =      checkpoint.missionFlightStatus;
+        lastFlyThroughVI =          checkpoint.lastFlyThroughVI;
+        _minAMSLAltitude =          checkpoint.minAMSLAltitude;
+        _maxAMSLAltitude =          checkpoint.maxAMSLAltitude;
+        totalHorizontalDistance =   checkpoint.totalHorizontalDistance;
+        firstCoordinateItem =       checkpoint.firstCoordinateItem;
+        vtolInHover =               checkpoint.vtolInHover;
+        linkStartToHome =           checkpoint.linkStartToHome;
+        foundRTL =                  checkpoint.foundRTL;
+        vehicleYawSpecificallySet = checkpoint.vehicleYawSpecificallySet;
+    }
+
+    for (int i=startIndex; i<_visualItems->count(); i++) {
         VisualMissionItem*  item =          qobject_cast<VisualMissionItem*>(_visualItems->get(i));
         SimpleMissionItem*  simpleItem =    qobject_cast<SimpleMissionItem*>(item);
         ComplexMissionItem* complexItem =   qobject_cast<ComplexMissionItem*>(item);
 
+        _flightStatusCheckpoints[i] = { _missionFlightStatus, lastFlyThroughVI, _minAMSLAltitude, _maxAMSLAltitude, totalHorizontalDistance,
+                                        firstCoordinateItem, vtolInHover, linkStartToHome, foundRTL, vehicleYawSpecificallySet };
+
         if (simpleItem && simpleItem->mavCommand() == MAV_CMD_NAV_RETURN_TO_LAUNCH) {
             foundRTL = true;
         }
@@ -1708,9 +1754,11 @@ void MissionController::_recalcMissionFlightStatus()
     emit minAMSLAltitudeChanged         (_minAMSLAltitude);
     emit maxAMSLAltitudeChanged         (_maxAMSLAltitude);
 
-    // Walk the list again calculating altitude percentages
+    // Walk the list again calculating altitude percentages. Unless the altitude range changed only the recalculated
+    // items can have new values.
     double altRange = _maxAMSLAltitude - _minAMSLAltitude;
-    for (int i=0; i<_visualItems->count(); i++) {
+    int altPercentStartIndex = _minAMSLAltitude == prevMinAMSLAltitude && _maxAMSLAltitude == prevMaxAMSLAltitude ? startIndex : 0;
+    for (int i=altPercentStartIndex; i<_visualItems->count(); i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
 
         if (item->specifiesCoordinate()) {
@@ -1752,6 +1800,10 @@ void MissionController::_recalcSequence(void)
     int sequenceNumber = 0;
     for (int i=0; i<_visualItems->count(); i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
+        if (item->sequenceNumber() != sequenceNumber) {
+            // Battery change point is tracked by sequence number. No recalc is requested for this, it is picked up by the next one.
+            _flightStatusDirtyIndex = qMin(_flightStatusDirtyIndex, i);
+        }
         item->setSequenceNumber(sequenceNumber);
         sequenceNumber = item->lastSequenceNumber() + 1;
     }
@@ -1822,6 +1874,8 @@ void MissionController::_recalcAllWithCoordinate(const QGeoCoordinate& coordinat
     if (!_flyView) {
         _setPlannedHomePositionFromFirstCoordinate(coordinate);
     }
+    // Items may have been added, removed or moved so none of the flight status checkpoints can be trusted
+    _flightStatusDirtyIndex = 0;
     _recalcSequence();
     _recalcChildItems();
     emit _recalcFlightPathSegmentsSignal();
@@ -1889,12 +1943,18 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     setDirty(false);
 
     connect(visualItem, &VisualMissionItem::specifiesCoordinateChanged,                 this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+
+    // Changes to a single item only require the flight status from that item on to be recalculated
+    connect(visualItem, &VisualMissionItem::coordinateChanged,                          this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::exitCoordinateChanged,                      this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::amslEntryAltChanged,                        this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::amslExitAltChanged,                         this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_visualItemFlightStatusChanged);
 
     connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_recalcSequence);
 
@@ -1909,10 +1969,10 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     } else {
         ComplexMissionItem* complexItem = qobject_cast<ComplexMissionItem*>(visualItem);
         if (complexItem) {
-            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_visualItemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_visualItemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_visualItemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_visualItemFlightStatusChanged);
             connect(complexItem, &ComplexMissionItem::isIncompleteChanged,          this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
         } else {
             qWarning() << "ComplexMissionItem not found";
@@ -1957,8 +2017,8 @@ void MissionController::_managerVehicleChanged(Vehicle* managerVehicle)
     connect(_missionManager, &MissionManager::lastCurrentIndexChanged,  this, &MissionController::resumeMissionIndexChanged);
     connect(_missionManager, &MissionManager::resumeMissionReady,       this, &MissionController::resumeMissionReady);
     connect(_missionManager, &MissionManager::resumeMissionUploadFail,  this, &MissionController::resumeMissionUploadFail);
-    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_missionFlightStatusChanged);
+    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_missionFlightStatusChanged);
     connect(_managerVehicle, &Vehicle::vehicleTypeChanged,              this, &MissionController::complexMissionItemNamesChanged);
 
     emit complexMissionItemNamesChanged();
@@ -2536,6 +2596,11 @@ void MissionController::_updateTimeout()
         _travelBoundingCube = boundingCube;
         emit missionBoundingCubeChanged();
         qCDebug(MissionControllerLog) << "Bounding cube:" << _travelBoundingCube.pointNW << _travelBoundingCube.pointSE;
+
+        // Load the terrain for the whole plan in parallel instead of one tile at a time as each item asks for it
+        if (!_flyView && !qgcApp()->runningUnitTests()) {
+            TerrainTileManager::instance()->prefetchTiles(_travelBoundingCube);
+        }
     }
 }
 
@@ -18,6 +18,7 @@
 #include "QGroundControlQmlGlobal.h"
 
 #include <QHash>
+#include <QVector>
 
 class FlightPathSegment;
 class VisualMissionItem;
@@ -311,8 +312,25 @@ private slots:
     void _recalcAll                             (void);
     void _managerVehicleChanged                 (Vehicle* managerVehicle);
     void _takeoffItemNotRequiredChanged         (void);
+    void _visualItemFlightStatusChanged         (void);
+    void _missionFlightStatusChanged            (void);
 
 private:
+    /// State of the _recalcMissionFlightStatus pass before it processes a visual item. This allows a pass to resume
+    /// from the first changed item instead of walking the whole mission.
+    typedef struct {
+        MissionFlightStatus_t   missionFlightStatus;
+        VisualMissionItem*      lastFlyThroughVI;
+        double                  minAMSLAltitude;
+        double                  maxAMSLAltitude;
+        double                  totalHorizontalDistance;
+        bool                    firstCoordinateItem;
+        bool                    vtolInHover;
+        bool                    linkStartToHome;
+        bool                    foundRTL;
+        bool                    vehicleYawSpecificallySet;
+    } FlightStatusCheckpoint_t;
+
     void                    _init                               (void);
     void                    _recalcSequence                     (void);
     void                    _recalcChildItems                   (void);
@@ -349,6 +367,7 @@ private:
     FlightPathSegment*      _createFlightPathSegmentWorker      (VisualItemPair& pair);
     void                    _allItemsRemoved                    (void);
     void                    _firstItemAdded                     (void);
+    void                    _setFlightStatusDirty               (int visualItemIndex);
 
     static double           _calcDistanceToHome                 (VisualMissionItem* currentItem, VisualMissionItem* homeItem);
     static double           _normalizeLat                       (double lat);
@@ -391,6 +410,10 @@ private:
     double                      _minAMSLAltitude =              0;
     double                      _maxAMSLAltitude =              0;
     bool                        _missionContainsVTOLTakeoff =   false;
+    int                         _flightStatusDirtyIndex =       0;                  ///< First visual item the next _recalcMissionFlightStatus pass must process
+    QVector<FlightStatusCheckpoint_t> _flightStatusCheckpoints;                     ///< One per visual item, from the last pass
+
+    static const int _flightStatusClean = std::numeric_limits<int>::max();
 
     QGroundControlQmlGlobal::AltitudeMode _globalAltMode = QGroundControlQmlGlobal::AltitudeModeRelative;
 
@@ -412,4 +435,6 @@ private:
     static const char*  _jsonComplexItemsKey;
 
     static const int    _missionFileVersion;
+
+    friend class MissionControllerTest;
 };
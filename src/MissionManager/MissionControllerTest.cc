@@ -17,6 +17,12 @@
 #include "SettingsManager.h"
 #include "AppSettings.h"
 
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+
 MissionControllerTest::MissionControllerTest(void)
     : _multiSpyMissionController(nullptr)
     , _multiSpyMissionItem(nullptr)
@@ -203,3 +209,177 @@ void MissionControllerTest::_testLoadJsonSectionAvailable(void)
 
     }
 }
+
+void MissionControllerTest::_dragWaypoints(int dragCount, bool forceFullRecalc)
+{
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    VisualMissionItem*  dragItem    = visualItems->value<VisualMissionItem*>(visualItems->count() / 2);
+    QGeoCoordinate      coordinate  = dragItem->coordinate();
+
+    // Each drag is followed by a pass of the event loop just like the map does while dragging
+    for (int i=0; i<dragCount; i++) {
+        coordinate = coordinate.atDistanceAndAzimuth(10, (i % 2) ? 0 : 180);
+        dragItem->setCoordinate(coordinate);
+        if (forceFullRecalc) {
+            _missionController->_flightStatusDirtyIndex = 0;
+        }
+        QCoreApplication::processEvents();
+    }
+}
+
+void MissionControllerTest::_testIncrementalRecalc(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+    _masterController->loadFromFile(":/unittest/800Waypoints.mission");
+    QCoreApplication::processEvents();
+
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    QVERIFY(visualItems->count() > 800);
+
+    _dragWaypoints(5, false);
+
+    QVector<double> distances;
+    QVector<double> distancesFromStart;
+    QVector<double> altPercents;
+    for (int i=0; i<visualItems->count(); i++) {
+        VisualMissionItem* item = visualItems->value<VisualMissionItem*>(i);
+        distances.append(item->distance());
+        distancesFromStart.append(item->distanceFromStart());
+        altPercents.append(item->altPercent());
+    }
+    double missionDistance  = _missionController->missionDistance();
+    double missionTime      = _missionController->missionTime();
+
+    // Incremental results must match a full pass over the whole mission
+    _missionController->_flightStatusDirtyIndex = 0;
+    _missionController->_recalcMissionFlightStatus();
+
+    for (int i=0; i<visualItems->count(); i++) {
+        VisualMissionItem* item = visualItems->value<VisualMissionItem*>(i);
+        QCOMPARE(item->distance(),          distances[i]);
+        QCOMPARE(item->distanceFromStart(), distancesFromStart[i]);
+        QCOMPARE(item->altPercent(),        altPercents[i]);
+    }
+    QCOMPARE(_missionController->missionDistance(), missionDistance);
+    QCOMPARE(_missionController->missionTime(),     missionTime);
+}
+
+void MissionControllerTest::_testIncrementalRecalcBenchmark(void)
+{
+    UT_BENCHMARK();
+
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+    _masterController->loadFromFile(":/unittest/800Waypoints.mission");
+    QCoreApplication::processEvents();
+
+    QElapsedTimer timer;
+
+    timer.start();
+    _dragWaypoints(_benchmarkDragCount, true);
+    qint64 fullMSecs = qMax(timer.elapsed(), static_cast<qint64>(1));
+
+    timer.start();
+    _dragWaypoints(_benchmarkDragCount, false);
+    qint64 incrementalMSecs = qMax(timer.elapsed(), static_cast<qint64>(1));
+
+    qDebug() << "Dragged waypoint" << _benchmarkDragCount << "times in" << _missionController->visualItems()->count() << "item mission:"
+             << "full recalc" << fullMSecs << "msecs," << "incremental recalc" << incrementalMSecs << "msecs";
+}
+
+QString MissionControllerTest::_writeLargePlan(const QString& directory, int copies)
+{
+    // Build the plan from a save of the 800 waypoint mission with its items repeated
+    _masterController->loadFromFile(":/unittest/800Waypoints.mission");
+    QJsonObject planJson    = _masterController->saveToJson().object();
+    QJsonObject missionJson = planJson[PlanMasterController::kJsonMissionObjectKey].toObject();
+    QJsonArray  items       = missionJson[QStringLiteral("items")].toArray();
+    QJsonArray  largeItems;
+
+    int doJumpId = 1;
+    for (int copy=0; copy<copies; copy++) {
+        for (const QJsonValue& itemValue: items) {
+            QJsonObject itemObject = itemValue.toObject();
+            itemObject[QStringLiteral("doJumpId")] = doJumpId++;
+            largeItems.append(itemObject);
+        }
+    }
+    missionJson[QStringLiteral("items")] = largeItems;
+    planJson[PlanMasterController::kJsonMissionObjectKey] = missionJson;
+
+    QString planFile = QDir(directory).filePath(QStringLiteral("Large.plan"));
+    QFile file(planFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write(QJsonDocument(planJson).toJson(QJsonDocument::Compact));
+
+    return planFile;
+}
+
+/// @return Memory value in KB from /proc/self/status, for example VmRSS or VmHWM. -1 if not available.
+qint64 MissionControllerTest::_statusKB(const char* key)
+{
+#ifdef Q_OS_LINUX
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        for (const QByteArray& line: file.readAll().split('\n')) {
+            if (line.startsWith(key) && line.mid(static_cast<int>(qstrlen(key))).startsWith(':')) {
+                return line.mid(static_cast<int>(qstrlen(key)) + 1).trimmed().split(' ').first().toLongLong();
+            }
+        }
+    }
+#else
+    Q_UNUSED(key)
+#endif
+    return -1;
+}
+
+/// Resets the peak RSS (VmHWM) to the current RSS so a later peak only covers what happened after this
+///     @return false: not supported
+bool MissionControllerTest::_resetPeakRSS(void)
+{
+#ifdef Q_OS_LINUX
+    QFile file(QStringLiteral("/proc/self/clear_refs"));
+    return file.open(QIODevice::WriteOnly) && file.write("5") == 1;
+#else
+    return false;
+#endif
+}
+
+void MissionControllerTest::_testLoadLargePlanBenchmark(void)
+{
+    UT_BENCHMARK();
+
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    QTemporaryDir   tempDir;
+    QString         planFile = _writeLargePlan(tempDir.path(), _benchmarkPlanCopies);
+    QVERIFY(!planFile.isEmpty());
+
+    // Start from an empty plan so the previous mission does not count towards the load
+    _masterController->removeAll();
+    QCoreApplication::processEvents();
+
+    // Peak RSS is a process lifetime high water mark, earlier tests would hide the load unless it is reset
+    bool            peakReset   = _resetPeakRSS();
+    qint64          startRSSKB  = _statusKB("VmRSS");
+    QElapsedTimer   timer;
+
+    timer.start();
+    _masterController->loadFromFile(planFile);
+    qint64 loadMSecs = timer.elapsed();
+    QCoreApplication::processEvents();
+    qint64 settleMSecs = timer.elapsed();
+    qint64 peakRSSKB = _statusKB("VmHWM");
+
+    int itemCount = _missionController->visualItems()->count();
+    QVERIFY(itemCount > 800 * _benchmarkPlanCopies);
+
+    // Editor Facts are built on demand and still match the item
+    SimpleMissionItem* item = _missionController->visualItems()->value<SimpleMissionItem*>(itemCount / 2);
+    QVERIFY(item);
+    QVERIFY(item->textFieldFacts()->count() + item->nanFacts()->count() + item->comboboxFacts()->count() > 0);
+
+    qDebug() << "Loaded" << itemCount << "item plan in" << loadMSecs << "msecs," << settleMSecs << "msecs including recalc,"
+             << "peak RSS increase KB" << (peakReset && startRSSKB >= 0 && peakRSSKB >= 0 ? QString::number(peakRSSKB - startRSSKB) : QStringLiteral("n/a"));
+}
@@ -36,6 +36,9 @@ private slots:
     void _testLoadJsonSectionAvailable(void);
     void _testEmptyVehicleAPM(void);
     void _testEmptyVehiclePX4(void);
+    void _testIncrementalRecalc(void);
+    void _testIncrementalRecalcBenchmark(void);
+    void _testLoadLargePlanBenchmark(void);
 
 private:
 #if 0
@@ -51,6 +54,10 @@ private:
     void _testOfflineToOnlineWorker(MAV_AUTOPILOT firmwareType);
 #endif
     void _setupVisualItemSignals(VisualMissionItem* visualItem);
+    void _dragWaypoints(int dragCount, bool forceFullRecalc);
+    QString _writeLargePlan(const QString& directory, int copies);
+    static qint64 _statusKB(const char* key);
+    static bool _resetPeakRSS(void);
 
     // MissiomItems signals
 
@@ -83,6 +90,9 @@ private:
     static const size_t _cVisualItemSignals = visualItemMaxSignalIndex;
     const char*         _rgVisualItemSignals[_cVisualItemSignals];
 
+    static const int _benchmarkDragCount = 200;
+    static const int _benchmarkPlanCopies = 30;         ///< Copies of the 800 waypoint mission in the large plan
+
     PlanMasterController*   _masterController;
     MissionController*      _missionController;
 };
@@ -25,7 +25,9 @@ MissionManager::MissionManager(Vehicle* vehicle)
     : PlanManager               (vehicle, MAV_MISSION_TYPE_MISSION)
     , _cachedLastCurrentIndex   (-1)
 {
-    connect(_vehicle, &Vehicle::mavlinkMessageReceived, this, &MissionManager::_mavlinkMessageReceived);
+    _vehicle->messageDispatcher()->registerHandler(this, MAVLinkMessageDispatcher::anyId, MAVLinkMessageDispatcher::anyId,
+                                                   QList<int>({ MAVLINK_MSG_ID_MISSION_CURRENT, MAVLINK_MSG_ID_HEARTBEAT }),
+                                                   [this](LinkInterface* /*link*/, const mavlink_message_t& message) { _mavlinkMessageReceived(message); });
 }
 
 MissionManager::~MissionManager()
@@ -12,6 +12,8 @@
 #include "LinkManager.h"
 #include "MultiVehicleManager.h"
 
+#include <QElapsedTimer>
+
 const MissionManagerTest::TestCase_t MissionManagerTest::_rgTestCases[] = {
     { "0\t0\t3\t16\t10\t20\t30\t40\t-10\t-20\t-30\t1\r\n",  { 0, QGeoCoordinate(-10.0, -20.0, -30.0), MAV_CMD_NAV_WAYPOINT,     10.0, 20.0, 30.0, 40.0, true, false, MAV_FRAME_GLOBAL_RELATIVE_ALT } },
     { "1\t0\t3\t17\t10\t20\t30\t40\t-10\t-20\t-30\t1\r\n",  { 1, QGeoCoordinate(-10.0, -20.0, -30.0), MAV_CMD_NAV_LOITER_UNLIM, 10.0, 20.0, 30.0, 40.0, true, false, MAV_FRAME_GLOBAL_RELATIVE_ALT } },
@@ -360,3 +362,58 @@ void MissionManagerTest::_testErrorAckFailureStrings(void)
     }
 
 }
+
+void MissionManagerTest::_transferItems(int transferWindow, qint64& writeMSecs, qint64& readMSecs)
+{
+    QElapsedTimer timer;
+
+    _mockLink->setMissionTransferWindow(transferWindow);
+    _missionManager->setTransferWindow(transferWindow);
+
+    // Home position first, PX4 does not send it to the vehicle
+    QList<MissionItem*> missionItems;
+    for (int i=0; i<=_benchmarkItemCount; i++) {
+        missionItems.append(new MissionItem(i, MAV_CMD_NAV_WAYPOINT, MAV_FRAME_GLOBAL_RELATIVE_ALT, i, 0, 0, 0, 47.3769 + (i * 0.0001), 8.549444, 50, true, false, this));
+    }
+
+    // A lost final ack fails a write by design, so the loss simulation is only used for the read
+    _mockLink->setLinkSimulation(_benchmarkLatencyMSecs, 0);
+    timer.start();
+    _missionManager->writeMissionItems(missionItems);
+    QVERIFY(_multiSpyMissionManager->waitForSignalByIndex(sendCompleteSignalIndex, _missionManagerSignalWaitTime * 10));
+    writeMSecs = timer.elapsed();
+    QCOMPARE(_multiSpyMissionManager->getSpyByIndex(errorSignalIndex)->count(), 0);
+    _multiSpyMissionManager->clearAllSignals();
+
+    _mockLink->setLinkSimulation(_benchmarkLatencyMSecs, _benchmarkLossPercent);
+    timer.restart();
+    _missionManager->loadFromVehicle();
+    QVERIFY(_multiSpyMissionManager->waitForSignalByIndex(newMissionItemsAvailableSignalIndex, _missionManagerSignalWaitTime * 10));
+    readMSecs = timer.elapsed();
+    QCOMPARE(_multiSpyMissionManager->getSpyByIndex(errorSignalIndex)->count(), 0);
+    _multiSpyMissionManager->clearAllSignals();
+    _mockLink->setLinkSimulation(0, 0);
+
+    // Items must come back complete and in order even though they may have arrived out of order
+    const QList<MissionItem*>& readItems = _missionManager->missionItems();
+    QCOMPARE(readItems.count(), _benchmarkItemCount);
+    for (int i=0; i<readItems.count(); i++) {
+        QCOMPARE(readItems[i]->sequenceNumber(), i);
+        QCOMPARE(static_cast<int>(readItems[i]->param1()), i + 1);
+    }
+}
+
+void MissionManagerTest::_testTransferWindowBenchmark(void)
+{
+    UT_BENCHMARK();
+
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    qint64 lockStepWriteMSecs, lockStepReadMSecs, windowWriteMSecs, windowReadMSecs;
+    _transferItems(1, lockStepWriteMSecs, lockStepReadMSecs);
+    _transferItems(_benchmarkTransferWindow, windowWriteMSecs, windowReadMSecs);
+
+    qDebug() << "Transferred" << _benchmarkItemCount << "items, latency" << _benchmarkLatencyMSecs << "msecs, read loss" << _benchmarkLossPercent << "%";
+    qDebug() << "  lock step write" << lockStepWriteMSecs << "msecs, read" << lockStepReadMSecs << "msecs";
+    qDebug() << "  window" << _benchmarkTransferWindow << "write" << windowWriteMSecs << "msecs, read" << windowReadMSecs << "msecs";
+}
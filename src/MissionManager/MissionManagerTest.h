@@ -32,15 +32,22 @@ private slots:
     void _testReadFailureHandlingPX4(void);
     void _testReadFailureHandlingAPM(void);
     void _testErrorAckFailureStrings(void);
+    void _testTransferWindowBenchmark(void);
 
 private:
     void _roundTripItems(MockLinkMissionItemHandler::FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult, bool shouldFail);
     void _writeItems(MockLinkMissionItemHandler::FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult, bool shouldFail);
     void _testWriteFailureHandlingWorker(void);
     void _testReadFailureHandlingWorker(void);
+    void _transferItems(int transferWindow, qint64& writeMSecs, qint64& readMSecs);
     
     static const TestCase_t _rgTestCases[];
     static const size_t     _cTestCases;
+
+    static const int _benchmarkItemCount        = 250;
+    static const int _benchmarkTransferWindow   = 16;
+    static const int _benchmarkLatencyMSecs     = 10;
+    static const int _benchmarkLossPercent      = 2;
 };
 
 #endif
@@ -19,6 +19,8 @@
 #include "MissionCommandTree.h"
 #include "MissionCommandUIInfo.h"
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(PlanManagerLog, "PlanManagerLog")
 
 PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
@@ -61,6 +63,7 @@ void PlanManager::_writeMissionItemsWorker(void)
     }
 
     _retryCount = 0;
+    _startTransferWindow();
     _setTransactionInProgress(TransactionWrite);
     _connectToMavlink();
     _writeMissionCount();
@@ -137,6 +140,7 @@ void PlanManager::loadFromVehicle(void)
     }
 
     _retryCount = 0;
+    _startTransferWindow();
     _setTransactionInProgress(TransactionRead);
     _connectToMavlink();
     _requestList();
@@ -150,6 +154,7 @@ void PlanManager::_requestList(void)
     mavlink_message_t message;
 
     _itemIndicesToRead.clear();
+    _itemIndicesInFlight.clear();
     _clearMissionItems();
 
     _dedicatedLink = _vehicle->priorityLink();
@@ -195,6 +200,8 @@ void PlanManager::_ackTimeout(void)
         } else {
             _retryCount++;
             qCDebug(PlanManagerLog) << tr("Retrying %1 MISSION_REQUEST retry Count").arg(_planTypeString()) << _retryCount;
+            // Only the items which have not arrived yet are requested again
+            _itemIndicesInFlight.clear();
             _requestNextMissionItem();
         }
         break;
@@ -339,6 +346,13 @@ void PlanManager::_handleMissionCount(const mavlink_message_t& message)
     }
 }
 
+void PlanManager::_startTransferWindow(void)
+{
+    _activeTransferWindow = _transferWindow > 0 ? _transferWindow : _vehicle->firmwarePlugin()->missionTransferWindow(_vehicle);
+    _activeTransferWindow = qMax(_activeTransferWindow, 1);
+    _itemIndicesInFlight.clear();
+}
+
 void PlanManager::_requestNextMissionItem(void)
 {
     if (_itemIndicesToRead.count() == 0) {
@@ -346,7 +360,21 @@ void PlanManager::_requestNextMissionItem(void)
         return;
     }
 
-    qCDebug(PlanManagerLog) << QStringLiteral("_requestNextMissionItem %1 sequenceNumber:retry").arg(_planTypeString()) << _itemIndicesToRead[0] << _retryCount;
+    // Keep the window full, lowest outstanding sequence numbers first
+    for (int i=0; i<_itemIndicesToRead.count() && _itemIndicesInFlight.count() < _activeTransferWindow; i++) {
+        int sequenceNumber = _itemIndicesToRead[i];
+        if (!_itemIndicesInFlight.contains(sequenceNumber)) {
+            _itemIndicesInFlight.append(sequenceNumber);
+            _sendMissionRequest(sequenceNumber);
+        }
+    }
+
+    _startAckTimeout(AckMissionItem);
+}
+
+void PlanManager::_sendMissionRequest(int sequenceNumber)
+{
+    qCDebug(PlanManagerLog) << QStringLiteral("_sendMissionRequest %1 sequenceNumber:retry").arg(_planTypeString()) << sequenceNumber << _retryCount;
 
     mavlink_message_t message;
     if (_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_MISSION_INT) {
@@ -356,7 +384,7 @@ void PlanManager::_requestNextMissionItem(void)
                                                   &message,
                                                   _vehicle->id(),
                                                   MAV_COMP_ID_AUTOPILOT1,
-                                                  _itemIndicesToRead[0],
+                                                  sequenceNumber,
                 _planType);
     } else {
         mavlink_msg_mission_request_pack_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
@@ -365,12 +393,11 @@ void PlanManager::_requestNextMissionItem(void)
                                               &message,
                                               _vehicle->id(),
                                               MAV_COMP_ID_AUTOPILOT1,
-                                              _itemIndicesToRead[0],
+                                              sequenceNumber,
                 _planType);
     }
     
     _vehicle->sendMessageOnLinkThreadSafe(_dedicatedLink, message);
-    _startAckTimeout(AckMissionItem);
 }
 
 void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool missionItemInt)
@@ -450,6 +477,18 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
     if (_itemIndicesToRead.contains(seq)) {
         _itemIndicesToRead.removeOne(seq);
 
+        // Mavlink links deliver in order, so anything requested before this item which has not arrived was lost
+        int inFlightIndex = _itemIndicesInFlight.indexOf(seq);
+        if (inFlightIndex != -1) {
+            QList<int> lostIndices = _itemIndicesInFlight.mid(0, inFlightIndex);
+            _itemIndicesInFlight = _itemIndicesInFlight.mid(inFlightIndex + 1);
+            for (int lostSeq: lostIndices) {
+                qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 requesting lost item again:").arg(_planTypeString()) << lostSeq;
+                _itemIndicesInFlight.append(lostSeq);
+                _sendMissionRequest(lostSeq);
+            }
+        }
+
         MissionItem* item = new MissionItem(seq,
                                             command,
                                             frame,
@@ -481,6 +520,12 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message, bool miss
     
     _retryCount = 0;
     if (_itemIndicesToRead.count() == 0) {
+        if (_activeTransferWindow > 1) {
+            // Items can arrive out of order when several are in flight
+            std::sort(_missionItems.begin(), _missionItems.end(), [](const MissionItem* item1, const MissionItem* item2) {
+                return item1->sequenceNumber() < item2->sequenceNumber();
+            });
+        }
         _readTransactionComplete();
     } else {
         _requestNextMissionItem();
@@ -538,8 +583,24 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message, bool m
         _itemIndicesToWrite.removeOne(missionRequestSeq);
     }
     
-    MissionItem* item = _writeMissionItems[missionRequestSeq];
-    qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequenceNumber:command").arg(_planTypeString()) << missionRequestSeq << item->command();
+    _sendMissionItem(missionRequestSeq, missionItemInt);
+
+    // With a transfer window the items following the request are sent without waiting to be asked for. A vehicle which
+    // lost one of them simply requests it again.
+    for (int i=missionRequestSeq+1; i<missionRequestSeq+_activeTransferWindow && i<_writeMissionItems.count(); i++) {
+        if (_itemIndicesToWrite.contains(i)) {
+            _itemIndicesToWrite.removeOne(i);
+            _sendMissionItem(i, missionItemInt);
+        }
+    }
+
+    _startAckTimeout(AckMissionRequest);
+}
+
+void PlanManager::_sendMissionItem(int sequenceNumber, bool missionItemInt)
+{
+    MissionItem* item = _writeMissionItems[sequenceNumber];
+    qCDebug(PlanManagerLog) << QStringLiteral("_sendMissionItem %1 sequenceNumber:command").arg(_planTypeString()) << sequenceNumber << item->command();
 
     // ArduPilot always expects to get MISSION_ITEM_INT if possible
     bool                forceMissionItemInt = (_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_MISSION_INT) && _vehicle->apmFirmware();
@@ -551,10 +612,10 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message, bool m
                                                &messageOut,
                                                _vehicle->id(),
                                                MAV_COMP_ID_AUTOPILOT1,
-                                               missionRequestSeq,
+                                               sequenceNumber,
                                                item->frame(),
                                                item->command(),
-                                               missionRequestSeq == 0,
+                                               sequenceNumber == 0,
                                                item->autoContinue(),
                                                item->param1(),
                                                item->param2(),
@@ -571,10 +632,10 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message, bool m
                                            &messageOut,
                                            _vehicle->id(),
                                            MAV_COMP_ID_AUTOPILOT1,
-                                           missionRequestSeq,
+                                           sequenceNumber,
                                            item->frame(),
                                            item->command(),
-                                           missionRequestSeq == 0,
+                                           sequenceNumber == 0,
                                            item->autoContinue(),
                                            item->param1(),
                                            item->param2(),
@@ -587,7 +648,6 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message, bool m
     }
     
     _vehicle->sendMessageOnLinkThreadSafe(_dedicatedLink, messageOut);
-    _startAckTimeout(AckMissionRequest);
 }
 
 void PlanManager::_handleMissionAck(const mavlink_message_t& message)
@@ -976,12 +1036,24 @@ void PlanManager::_clearAndDeleteWriteMissionItems(void)
 
 void PlanManager::_connectToMavlink(void)
 {
-    connect(_vehicle, &Vehicle::mavlinkMessageReceived, this, &PlanManager::_mavlinkMessageReceived);
+    static const QList<int> msgIds = {
+        MAVLINK_MSG_ID_MISSION_COUNT,
+        MAVLINK_MSG_ID_MISSION_ITEM,
+        MAVLINK_MSG_ID_MISSION_ITEM_INT,
+        MAVLINK_MSG_ID_MISSION_REQUEST,
+        MAVLINK_MSG_ID_MISSION_REQUEST_INT,
+        MAVLINK_MSG_ID_MISSION_ACK,
+    };
+
+    _disconnectFromMavlink();
+    _messageHandlerIds = _vehicle->messageDispatcher()->registerHandler(this, MAVLinkMessageDispatcher::anyId, MAVLinkMessageDispatcher::anyId, msgIds,
+                                                                        [this](LinkInterface* /*link*/, const mavlink_message_t& message) { _mavlinkMessageReceived(message); });
 }
 
 void PlanManager::_disconnectFromMavlink(void)
 {
-    disconnect(_vehicle, &Vehicle::mavlinkMessageReceived, this, &PlanManager::_mavlinkMessageReceived);
+    _vehicle->messageDispatcher()->unregisterHandlers(_messageHandlerIds);
+    _messageHandlerIds.clear();
 }
 
 QString PlanManager::_planTypeString(void)
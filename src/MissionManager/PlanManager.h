@@ -57,6 +57,12 @@ public:
     ///     Signals removeAllComplete when done
     void removeAll(void);
 
+    /// Number of mission items kept in flight during transfers. 1 is the lock step protocol, larger windows
+    /// require a vehicle which tolerates several outstanding requests and unrequested items.
+    ///     @param transferWindow 0: Use the firmware plugin default
+    void setTransferWindow(int transferWindow) { _transferWindow = transferWindow; }
+    int  transferWindow(void) const { return _transferWindow; }
+
     /// Error codes returned in error signal
     typedef enum {
         InternalError,
@@ -118,6 +124,9 @@ protected:
     void _handleMissionRequest(const mavlink_message_t& message, bool missionItemInt);
     void _handleMissionAck(const mavlink_message_t& message);
     void _requestNextMissionItem(void);
+    void _sendMissionRequest(int sequenceNumber);
+    void _sendMissionItem(int sequenceNumber, bool missionItemInt);
+    void _startTransferWindow(void);
     void _clearMissionItems(void);
     void _sendError(ErrorCode_t errorCode, const QString& errorMsg);
     QString _ackTypeToString(AckType_t ackType);
@@ -136,6 +145,7 @@ protected:
 
 protected:
     Vehicle*            _vehicle =              nullptr;
+    QList<int>          _messageHandlerIds;     ///< Registrations with the vehicle message dispatcher while connected
     MissionCommandTree* _missionCommandTree =   nullptr;
     MAV_MISSION_TYPE    _planType;
     LinkInterface*      _dedicatedLink =        nullptr;
@@ -150,6 +160,9 @@ protected:
     QList<int>          _itemIndicesToRead;     ///< List of mission items which still need to be requested from vehicle
     int                 _lastMissionRequest;    ///< Index of item last requested by MISSION_REQUEST
     int                 _missionItemCountToRead;///< Count of all mission items to read
+    int                 _transferWindow =       0;  ///< Requested window, 0 for firmware plugin default
+    int                 _activeTransferWindow = 1;  ///< Window used by the transaction in progress
+    QList<int>          _itemIndicesInFlight;   ///< Items requested from the vehicle which have not arrived yet, in request order
 
     QList<MissionItem*> _missionItems;          ///< Set of mission items on vehicle
     QList<MissionItem*> _writeMissionItems;     ///< Set of mission items currently being written to vehicle
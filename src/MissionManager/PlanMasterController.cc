@@ -335,10 +335,9 @@ void PlanMasterController::loadFromFile(const QString& filename)
 
     bool success = false;
     if(fileInfo.suffix() == AppSettings::planFileExtension) {
-        QJsonDocument   jsonDoc;
-        QByteArray      bytes = file.readAll();
+        QJsonDocument jsonDoc;
 
-        if (!JsonHelper::isJsonFile(bytes, jsonDoc, errorString)) {
+        if (!JsonHelper::isJsonFile(file, jsonDoc, errorString)) {
             qgcApp()->showAppMessage(errorMessage.arg(errorString));
             return;
         }
@@ -28,6 +28,8 @@ FactMetaData* SimpleMissionItem::_frameMetaData =           nullptr;
 FactMetaData* SimpleMissionItem::_latitudeMetaData =        nullptr;
 FactMetaData* SimpleMissionItem::_longitudeMetaData =       nullptr;
 
+QHash<QString, FactMetaData*> SimpleMissionItem::_paramMetaDataCache;
+
 const char* SimpleMissionItem::_jsonAltitudeModeKey =           "AltitudeMode";
 const char* SimpleMissionItem::_jsonAltitudeKey =               "Altitude";
 const char* SimpleMissionItem::_jsonAMSLAltAboveTerrainKey =    "AMSLAltAboveTerrain";
@@ -58,13 +60,6 @@ SimpleMissionItem::SimpleMissionItem(PlanMasterController* masterController, boo
     , _supportedCommandFact             (0, "Command:",             FactMetaData::valueTypeUint32)
     , _altitudeFact                     (0, "Altitude",             FactMetaData::valueTypeDouble)
     , _amslAltAboveTerrainFact          (0, "Alt above terrain",    FactMetaData::valueTypeDouble)
-    , _param1MetaData                   (FactMetaData::valueTypeDouble)
-    , _param2MetaData                   (FactMetaData::valueTypeDouble)
-    , _param3MetaData                   (FactMetaData::valueTypeDouble)
-    , _param4MetaData                   (FactMetaData::valueTypeDouble)
-    , _param5MetaData                   (FactMetaData::valueTypeDouble)
-    , _param6MetaData                   (FactMetaData::valueTypeDouble)
-    , _param7MetaData                   (FactMetaData::valueTypeDouble)
 {
     _editorQml = QStringLiteral("qrc:/qml/SimpleItemEditor.qml");
 
@@ -87,13 +82,6 @@ SimpleMissionItem::SimpleMissionItem(PlanMasterController* masterController, boo
     , _supportedCommandFact     (0,         "Command:",             FactMetaData::valueTypeUint32)
     , _altitudeFact             (0,         "Altitude",             FactMetaData::valueTypeDouble)
     , _amslAltAboveTerrainFact  (0,         "Alt above terrain",    FactMetaData::valueTypeDouble)
-    , _param1MetaData           (FactMetaData::valueTypeDouble)
-    , _param2MetaData           (FactMetaData::valueTypeDouble)
-    , _param3MetaData           (FactMetaData::valueTypeDouble)
-    , _param4MetaData           (FactMetaData::valueTypeDouble)
-    , _param5MetaData           (FactMetaData::valueTypeDouble)
-    , _param6MetaData           (FactMetaData::valueTypeDouble)
-    , _param7MetaData           (FactMetaData::valueTypeDouble)
 {
     _editorQml = QStringLiteral("qrc:/qml/SimpleItemEditor.qml");
 
@@ -442,7 +430,6 @@ void SimpleMissionItem::_rebuildTextFieldFacts(void)
         }
 
         Fact*           rgParamFacts[7] =       { &_missionItem._param1Fact, &_missionItem._param2Fact, &_missionItem._param3Fact, &_missionItem._param4Fact, &_missionItem._param5Fact, &_missionItem._param6Fact, &_missionItem._param7Fact };
-        FactMetaData*   rgParamMetaData[7] =    { &_param1MetaData, &_param2MetaData, &_param3MetaData, &_param4MetaData, &_param5MetaData, &_param6MetaData, &_param7MetaData };
 
         const MissionCommandUIInfo* uiInfo = _commandTree->getUIInfo(_controllerVehicle, command);
 
@@ -451,13 +438,10 @@ void SimpleMissionItem::_rebuildTextFieldFacts(void)
             const MissionCmdParamInfo* paramInfo = uiInfo->getParamInfo(i, showUI);
 
             if (showUI && paramInfo && paramInfo->enumStrings().count() == 0 && !paramInfo->nanUnchanged()) {
-                Fact*               paramFact =     rgParamFacts[i-1];
-                FactMetaData*       paramMetaData = rgParamMetaData[i-1];
+                Fact* paramFact = rgParamFacts[i-1];
 
                 paramFact->_setName(paramInfo->label());
-                paramMetaData->setDecimalPlaces(paramInfo->decimalPlaces());
-                paramMetaData->setRawUnits(paramInfo->units());
-                paramFact->setMetaData(paramMetaData);
+                paramFact->setMetaData(_paramMetaData(paramInfo, false /* enumInfo */));
                 _textFieldFacts.append(paramFact);
             }
         }
@@ -481,7 +465,6 @@ void SimpleMissionItem::_rebuildNaNFacts(void)
         }
 
         Fact*           rgParamFacts[7] =       { &_missionItem._param1Fact, &_missionItem._param2Fact, &_missionItem._param3Fact, &_missionItem._param4Fact, &_missionItem._param5Fact, &_missionItem._param6Fact, &_missionItem._param7Fact };
-        FactMetaData*   rgParamMetaData[7] =    { &_param1MetaData, &_param2MetaData, &_param3MetaData, &_param4MetaData, &_param5MetaData, &_param6MetaData, &_param7MetaData };
 
         const MissionCommandUIInfo* uiInfo = _commandTree->getUIInfo(_controllerVehicle, command);
 
@@ -501,13 +484,10 @@ void SimpleMissionItem::_rebuildNaNFacts(void)
                     continue;
                 }
 
-                Fact*               paramFact =     rgParamFacts[i-1];
-                FactMetaData*       paramMetaData = rgParamMetaData[i-1];
+                Fact* paramFact = rgParamFacts[i-1];
 
                 paramFact->_setName(paramInfo->label());
-                paramMetaData->setDecimalPlaces(paramInfo->decimalPlaces());
-                paramMetaData->setRawUnits(paramInfo->units());
-                paramFact->setMetaData(paramMetaData);
+                paramFact->setMetaData(_paramMetaData(paramInfo, false /* enumInfo */));
                 _nanFacts.append(paramFact);
             }
         }
@@ -530,7 +510,6 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
         _comboboxFacts.append(&_missionItem._frameFact);
     } else {
         Fact*           rgParamFacts[7] =       { &_missionItem._param1Fact, &_missionItem._param2Fact, &_missionItem._param3Fact, &_missionItem._param4Fact, &_missionItem._param5Fact, &_missionItem._param6Fact, &_missionItem._param7Fact };
-        FactMetaData*   rgParamMetaData[7] =    { &_param1MetaData, &_param2MetaData, &_param3MetaData, &_param4MetaData, &_param5MetaData, &_param6MetaData, &_param7MetaData };
 
         MAV_CMD command;
         if (_homePositionSpecialCase) {
@@ -544,14 +523,10 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
             const MissionCmdParamInfo* paramInfo = _commandTree->getUIInfo(_controllerVehicle, command)->getParamInfo(i, showUI);
 
             if (showUI && paramInfo && paramInfo->enumStrings().count() != 0) {
-                Fact*               paramFact =     rgParamFacts[i-1];
-                FactMetaData*       paramMetaData = rgParamMetaData[i-1];
+                Fact* paramFact = rgParamFacts[i-1];
 
                 paramFact->_setName(paramInfo->label());
-                paramMetaData->setDecimalPlaces(paramInfo->decimalPlaces());
-                paramMetaData->setEnumInfo(paramInfo->enumStrings(), paramInfo->enumValues());
-                paramMetaData->setRawUnits(paramInfo->units());
-                paramFact->setMetaData(paramMetaData);
+                paramFact->setMetaData(_paramMetaData(paramInfo, true /* enumInfo */));
                 _comboboxFacts.append(paramFact);
             }
         }
@@ -560,9 +535,55 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
 
 void SimpleMissionItem::_rebuildFacts(void)
 {
-    _rebuildTextFieldFacts();
-    _rebuildNaNFacts();
-    _rebuildComboBoxFacts();
+    if (_factsBuilt) {
+        _rebuildTextFieldFacts();
+        _rebuildNaNFacts();
+        _rebuildComboBoxFacts();
+    }
+}
+
+void SimpleMissionItem::_buildFacts(void)
+{
+    if (!_factsBuilt) {
+        _factsBuilt = true;
+        _rebuildFacts();
+    }
+}
+
+FactMetaData* SimpleMissionItem::_paramMetaData(const MissionCmdParamInfo* paramInfo, bool enumInfo)
+{
+    // Most items use the same handful of param definitions, so items share a single read only copy of each. The unit
+    // translators are picked from the unit settings when the meta data is created, so the settings are part of the key.
+    // Once they change new items get new meta data, the old entries stay valid for the items still using them.
+    UnitsSettings* unitsSettings = qgcApp()->toolbox()->settingsManager()->unitsSettings();
+    QString key = QStringLiteral("%1,%2,%3,%4,%5,%6|%7|%8")
+            .arg(unitsSettings->horizontalDistanceUnits()->rawValue().toInt())
+            .arg(unitsSettings->verticalDistanceUnits()->rawValue().toInt())
+            .arg(unitsSettings->areaUnits()->rawValue().toInt())
+            .arg(unitsSettings->speedUnits()->rawValue().toInt())
+            .arg(unitsSettings->temperatureUnits()->rawValue().toInt())
+            .arg(unitsSettings->weightUnits()->rawValue().toInt())
+            .arg(paramInfo->decimalPlaces())
+            .arg(paramInfo->units());
+    if (enumInfo) {
+        key += QStringLiteral("|%1").arg(paramInfo->enumStrings().join(QStringLiteral(",")));
+        for (const QVariant& enumValue: paramInfo->enumValues()) {
+            key += QStringLiteral(",%1").arg(enumValue.toString());
+        }
+    }
+
+    FactMetaData* metaData = _paramMetaDataCache.value(key);
+    if (!metaData) {
+        metaData = new FactMetaData(FactMetaData::valueTypeDouble);
+        metaData->setDecimalPlaces(paramInfo->decimalPlaces());
+        metaData->setRawUnits(paramInfo->units());
+        if (enumInfo) {
+            metaData->setEnumInfo(paramInfo->enumStrings(), paramInfo->enumValues());
+        }
+        _paramMetaDataCache[key] = metaData;
+    }
+
+    return metaData;
 }
 
 bool SimpleMissionItem::friendlyEditAllowed(void) const
@@ -18,6 +18,10 @@
 #include "SpeedSection.h"
 #include "QGroundControlQmlGlobal.h"
 
+#include <QHash>
+
+class MissionCmdParamInfo;
+
 /// A SimpleMissionItem is used to represent a single MissionItem to the ui.
 class SimpleMissionItem : public VisualMissionItem
 {
@@ -74,9 +78,10 @@ public:
     CameraSection*  cameraSection       (void) { return _cameraSection; }
     SpeedSection*   speedSection        (void) { return _speedSection; }
 
-    QmlObjectListModel* textFieldFacts  (void) { return &_textFieldFacts; }
-    QmlObjectListModel* nanFacts        (void) { return &_nanFacts; }
-    QmlObjectListModel* comboboxFacts   (void) { return &_comboboxFacts; }
+    // The editor Facts are only built once they are asked for, which for most items in a large mission is never
+    QmlObjectListModel* textFieldFacts  (void) { _buildFacts(); return &_textFieldFacts; }
+    QmlObjectListModel* nanFacts        (void) { _buildFacts(); return &_nanFacts; }
+    QmlObjectListModel* comboboxFacts   (void) { _buildFacts(); return &_comboboxFacts; }
 
     void setRawEdit(bool rawEdit);
     void setAltitudeMode(QGroundControlQmlGlobal::AltitudeMode altitudeMode);
@@ -160,6 +165,9 @@ private:
     void _updateOptionalSections(void);
     void _rebuildNaNFacts       (void);
     void _rebuildComboBoxFacts  (void);
+    void _buildFacts            (void);
+
+    static FactMetaData* _paramMetaData(const MissionCmdParamInfo* paramInfo, bool enumInfo);
 
     MissionItem     _missionItem;
     bool            _rawEdit =                  false;
@@ -181,6 +189,7 @@ private:
     QmlObjectListModel  _textFieldFacts;
     QmlObjectListModel  _nanFacts;
     QmlObjectListModel  _comboboxFacts;
+    bool                _factsBuilt = false;    ///< true: editor Facts have been asked for and are kept up to date
     
     static FactMetaData*    _altitudeMetaData;
     static FactMetaData*    _commandMetaData;
@@ -189,13 +198,7 @@ private:
     static FactMetaData*    _latitudeMetaData;
     static FactMetaData*    _longitudeMetaData;
 
-    FactMetaData    _param1MetaData;
-    FactMetaData    _param2MetaData;
-    FactMetaData    _param3MetaData;
-    FactMetaData    _param4MetaData;
-    FactMetaData    _param5MetaData;
-    FactMetaData    _param6MetaData;
-    FactMetaData    _param7MetaData;
+    static QHash<QString, FactMetaData*> _paramMetaDataCache;   ///< Param meta data shared by all items, keyed by its contents and the unit settings
 
     static const char* _jsonAltitudeModeKey;
     static const char* _jsonAltitudeKey;
@@ -163,6 +163,41 @@ void SimpleMissionItemTest::_testEditorFacts(void)
     }
 }
 
+void SimpleMissionItemTest::_testEditorFactsUnits(void)
+{
+    PlanMasterController    fwMasterController(MAV_AUTOPILOT_PX4, MAV_TYPE_FIXED_WING);
+    Fact*                   horizontalUnits = qgcApp()->toolbox()->settingsManager()->unitsSettings()->horizontalDistanceUnits();
+    QVariant                savedUnits      = horizontalUnits->rawValue();
+    MissionItem             missionItem(1, MAV_CMD_NAV_LOITER_UNLIM, MAV_FRAME_GLOBAL, 10, 20, 30, 40, 50, 60, 70, true, false);
+
+    auto radiusFact = [](SimpleMissionItem& item) -> Fact* {
+        for (int i=0; i<item.textFieldFacts()->count(); i++) {
+            Fact* fact = qobject_cast<Fact*>(item.textFieldFacts()->get(i));
+            if (fact->rawUnits() == QStringLiteral("m")) {
+                return fact;
+            }
+        }
+        return nullptr;
+    };
+
+    // Param meta data is shared between items, items built after a units change must still get the new units
+    horizontalUnits->setRawValue(UnitsSettings::HorizontalDistanceUnitsMeters);
+    SimpleMissionItem metersItem(&fwMasterController, false /* flyView */, missionItem, nullptr);
+    Fact* metersRadius = radiusFact(metersItem);
+
+    horizontalUnits->setRawValue(UnitsSettings::HorizontalDistanceUnitsFeet);
+    SimpleMissionItem feetItem(&fwMasterController, false /* flyView */, missionItem, nullptr);
+    Fact* feetRadius = radiusFact(feetItem);
+
+    horizontalUnits->setRawValue(savedUnits);
+
+    QVERIFY(metersRadius);
+    QVERIFY(feetRadius);
+    QCOMPARE(metersRadius->cookedUnits(), QStringLiteral("m"));
+    QCOMPARE(feetRadius->cookedUnits(), QStringLiteral("ft"));
+    QCOMPARE(feetRadius->rawValue().toDouble(), metersRadius->rawValue().toDouble());
+}
+
 void SimpleMissionItemTest::_testDefaultValues(void)
 {
     SimpleMissionItem item(_masterController, false /* flyView */, false /* forLoad */, nullptr);
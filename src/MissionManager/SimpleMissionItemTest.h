@@ -26,6 +26,7 @@ public:
 private slots:
     void _testSignals(void);
     void _testEditorFacts(void);
+    void _testEditorFactsUnits(void);
     void _testDefaultValues(void);
     void _testCameraSectionDirty(void);
     void _testSpeedSectionDirty(void);
@@ -19,6 +19,7 @@
 #include "QGCApplication.h"
 
 #include <QPolygonF>
+#include <QtConcurrent>
 
 QGC_LOGGING_CATEGORY(SurveyComplexItemLog, "SurveyComplexItemLog")
 
@@ -71,6 +72,7 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     , _flyAlternateTransectsFact(settingsGroup, _metaDataMap[flyAlternateTransectsName])
     , _splitConcavePolygonsFact (settingsGroup, _metaDataMap[splitConcavePolygonsName])
     , _entryPoint               (EntryLocationTopLeft)
+    , _threadedTransects        (!qgcApp()->runningUnitTests())
 {
     _editorQml = "qrc:/qml/SurveyItemEditor.qml";
 
@@ -104,6 +106,8 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::isValidChanged,             this, &SurveyComplexItem::_updateWizardMode);
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::traceModeChanged,           this, &SurveyComplexItem::_updateWizardMode);
 
+    connect(&_transectsWatcher,         &QFutureWatcher<Transects_t>::finished,     this, &SurveyComplexItem::_transectsJobFinished);
+
     if (!kmlOrShpFile.isEmpty()) {
         _surveyAreaPolygon.loadKMLOrSHPFile(kmlOrShpFile);
         _surveyAreaPolygon.setDirty(false);
@@ -111,6 +115,20 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     setDirty(false);
 }
 
+SurveyComplexItem::~SurveyComplexItem()
+{
+    // A running job only works on its own snapshot, so it is safe to let it finish on its own
+    _cancelTransectsJob();
+}
+
+void SurveyComplexItem::setThreadedTransects(bool threadedTransects)
+{
+    if (!threadedTransects) {
+        _waitForTransects();
+    }
+    _threadedTransects = threadedTransects;
+}
+
 void SurveyComplexItem::save(QJsonArray&  planItems)
 {
     QJsonObject saveObject;
@@ -156,6 +174,9 @@ void SurveyComplexItem::loadPreset(const QString& name)
 
 bool SurveyComplexItem::load(const QJsonObject& complexObject, int sequenceNumber, QString& errorString)
 {
+    // Transects from a job started before the load are stale
+    _cancelTransectsJob();
+
     // We need to pull version first to determine what validation/conversion needs to be performed
     QList<JsonHelper::KeyValidateInfo> versionKeyInfoList = {
         { JsonHelper::jsonVersionKey, QJsonValue::Double, true },
@@ -469,7 +490,7 @@ bool SurveyComplexItem::_gridAngleIsNorthSouthTransects()
     return gridAngle < 45.0 || (gridAngle > 360.0 - 45.0) || (gridAngle > 90.0 + 45.0 && gridAngle < 270.0 - 45.0);
 }
 
-void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects)
+void SurveyComplexItem::_adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects)
 {
     if (transects.count() == 0) {
         return;
@@ -478,10 +499,10 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
     bool reversePoints = false;
     bool reverseTransects = false;
 
-    if (_entryPoint == EntryLocationBottomLeft || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationBottomLeft || entryPoint == EntryLocationBottomRight) {
         reversePoints = true;
     }
-    if (_entryPoint == EntryLocationTopRight || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationTopRight || entryPoint == EntryLocationBottomRight) {
         reverseTransects = true;
     }
 
@@ -494,7 +515,7 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
         _reverseTransectOrder(transects);
     }
 
-    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << _entryPoint;
+    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << entryPoint;
 }
 
 QPointF SurveyComplexItem::_rotatePoint(const QPointF& point, const QPointF& origin, double angle)
@@ -678,29 +699,47 @@ double SurveyComplexItem::_turnaroundDistance(void) const
     return _turnAroundDistanceFact.rawValue().toDouble();
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1(void)
+SurveyComplexItem::TransectParams_t SurveyComplexItem::_transectParams(void) const
 {
-    bool split = splitConcavePolygons()->rawValue().toBool();
-	if (split) {
-		_rebuildTransectsPhase1WorkerSplitPolygons(false /* refly */);
-	} else {
-		_rebuildTransectsPhase1WorkerSinglePolygon(false /* refly */);
-	}
-    if (_refly90DegreesFact.rawValue().toBool()) {
-    	if (split) {
-    		_rebuildTransectsPhase1WorkerSplitPolygons(true /* refly */);
-    	} else {
-    		_rebuildTransectsPhase1WorkerSinglePolygon(true /* refly */);
-    	}
-    }
+    TransectParams_t params;
+
+    params.polygon                  = _surveyAreaPolygon.coordinateList();
+    params.splitConcavePolygons     = _splitConcavePolygonsFact.rawValue().toBool();
+    params.refly90Degrees           = _refly90DegreesFact.rawValue().toBool();
+    params.gridAngle                = _gridAngleFact.rawValue().toDouble();
+    params.gridSpacing              = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    params.entryPoint               = _entryPoint;
+    params.flyAlternateTransects    = _flyAlternateTransectsFact.rawValue().toBool();
+    params.hoverAndCapture          = triggerCamera() && hoverAndCaptureEnabled();
+    params.triggerDistance          = triggerDistance();
+    params.turnAroundDistance       = _turnAroundDistanceFact.rawValue().toDouble();
+    params.cancelled                = QSharedPointer<QAtomicInt>::create(0);
+
+    return params;
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
+SurveyComplexItem::Transects_t SurveyComplexItem::_buildTransects(const TransectParams_t params)
 {
-    if (_ignoreRecalc) {
-        return;
+    Transects_t transects;
+
+    if (params.splitConcavePolygons) {
+        _rebuildTransectsPhase1WorkerSplitPolygons(params, false /* refly */, transects);
+    } else {
+        _rebuildTransectsPhase1WorkerSinglePolygon(params, false /* refly */, transects);
     }
+    if (params.refly90Degrees && !transects.isEmpty()) {
+        if (params.splitConcavePolygons) {
+            _rebuildTransectsPhase1WorkerSplitPolygons(params, true /* refly */, transects);
+        } else {
+            _rebuildTransectsPhase1WorkerSinglePolygon(params, true /* refly */, transects);
+        }
+    }
+
+    return transects;
+}
 
+void SurveyComplexItem::_applyTransects(const Transects_t& transects)
+{
     // If the transects are getting rebuilt then any previously loaded mission items are now invalid
     if (_loadedMissionItemsParent) {
         _loadedMissionItems.clear();
@@ -708,24 +747,83 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         _loadedMissionItemsParent = nullptr;
     }
 
-    // First pass will clear old transect data, refly will append to existing data
-    if (!refly) {
-        _transects.clear();
-        _transectsPathHeightInfo.clear();
+    _transects = transects;
+    _transectsPathHeightInfo.clear();
+}
+
+void SurveyComplexItem::_rebuildTransectsPhase1(void)
+{
+    if (_ignoreRecalc) {
+        return;
+    }
+
+    _applyTransects(_buildTransects(_transectParams()));
+}
+
+void SurveyComplexItem::_rebuildTransects(void)
+{
+    if (!_threadedTransects) {
+        TransectStyleComplexItem::_rebuildTransects();
+        return;
+    }
+
+    if (_ignoreRecalc) {
+        return;
+    }
+
+    // Only the newest job is of interest. The old one stops at its next cancel check and since the watcher moves
+    // on to the new job its result is never applied.
+    _cancelTransectsJob();
+
+    TransectParams_t params = _transectParams();
+    _transectsJobCancelled = params.cancelled;
+    _transectsJobPending = true;
+    _transectsWatcher.setFuture(QtConcurrent::run(&SurveyComplexItem::_buildTransects, params));
+}
+
+void SurveyComplexItem::_cancelTransectsJob(void)
+{
+    if (_transectsJobCancelled) {
+        _transectsJobCancelled->storeRelease(1);
+        _transectsJobCancelled.clear();
     }
+    _transectsJobPending = false;
+}
 
-    if (_surveyAreaPolygon.count() < 3) {
+void SurveyComplexItem::_transectsJobFinished(void)
+{
+    if (!_transectsJobPending || !_transectsWatcher.isFinished()) {
+        return;
+    }
+    _transectsJobPending = false;
+    _transectsJobCancelled.clear();
+
+    _applyTransects(_transectsWatcher.result());
+    _rebuildTransectsPhase2();
+}
+
+void SurveyComplexItem::_waitForTransects(void)
+{
+    if (_transectsJobPending) {
+        _transectsWatcher.waitForFinished();
+        _transectsJobFinished();
+    }
+}
+
+void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(const TransectParams_t& params, bool refly, Transects_t& transectsOut)
+{
+    if (params.polygon.count() < 3) {
         return;
     }
 
     // Convert polygon to NED
 
     QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
+    QGeoCoordinate tangentOrigin = params.polygon[0];
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - polygon.count():tangentOrigin" << params.polygon.count() << tangentOrigin;
+    for (int i=0; i<params.polygon.count(); i++) {
         double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
+        QGeoCoordinate vertex = params.polygon[i];
         if (i == 0) {
             // This avoids a nan calculation that comes out of convertGeoToNed
             x = y = 0;
@@ -738,8 +836,8 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
 
     // Generate transects
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    double gridAngle = params.gridAngle;
+    double gridSpacing = params.gridSpacing;
     if (gridSpacing < 0.5) {
         // We can't let gridSpacing get too small otherwise we will end up with too many transects.
         // So we limit to 0.5 meter spacing as min and set to huge value which will cause a single
@@ -779,6 +877,10 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     double transectX = boundingCenter.x() - halfWidth;
     double transectXMax = transectX + maxWidth;
     while (transectX < transectXMax) {
+        if (params.cancelled->loadAcquire()) {
+            return;
+        }
+
         double transectYTop = boundingCenter.y() - halfWidth;
         double transectYBottom = boundingCenter.y() + halfWidth;
 
@@ -799,7 +901,6 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -829,13 +930,13 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects.append(transect);
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(params.entryPoint, transects);
 
     if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+        _optimizeTransectsForShortestDistance(transectsOut.last().last().coord, transects);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
+    if (params.flyAlternateTransects) {
         QList<QList<QGeoCoordinate>> alternatingTransects;
         for (int i=0; i<transects.count(); i++) {
             if (!(i & 1)) {
@@ -868,7 +969,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects[i] = transectVertices;
     }
 
-    // Convert to CoordInfo transects and append to _transects
+    // Convert to CoordInfo transects and append to the output transects
     for (const QList<QGeoCoordinate>& transect : transects) {
         QGeoCoordinate                                  coord;
         QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
@@ -880,14 +981,14 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         coordInfoTransect.append(coordInfo);
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
+        if (params.hoverAndCapture) {
             double transectLength = transect[0].distanceTo(transect[1]);
             double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+            if (params.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / params.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
                 for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
+                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(params.triggerDistance * (i + 1), transectAzimuth);
                     TransectStyleComplexItem::CoordInfo_t coordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
                     coordInfoTransect.insert(1 + i, coordInfo);
                 }
@@ -895,9 +996,9 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (params.turnAroundDistance > 0) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+            double turnAroundDistance = params.turnAroundDistance;
 
             double azimuth = transect[0].azimuthTo(transect[1]);
             turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -912,42 +1013,25 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
             coordInfoTransect.append(coordInfo);
         }
 
-        _transects.append(coordInfoTransect);
+        transectsOut.append(coordInfoTransect);
     }
 }
 
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
+void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(const TransectParams_t& params, bool refly, Transects_t& transects)
 {
-    if (_ignoreRecalc) {
-        return;
-    }
-
-    // If the transects are getting rebuilt then any previously loaded mission items are now invalid
-    if (_loadedMissionItemsParent) {
-        _loadedMissionItems.clear();
-        _loadedMissionItemsParent->deleteLater();
-        _loadedMissionItemsParent = nullptr;
-    }
-
-    // First pass will clear old transect data, refly will append to existing data
-    if (!refly) {
-        _transects.clear();
-        _transectsPathHeightInfo.clear();
-    }
-
-    if (_surveyAreaPolygon.count() < 3) {
+    if (params.polygon.count() < 3) {
         return;
     }
 
     // Convert polygon to NED
 
     QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
+    QGeoCoordinate tangentOrigin = params.polygon[0];
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - polygon.count():tangentOrigin" << params.polygon.count() << tangentOrigin;
+    for (int i=0; i<params.polygon.count(); i++) {
         double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
+        QGeoCoordinate vertex = params.polygon[i];
         if (i == 0) {
             // This avoids a nan calculation that comes out of convertGeoToNed
             x = y = 0;
@@ -967,10 +1051,14 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
 
     // Create list of separate polygons
     QList<QPolygonF> polygons{};
-    _PolygonDecomposeConvex(polygon, polygons);
+    _PolygonDecomposeConvex(polygon, polygons, *params.cancelled);
 
     // iterate over polygons
     for (auto p = polygons.begin(); p != polygons.end(); ++p) {
+        if (params.cancelled->loadAcquire()) {
+            return;
+        }
+
         QPointF* vMatch = nullptr;
         // find matching vertex in previous polygon
         if (p != polygons.begin()) {
@@ -994,11 +1082,11 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
         // TODO figure out tangent origin
         // TODO improve selection of entry points
 //        qCDebug(SurveyComplexItemLog) << "Transects from polynom p " << p;
-        _rebuildTransectsFromPolygon(refly, *p, tangentOrigin, vMatch);
+        _rebuildTransectsFromPolygon(params, refly, *p, tangentOrigin, vMatch, transects);
     }
 }
 
-void SurveyComplexItem::_PolygonDecomposeConvex(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons)
+void SurveyComplexItem::_PolygonDecomposeConvex(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons, const QAtomicInt& cancelled)
 {
 	// this follows "Mark Keil's Algorithm" https://mpen.ca/406/keil
     int decompSize = std::numeric_limits<int>::max();
@@ -1012,6 +1100,11 @@ void SurveyComplexItem::_PolygonDecomposeConvex(const QPolygonF& polygon, QList<
 
     for (auto vertex = polygon.begin(); vertex != polygon.end(); ++vertex)
     {
+        if (cancelled.loadAcquire()) {
+            // Result is thrown away, anything will do
+            break;
+        }
+
         // is vertex reflex?
         bool vertexIsReflex = _VertexIsReflex(polygon, vertex);
 
@@ -1062,10 +1155,10 @@ void SurveyComplexItem::_PolygonDecomposeConvex(const QPolygonF& polygon, QList<
 
             // recursion
             QList<QPolygonF> polyLeftDecomposed{};
-            _PolygonDecomposeConvex(polyLeft, polyLeftDecomposed);
+            _PolygonDecomposeConvex(polyLeft, polyLeftDecomposed, cancelled);
 
             QList<QPolygonF> polyRightDecomposed{};
-            _PolygonDecomposeConvex(polyRight, polyRightDecomposed);
+            _PolygonDecomposeConvex(polyRight, polyRightDecomposed, cancelled);
 
             // compositon
             auto subSize = polyLeftDecomposed.size() + polyRightDecomposed.size();
@@ -1150,12 +1243,12 @@ bool SurveyComplexItem::_VertexIsReflex(const QPolygonF& polygon, const QPointF*
 }
 
 
-void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint)
+void SurveyComplexItem::_rebuildTransectsFromPolygon(const TransectParams_t& params, bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint, Transects_t& transectsOut)
 {
     // Generate transects
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    double gridAngle = params.gridAngle;
+    double gridSpacing = params.gridSpacing;
 
     gridAngle = _clampGridAngle90(gridAngle);
     gridAngle += refly ? 90 : 0;
@@ -1183,6 +1276,10 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
     double transectX = boundingCenter.x() - halfWidth;
     double transectXMax = transectX + maxWidth;
     while (transectX < transectXMax) {
+        if (params.cancelled->loadAcquire()) {
+            return;
+        }
+
         double transectYTop = boundingCenter.y() - halfWidth;
         double transectYBottom = boundingCenter.y() + halfWidth;
 
@@ -1203,7 +1300,6 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -1243,13 +1339,13 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         transects.append(transect);
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(params.entryPoint, transects);
 
     if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+        _optimizeTransectsForShortestDistance(transectsOut.last().last().coord, transects);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
+    if (params.flyAlternateTransects) {
         QList<QList<QGeoCoordinate>> alternatingTransects;
         for (int i=0; i<transects.count(); i++) {
             if (!(i & 1)) {
@@ -1282,7 +1378,7 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         transects[i] = transectVertices;
     }
 
-    // Convert to CoordInfo transects and append to _transects
+    // Convert to CoordInfo transects and append to the output transects
     for (const QList<QGeoCoordinate>& transect: transects) {
         QGeoCoordinate                                  coord;
         QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
@@ -1294,14 +1390,14 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         coordInfoTransect.append(coordInfo);
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
+        if (params.hoverAndCapture) {
             double transectLength = transect[0].distanceTo(transect[1]);
             double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+            if (params.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / params.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
                 for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
+                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(params.triggerDistance * (i + 1), transectAzimuth);
                     TransectStyleComplexItem::CoordInfo_t coordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
                     coordInfoTransect.insert(1 + i, coordInfo);
                 }
@@ -1309,9 +1405,9 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (params.turnAroundDistance > 0) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+            double turnAroundDistance = params.turnAroundDistance;
 
             double azimuth = transect[0].azimuthTo(transect[1]);
             turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -1326,9 +1422,9 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
             coordInfoTransect.append(coordInfo);
         }
 
-        _transects.append(coordInfoTransect);
+        transectsOut.append(coordInfoTransect);
     }
-    qCDebug(SurveyComplexItemLog) << "_transects.size() " << _transects.size();
+    qCDebug(SurveyComplexItemLog) << "transects.size() " << transectsOut.size();
 }
 
 void SurveyComplexItem::_recalcCameraShots(void)
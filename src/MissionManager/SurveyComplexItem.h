@@ -14,6 +14,10 @@
 #include "SettingsFact.h"
 #include "QGCLoggingCategory.h"
 
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QAtomicInt>
+
 Q_DECLARE_LOGGING_CATEGORY(SurveyComplexItemLog)
 
 class PlanMasterController;
@@ -26,6 +30,7 @@ public:
     /// @param flyView true: Created for use in the Fly View, false: Created for use in the Plan View
     /// @param kmlOrShpFile Polygon comes from this file, empty for default polygon
     SurveyComplexItem(PlanMasterController* masterController, bool flyView, const QString& kmlOrShpFile, QObject* parent);
+    ~SurveyComplexItem();
 
     Q_PROPERTY(Fact* gridAngle              READ gridAngle              CONSTANT)
     Q_PROPERTY(Fact* flyAlternateTransects  READ flyAlternateTransects  CONSTANT)
@@ -37,6 +42,11 @@ public:
 
     Q_INVOKABLE void rotateEntryPoint(void);
 
+    /// true: Transects are built on a worker thread and applied once done, false: Transects are built synchronously.
+    /// Defaults to true, except when running unit tests.
+    bool threadedTransects      (void) const { return _threadedTransects; }
+    void setThreadedTransects   (bool threadedTransects);
+
     // Overrides from ComplexMissionItem
     QString patternName         (void) const final { return name; }
     bool    load                (const QJsonObject& complexObject, int sequenceNumber, QString& errorString) final;
@@ -83,8 +93,10 @@ signals:
 
 private slots:
     void _updateWizardMode              (void);
+    void _transectsJobFinished          (void);
 
     // Overrides from TransectStyleComplexItem
+    void _rebuildTransects              (void) final;
     void _rebuildTransectsPhase1        (void) final;
     void _recalcCameraShots             (void) final;
 
@@ -96,21 +108,39 @@ private:
         CameraTriggerHoverAndCapture
     };
 
-    QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
-    void _intersectLinesWithRect(const QList<QLineF>& lineList, const QRectF& boundRect, QList<QLineF>& resultLines);
-    void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
-    void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
+    typedef QList<QList<CoordInfo_t>> Transects_t;
+
+    /// Snapshot of everything transect generation depends on. Transects are built from this alone so they can be built
+    /// on a worker thread while the item continues to be edited.
+    typedef struct {
+        QList<QGeoCoordinate>       polygon;
+        bool                        splitConcavePolygons;
+        bool                        refly90Degrees;
+        double                      gridAngle;
+        double                      gridSpacing;
+        int                         entryPoint;
+        bool                        flyAlternateTransects;
+        bool                        hoverAndCapture;        ///< true: camera triggers and hover and capture is enabled
+        double                      triggerDistance;
+        double                      turnAroundDistance;
+        QSharedPointer<QAtomicInt>  cancelled;              ///< Set to non-zero once a newer job replaces this one
+    } TransectParams_t;
+
+    static QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
+    static void _intersectLinesWithRect(const QList<QLineF>& lineList, const QRectF& boundRect, QList<QLineF>& resultLines);
+    static void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
+    static void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
     bool _nextTransectCoord(const QList<QGeoCoordinate>& transectPoints, int pointIndex, QGeoCoordinate& coord);
     bool _appendMissionItemsWorker(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, bool hasRefly, bool buildRefly);
-    void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
-    qreal _ccw(QPointF pt1, QPointF pt2, QPointF pt3);
-    qreal _dp(QPointF pt1, QPointF pt2);
-    void _swapPoints(QList<QPointF>& points, int index1, int index2);
-    void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
-    void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
-    void _adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects);
+    static void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
+    static qreal _ccw(QPointF pt1, QPointF pt2, QPointF pt3);
+    static qreal _dp(QPointF pt1, QPointF pt2);
+    static void _swapPoints(QList<QPointF>& points, int index1, int index2);
+    static void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
+    static void _adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects);
     bool _gridAngleIsNorthSouthTransects();
-    double _clampGridAngle90(double gridAngle);
+    static double _clampGridAngle90(double gridAngle);
     bool _imagesEverywhere(void) const;
     bool _triggerCamera(void) const;
     bool _hasTurnaround(void) const;
@@ -119,16 +149,21 @@ private:
     bool _loadV3(const QJsonObject& complexObject, int sequenceNumber, QString& errorString);
     bool _loadV4V5(const QJsonObject& complexObject, int sequenceNumber, QString& errorString, int version, bool forPresets);
     void _saveWorker(QJsonObject& complexObject);
-    void _rebuildTransectsPhase1Worker(bool refly);
-    void _rebuildTransectsPhase1WorkerSinglePolygon(bool refly);
-    void _rebuildTransectsPhase1WorkerSplitPolygons(bool refly);
-    /// Adds to the _transects array from one polygon
-    void _rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint);
+    TransectParams_t _transectParams(void) const;
+    void _cancelTransectsJob(void);
+    void _applyTransects(const Transects_t& transects);
+    void _waitForTransects(void) final;
+    /// Builds all transects from the snapshot. Safe to call from any thread.
+    static Transects_t _buildTransects(const TransectParams_t params);
+    static void _rebuildTransectsPhase1WorkerSinglePolygon(const TransectParams_t& params, bool refly, Transects_t& transects);
+    static void _rebuildTransectsPhase1WorkerSplitPolygons(const TransectParams_t& params, bool refly, Transects_t& transects);
+    /// Adds to the transects array from one polygon
+    static void _rebuildTransectsFromPolygon(const TransectParams_t& params, bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint, Transects_t& transects);
     // Decompose polygon into list of convex sub polygons
-    void _PolygonDecomposeConvex(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons);
+    static void _PolygonDecomposeConvex(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons, const QAtomicInt& cancelled);
     // return true if vertex a can see vertex b
-    bool _VertexCanSeeOther(const QPolygonF& polygon, const QPointF* vertexA, const QPointF* vertexB);
-    bool _VertexIsReflex(const QPolygonF& polygon, const QPointF* vertex);
+    static bool _VertexCanSeeOther(const QPolygonF& polygon, const QPointF* vertexA, const QPointF* vertexB);
+    static bool _VertexIsReflex(const QPolygonF& polygon, const QPointF* vertex);
 
     QMap<QString, FactMetaData*> _metaDataMap;
 
@@ -137,6 +172,11 @@ private:
     SettingsFact    _splitConcavePolygonsFact;
     int             _entryPoint;
 
+    bool                        _threadedTransects;
+    QFutureWatcher<Transects_t> _transectsWatcher;
+    QSharedPointer<QAtomicInt>  _transectsJobCancelled;     ///< Cancel flag of the job _transectsWatcher is watching
+    bool                        _transectsJobPending =  false;
+
     static const char* _jsonGridAngleKey;
     static const char* _jsonEntryPointKey;
     static const char* _jsonFlyAlternateTransectsKey;
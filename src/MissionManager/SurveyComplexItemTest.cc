@@ -351,3 +351,40 @@ void SurveyComplexItemTest::_testHoverCaptureItemGeneration(void)
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, true /* useConditionGate */, expectedCommands);
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, false /* useConditionGate */, expectedCommands);
 }
+
+void SurveyComplexItemTest::_testThreadedTransects(void)
+{
+    // Build the expected transects synchronously
+    _surveyItem->refly90Degrees()->setRawValue(true);
+    _surveyItem->gridAngle()->setRawValue(45);
+    QVariantList expectedPoints = _surveyItem->visualTransectPoints();
+    _surveyItem->gridAngle()->setRawValue(0);
+
+    _surveyItem->setThreadedTransects(true);
+    QSignalSpy spyTransects(_surveyItem, &SurveyComplexItem::visualTransectPointsChanged);
+
+    // Rapid edits: every edit replaces the previous job and only the newest one is applied
+    for (int gridAngle=5; gridAngle<=45; gridAngle+=5) {
+        _surveyItem->gridAngle()->setRawValue(gridAngle);
+    }
+    QVERIFY(spyTransects.wait(10000));
+    QTest::qWait(100);
+    QCOMPARE(spyTransects.count(), 1);
+    QVariantList transectPoints = _surveyItem->visualTransectPoints();
+    QCOMPARE(transectPoints.count(), expectedPoints.count());
+    for (int i=0; i<transectPoints.count(); i++) {
+        QCOMPARE(transectPoints[i].value<QGeoCoordinate>(), expectedPoints[i].value<QGeoCoordinate>());
+    }
+
+    // Building mission items applies a pending job right away
+    spyTransects.clear();
+    _surveyItem->gridAngle()->setRawValue(0);
+    QList<MissionItem*> items;
+    _surveyItem->appendMissionItems(items, this);
+    QCOMPARE(spyTransects.count(), 1);
+    QCOMPARE(items.count() - 1, _surveyItem->lastSequenceNumber());
+    QTest::qWait(100);
+    QCOMPARE(spyTransects.count(), 1);
+
+    _surveyItem->setThreadedTransects(false);
+}
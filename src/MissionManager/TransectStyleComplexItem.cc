@@ -142,6 +142,8 @@ void TransectStyleComplexItem::setDirty(bool dirty)
 
 void TransectStyleComplexItem::_save(QJsonObject& complexObject)
 {
+    _waitForTransects();
+
     QJsonObject innerObject;
 
     innerObject[JsonHelper::jsonVersionKey] =       1;
@@ -380,7 +382,11 @@ void TransectStyleComplexItem::_rebuildTransects(void)
     }
 
     _rebuildTransectsPhase1();
+    _rebuildTransectsPhase2();
+}
 
+void TransectStyleComplexItem::_rebuildTransectsPhase2(void)
+{
     if (_followTerrain) {
         // Query the terrain data. Once available terrain heights will be calculated
         _queryTransectsPathHeightInfo();
@@ -924,6 +930,8 @@ void TransectStyleComplexItem::_handleHoverAndCaptureEnabled(QVariant enabled)
 
 void TransectStyleComplexItem::appendMissionItems(QList<MissionItem*>& items, QObject* missionItemParent)
 {
+    _waitForTransects();
+
     if (_loadedMissionItems.count()) {
         // We have mission items from the loaded plan, use those
         _appendLoadedMissionItems(items, missionItemParent);
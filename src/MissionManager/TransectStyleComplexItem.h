@@ -136,11 +136,14 @@ protected slots:
     void _setIfDirty                        (bool dirty);
     void _updateCoordinateAltitudes         (void);
     void _polyPathTerrainData               (bool success, const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo);
-    void _rebuildTransects                  (void);
+    virtual void _rebuildTransects          (void);
 
 protected:
     virtual void _rebuildTransectsPhase1    (void) = 0; ///< Rebuilds the _transects array
     virtual void _recalcCameraShots         (void) = 0;
+    virtual void _waitForTransects          (void) { }  ///< Derived classes which build _transects on a worker thread apply any pending result here
+
+    void    _rebuildTransectsPhase2         (void);     ///< Updates everything which is calculated from _transects
 
     void    _save                           (QJsonObject& saveObject);
     bool    _load                           (const QJsonObject& complexObject, bool forPresets, QString& errorString);
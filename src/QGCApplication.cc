@@ -352,6 +352,9 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
     // We need to set language as early as possible prior to loading on JSON files.
     setLanguage();
 
+    // FactGroup updates are timed from the GUI thread
+    _factGroupUpdateScheduler = new FactGroupUpdateScheduler();
+
     _toolbox = new QGCToolbox(this);
     _toolbox->setChildToolboxes();
 
@@ -491,6 +494,9 @@ void QGCApplication::_shutdown()
     delete _qmlAppEngine;
 
     delete _toolbox;
+
+    delete _factGroupUpdateScheduler;
+    _factGroupUpdateScheduler = nullptr;
 }
 
 QGCApplication::~QGCApplication()
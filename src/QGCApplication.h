@@ -196,6 +196,7 @@ private:
     int                 _buildVersion           = 0;
     QGCFileDownload*    _currentVersionDownload = nullptr;
     GPSRTKFactGroup*    _gpsRtkFactGroup        = nullptr;
+    FactGroupUpdateScheduler* _factGroupUpdateScheduler = nullptr;
     QGCToolbox*         _toolbox                = nullptr;
     QQuickItem*         _mainRootWindow         = nullptr;
     bool                _bluetoothAvailable     = false;
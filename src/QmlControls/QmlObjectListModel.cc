@@ -210,19 +210,20 @@ void QmlObjectListModel::insert(int i, QList<QObject*> objects)
         qWarning() << "Invalid index index:count" << i << _objectList.count();
     }
 
+    const QByteArray dirtyChangedSignature = QMetaObject::normalizedSignature("dirtyChanged(bool)");
+
     int j = i;
     for (QObject* object: objects) {
         QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
 
         // Look for a dirtyChanged signal on the object
-        if (object->metaObject()->indexOfSignal(QMetaObject::normalizedSignature("dirtyChanged(bool)")) != -1) {
+        if (object->metaObject()->indexOfSignal(dirtyChangedSignature) != -1) {
             if (!_skipDirtyFirstItem || j != 0) {
                 QObject::connect(object, SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
             }
         }
-        j++;
 
-        _objectList.insert(j, object);
+        _objectList.insert(j++, object);
     }
 
     insertRows(i, objects.count());
@@ -45,6 +45,16 @@ struct stQGeoTileCacheQGCMapTypes {
 static const char* kMaxDiskCacheKey = "MaxDiskCache";
 static const char* kMaxMemCacheKey  = "MaxMemoryCache";
 
+//-- Byte budget for the hot tile cache. This holds the encoded tile data so it goes a lot further than the same
+//   amount of QtLocation memory cache.
+#ifdef __mobile__
+#define HOT_TILE_CACHE_BYTES    (8 * 1024 * 1024)
+#else
+#define HOT_TILE_CACHE_BYTES    (32 * 1024 * 1024)
+#endif
+//-- Hit rate is logged every this many lookups
+#define HOT_TILE_LOG_INTERVAL   1000
+
 //-----------------------------------------------------------------------------
 // Singleton
 static QGCMapEngine* kMapEngine = nullptr;
@@ -90,6 +100,9 @@ QGCMapEngine::QGCMapEngine()
     , _prunning(false)
     , _cacheWasReset(false)
     , _isInternetActive(false)
+    , _hotTiles(HOT_TILE_CACHE_BYTES)
+    , _hotTileHits(0)
+    , _hotTileMisses(0)
 {
     qRegisterMetaType<QGCMapTask::TaskType>();
     qRegisterMetaType<QGCTile>();
@@ -195,9 +208,78 @@ QGCMapEngine::_wipeDirectory(const QString& dirPath)
 void
 QGCMapEngine::addTask(QGCMapTask* task)
 {
+    //-- The cached tiles are going away
+    if(task->type() == QGCMapTask::taskReset || task->type() == QGCMapTask::taskImport) {
+        clearHotTiles();
+    }
     _worker.enqueueTask(task);
 }
 
+//-----------------------------------------------------------------------------
+bool
+QGCMapEngine::getHotTile(const QString& hash, QByteArray& image, QString& format)
+{
+    QMutexLocker lock(&_hotTilesMutex);
+    HotTile_t* tile = _hotTiles.object(hash);
+    if(tile) {
+        image  = tile->image;
+        format = tile->format;
+        _hotTileHits++;
+    } else {
+        _hotTileMisses++;
+    }
+    if(((_hotTileHits + _hotTileMisses) % HOT_TILE_LOG_INTERVAL) == 0) {
+        qCDebug(QGCTileCacheLog) << "Hot tile cache hits:" << _hotTileHits << "misses:" << _hotTileMisses
+                                 << "hit rate:" << (100 * _hotTileHits) / (_hotTileHits + _hotTileMisses) << "%"
+                                 << "tiles:" << _hotTiles.count() << "bytes:" << _hotTiles.totalCost();
+    }
+    return tile != nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMapEngine::addHotTile(const QString& hash, const QByteArray& image, const QString& format)
+{
+    if(image.isEmpty()) {
+        return;
+    }
+    QMutexLocker lock(&_hotTilesMutex);
+    //-- QCache takes ownership and evicts least recently used tiles until the new one fits
+    _hotTiles.insert(hash, new HotTile_t{ image, format }, image.size());
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMapEngine::clearHotTiles()
+{
+    QMutexLocker lock(&_hotTilesMutex);
+    _hotTiles.clear();
+}
+
+//-----------------------------------------------------------------------------
+int
+QGCMapEngine::hotTileBytes()
+{
+    QMutexLocker lock(&_hotTilesMutex);
+    return _hotTiles.totalCost();
+}
+
+//-----------------------------------------------------------------------------
+quint64
+QGCMapEngine::hotTileHits()
+{
+    QMutexLocker lock(&_hotTilesMutex);
+    return _hotTileHits;
+}
+
+//-----------------------------------------------------------------------------
+quint64
+QGCMapEngine::hotTileMisses()
+{
+    QMutexLocker lock(&_hotTilesMutex);
+    return _hotTileMisses;
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCMapEngine::cacheTile(QString type, int x, int y, int z, const QByteArray& image, const QString &format, qulonglong set)
@@ -211,6 +293,10 @@ void
 QGCMapEngine::cacheTile(QString type, const QString& hash, const QByteArray& image, const QString& format, qulonglong set)
 {
     AppSettings* appSettings = qgcApp()->toolbox()->settingsManager()->appSettings();
+    //-- Only tiles fetched while browsing the map are hot. Tile set downloads would just flush the cache.
+    if(set == UINT64_MAX) {
+        addHotTile(hash, image, format);
+    }
     //-- If we are allowed to persist data, save tile to cache
     if(!appSettings->disableAllPersistence()->rawValue().toBool()) {
         QGCSaveTileTask* task = new QGCSaveTileTask(new QGCCacheTile(hash, image, format, type, set));
@@ -20,6 +20,8 @@
 #define QGC_MAP_ENGINE_H
 
 #include <QString>
+#include <QCache>
+#include <QMutex>
 
 #include "QGCMapUrlEngine.h"
 #include "QGCMapEngineData.h"
@@ -55,6 +57,14 @@ public:
 
     UrlFactory*                 urlFactory          () { return _urlFactory; }
 
+    //-- Hot tile cache. Recently used tile data kept in memory in front of the cache database. Thread safe.
+    bool                        getHotTile          (const QString& hash, QByteArray& image, QString& format);
+    void                        addHotTile          (const QString& hash, const QByteArray& image, const QString& format);
+    void                        clearHotTiles       ();
+    quint64                     hotTileHits         ();
+    quint64                     hotTileMisses       ();
+    int                         hotTileBytes        ();
+
     //-- Tile Math
     static QGCTileSet           getTileCount        (int zoom, double topleftLon, double topleftLat, double bottomRightLon, double bottomRightLat, QString mapType);
     static QString              getTileHash         (QString type, int x, int y, int z);
@@ -79,6 +89,11 @@ private:
     bool _wipeDirectory         (const QString& dirPath);
 
 private:
+    typedef struct {
+        QByteArray  image;
+        QString     format;
+    } HotTile_t;
+
     QGCCacheWorker          _worker;
     QString                 _cachePath;
     QString                 _cacheFile;
@@ -89,6 +104,10 @@ private:
     bool                    _prunning;
     bool                    _cacheWasReset;
     bool                    _isInternetActive;
+    QCache<QString, HotTile_t> _hotTiles;           ///< LRU with the tile size in bytes as cost
+    QMutex                  _hotTilesMutex;         ///< Protects _hotTiles and the hit/miss counters
+    quint64                 _hotTileHits;
+    quint64                 _hotTileMisses;
 };
 
 extern QGCMapEngine*    getQGCMapEngine();
@@ -0,0 +1,48 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCMapEngineTest.h"
+#include "QGCMapEngine.h"
+
+QGCMapEngineTest::QGCMapEngineTest(void)
+{
+
+}
+
+void QGCMapEngineTest::_hotTileCache_test(void)
+{
+    QGCMapEngine*   mapEngine = getQGCMapEngine();
+    QByteArray      image;
+    QString         format;
+
+    mapEngine->clearHotTiles();
+    quint64 hits    = mapEngine->hotTileHits();
+    quint64 misses  = mapEngine->hotTileMisses();
+
+    QVERIFY(!mapEngine->getHotTile(QStringLiteral("HotTile0"), image, format));
+    mapEngine->addHotTile(QStringLiteral("HotTile0"), QByteArray(_tileSize, 'a'), QStringLiteral("png"));
+    QVERIFY(mapEngine->getHotTile(QStringLiteral("HotTile0"), image, format));
+    QCOMPARE(image, QByteArray(_tileSize, 'a'));
+    QCOMPARE(format, QStringLiteral("png"));
+    QCOMPARE(mapEngine->hotTileHits(),   hits + 1);
+    QCOMPARE(mapEngine->hotTileMisses(), misses + 1);
+
+    // Going well over the byte budget evicts the least recently used tiles
+    QByteArray bigImage(1024 * 1024, 'b');
+    for (int i=1; i<=64; i++) {
+        mapEngine->addHotTile(QStringLiteral("HotTile%1").arg(i), bigImage, QStringLiteral("png"));
+    }
+    QVERIFY(!mapEngine->getHotTile(QStringLiteral("HotTile0"), image, format));
+    QVERIFY(!mapEngine->getHotTile(QStringLiteral("HotTile1"), image, format));
+    QVERIFY(mapEngine->getHotTile(QStringLiteral("HotTile64"), image, format));
+    QVERIFY(mapEngine->hotTileBytes() < 64 * bigImage.size());
+
+    mapEngine->clearHotTiles();
+    QCOMPARE(mapEngine->hotTileBytes(), 0);
+}
@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// @file
+///     @brief QGCMapEngine hot tile cache unit test
+
+class QGCMapEngineTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    QGCMapEngineTest(void);
+
+private slots:
+    void _hotTileCache_test(void);
+
+private:
+    static const int _tileSize = 4096;
+};
@@ -40,9 +40,18 @@ QGC_LOGGING_CATEGORY(QGCTileCacheLog, "QGCTileCacheLog")
 #define LONG_TIMEOUT        5
 #define SHORT_TIMEOUT       2
 
+//-- Tile saves are grouped into a single transaction until one of these is reached (or the queue runs dry)
+
+#define SAVE_BATCH_TILES    1000
+#define SAVE_BATCH_MSECS    500
+
 //-----------------------------------------------------------------------------
 QGCCacheWorker::QGCCacheWorker()
     : _db(nullptr)
+    , _saveTileQuery(nullptr)
+    , _saveSetTileQuery(nullptr)
+    , _saveBatchOpen(false)
+    , _saveBatchCount(0)
     , _valid(false)
     , _failed(false)
     , _defaultSet(UINT64_MAX)
@@ -50,6 +59,7 @@ QGCCacheWorker::QGCCacheWorker()
     , _totalCount(0)
     , _defaultSize(0)
     , _defaultCount(0)
+    , _totalsValid(false)
     , _lastUpdate(0)
     , _updateTimeout(SHORT_TIMEOUT)
     , _hostLookupID(0)
@@ -115,10 +125,7 @@ QGCCacheWorker::run()
         _init();
     }
     if(_valid) {
-        _db = new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", kSession));
-        _db->setDatabaseName(_databasePath);
-        _db->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
-        _valid = _db->open();
+        _valid = _connectDB();
     }
     while(true) {
         QGCMapTask* task;
@@ -126,6 +133,22 @@ QGCCacheWorker::run()
             _mutex.lock();
             task = _taskQueue.dequeue();
             _mutex.unlock();
+            //-- Tile fetches and download state updates run inside the open save batch, on the same connection
+            //   they see the tiles saved so far. Tasks which start their own transaction or rewrite the database
+            //   only see committed data.
+            switch(task->type()) {
+                case QGCMapTask::taskCreateTileSet:
+                case QGCMapTask::taskDeleteTileSet:
+                case QGCMapTask::taskRenameTileSet:
+                case QGCMapTask::taskPruneCache:
+                case QGCMapTask::taskReset:
+                case QGCMapTask::taskExport:
+                case QGCMapTask::taskImport:
+                    _commitSaveBatch();
+                    break;
+                default:
+                    break;
+            }
             switch(task->type()) {
                 case QGCMapTask::taskInit:
                     break;
@@ -170,8 +193,12 @@ QGCCacheWorker::run()
                     break;
             }
             task->deleteLater();
-            //-- Check for update timeout
             size_t count = static_cast<size_t>(_taskQueue.count());
+            //-- Check for save batch completion. An empty queue doesn't end the batch, see below.
+            if(_saveBatchOpen && (_saveBatchCount >= SAVE_BATCH_TILES || _saveBatchTimer.elapsed() >= SAVE_BATCH_MSECS)) {
+                _commitSaveBatch();
+            }
+            //-- Check for update timeout
             if(count > 100) {
                 _updateTimeout = LONG_TIMEOUT;
             } else if(count < 25) {
@@ -182,6 +209,20 @@ QGCCacheWorker::run()
                     _updateTotals();
                 }
             }
+        } else if(_saveBatchOpen) {
+            //-- Downloaded tiles trickle in as the replies arrive, keep the batch open for them until it times out
+            qint64 remaining = SAVE_BATCH_MSECS - _saveBatchTimer.elapsed();
+            if(remaining > 0) {
+                _waitmutex.lock();
+                _waitc.wait(&_waitmutex, static_cast<unsigned long>(remaining));
+                _waitmutex.unlock();
+            }
+            _mutex.lock();
+            bool idle = !_taskQueue.count();
+            _mutex.unlock();
+            if(idle) {
+                _commitSaveBatch();
+            }
         } else {
             //-- Wait a bit before shutting things down
             _waitmutex.lock();
@@ -197,12 +238,67 @@ QGCCacheWorker::run()
             _mutex.unlock();
         }
     }
+    _commitSaveBatch();
+    _disconnectDB();
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCacheWorker::_connectDB()
+{
+    _db = new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", kSession));
+    _db->setDatabaseName(_databasePath);
+    _db->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
+    if(!_db->open()) {
+        qCritical() << "Map Cache SQL error (open db):" << _db->lastError();
+        return false;
+    }
+    //-- With WAL a commit is a sequential append instead of a rewrite of the touched pages. NORMAL sync is
+    //   safe with WAL, a power loss can only lose the last few batches which are just cached tiles anyway.
+    QSqlQuery query(*_db);
+    if(!query.exec("PRAGMA journal_mode=WAL")) {
+        qWarning() << "Map Cache SQL error (set WAL journal mode):" << query.lastError().text();
+    }
+    if(!query.exec("PRAGMA synchronous=NORMAL")) {
+        qWarning() << "Map Cache SQL error (set synchronous mode):" << query.lastError().text();
+    }
+    _saveTileQuery = new QSqlQuery(*_db);
+    _saveTileQuery->prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
+    _saveSetTileQuery = new QSqlQuery(*_db);
+    _saveSetTileQuery->prepare("INSERT INTO SetTiles(tileID, setID) VALUES(?, ?)");
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_disconnectDB()
+{
+    //-- Queries must go before the connection they were prepared on
+    delete _saveTileQuery;
+    _saveTileQuery = nullptr;
+    delete _saveSetTileQuery;
+    _saveSetTileQuery = nullptr;
     if(_db) {
         delete _db;
         _db = nullptr;
         QSqlDatabase::removeDatabase(kSession);
     }
 }
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_commitSaveBatch()
+{
+    if(!_saveBatchOpen) {
+        return;
+    }
+    _saveBatchOpen = false;
+    if(!_db->commit()) {
+        qWarning() << "Map Cache SQL error (commit saved tiles):" << _db->lastError();
+    }
+    qCDebug(QGCTileCacheLog) << "_commitSaveBatch() tiles:" << _saveBatchCount << "msecs:" << _saveBatchTimer.elapsed();
+}
+
 //-----------------------------------------------------------------------------
 bool
 QGCCacheWorker::_findTileSetID(const QString name, quint64& setID)
@@ -241,21 +337,34 @@ QGCCacheWorker::_saveTile(QGCMapTask *mtask)
 {
     if(_valid) {
         QGCSaveTileTask* task = static_cast<QGCSaveTileTask*>(mtask);
-        QSqlQuery query(*_db);
-        query.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-        query.addBindValue(task->tile()->hash());
-        query.addBindValue(task->tile()->format());
-        query.addBindValue(task->tile()->img());
-        query.addBindValue(task->tile()->img().size());
-        query.addBindValue(task->tile()->type());
-        query.addBindValue(QDateTime::currentDateTime().toTime_t());
-        if(query.exec()) {
-            quint64 tileID = query.lastInsertId().toULongLong();
+        if(!_saveBatchOpen) {
+            //-- If the transaction can't be started the tile is simply saved on its own
+            _saveBatchOpen  = _db->transaction();
+            _saveBatchCount = 0;
+            _saveBatchTimer.start();
+        }
+        QByteArray img = task->tile()->img();
+        _saveTileQuery->bindValue(0, task->tile()->hash());
+        _saveTileQuery->bindValue(1, task->tile()->format());
+        _saveTileQuery->bindValue(2, img);
+        _saveTileQuery->bindValue(3, img.size());
+        _saveTileQuery->bindValue(4, task->tile()->type());
+        _saveTileQuery->bindValue(5, QDateTime::currentDateTime().toTime_t());
+        if(_saveTileQuery->exec()) {
+            quint64 tileID = _saveTileQuery->lastInsertId().toULongLong();
             quint64 setID = task->tile()->set() == UINT64_MAX ? _getDefaultTileSet() : task->tile()->set();
-            QString s = QString("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-            query.prepare(s);
-            if(!query.exec()) {
-                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
+            _saveSetTileQuery->bindValue(0, tileID);
+            _saveSetTileQuery->bindValue(1, setID);
+            if(!_saveSetTileQuery->exec()) {
+                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << _saveSetTileQuery->lastError().text();
+            }
+            _saveBatchCount++;
+            //-- A new tile belongs to a single set, so totals can be kept current without querying them
+            _totalCount++;
+            _totalSize += static_cast<quint64>(img.size());
+            if(setID == _getDefaultTileSet()) {
+                _defaultCount++;
+                _defaultSize += static_cast<quint64>(img.size());
             }
             qCDebug(QGCTileCacheLog) << "_saveTile() HASH:" << task->tile()->hash();
         } else {
@@ -391,11 +500,22 @@ QGCCacheWorker::_updateSetTotals(QGCCachedTileSet* set)
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_updateTotals()
+{
+    if(!_totalsValid) {
+        _queryTotals();
+    }
+    emit updateTotals(_totalCount, _totalSize, _defaultCount, _defaultSize);
+    _lastUpdate = time(nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_queryTotals()
 {
     QSqlQuery query(*_db);
     QString s;
     s = QString("SELECT COUNT(size), SUM(size) FROM Tiles");
-    qCDebug(QGCTileCacheLog) << "_updateTotals(): " << s;
+    qCDebug(QGCTileCacheLog) << "_queryTotals(): " << s;
     if(query.exec(s)) {
         if(query.next()) {
             _totalCount = query.value(0).toUInt();
@@ -403,15 +523,14 @@ QGCCacheWorker::_updateTotals()
         }
     }
     s = QString("SELECT COUNT(size), SUM(size) FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1)").arg(_getDefaultTileSet());
-    qCDebug(QGCTileCacheLog) << "_updateTotals(): " << s;
+    qCDebug(QGCTileCacheLog) << "_queryTotals(): " << s;
     if(query.exec(s)) {
         if(query.next()) {
             _defaultCount = query.value(0).toUInt();
             _defaultSize  = query.value(1).toULongLong();
         }
     }
-    emit updateTotals(_totalCount, _totalSize, _defaultCount, _defaultSize);
-    _lastUpdate = time(nullptr);
+    _totalsValid = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -500,6 +619,8 @@ QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
                 }
             }
             _db->commit();
+            //-- Existing tiles may have been added to the set which changes the default set unique totals
+            _totalsValid = false;
             //-- Done
             _updateSetTotals(task->tileSet());
             task->setTileSetSaved();
@@ -590,6 +711,7 @@ QGCCacheWorker::_pruneCache(QGCMapTask* mtask)
             if(!query.exec(s))
                 break;
         }
+        _totalsValid = false;
         task->setPruned();
     }
 }
@@ -621,6 +743,7 @@ QGCCacheWorker::_deleteTileSet(qulonglong id)
     query.exec(s);
     s = QString("DELETE FROM SetTiles WHERE setID = %1").arg(id);
     query.exec(s);
+    _totalsValid = false;
     _updateTotals();
 }
 
@@ -659,6 +782,7 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
     s = QString("DROP TABLE TilesDownload");
     query.exec(s);
     _valid = _createDB(_db);
+    _totalsValid = false;
     task->setResetCompleted();
 }
 
@@ -673,23 +797,18 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
     //-- If replacing, simply copy over it
     if(task->replace()) {
         //-- Close and delete old database
-        if(_db) {
-            delete _db;
-            _db = nullptr;
-            QSqlDatabase::removeDatabase(kSession);
-        }
+        _disconnectDB();
         QFile file(_databasePath);
         file.remove();
+        QFile::remove(_databasePath + "-wal");
+        QFile::remove(_databasePath + "-shm");
         //-- Copy given database
         QFile::copy(task->path(), _databasePath);
         task->setProgress(25);
         _init();
         if(_valid) {
             task->setProgress(50);
-            _db = new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", kSession));
-            _db->setDatabaseName(_databasePath);
-            _db->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
-            _valid = _db->open();
+            _valid = _connectDB();
         }
         task->setProgress(100);
     } else {
@@ -845,6 +964,7 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
             task->setError("Error opening import database");
         }
     }
+    _totalsValid = false;
     task->setImportCompleted();
 }
 
@@ -25,6 +25,7 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QMutexLocker>
+#include <QElapsedTimer>
 #include <QtSql/QSqlDatabase>
 #include <QHostInfo>
 
@@ -34,6 +35,7 @@ Q_DECLARE_LOGGING_CATEGORY(QGCTileCacheLog)
 
 class QGCMapTask;
 class QGCCachedTileSet;
+class QSqlQuery;
 
 //-----------------------------------------------------------------------------
 class QGCCacheWorker : public QThread
@@ -73,9 +75,13 @@ private:
     bool        _findTileSetID          (const QString name, quint64& setID);
     void        _updateSetTotals        (QGCCachedTileSet* set);
     bool        _init                   ();
+    bool        _connectDB              ();
+    void        _disconnectDB           ();
     bool        _createDB               (QSqlDatabase *db, bool createDefault = true);
     quint64     _getDefaultTileSet      ();
+    void        _commitSaveBatch        ();
     void        _updateTotals           ();
+    void        _queryTotals            ();
     void        _deleteTileSet          (qulonglong id);
 
 signals:
@@ -89,6 +95,11 @@ private:
     QWaitCondition          _waitc;
     QString                 _databasePath;
     QSqlDatabase*           _db;
+    QSqlQuery*              _saveTileQuery;         ///< Prepared once per connection and reused for every saved tile
+    QSqlQuery*              _saveSetTileQuery;
+    bool                    _saveBatchOpen;         ///< A transaction holding tile saves is open
+    int                     _saveBatchCount;
+    QElapsedTimer           _saveBatchTimer;
     bool                    _valid;
     bool                    _failed;
     quint64                 _defaultSet;
@@ -96,6 +107,7 @@ private:
     quint32                 _totalCount;
     quint64                 _defaultSize;
     quint32                 _defaultCount;
+    bool                    _totalsValid;           ///< false: totals must be queried from the database, true: kept up to date incrementally
     time_t                  _lastUpdate;
     int                     _updateTimeout;
     int                     _hostLookupID;
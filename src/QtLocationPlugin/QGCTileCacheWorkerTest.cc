@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileCacheWorkerTest.h"
+#include "QGCMapEngine.h"
+
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+
+QGCTileCacheWorkerTest::QGCTileCacheWorkerTest(void)
+{
+
+}
+
+bool QGCTileCacheWorkerTest::_initWorker(QGCCacheWorker& worker, const QString& databaseFile)
+{
+    worker.setDatabaseFile(databaseFile);
+
+    // Totals are signalled once the init task has been processed and the database is open
+    QSignalSpy spyTotals(&worker, &QGCCacheWorker::updateTotals);
+    worker.enqueueTask(new QGCMapTask(QGCMapTask::taskInit));
+    return spyTotals.wait(10000);
+}
+
+void QGCTileCacheWorkerTest::_enqueueTiles(QGCCacheWorker& worker, int first, int count)
+{
+    // All tiles share the same image data
+    QByteArray image(_tileSize, 'x');
+
+    for (int i=first; i<first+count; i++) {
+        worker.enqueueTask(new QGCSaveTileTask(new QGCCacheTile(QStringLiteral("TileCacheWorkerTest%1").arg(i), image, QStringLiteral("png"), QStringLiteral("1"))));
+    }
+}
+
+void QGCTileCacheWorkerTest::_enqueueDownloadedTiles(QGCCacheWorker& worker, int first, int count)
+{
+    QByteArray image(_tileSize, 'x');
+
+    // Same task mix as QGCCachedTileSet::_networkReplyFinished: each downloaded tile is saved into the set and then
+    // removed from the set's download list
+    for (int i=first; i<first+count; i++) {
+        QString hash = QStringLiteral("TileCacheWorkerTest%1").arg(i);
+        worker.enqueueTask(new QGCSaveTileTask(new QGCCacheTile(hash, image, QStringLiteral("png"), QStringLiteral("1"), _defaultSetID)));
+        worker.enqueueTask(new QGCUpdateTileDownloadStateTask(_defaultSetID, QGCTile::StateComplete, hash));
+    }
+}
+
+bool QGCTileCacheWorkerTest::_waitForTotalCount(QGCCacheWorker& worker, quint32 totalCount, int timeoutMSecs, QList<QVariant>* totals)
+{
+    QSignalSpy      spyTotals(&worker, &QGCCacheWorker::updateTotals);
+    QElapsedTimer   timer;
+
+    timer.start();
+    while (timer.elapsed() < timeoutMSecs) {
+        if (!spyTotals.wait(timeoutMSecs - static_cast<int>(timer.elapsed()))) {
+            return false;
+        }
+        if (spyTotals.last()[0].toUInt() >= totalCount) {
+            if (totals) {
+                *totals = spyTotals.last();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void QGCTileCacheWorkerTest::_saveTiles_test(void)
+{
+    QTemporaryDir   tempDir;
+    QGCCacheWorker  worker;
+
+    QVERIFY(_initWorker(worker, tempDir.filePath("TileCacheWorkerTest.db")));
+
+    // Totals are tracked as the tiles are saved, duplicates don't count
+    _enqueueTiles(worker, 0, 10);
+    _enqueueTiles(worker, 5, 10);
+    QList<QVariant> totals;
+    QVERIFY(_waitForTotalCount(worker, 15, 10000, &totals));
+    QCOMPARE(totals[0].toUInt(),        15u);
+    QCOMPARE(totals[1].toULongLong(),   static_cast<quint64>(15 * _tileSize));
+    QCOMPARE(totals[2].toUInt(),        15u);
+    QCOMPARE(totals[3].toULongLong(),   static_cast<quint64>(15 * _tileSize));
+
+    // Saved tiles can be fetched back
+    QGCFetchTileTask* fetchTask = new QGCFetchTileTask(QStringLiteral("TileCacheWorkerTest12"));
+    QSignalSpy spyFetched(fetchTask, &QGCFetchTileTask::tileFetched);
+    worker.enqueueTask(fetchTask);
+    QVERIFY(spyFetched.wait(10000));
+    QGCCacheTile* tile = spyFetched.first()[0].value<QGCCacheTile*>();
+    QCOMPARE(tile->img().size(), _tileSize);
+    delete tile;
+
+    worker.quit();
+    worker.wait();
+}
+
+void QGCTileCacheWorkerTest::_saveTilesBenchmark_test(void)
+{
+    UT_BENCHMARK();
+
+    QTemporaryDir   tempDir;
+    QGCCacheWorker  worker;
+    QElapsedTimer   timer;
+
+    QVERIFY(_initWorker(worker, tempDir.filePath("TileCacheWorkerBenchmark.db")));
+
+    timer.start();
+    _enqueueDownloadedTiles(worker, 0, _benchmarkTileCount);
+    QVERIFY(_waitForTotalCount(worker, _benchmarkTileCount, 600000));
+    qint64 elapsedMSecs = qMax(timer.elapsed(), static_cast<qint64>(1));
+
+    qDebug() << "Cached and updated download state of" << _benchmarkTileCount << "tiles in" << elapsedMSecs << "msecs," << (_benchmarkTileCount * 1000LL) / elapsedMSecs << "tiles/sec";
+
+    worker.quit();
+    worker.wait();
+}
@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGCCacheWorker;
+
+class QGCTileCacheWorkerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    QGCTileCacheWorkerTest(void);
+
+private slots:
+    void _saveTiles_test            (void);
+    void _saveTilesBenchmark_test   (void);
+
+private:
+    bool _initWorker        (QGCCacheWorker& worker, const QString& databaseFile);
+    void _enqueueTiles      (QGCCacheWorker& worker, int first, int count);
+    void _enqueueDownloadedTiles(QGCCacheWorker& worker, int first, int count);
+    bool _waitForTotalCount (QGCCacheWorker& worker, quint32 totalCount, int timeoutMSecs, QList<QVariant>* totals = nullptr);
+
+    static const int _tileSize              = 4096;
+    static const int _benchmarkTileCount    = 100000;
+    static const int _defaultSetID          = 1;        ///< Set created along with a new database
+};
@@ -51,6 +51,8 @@
 #include <QtLocation/private/qgeotilespec_p.h>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QFile>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 #include "TerrainTile.h"
 
 int QGeoTiledMapReplyQGC::_requestCount = 0;
@@ -73,6 +75,22 @@ QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(QNetworkAccessManager *networkManager
         setFinished(true);
         setCached(false);
     } else {
+        //-- Answer from the hot tile cache without a round trip through the cache worker
+        QString hash = QGCMapEngine::getTileHash(getQGCMapEngine()->urlFactory()->getTypeFromId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
+        QByteArray image;
+        QString format;
+        if(getQGCMapEngine()->getHotTile(hash, image, format)) {
+            if(getQGCMapEngine()->urlFactory()->isElevation(spec.mapId())) {
+                //-- Nobody is connected to terrainDone yet
+                QMetaObject::invokeMethod(this, [this, image]() { emit terrainDone(image, QNetworkReply::NoError); }, Qt::QueuedConnection);
+            } else {
+                setMapImageData(image);
+                setMapImageFormat(format);
+                setFinished(true);
+                setCached(true);
+            }
+            return;
+        }
         QGCFetchTileTask* task = getQGCMapEngine()->createFetchTileTask(getQGCMapEngine()->urlFactory()->getTypeFromId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
         connect(task, &QGCFetchTileTask::tileFetched, this, &QGeoTiledMapReplyQGC::cacheReply);
         connect(task, &QGCMapTask::error, this, &QGeoTiledMapReplyQGC::cacheError);
@@ -125,15 +143,21 @@ QGeoTiledMapReplyQGC::networkReplyFinished()
     QString format = getQGCMapEngine()->urlFactory()->getImageFormat(tileSpec().mapId(), a);
     //-- Test for a specialized, elevation data (not map tile)
     if( getQGCMapEngine()->urlFactory()->isElevation(tileSpec().mapId())){
-        a = TerrainTile::serialize(a);
-        //-- Cache it if valid
-        if(!a.isEmpty()) {
-            getQGCMapEngine()->cacheTile(
-                getQGCMapEngine()->urlFactory()->getTypeFromId(
-                    tileSpec().mapId()),
-                tileSpec().x(), tileSpec().y(), tileSpec().zoom(), a, format);
-        }
-        emit terrainDone(a, QNetworkReply::NoError);
+        //-- Decode the json on the thread pool, prefetched tiles tend to arrive together
+        QFutureWatcher<QByteArray>* watcher = new QFutureWatcher<QByteArray>(this);
+        connect(watcher, &QFutureWatcher<QByteArray>::finished, this, [this, watcher, format]() {
+            QByteArray serialized = watcher->result();
+            watcher->deleteLater();
+            //-- Cache it if valid
+            if(!serialized.isEmpty()) {
+                getQGCMapEngine()->cacheTile(
+                    getQGCMapEngine()->urlFactory()->getTypeFromId(
+                        tileSpec().mapId()),
+                    tileSpec().x(), tileSpec().y(), tileSpec().zoom(), serialized, format);
+            }
+            emit terrainDone(serialized, QNetworkReply::NoError);
+        });
+        watcher->setFuture(QtConcurrent::run(&TerrainTile::serialize, a));
     } else {
         //-- This is a map tile. Process and cache it if valid.
         setMapImageData(a);
@@ -209,6 +233,7 @@ QGeoTiledMapReplyQGC::cacheError(QGCMapTask::TaskType type, QString /*errorStrin
 void
 QGeoTiledMapReplyQGC::cacheReply(QGCCacheTile* tile)
 {
+    getQGCMapEngine()->addHotTile(tile->hash(), tile->img(), tile->format());
     //-- Test for a specialized, elevation data (not map tile)
     if( getQGCMapEngine()->urlFactory()->isElevation(tileSpec().mapId())){
         emit terrainDone(tile->img(), QNetworkReply::NoError);
@@ -82,7 +82,7 @@ void TerrainAirMapQuery::requestPathHeights(const QGeoCoordinate& fromCoord, con
 void TerrainAirMapQuery::requestCarpetHeights(const QGeoCoordinate& swCoord, const QGeoCoordinate& neCoord, bool statsOnly)
 {
     if (qgcApp()->runningUnitTests()) {
-        emit carpetHeightsReceived(false, qQNaN(), qQNaN(), QList<QList<double>>());
+        emit carpetHeightsReceived(false, qQNaN(), qQNaN(), qQNaN(), QList<QList<double>>());
         return;
     }
 
@@ -215,7 +215,7 @@ void TerrainAirMapQuery::_requestFailed(void)
         emit pathHeightsReceived(false /* success */, qQNaN() /* latStep */, qQNaN() /* lonStep */, QList<double>() /* heights */);
         break;
     case QueryModeCarpet:
-        emit carpetHeightsReceived(false /* success */, qQNaN() /* minHeight */, qQNaN() /* maxHeight */, QList<QList<double>>() /* carpet */);
+        emit carpetHeightsReceived(false /* success */, qQNaN() /* minHeight */, qQNaN() /* maxHeight */, qQNaN() /* avgHeight */, QList<QList<double>>() /* carpet */);
         break;
     }
 }
@@ -255,6 +255,7 @@ void TerrainAirMapQuery::_parseCarpetData(const QJsonValue& carpetJson)
     QJsonObject statsObject =   jsonObject["stats"].toObject();
     double      minHeight =     statsObject["min"].toDouble();
     double      maxHeight =     statsObject["max"].toDouble();
+    double      avgHeight =     statsObject["avg"].toDouble();
 
     QList<QList<double>> carpet;
     if (!_carpetStatsOnly) {
@@ -271,7 +272,7 @@ void TerrainAirMapQuery::_parseCarpetData(const QJsonValue& carpetJson)
         }
     }
 
-    emit carpetHeightsReceived(true /*success*/, minHeight, maxHeight, carpet);
+    emit carpetHeightsReceived(true /*success*/, minHeight, maxHeight, avgHeight, carpet);
 }
 
 TerrainOfflineAirMapQuery::TerrainOfflineAirMapQuery(QObject* parent)
@@ -307,15 +308,11 @@ void TerrainOfflineAirMapQuery::requestPathHeights(const QGeoCoordinate& fromCoo
 void TerrainOfflineAirMapQuery::requestCarpetHeights(const QGeoCoordinate& swCoord, const QGeoCoordinate& neCoord, bool statsOnly)
 {
     if (qgcApp()->runningUnitTests()) {
-        emit carpetHeightsReceived(false, qQNaN(), qQNaN(), QList<QList<double>>());
+        emit carpetHeightsReceived(false, qQNaN(), qQNaN(), qQNaN(), QList<QList<double>>());
         return;
     }
 
-    // TODO
-    Q_UNUSED(swCoord);
-    Q_UNUSED(neCoord);
-    Q_UNUSED(statsOnly);
-    qWarning() << "Carpet queries are currently not supported from offline air map data";
+    _terrainTileManager->addCarpetQuery(this, swCoord, neCoord, statsOnly, _carpetSampling);
 }
 
 void TerrainOfflineAirMapQuery::_signalCoordinateHeights(bool success, QList<double> heights)
@@ -328,12 +325,13 @@ void TerrainOfflineAirMapQuery::_signalPathHeights(bool success, double distance
     emit pathHeightsReceived(success, distanceBetween, finalDistanceBetween, heights);
 }
 
-void TerrainOfflineAirMapQuery::_signalCarpetHeights(bool success, double minHeight, double maxHeight, const QList<QList<double>>& carpet)
+void TerrainOfflineAirMapQuery::_signalCarpetHeights(bool success, double minHeight, double maxHeight, double avgHeight, const QList<QList<double>>& carpet)
 {
-    emit carpetHeightsReceived(success, minHeight, maxHeight, carpet);
+    emit carpetHeightsReceived(success, minHeight, maxHeight, avgHeight, carpet);
 }
 
 TerrainTileManager::TerrainTileManager(void)
+    : _tiles(_tileCacheBytes)
 {
 
 }
@@ -348,7 +346,7 @@ void TerrainTileManager::addCoordinateQuery(TerrainOfflineAirMapQuery* terrainQu
 
         if (!getAltitudesForCoordinates(coordinates, altitudes, error)) {
             qCDebug(TerrainQueryLog) << "TerrainTileManager::addPathQuery queue count" << _requestQueue.count();
-            QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModeCoordinates, 0, 0, coordinates };
+            QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModeCoordinates, 0, 0, coordinates, 0, false, TerrainTile::SamplingNearest };
             _requestQueue.append(queuedRequestInfo);
             return;
         }
@@ -366,39 +364,30 @@ void TerrainTileManager::addCoordinateQuery(TerrainOfflineAirMapQuery* terrainQu
 
 void TerrainTileManager::addPathQuery(TerrainOfflineAirMapQuery* terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint)
 {
-    // Convert to individual coordinate queries
-    QList<QGeoCoordinate> coordinates;
-    double lat = startPoint.latitude();
-    double lon = startPoint.longitude();
+    // Heights are sampled evenly along the path about terrainAltitudeSpacing apart, with the last one at the end point
     double steps = ceil(endPoint.distanceTo(startPoint) / TerrainTile::terrainAltitudeSpacing);
-    double latDiff = endPoint.latitude() - lat;
-    double lonDiff = endPoint.longitude() - lon;
+    int pointCount = steps == 0 ? 2 : static_cast<int>(steps) + 1;
 
     double distanceBetween;
     double finalDistanceBetween;
     if (steps == 0) {
-        coordinates.append(startPoint);
-        coordinates.append(endPoint);
-        distanceBetween = finalDistanceBetween = coordinates[0].distanceTo(coordinates[1]);
+        distanceBetween = finalDistanceBetween = startPoint.distanceTo(endPoint);
     } else {
-        for (double i = 0.0; i <= steps; i = i + 1) {
-            coordinates.append(QGeoCoordinate(lat + latDiff * i / steps, lon + lonDiff * i / steps));
-        }
-        // We always have one too many and we always want the last one to be the endpoint
-        coordinates.last() = endPoint;
-        distanceBetween = coordinates[0].distanceTo(coordinates[1]);
-        finalDistanceBetween = coordinates[coordinates.count() - 2].distanceTo(coordinates.last());
+        double latDiff = endPoint.latitude() - startPoint.latitude();
+        double lonDiff = endPoint.longitude() - startPoint.longitude();
+        QGeoCoordinate secondPoint          = steps == 1 ? endPoint : QGeoCoordinate(startPoint.latitude() + latDiff / steps, startPoint.longitude() + lonDiff / steps);
+        QGeoCoordinate secondToLastPoint    = steps == 1 ? startPoint : QGeoCoordinate(startPoint.latitude() + latDiff * (steps - 1) / steps, startPoint.longitude() + lonDiff * (steps - 1) / steps);
+        distanceBetween         = startPoint.distanceTo(secondPoint);
+        finalDistanceBetween    = secondToLastPoint.distanceTo(endPoint);
     }
 
-    //qDebug() << "terrain" << startPoint.distanceTo(endPoint) << coordinates.count() << distanceBetween;
-
-    qCDebug(TerrainQueryLog) << "TerrainTileManager::addPathQuery start:end:coordCount" << startPoint << endPoint << coordinates.count();
+    qCDebug(TerrainQueryLog) << "TerrainTileManager::addPathQuery start:end:pointCount" << startPoint << endPoint << pointCount;
 
     bool error;
-    QList<double> altitudes;
-    if (!getAltitudesForCoordinates(coordinates, altitudes, error)) {
+    QVector<double> altitudes(pointCount);
+    if (!getAltitudesForPath(startPoint, endPoint, pointCount, altitudes.data(), error)) {
         qCDebug(TerrainQueryLog) << "TerrainTileManager::addPathQuery queue count" << _requestQueue.count();
-        QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModePath, distanceBetween, finalDistanceBetween, coordinates };
+        QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModePath, distanceBetween, finalDistanceBetween, { startPoint, endPoint }, pointCount, false, TerrainTile::SamplingNearest };
         _requestQueue.append(queuedRequestInfo);
         return;
     }
@@ -409,7 +398,32 @@ void TerrainTileManager::addPathQuery(TerrainOfflineAirMapQuery* terrainQueryInt
         terrainQueryInterface->_signalPathHeights(false, distanceBetween, finalDistanceBetween, noAltitudes);
     } else {
         qCDebug(TerrainQueryLog) << "addPathQuery: All altitudes taken from cached data";
-        terrainQueryInterface->_signalPathHeights(coordinates.count() == altitudes.count(), distanceBetween, finalDistanceBetween, altitudes);
+        terrainQueryInterface->_signalPathHeights(true, distanceBetween, finalDistanceBetween, altitudes.toList());
+    }
+}
+
+void TerrainTileManager::addCarpetQuery(TerrainOfflineAirMapQuery* terrainQueryInterface, const QGeoCoordinate& swCoord, const QGeoCoordinate& neCoord, bool statsOnly, TerrainTile::Sampling sampling)
+{
+    qCDebug(TerrainQueryLog) << "TerrainTileManager::addCarpetQuery sw:ne:statsOnly" << swCoord << neCoord << statsOnly;
+
+    bool                    error;
+    double                  minHeight;
+    double                  maxHeight;
+    double                  avgHeight;
+    QList<QList<double>>    carpet;
+    if (!getCarpetHeights(swCoord, neCoord, statsOnly, sampling, minHeight, maxHeight, avgHeight, carpet, error)) {
+        qCDebug(TerrainQueryLog) << "TerrainTileManager::addCarpetQuery queue count" << _requestQueue.count();
+        QueuedRequestInfo_t queuedRequestInfo = { terrainQueryInterface, QueryMode::QueryModeCarpet, 0, 0, { swCoord, neCoord }, 0, statsOnly, sampling };
+        _requestQueue.append(queuedRequestInfo);
+        return;
+    }
+
+    if (error) {
+        qCWarning(TerrainQueryLog) << "addCarpetQuery: signalling failure due to internal error";
+        terrainQueryInterface->_signalCarpetHeights(false, qQNaN(), qQNaN(), qQNaN(), QList<QList<double>>());
+    } else {
+        qCDebug(TerrainQueryLog) << "addCarpetQuery: All heights taken from cached data";
+        terrainQueryInterface->_signalCarpetHeights(true, minHeight, maxHeight, avgHeight, carpet);
     }
 }
 
@@ -420,19 +434,41 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>&
 {
     error = false;
 
+    // Resolve the provider once instead of looking it up by name for every coordinate
+    MapProvider* provider = _elevationProvider();
+    if (!provider) {
+        qCWarning(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates Internal Error: no elevation provider";
+        error = true;
+        return true;
+    }
+
+    altitudes.reserve(altitudes.count() + coordinates.count());
+
+    // The cache is locked once for the whole query. Consecutive coordinates usually fall within the same tile,
+    // so the last tile is reused without going back to the cache.
+    QMutexLocker    tilesLocker (&_tilesMutex);
+    quint64         lastKey     = 0;
+    TerrainTile*    tile        = nullptr;
+
     for (const QGeoCoordinate& coordinate: coordinates) {
-        QString tileHash = _getTileHash(coordinate);
-        qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates hash:coordinate" << tileHash << coordinate;
+        int     x   = provider->long2tileX(coordinate.longitude(), _tileZoom);
+        int     y   = provider->lat2tileY(coordinate.latitude(), _tileZoom);
+        quint64 key = _tileKey(x, y, _tileZoom);
+        qCDebug(TerrainQueryVerboseLog) << "TerrainTileManager::getAltitudesForCoordinates x:y:coordinate" << x << y << coordinate;
+
+        if (!tile || key != lastKey) {
+            tile    = _tiles.object(key);
+            lastKey = key;
+        }
 
-        _tilesMutex.lock();
-        if (_tiles.contains(tileHash)) {
-            if (_tiles[tileHash].isIn(coordinate)) {
-                double elevation = _tiles[tileHash].elevation(coordinate);
+        if (tile) {
+            if (tile->isIn(coordinate)) {
+                double elevation = tile->elevation(coordinate);
                 if (qIsNaN(elevation)) {
                     error = true;
                     qCWarning(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates Internal Error: missing elevation in tile cache";
                 } else {
-                    qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates returning elevation from tile cache" << elevation;
+                    qCDebug(TerrainQueryVerboseLog) << "TerrainTileManager::getAltitudesForCoordinates returning elevation from tile cache" << elevation;
                 }
                 altitudes.push_back(elevation);
             } else {
@@ -441,46 +477,340 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>&
                 error = true;
             }
         } else {
-            if (_state != State::Downloading) {
-                QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL("Airmap Elevation", getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation",coordinate.longitude(), 1), getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1), 1, &_networkManager);
-                qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates query from database" << request.url();
-                QGeoTileSpec spec;
-                spec.setX(getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation", coordinate.longitude(), 1));
-                spec.setY(getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1));
-                spec.setZoom(1);
-                spec.setMapId(getQGCMapEngine()->urlFactory()->getIdFromType("Airmap Elevation"));
-                QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(&_networkManager, request, spec);
-                connect(reply, &QGeoTiledMapReplyQGC::terrainDone, this, &TerrainTileManager::_terrainDone);
-                _state = State::Downloading;
-            }
-            _tilesMutex.unlock();
+            _requestTile(x, y);
+            return false;
+        }
+    }
 
+    return true;
+}
+
+/// Either returns altitudes along the path from cache or queues database request. The path is sampled at pointCount
+/// points evenly spaced in latitude and longitude, the first at startPoint and the last at endPoint.
+///     @param[out] altitudes Buffer for pointCount altitudes
+///     @param[out] error true: altitude not returned due to error, false: altitudes returned
+/// @return true: altitude returned (check error as well), false: database query queued (altitudes not returned)
+bool TerrainTileManager::getAltitudesForPath(const QGeoCoordinate& startPoint, const QGeoCoordinate& endPoint, int pointCount, double* altitudes, bool& error)
+{
+    error = false;
+
+    MapProvider* provider = _elevationProvider();
+    if (!provider || pointCount < 2) {
+        qCWarning(TerrainQueryLog) << "TerrainTileManager::getAltitudesForPath Internal Error: provider:pointCount" << provider << pointCount;
+        error = true;
+        return true;
+    }
+
+    const double lat0       = startPoint.latitude();
+    const double lon0       = startPoint.longitude();
+    const double latDiff    = endPoint.latitude() - lat0;
+    const double lonDiff    = endPoint.longitude() - lon0;
+    const double divisor    = pointCount - 1;
+
+    QMutexLocker tilesLocker(&_tilesMutex);
+
+    // Walk the tile grid along the path (DDA). For each tile the path enters, work out where the path leaves it again and
+    // sample every point up to there from that tile. The tile bounds follow AirmapElevationProvider::long2tileX/lat2tileY.
+    int point = 0;
+    while (point < pointCount) {
+        int x = provider->long2tileX(lon0 + lonDiff * point / divisor, _tileZoom);
+        int y = provider->lat2tileY(lat0 + latDiff * point / divisor, _tileZoom);
+
+        TerrainTile* tile = _tiles.object(_tileKey(x, y, _tileZoom));
+        if (!tile) {
+            _requestTile(x, y);
             return false;
         }
-        _tilesMutex.unlock();
+
+        double exitFraction = 2.0;
+        if (lonDiff > 0) {
+            exitFraction = qMin(exitFraction, ((x + 1) * srtm1TileSize - 180.0 - lon0) / lonDiff);
+        } else if (lonDiff < 0) {
+            exitFraction = qMin(exitFraction, (x * srtm1TileSize - 180.0 - lon0) / lonDiff);
+        }
+        if (latDiff > 0) {
+            exitFraction = qMin(exitFraction, ((y + 1) * srtm1TileSize - 90.0 - lat0) / latDiff);
+        } else if (latDiff < 0) {
+            exitFraction = qMin(exitFraction, (y * srtm1TileSize - 90.0 - lat0) / latDiff);
+        }
+        int exitPoint = static_cast<int>(qBound(static_cast<double>(point + 1), ceil(exitFraction * divisor), static_cast<double>(pointCount)));
+
+        for (; point < exitPoint; point++) {
+            double altitude;
+            if (point == pointCount - 1) {
+                altitude = tile->elevation(endPoint.latitude(), endPoint.longitude());
+            } else {
+                altitude = tile->elevation(lat0 + latDiff * point / divisor, lon0 + lonDiff * point / divisor);
+            }
+            if (qIsNaN(altitude)) {
+                qCWarning(TerrainQueryLog) << "TerrainTileManager::getAltitudesForPath Internal Error: missing elevation in tile cache";
+                error = true;
+            }
+            altitudes[point] = altitude;
+        }
     }
 
     return true;
 }
 
-void TerrainTileManager::_tileFailed(void)
+/// Either returns carpet heights sampled from cached tiles or queues database requests for the missing tiles. The carpet
+/// rows go from south to north, the columns from west to east.
+///     @param[out] error true: heights not returned due to error, false: heights returned
+/// @return true: heights returned (check error as well), false: database query queued (heights not returned)
+bool TerrainTileManager::getCarpetHeights(const QGeoCoordinate& swCoord, const QGeoCoordinate& neCoord, bool statsOnly, TerrainTile::Sampling sampling, double& minHeight, double& maxHeight, double& avgHeight, QList<QList<double>>& carpet, bool& error)
 {
-    QList<double>    noAltitudes;
+    error = false;
+    minHeight = maxHeight = avgHeight = qQNaN();
+
+    MapProvider* provider = _elevationProvider();
+    if (!provider) {
+        qCWarning(TerrainQueryLog) << "TerrainTileManager::getCarpetHeights Internal Error: no elevation provider";
+        error = true;
+        return true;
+    }
+    if (!swCoord.isValid() || !neCoord.isValid() || swCoord.latitude() > neCoord.latitude() || swCoord.longitude() > neCoord.longitude()) {
+        qCWarning(TerrainQueryLog) << "TerrainTileManager::getCarpetHeights invalid bounds" << swCoord << neCoord;
+        error = true;
+        return true;
+    }
+
+    int x0 = provider->long2tileX(swCoord.longitude(), _tileZoom);
+    int y0 = provider->lat2tileY(swCoord.latitude(), _tileZoom);
+    int x1 = provider->long2tileX(neCoord.longitude(), _tileZoom);
+    int y1 = provider->lat2tileY(neCoord.latitude(), _tileZoom);
+    if (static_cast<qint64>(x1 - x0 + 1) * (y1 - y0 + 1) > _maxCarpetTiles) {
+        qCWarning(TerrainQueryLog) << "TerrainTileManager::getCarpetHeights area too large" << swCoord << neCoord;
+        error = true;
+        return true;
+    }
+
+    QMutexLocker tilesLocker(&_tilesMutex);
+
+    // Every tile must be cached before sampling starts, missing ones are all requested at once
+    bool tilesMissing = false;
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            if (!_tiles.contains(_tileKey(x, y, _tileZoom))) {
+                _requestTile(x, y);
+                tilesMissing = true;
+            }
+        }
+    }
+    if (tilesMissing) {
+        return false;
+    }
+
+    const double    swLat   = swCoord.latitude();
+    const double    swLon   = swCoord.longitude();
+    const int       rows    = static_cast<int>((neCoord.latitude() - swLat) / _carpetSpacing) + 1;
+    const int       cols    = static_cast<int>((neCoord.longitude() - swLon) / _carpetSpacing) + 1;
+
+    // The tile column of each carpet column is the same for every row, so the runs of columns which fall within
+    // a single tile are worked out once
+    QVector<int> runX;
+    QVector<int> runStart;
+    for (int col = 0; col < cols; col++) {
+        int x = provider->long2tileX(qMin(swLon + col * _carpetSpacing, neCoord.longitude()), _tileZoom);
+        if (runX.isEmpty() || runX.last() != x) {
+            runX.append(x);
+            runStart.append(col);
+        }
+    }
+    runStart.append(cols);
+
+    QVector<double> heights(cols);
+    double          sum = 0;
+
+    minHeight = qInf();
+    maxHeight = -qInf();
+    if (!statsOnly) {
+        carpet.reserve(rows);
+    }
+
+    for (int row = 0; row < rows; row++) {
+        double  lat = qMin(swLat + row * _carpetSpacing, neCoord.latitude());
+        int     y   = provider->lat2tileY(lat, _tileZoom);
+
+        for (int run = 0; run < runX.count(); run++) {
+            TerrainTile* tile = _tiles.object(_tileKey(runX[run], y, _tileZoom));
+            if (!tile) {
+                qCWarning(TerrainQueryLog) << "TerrainTileManager::getCarpetHeights Internal Error: missing tile in tile cache";
+                error = true;
+                return true;
+            }
+            int first = runStart[run];
+            tile->elevationRow(lat, swLon + first * _carpetSpacing, _carpetSpacing, runStart[run + 1] - first, sampling, &heights.data()[first]);
+        }
+
+        for (double height: heights) {
+            minHeight = qMin(minHeight, height);
+            maxHeight = qMax(maxHeight, height);
+            sum += height;
+        }
+        if (!statsOnly) {
+            carpet.append(heights.toList());
+        }
+    }
+
+    avgHeight = sum / (static_cast<double>(rows) * cols);
+
+    return true;
+}
+
+/// Starts a download of the specified tile unless it is already in progress or the concurrent download limit is reached.
+/// Queries which could not start a download are retried as other downloads complete.
+void TerrainTileManager::_requestTile(int x, int y)
+{
+    quint64 key = _tileKey(x, y, _tileZoom);
+    if (_downloadingTiles.contains(key) || _downloadingTiles.count() >= _maxConcurrentDownloads) {
+        return;
+    }
+
+    QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL("Airmap Elevation", x, y, _tileZoom, &_networkManager);
+    qCDebug(TerrainQueryLog) << "TerrainTileManager::_requestTile query from database" << request.url();
+    QGeoTileSpec spec;
+    spec.setX(x);
+    spec.setY(y);
+    spec.setZoom(_tileZoom);
+    spec.setMapId(getQGCMapEngine()->urlFactory()->getIdFromType("Airmap Elevation"));
+    QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(&_networkManager, request, spec);
+    connect(reply, &QGeoTiledMapReplyQGC::terrainDone, this, &TerrainTileManager::_terrainDone);
+    _downloadingTiles.insert(key);
+}
+
+TerrainTileManager* TerrainTileManager::instance(void)
+{
+    return _terrainTileManager;
+}
+
+void TerrainTileManager::prefetchTiles(const QGCGeoBoundingCube& boundingCube)
+{
+    MapProvider* provider = _elevationProvider();
+    if (!provider || !boundingCube.isValid()) {
+        return;
+    }
+
+    int x0 = provider->long2tileX(boundingCube.pointNW.longitude(), _tileZoom);
+    int x1 = provider->long2tileX(boundingCube.pointSE.longitude(), _tileZoom);
+    int y0 = provider->lat2tileY(boundingCube.pointSE.latitude(), _tileZoom);
+    int y1 = provider->lat2tileY(boundingCube.pointNW.latitude(), _tileZoom);
+    if (x1 < x0 || y1 < y0 || static_cast<qint64>(x1 - x0 + 1) * (y1 - y0 + 1) > _maxPrefetchTiles) {
+        qCDebug(TerrainQueryLog) << "TerrainTileManager::prefetchTiles skipping area" << boundingCube.pointNW << boundingCube.pointSE;
+        return;
+    }
+
+    _tilesMutex.lock();
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            quint64 key = _tileKey(x, y, _tileZoom);
+            if (!_tiles.contains(key) && !_prefetchKeys.contains(key)) {
+                _prefetchKeys.insert(key);
+                _prefetchQueue.append(QPoint(x, y));
+            }
+        }
+    }
+    _tilesMutex.unlock();
+
+    qCDebug(TerrainQueryLog) << "TerrainTileManager::prefetchTiles tile count" << _prefetchKeys.count();
+
+    _startPrefetch();
+}
+
+/// Requests queued prefetch tiles until the concurrent download limit is reached
+void TerrainTileManager::_startPrefetch(void)
+{
+    while (!_prefetchQueue.isEmpty() && _downloadingTiles.count() < _maxConcurrentDownloads) {
+        QPoint  tile    = _prefetchQueue.takeFirst();
+        quint64 key     = _tileKey(tile.x(), tile.y(), _tileZoom);
+
+        _tilesMutex.lock();
+        bool cached = _tiles.contains(key);
+        _tilesMutex.unlock();
+
+        if (cached) {
+            // Loaded by a query in the meantime
+            _prefetchKeys.remove(key);
+        } else {
+            _requestTile(tile.x(), tile.y());
+        }
+    }
+}
+
+MapProvider* TerrainTileManager::_elevationProvider(void)
+{
+    return getQGCMapEngine()->urlFactory()->getProviderTable().value(QStringLiteral("Airmap Elevation"));
+}
+
+/// @return true: the query can't be answered without the specified tile
+bool TerrainTileManager::_requestNeedsTile(const QueuedRequestInfo_t& requestInfo, quint64 key)
+{
+    MapProvider* provider = _elevationProvider();
+    if (!provider) {
+        return true;
+    }
+
+    if (requestInfo.queryMode == QueryMode::QueryModeCarpet) {
+        int x0 = provider->long2tileX(requestInfo.coordinates[0].longitude(), _tileZoom);
+        int y0 = provider->lat2tileY(requestInfo.coordinates[0].latitude(), _tileZoom);
+        int x1 = provider->long2tileX(requestInfo.coordinates[1].longitude(), _tileZoom);
+        int y1 = provider->lat2tileY(requestInfo.coordinates[1].latitude(), _tileZoom);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                if (_tileKey(x, y, _tileZoom) == key) {
+                    return true;
+                }
+            }
+        }
+    } else if (requestInfo.queryMode == QueryMode::QueryModePath) {
+        // Same sample points as getAltitudesForPath
+        const QGeoCoordinate&   startPoint  = requestInfo.coordinates[0];
+        const QGeoCoordinate&   endPoint    = requestInfo.coordinates[1];
+        const double            latDiff     = endPoint.latitude() - startPoint.latitude();
+        const double            lonDiff     = endPoint.longitude() - startPoint.longitude();
+        const double            divisor     = qMax(requestInfo.pointCount - 1, 1);
+        for (int point = 0; point < requestInfo.pointCount; point++) {
+            int x = provider->long2tileX(startPoint.longitude() + lonDiff * point / divisor, _tileZoom);
+            int y = provider->lat2tileY(startPoint.latitude() + latDiff * point / divisor, _tileZoom);
+            if (_tileKey(x, y, _tileZoom) == key) {
+                return true;
+            }
+        }
+    } else {
+        for (const QGeoCoordinate& coordinate: requestInfo.coordinates) {
+            if (_tileKey(provider->long2tileX(coordinate.longitude(), _tileZoom), provider->lat2tileY(coordinate.latitude(), _tileZoom), _tileZoom) == key) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// Fails the queued queries which need the specified tile. All other queries stay queued, they are retried along with
+/// the next completed download.
+void TerrainTileManager::_tileFailed(quint64 key)
+{
+    QList<double> noAltitudes;
+
+    for (int i = _requestQueue.count() - 1; i >= 0; i--) {
+        const QueuedRequestInfo_t requestInfo = _requestQueue[i];
+        if (!_requestNeedsTile(requestInfo, key)) {
+            continue;
+        }
+        _requestQueue.removeAt(i);
 
-    for (const QueuedRequestInfo_t& requestInfo: _requestQueue) {
         if (requestInfo.queryMode == QueryMode::QueryModeCoordinates) {
             requestInfo.terrainQueryInterface->_signalCoordinateHeights(false, noAltitudes);
         } else if (requestInfo.queryMode == QueryMode::QueryModePath) {
             requestInfo.terrainQueryInterface->_signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
+        } else if (requestInfo.queryMode == QueryMode::QueryModeCarpet) {
+            requestInfo.terrainQueryInterface->_signalCarpetHeights(false, qQNaN(), qQNaN(), qQNaN(), QList<QList<double>>());
         }
     }
-    _requestQueue.clear();
 }
 
 void TerrainTileManager::_terrainDone(QByteArray responseBytes, QNetworkReply::NetworkError error)
 {
     QGeoTiledMapReplyQGC* reply = qobject_cast<QGeoTiledMapReplyQGC*>(QObject::sender());
-    _state = State::Idle;
 
     if (!reply) {
         qCWarning(TerrainQueryLog) << "Elevation tile fetched but invalid reply data type.";
@@ -489,80 +819,123 @@ void TerrainTileManager::_terrainDone(QByteArray responseBytes, QNetworkReply::N
 
     // remove from download queue
     QGeoTileSpec spec = reply->tileSpec();
-    QString hash = QGCMapEngine::getTileHash("Airmap Elevation", spec.x(), spec.y(), spec.zoom());
+    quint64 key = _tileKey(spec.x(), spec.y(), spec.zoom());
+    _downloadingTiles.remove(key);
+    _prefetchKeys.remove(key);
 
-    // handle potential errors
+    // handle potential errors, only the queries which need this tile fail
     if (error != QNetworkReply::NoError) {
         qCWarning(TerrainQueryLog) << "Elevation tile fetching returned error (" << error << ")";
-        _tileFailed();
-        reply->deleteLater();
-        return;
-    }
-    if (responseBytes.isEmpty()) {
+        _tileFailed(key);
+    } else if (responseBytes.isEmpty()) {
         qCWarning(TerrainQueryLog) << "Error in fetching elevation tile. Empty response.";
-        _tileFailed();
-        reply->deleteLater();
-        return;
-    }
-
-    qCDebug(TerrainQueryLog) << "Received some bytes of terrain data: " << responseBytes.size();
-
-    TerrainTile* terrainTile = new TerrainTile(responseBytes);
-    if (terrainTile->isValid()) {
-        _tilesMutex.lock();
-        if (!_tiles.contains(hash)) {
-            _tiles.insert(hash, *terrainTile);
+        _tileFailed(key);
+    } else {
+        qCDebug(TerrainQueryLog) << "Received some bytes of terrain data: " << responseBytes.size();
+
+        TerrainTile* terrainTile = new TerrainTile(responseBytes);
+        if (terrainTile->isValid()) {
+            _tilesMutex.lock();
+            if (!_tiles.contains(key)) {
+                // The cache takes ownership of the tile
+                _tiles.insert(key, terrainTile, terrainTile->dataBytes());
+            } else {
+                delete terrainTile;
+            }
+            _tilesMutex.unlock();
         } else {
             delete terrainTile;
+            qCWarning(TerrainQueryLog) << "Received invalid tile";
+            _tileFailed(key);
         }
-        _tilesMutex.unlock();
-    } else {
-        delete terrainTile;
-        qCWarning(TerrainQueryLog) << "Received invalid tile";
     }
     reply->deleteLater();
 
-    // now try to query the data again
+    // Queued queries are retried as soon as a tile they need is in. Queries which are not waiting on any download were held back
+    // by the download limit. They are retried as well, ahead of the prefetch, so they get the download slot which just freed up.
     for (int i = _requestQueue.count() - 1; i >= 0; i--) {
-        bool error;
-        QList<double> altitudes;
-        QueuedRequestInfo_t& requestInfo = _requestQueue[i];
-
-        if (getAltitudesForCoordinates(requestInfo.coordinates, altitudes, error)) {
-            if (requestInfo.queryMode == QueryMode::QueryModeCoordinates) {
-                if (error) {
-                    QList<double> noAltitudes;
-                    qCWarning(TerrainQueryLog) << "_terrainDone(coordinateQuery): signalling failure due to internal error";
-                    requestInfo.terrainQueryInterface->_signalCoordinateHeights(false, noAltitudes);
-                } else {
-                    qCDebug(TerrainQueryLog) << "_terrainDone(coordinateQuery): All altitudes taken from cached data";
-                    requestInfo.terrainQueryInterface->_signalCoordinateHeights(requestInfo.coordinates.count() == altitudes.count(), altitudes);
-                }
-            } else if (requestInfo.queryMode == QueryMode::QueryModePath) {
-                if (error) {
-                    QList<double> noAltitudes;
-                    qCWarning(TerrainQueryLog) << "_terrainDone(coordinateQuery): signalling failure due to internal error";
-                    requestInfo.terrainQueryInterface->_signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
-                } else {
-                    qCDebug(TerrainQueryLog) << "_terrainDone(coordinateQuery): All altitudes taken from cached data";
-                    requestInfo.terrainQueryInterface->_signalPathHeights(requestInfo.coordinates.count() == altitudes.count(), requestInfo.distanceBetween, requestInfo.finalDistanceBetween, altitudes);
-                }
-            }
+        const QueuedRequestInfo_t requestInfo = _requestQueue[i];
+        if (!_requestNeedsTile(requestInfo, key) && _requestNeedsDownload(requestInfo)) {
+            continue;
+        }
+        if (_retryRequest(requestInfo)) {
             _requestQueue.removeAt(i);
         }
     }
+
+    _startPrefetch();
+}
+
+/// @return true: the query is waiting on a tile which is downloading
+bool TerrainTileManager::_requestNeedsDownload(const QueuedRequestInfo_t& requestInfo)
+{
+    for (quint64 key: _downloadingTiles) {
+        if (_requestNeedsTile(requestInfo, key)) {
+            return true;
+        }
+    }
+    return false;
 }
 
-QString TerrainTileManager::_getTileHash(const QGeoCoordinate& coordinate)
+/// Tries to answer a queued query from cache, which also requests tiles that were held back by the download limit.
+///     @return true: query was answered
+bool TerrainTileManager::_retryRequest(const QueuedRequestInfo_t& requestInfo)
 {
-    QString ret = QGCMapEngine::getTileHash(
-        "Airmap Elevation",
-        getQGCMapEngine()->urlFactory()->long2tileX("Airmap Elevation", coordinate.longitude(), 1),
-        getQGCMapEngine()->urlFactory()->lat2tileY("Airmap Elevation", coordinate.latitude(), 1),
-        1);
-    qCDebug(TerrainQueryVerboseLog) << "Computing unique tile hash for " << coordinate << ret;
+    bool error;
+
+    if (requestInfo.queryMode == QueryMode::QueryModeCarpet) {
+        double                  minHeight;
+        double                  maxHeight;
+        double                  avgHeight;
+        QList<QList<double>>    carpet;
+
+        if (!getCarpetHeights(requestInfo.coordinates[0], requestInfo.coordinates[1], requestInfo.statsOnly, requestInfo.sampling, minHeight, maxHeight, avgHeight, carpet, error)) {
+            return false;
+        }
+        if (error) {
+            qCWarning(TerrainQueryLog) << "_terrainDone(carpetQuery): signalling failure due to internal error";
+            requestInfo.terrainQueryInterface->_signalCarpetHeights(false, qQNaN(), qQNaN(), qQNaN(), QList<QList<double>>());
+        } else {
+            qCDebug(TerrainQueryLog) << "_terrainDone(carpetQuery): All heights taken from cached data";
+            requestInfo.terrainQueryInterface->_signalCarpetHeights(true, minHeight, maxHeight, avgHeight, carpet);
+        }
+    } else if (requestInfo.queryMode == QueryMode::QueryModePath) {
+        QVector<double> pathAltitudes(requestInfo.pointCount);
+
+        if (!getAltitudesForPath(requestInfo.coordinates[0], requestInfo.coordinates[1], requestInfo.pointCount, pathAltitudes.data(), error)) {
+            return false;
+        }
+        if (error) {
+            QList<double> noAltitudes;
+            qCWarning(TerrainQueryLog) << "_terrainDone(pathQuery): signalling failure due to internal error";
+            requestInfo.terrainQueryInterface->_signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
+        } else {
+            qCDebug(TerrainQueryLog) << "_terrainDone(pathQuery): All altitudes taken from cached data";
+            requestInfo.terrainQueryInterface->_signalPathHeights(true, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, pathAltitudes.toList());
+        }
+    } else {
+        QList<double> altitudes;
+
+        if (!getAltitudesForCoordinates(requestInfo.coordinates, altitudes, error)) {
+            return false;
+        }
+        if (error) {
+            QList<double> noAltitudes;
+            qCWarning(TerrainQueryLog) << "_terrainDone(coordinateQuery): signalling failure due to internal error";
+            requestInfo.terrainQueryInterface->_signalCoordinateHeights(false, noAltitudes);
+        } else {
+            qCDebug(TerrainQueryLog) << "_terrainDone(coordinateQuery): All altitudes taken from cached data";
+            requestInfo.terrainQueryInterface->_signalCoordinateHeights(requestInfo.coordinates.count() == altitudes.count(), altitudes);
+        }
+    }
+
+    return true;
+}
 
-    return ret;
+quint64 TerrainTileManager::_tileKey(int x, int y, int zoom)
+{
+    // Elevation tile indices are well within 28 bits, zoom gets the top 8
+    return (static_cast<quint64>(zoom & 0xff) << 56) | (static_cast<quint64>(static_cast<quint32>(x) & 0x0fffffff) << 28) | (static_cast<quint32>(y) & 0x0fffffff);
 }
 
 TerrainAtCoordinateBatchManager::TerrainAtCoordinateBatchManager(void)
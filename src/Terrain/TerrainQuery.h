@@ -12,18 +12,24 @@
 #include "TerrainTile.h"
 #include "QGCMapEngineData.h"
 #include "QGCLoggingCategory.h"
+#include "QGCGeoBoundingCube.h"
 
 #include <QObject>
 #include <QGeoCoordinate>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QTimer>
+#include <QCache>
+#include <QMutex>
+#include <QSet>
+#include <QPoint>
 #include <QtLocation/private/qgeotiledmapreply_p.h>
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainQueryLog)
 Q_DECLARE_LOGGING_CATEGORY(TerrainQueryVerboseLog)
 
 class TerrainAtCoordinateQuery;
+class MapProvider;
 
 /// Base class for offline/online terrain queries
 class TerrainQueryInterface : public QObject
@@ -52,7 +58,7 @@ public:
 signals:
     void coordinateHeightsReceived(bool success, QList<double> heights);
     void pathHeightsReceived(bool success, double distanceBetween, double finalDistanceBetween, const QList<double>& heights);
-    void carpetHeightsReceived(bool success, double minHeight, double maxHeight, const QList<QList<double>>& carpet);
+    void carpetHeightsReceived(bool success, double minHeight, double maxHeight, double avgHeight, const QList<QList<double>>& carpet);
 };
 
 /// AirMap online implementation of terrain queries
@@ -102,10 +108,16 @@ public:
     void requestPathHeights(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord) final;
     void requestCarpetHeights(const QGeoCoordinate& swCoord, const QGeoCoordinate& neCoord, bool statsOnly) final;
 
+    /// Sets how carpet heights are sampled from the cached tiles, default is bilinear
+    void setCarpetSampling(TerrainTile::Sampling sampling) { _carpetSampling = sampling; }
+
     // Internal methods
     void _signalCoordinateHeights(bool success, QList<double> heights);
     void _signalPathHeights(bool success, double distanceBetween, double finalDistanceBetween, const QList<double>& heights);
-    void _signalCarpetHeights(bool success, double minHeight, double maxHeight, const QList<QList<double>>& carpet);
+    void _signalCarpetHeights(bool success, double minHeight, double maxHeight, double avgHeight, const QList<QList<double>>& carpet);
+
+private:
+    TerrainTile::Sampling _carpetSampling = TerrainTile::SamplingBilinear;
 };
 
 /// Used internally by TerrainOfflineAirMapQuery to manage terrain tiles
@@ -115,19 +127,29 @@ class TerrainTileManager : public QObject {
 public:
     TerrainTileManager(void);
 
+    /// @return The tile manager used by all offline terrain queries
+    static TerrainTileManager* instance(void);
+
+    /// Downloads all tiles within the bounding cube which are not cached yet, up to maxConcurrentDownloads at a time.
+    /// Queued queries don't wait for the prefetch, each one resolves as soon as the tiles it needs are in.
+    void prefetchTiles(const QGCGeoBoundingCube& boundingCube);
+
+    int     maxConcurrentDownloads      (void) const { return _maxConcurrentDownloads; }
+    void    setMaxConcurrentDownloads   (int maxConcurrentDownloads) { _maxConcurrentDownloads = qMax(1, maxConcurrentDownloads); }
+    int     downloadCount               (void) const { return _downloadingTiles.count(); }
+    int     prefetchCount               (void) const { return _prefetchKeys.count(); }
+
     void addCoordinateQuery         (TerrainOfflineAirMapQuery* terrainQueryInterface, const QList<QGeoCoordinate>& coordinates);
     void addPathQuery               (TerrainOfflineAirMapQuery* terrainQueryInterface, const QGeoCoordinate& startPoint, const QGeoCoordinate& endPoint);
+    void addCarpetQuery             (TerrainOfflineAirMapQuery* terrainQueryInterface, const QGeoCoordinate& swCoord, const QGeoCoordinate& neCoord, bool statsOnly, TerrainTile::Sampling sampling);
     bool getAltitudesForCoordinates (const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error);
+    bool getAltitudesForPath        (const QGeoCoordinate& startPoint, const QGeoCoordinate& endPoint, int pointCount, double* altitudes, bool& error);
+    bool getCarpetHeights           (const QGeoCoordinate& swCoord, const QGeoCoordinate& neCoord, bool statsOnly, TerrainTile::Sampling sampling, double& minHeight, double& maxHeight, double& avgHeight, QList<QList<double>>& carpet, bool& error);
 
 private slots:
     void _terrainDone       (QByteArray responseBytes, QNetworkReply::NetworkError error);
 
 private:
-    enum class State {
-        Idle,
-        Downloading,
-    };
-
     enum QueryMode {
         QueryModeCoordinates,
         QueryModePath,
@@ -139,18 +161,39 @@ private:
         QueryMode                   queryMode;
         double                      distanceBetween;        // Distance between each returned height
         double                      finalDistanceBetween;   // Distance between for final height
-        QList<QGeoCoordinate>       coordinates;
+        QList<QGeoCoordinate>       coordinates;            // Path queries: start and end, Carpet queries: south west and north east corners
+        int                         pointCount;             // Number of heights along path
+        bool                        statsOnly;
+        TerrainTile::Sampling       sampling;
     } QueuedRequestInfo_t;
 
-    void    _tileFailed                         (void);
-    QString _getTileHash                        (const QGeoCoordinate& coordinate);
+    void            _tileFailed         (quint64 key);
+    bool            _requestNeedsTile   (const QueuedRequestInfo_t& requestInfo, quint64 key);
+    bool            _requestNeedsDownload(const QueuedRequestInfo_t& requestInfo);
+    bool            _retryRequest       (const QueuedRequestInfo_t& requestInfo);
+    void            _requestTile        (int x, int y);
+    void            _startPrefetch      (void);
+    MapProvider*    _elevationProvider  (void);
+    static quint64  _tileKey            (int x, int y, int zoom);
 
     QList<QueuedRequestInfo_t>  _requestQueue;
-    State                       _state = State::Idle;
     QNetworkAccessManager       _networkManager;
-
-    QMutex                      _tilesMutex;
-    QHash<QString, TerrainTile> _tiles;
+    QSet<quint64>               _downloadingTiles;
+    QList<QPoint>               _prefetchQueue;                                 ///< Tile x, y still to be requested
+    QSet<quint64>               _prefetchKeys;                                  ///< Prefetch tiles which have not completed yet
+    int                         _maxConcurrentDownloads = _defaultMaxConcurrentDownloads;
+
+    /// Least recently used tiles are evicted once the elevation grids go over the byte budget
+    QMutex                          _tilesMutex;
+    QCache<quint64, TerrainTile>    _tiles;
+
+    static const int _tileZoom          = 1;
+    static const int _tileCacheBytes    = 32 * 1024 * 1024;
+    static const int _maxCarpetTiles    = 4096;     ///< Roughly 11MB of 1 arc second tiles, all stay within the cache budget
+    static const int _maxPrefetchTiles  = 4096;
+    static const int _defaultMaxConcurrentDownloads = 6;
+
+    static constexpr double _carpetSpacing = 1.0 / 3600.0;   ///< Carpet points are 1 arc second apart, the tile resolution
 };
 
 /// Used internally by TerrainAtCoordinateQuery to batch coordinate requests together
@@ -0,0 +1,330 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTileTest.h"
+#include "TerrainQuery.h"
+#include "QGCMapEngine.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QElapsedTimer>
+
+#include <cmath>
+
+TerrainTileTest::TerrainTileTest(void)
+{
+
+}
+
+/// Builds a serialized tile with its south west corner at 0,0. The elevation at each grid point is 100 * latIndex + 10 * lonIndex,
+/// which is linear so bilinear sampling can be checked exactly.
+QByteArray TerrainTileTest::_tileBytes(int gridSize, double size)
+{
+    QJsonArray carpetArray;
+    for (int i=0; i<gridSize; i++) {
+        QJsonArray rowArray;
+        for (int j=0; j<gridSize; j++) {
+            rowArray.append(100 * i + 10 * j);
+        }
+        carpetArray.append(rowArray);
+    }
+
+    QJsonObject boundsObject;
+    boundsObject["sw"] = QJsonArray({ 0.0, 0.0 });
+    boundsObject["ne"] = QJsonArray({ size, size });
+
+    QJsonObject statsObject;
+    statsObject["min"] = 0;
+    statsObject["max"] = 110 * (gridSize - 1);
+    statsObject["avg"] = 55 * (gridSize - 1);
+
+    QJsonObject dataObject;
+    dataObject["bounds"]    = boundsObject;
+    dataObject["stats"]     = statsObject;
+    dataObject["carpet"]    = carpetArray;
+
+    QJsonObject rootObject;
+    rootObject["status"]    = "success";
+    rootObject["data"]      = dataObject;
+
+    return TerrainTile::serialize(QJsonDocument(rootObject).toJson());
+}
+
+/// Builds a serialized elevation provider tile. Elevations depend only on the global grid position so neighbouring tiles agree
+/// on their shared edges.
+QByteArray TerrainTileTest::_elevationTileBytes(int x, int y)
+{
+    const int spacings = _elevationGridSize - 1;
+
+    QJsonArray carpetArray;
+    for (int i=0; i<_elevationGridSize; i++) {
+        QJsonArray rowArray;
+        for (int j=0; j<_elevationGridSize; j++) {
+            rowArray.append(((y * spacings + i) * 7 + (x * spacings + j) * 3) % 5000);
+        }
+        carpetArray.append(rowArray);
+    }
+
+    QJsonObject boundsObject;
+    boundsObject["sw"] = QJsonArray({ y * srtm1TileSize - 90.0, x * srtm1TileSize - 180.0 });
+    boundsObject["ne"] = QJsonArray({ (y + 1) * srtm1TileSize - 90.0, (x + 1) * srtm1TileSize - 180.0 });
+
+    QJsonObject statsObject;
+    statsObject["min"] = 0;
+    statsObject["max"] = 5000;
+    statsObject["avg"] = 2500;
+
+    QJsonObject dataObject;
+    dataObject["bounds"]    = boundsObject;
+    dataObject["stats"]     = statsObject;
+    dataObject["carpet"]    = carpetArray;
+
+    QJsonObject rootObject;
+    rootObject["status"]    = "success";
+    rootObject["data"]      = dataObject;
+
+    return TerrainTile::serialize(QJsonDocument(rootObject).toJson());
+}
+
+/// Makes the elevation tiles covering the area available from the hot tile cache, so the tile manager loads them without
+/// any network access
+void TerrainTileTest::_addElevationTiles(const QGeoCoordinate& southWest, const QGeoCoordinate& northEast)
+{
+    UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
+
+    int x0 = urlFactory->long2tileX("Airmap Elevation", southWest.longitude(), 1);
+    int x1 = urlFactory->long2tileX("Airmap Elevation", northEast.longitude(), 1);
+    int y0 = urlFactory->lat2tileY("Airmap Elevation", southWest.latitude(), 1);
+    int y1 = urlFactory->lat2tileY("Airmap Elevation", northEast.latitude(), 1);
+    for (int x=x0; x<=x1; x++) {
+        for (int y=y0; y<=y1; y++) {
+            getQGCMapEngine()->addHotTile(QGCMapEngine::getTileHash("Airmap Elevation", x, y, 1), _elevationTileBytes(x, y), QString());
+        }
+    }
+}
+
+/// Calls TerrainTileManager::getAltitudesForPath until all the tiles the path needs have been loaded
+bool TerrainTileTest::_getAltitudesForPath(TerrainTileManager& tileManager, const QGeoCoordinate& startPoint, const QGeoCoordinate& endPoint, int pointCount, double* altitudes)
+{
+    QElapsedTimer timer;
+
+    timer.start();
+    while (timer.elapsed() < 10000) {
+        bool error;
+        if (tileManager.getAltitudesForPath(startPoint, endPoint, pointCount, altitudes, error)) {
+            return !error;
+        }
+        QTest::qWait(1);
+    }
+    return false;
+}
+
+void TerrainTileTest::_elevation_test(void)
+{
+    TerrainTile tile(_tileBytes(3, 0.01));
+
+    QVERIFY(tile.isValid());
+    QCOMPARE(tile.dataBytes(), 9 * static_cast<int>(sizeof(int16_t)));
+    QCOMPARE(tile.elevation(QGeoCoordinate(0, 0)),          0.0);
+    QCOMPARE(tile.elevation(QGeoCoordinate(0.01, 0)),       200.0);
+    QCOMPARE(tile.elevation(QGeoCoordinate(0.0051, 0.01)),  120.0);
+
+    // Copies share nothing that can be freed twice
+    TerrainTile copy = tile;
+    QCOMPARE(copy.elevation(QGeoCoordinate(0.01, 0.01)),    220.0);
+}
+
+void TerrainTileTest::_elevationRowNearest_test(void)
+{
+    TerrainTile tile(_tileBytes(3, 0.01));
+    double      elevations[7];
+
+    // Grid spacing is 0.005, points are offset from the halfway marks so rounding is unambiguous
+    QVERIFY(tile.elevationRow(0.0051, 0.0001, 0.0025, 5, TerrainTile::SamplingNearest, elevations));
+    QCOMPARE(elevations[0], 100.0);
+    QCOMPARE(elevations[1], 110.0);
+    QCOMPARE(elevations[2], 110.0);
+    QCOMPARE(elevations[3], 120.0);
+    QCOMPARE(elevations[4], 120.0);
+
+    // Points outside of the tile clamp to the edge
+    QVERIFY(tile.elevationRow(0.02, -0.01, 0.01, 3, TerrainTile::SamplingNearest, elevations));
+    QCOMPARE(elevations[0], 200.0);
+    QCOMPARE(elevations[1], 200.0);
+    QCOMPARE(elevations[2], 220.0);
+
+    // Single elevation lookups agree
+    QVERIFY(tile.elevationRow(0.0074, 0.0026, 0, 1, TerrainTile::SamplingNearest, elevations));
+    QCOMPARE(elevations[0], tile.elevation(QGeoCoordinate(0.0074, 0.0026)));
+}
+
+void TerrainTileTest::_elevationRowBilinear_test(void)
+{
+    TerrainTile tile(_tileBytes(3, 0.01));
+    double      elevations[5];
+
+    // Halfway between the first two rows
+    QVERIFY(tile.elevationRow(0.0025, 0, 0.0025, 5, TerrainTile::SamplingBilinear, elevations));
+    for (int i=0; i<5; i++) {
+        QVERIFY(qAbs(elevations[i] - (50.0 + 5.0 * i)) < _tolerance);
+    }
+
+    // The top row and the east edge interpolate without reading past the grid
+    QVERIFY(tile.elevationRow(0.01, 0.0075, 0.0025, 3, TerrainTile::SamplingBilinear, elevations));
+    QVERIFY(qAbs(elevations[0] - 215.0) < _tolerance);
+    QVERIFY(qAbs(elevations[1] - 220.0) < _tolerance);
+    QVERIFY(qAbs(elevations[2] - 220.0) < _tolerance);
+
+    // A larger grid exercises the blended row beyond the fixed preallocation
+    TerrainTile bigTile(_tileBytes(250, 0.01));
+    double      bigElevations[2];
+    double      gridSpacing = 0.01 / 249;
+    QVERIFY(bigTile.isValid());
+    QVERIFY(bigTile.elevationRow(gridSpacing * 150.5, gridSpacing * 230.5, gridSpacing, 2, TerrainTile::SamplingBilinear, bigElevations));
+    QVERIFY(qAbs(bigElevations[0] - (100 * 150.5 + 10 * 230.5)) < _tolerance);
+    QVERIFY(qAbs(bigElevations[1] - (100 * 150.5 + 10 * 231.5)) < _tolerance);
+}
+
+void TerrainTileTest::_elevationRowInvalid_test(void)
+{
+    TerrainTile tile;
+    double      elevations[2] = { 0, 0 };
+
+    QVERIFY(!tile.elevationRow(0, 0, 0.001, 2, TerrainTile::SamplingBilinear, elevations));
+    QVERIFY(qIsNaN(elevations[0]));
+    QVERIFY(qIsNaN(elevations[1]));
+}
+
+void TerrainTileTest::_pathHeights_test(void)
+{
+    TerrainTileManager  tileManager;
+    QGeoCoordinate      southWest(47.6, -122.1);
+    QGeoCoordinate      northEast(47.64, -122.06);
+
+    _addElevationTiles(southWest, northEast);
+
+    // Diagonal paths in both directions crossing several tiles, plus one which stays within a single tile
+    QList<QPair<QGeoCoordinate, QGeoCoordinate>> paths = {
+        { QGeoCoordinate(47.6012, -122.0987),   QGeoCoordinate(47.6389, -122.0634) },
+        { QGeoCoordinate(47.6371, -122.0655),   QGeoCoordinate(47.6043, -122.0991) },
+        { QGeoCoordinate(47.6203, -122.0702),   QGeoCoordinate(47.6205, -122.0999) },
+        { QGeoCoordinate(47.6021, -122.0821),   QGeoCoordinate(47.6088, -122.0811) },
+    };
+
+    for (const auto& path: paths) {
+        int pointCount = static_cast<int>(ceil(path.first.distanceTo(path.second) / TerrainTile::terrainAltitudeSpacing)) + 1;
+
+        QVector<double> altitudes(pointCount);
+        QVERIFY(_getAltitudesForPath(tileManager, path.first, path.second, pointCount, altitudes.data()));
+
+        // Must match sampling the same points one coordinate at a time
+        QList<QGeoCoordinate> coordinates;
+        double divisor = pointCount - 1;
+        for (int i=0; i<pointCount; i++) {
+            coordinates.append(QGeoCoordinate(path.first.latitude() + (path.second.latitude() - path.first.latitude()) * i / divisor,
+                                              path.first.longitude() + (path.second.longitude() - path.first.longitude()) * i / divisor));
+        }
+        coordinates.last() = path.second;
+
+        bool            error;
+        QList<double>   expectedAltitudes;
+        QVERIFY(tileManager.getAltitudesForCoordinates(coordinates, expectedAltitudes, error));
+        QVERIFY(!error);
+        QCOMPARE(altitudes.toList(), expectedAltitudes);
+    }
+}
+
+void TerrainTileTest::_pathBenchmark_test(void)
+{
+    UT_BENCHMARK();
+
+    TerrainTileManager  tileManager;
+    QElapsedTimer       timer;
+
+    // Lawnmower transects 1km long and 5m apart, starting from the corner of the SurveyComplexItemTest polygon
+    const QGeoCoordinate    origin          (47.633550640000003, -122.08982199);
+    const double            transectLength  = 1000;
+    const double            transectSpacing = 5;
+
+    QList<QPair<QGeoCoordinate, QGeoCoordinate>> transects;
+    for (int i=0; i<_benchmarkTransects; i++) {
+        QGeoCoordinate start    = origin.atDistanceAndAzimuth(i * transectSpacing, 0);
+        QGeoCoordinate end      = start.atDistanceAndAzimuth(transectLength, 90);
+        transects.append(i & 1 ? qMakePair(end, start) : qMakePair(start, end));
+    }
+    _addElevationTiles(origin, origin.atDistanceAndAzimuth(_benchmarkTransects * transectSpacing, 0).atDistanceAndAzimuth(transectLength, 90));
+
+    QVector<int> pointCounts;
+    int totalPoints = 0;
+    for (const auto& transect: transects) {
+        pointCounts.append(static_cast<int>(ceil(transect.first.distanceTo(transect.second) / TerrainTile::terrainAltitudeSpacing)) + 1);
+        totalPoints += pointCounts.last();
+    }
+
+    // Load all tiles before timing
+    QVector<double> altitudes;
+    for (int i=0; i<transects.count(); i++) {
+        altitudes.resize(pointCounts[i]);
+        QVERIFY(_getAltitudesForPath(tileManager, transects[i].first, transects[i].second, pointCounts[i], altitudes.data()));
+    }
+
+    bool error;
+    timer.start();
+    for (int i=0; i<transects.count(); i++) {
+        altitudes.resize(pointCounts[i]);
+        QVERIFY(tileManager.getAltitudesForPath(transects[i].first, transects[i].second, pointCounts[i], altitudes.data(), error));
+        QVERIFY(!error);
+    }
+    qint64 pathNSecs = qMax(timer.nsecsElapsed(), static_cast<qint64>(1));
+
+    // Same points through a coordinate list, which is how paths used to be sampled
+    timer.start();
+    for (int i=0; i<transects.count(); i++) {
+        QList<QGeoCoordinate> coordinates;
+        double divisor = pointCounts[i] - 1;
+        for (int j=0; j<pointCounts[i]; j++) {
+            coordinates.append(QGeoCoordinate(transects[i].first.latitude() + (transects[i].second.latitude() - transects[i].first.latitude()) * j / divisor,
+                                              transects[i].first.longitude() + (transects[i].second.longitude() - transects[i].first.longitude()) * j / divisor));
+        }
+        QList<double> coordinateAltitudes;
+        QVERIFY(tileManager.getAltitudesForCoordinates(coordinates, coordinateAltitudes, error));
+        QVERIFY(!error);
+    }
+    qint64 coordinateNSecs = qMax(timer.nsecsElapsed(), static_cast<qint64>(1));
+
+    qDebug() << "Sampled" << totalPoints << "points along" << transects.count() << "transects:"
+             << "path" << pathNSecs / 1000 << "usecs,"
+             << "coordinate list" << coordinateNSecs / 1000 << "usecs,"
+             << "speedup" << static_cast<double>(coordinateNSecs) / pathNSecs;
+}
+
+void TerrainTileTest::_prefetch_test(void)
+{
+    TerrainTileManager  tileManager;
+    QGeoCoordinate      southWest(47.5, -122.2);
+    QGeoCoordinate      northEast(47.54, -122.16);
+
+    _addElevationTiles(southWest, northEast);
+
+    // Downloads are limited to the configured number at a time
+    tileManager.setMaxConcurrentDownloads(3);
+    tileManager.prefetchTiles(QGCGeoBoundingCube(QGeoCoordinate(northEast.latitude(), southWest.longitude(), 0), QGeoCoordinate(southWest.latitude(), northEast.longitude(), 100)));
+    QCOMPARE(tileManager.downloadCount(), 3);
+    QVERIFY(tileManager.prefetchCount() > tileManager.downloadCount());
+    QTRY_COMPARE_WITH_TIMEOUT(tileManager.prefetchCount(), 0, 10000);
+    QCOMPARE(tileManager.downloadCount(), 0);
+
+    // Everything within the area now resolves from cache without downloading
+    double  altitudes[100];
+    bool    error;
+    QVERIFY(tileManager.getAltitudesForPath(southWest, northEast, 100, altitudes, error));
+    QVERIFY(!error);
+    QCOMPARE(tileManager.downloadCount(), 0);
+}
@@ -0,0 +1,43 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "TerrainTile.h"
+
+class TerrainTileManager;
+
+class TerrainTileTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    TerrainTileTest(void);
+
+private slots:
+    void _elevation_test            (void);
+    void _elevationRowNearest_test  (void);
+    void _elevationRowBilinear_test (void);
+    void _elevationRowInvalid_test  (void);
+    void _pathHeights_test          (void);
+    void _pathBenchmark_test        (void);
+    void _prefetch_test             (void);
+
+private:
+    QByteArray  _tileBytes              (int gridSize, double size);
+    QByteArray  _elevationTileBytes     (int x, int y);
+    void        _addElevationTiles      (const QGeoCoordinate& southWest, const QGeoCoordinate& northEast);
+    bool        _getAltitudesForPath    (TerrainTileManager& tileManager, const QGeoCoordinate& startPoint, const QGeoCoordinate& endPoint, int pointCount, double* altitudes);
+
+    static const int _elevationGridSize     = 37;       ///< 1 arc second spacing across 0.01 degrees, edges included
+    static const int _benchmarkTransects    = 2000;
+
+    static constexpr double _tolerance = 0.01;  ///< Rows are blended in single precision
+};
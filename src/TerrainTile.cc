@@ -15,6 +15,7 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDataStream>
+#include <QVarLengthArray>
 
 QGC_LOGGING_CATEGORY(TerrainTileLog, "TerrainTileLog");
 
@@ -33,7 +34,6 @@ TerrainTile::TerrainTile()
     : _minElevation(-1.0)
     , _maxElevation(-1.0)
     , _avgElevation(-1.0)
-    , _data(nullptr)
     , _gridSizeLat(-1)
     , _gridSizeLon(-1)
     , _isValid(false)
@@ -41,22 +41,10 @@ TerrainTile::TerrainTile()
 
 }
 
-TerrainTile::~TerrainTile()
-{
-    if (_data) {
-        for (int i = 0; i < _gridSizeLat; i++) {
-            delete _data[i];
-        }
-        delete _data;
-        _data = nullptr;
-    }
-}
-
 TerrainTile::TerrainTile(QByteArray byteArray)
     : _minElevation(-1.0)
     , _maxElevation(-1.0)
     , _avgElevation(-1.0)
-    , _data(nullptr)
     , _gridSizeLat(-1)
     , _gridSizeLon(-1)
     , _isValid(false)
@@ -89,18 +77,9 @@ TerrainTile::TerrainTile(QByteArray byteArray)
         return;
     }
 
-    _data = new int16_t*[_gridSizeLat];
-    for (int k = 0; k < _gridSizeLat; k++) {
-        _data[k] = new int16_t[_gridSizeLon];
-    }
-
-    int valueIndex = 0;
-    const int16_t* pTileData = reinterpret_cast<const int16_t*>(&reinterpret_cast<const uint8_t*>(byteArray.constData())[cTileHeaderBytes]);
-    for (int i = 0; i < _gridSizeLat; i++) {
-        for (int j = 0; j < _gridSizeLon; j++) {
-            _data[i][j] = pTileData[valueIndex++];
-        }
-    }
+    // The serialized grid is already row major, so it is copied in one go
+    _data.resize(_gridSizeLat * _gridSizeLon);
+    memcpy(_data.data(), &byteArray.constData()[cTileHeaderBytes], static_cast<size_t>(cTileDataBytes));
 
     _isValid = true;
 
@@ -131,14 +110,75 @@ double TerrainTile::elevation(const QGeoCoordinate& coordinate) const
             qCWarning(TerrainTileLog) << "Internal error indexLat:indexLon == -1" << indexLat << indexLon;
             return qQNaN();
         }
-        qCDebug(TerrainTileLog) << "indexLat:indexLon" << indexLat << indexLon << "elevation" << _data[indexLat][indexLon];
-        return static_cast<double>(_data[indexLat][indexLon]);
+        int16_t elevation = _data[indexLat * _gridSizeLon + indexLon];
+        qCDebug(TerrainTileLog) << "indexLat:indexLon" << indexLat << indexLon << "elevation" << elevation;
+        return static_cast<double>(elevation);
     } else {
         qCWarning(TerrainTileLog) << "Asking for elevation, but no valid data.";
         return qQNaN();
     }
 }
 
+double TerrainTile::elevation(double latitude, double longitude) const
+{
+    if (!_isValid || _data.isEmpty()) {
+        return qQNaN();
+    }
+
+    int indexLat = qRound((latitude - _southWest.latitude()) / (_northEast.latitude() - _southWest.latitude()) * (_gridSizeLat - 1));
+    int indexLon = qRound((longitude - _southWest.longitude()) / (_northEast.longitude() - _southWest.longitude()) * (_gridSizeLon - 1));
+    return _data[qBound(0, indexLat, _gridSizeLat - 1) * _gridSizeLon + qBound(0, indexLon, _gridSizeLon - 1)];
+}
+
+bool TerrainTile::elevationRow(double latitude, double longitude, double longitudeStep, int count, Sampling sampling, double* elevations) const
+{
+    if (!_isValid || _data.isEmpty()) {
+        qCWarning(TerrainTileLog) << "Asking for elevation row, but no valid data.";
+        for (int i = 0; i < count; i++) {
+            elevations[i] = qQNaN();
+        }
+        return false;
+    }
+
+    const double    maxLatIndex     = _gridSizeLat - 1;
+    const double    maxLonIndex     = _gridSizeLon - 1;
+    const double    latScale        = maxLatIndex / (_northEast.latitude() - _southWest.latitude());
+    const double    lonScale        = maxLonIndex / (_northEast.longitude() - _southWest.longitude());
+    const double    latIndex        = qBound(0.0, (latitude - _southWest.latitude()) * latScale, maxLatIndex);
+    const double    lonIndex        = (longitude - _southWest.longitude()) * lonScale;
+    const double    lonIndexStep    = longitudeStep * lonScale;
+    const int16_t*  data            = _data.constData();
+
+    if (sampling == SamplingNearest || _gridSizeLat < 2 || _gridSizeLon < 2) {
+        const int16_t* row = &data[qRound(latIndex) * _gridSizeLon];
+        for (int i = 0; i < count; i++) {
+            elevations[i] = row[qRound(qBound(0.0, lonIndex + i * lonIndexStep, maxLonIndex))];
+        }
+    } else {
+        // Blend the two surrounding rows first. That loop runs over contiguous memory with no branches so the compiler
+        // can vectorize it, which leaves a single interpolation between columns for each point.
+        const int       row0        = qMin(static_cast<int>(latIndex), _gridSizeLat - 2);
+        const float     latFraction = static_cast<float>(latIndex - row0);
+        const int16_t*  south       = &data[row0 * _gridSizeLon];
+        const int16_t*  north       = south + _gridSizeLon;
+
+        QVarLengthArray<float, 256> blendedRow(_gridSizeLon);
+        float* blended = blendedRow.data();
+        for (int j = 0; j < _gridSizeLon; j++) {
+            blended[j] = south[j] + (north[j] - south[j]) * latFraction;
+        }
+
+        for (int i = 0; i < count; i++) {
+            const double    x           = qBound(0.0, lonIndex + i * lonIndexStep, maxLonIndex);
+            const int       col0        = qMin(static_cast<int>(x), _gridSizeLon - 2);
+            const double    lonFraction = x - col0;
+            elevations[i] = blended[col0] + (blended[col0 + 1] - blended[col0]) * lonFraction;
+        }
+    }
+
+    return true;
+}
+
 QGeoCoordinate TerrainTile::centerCoordinate(void) const
 {
     return _southWest.atDistanceAndAzimuth(_southWest.distanceTo(_northEast) / 2.0, _southWest.azimuthTo(_northEast));
@@ -4,6 +4,7 @@
 #include "QGCLoggingCategory.h"
 
 #include <QGeoCoordinate>
+#include <QVector>
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainTileLog)
 
@@ -16,8 +17,12 @@ Q_DECLARE_LOGGING_CATEGORY(TerrainTileLog)
 class TerrainTile
 {
 public:
+    enum Sampling {
+        SamplingNearest,    ///< Elevation of the closest grid point
+        SamplingBilinear,   ///< Interpolated between the four surrounding grid points
+    };
+
     TerrainTile();
-    ~TerrainTile();
 
     /**
     * Constructor from json doc with elevation data (either from file or web)
@@ -56,6 +61,30 @@ public:
     */
     double elevation(const QGeoCoordinate& coordinate) const;
 
+    /**
+    * Evaluates the elevation of the grid point closest to the given position without any logging. Positions outside of
+    * the tile are clamped to its edge.
+    *
+    * @param latitude
+    * @param longitude
+    * @return elevation, NaN if no valid data
+    */
+    double elevation(double latitude, double longitude) const;
+
+    /**
+    * Evaluates the elevation at evenly spaced points along a line of latitude. Points outside of the tile are clamped
+    * to its edge.
+    *
+    * @param latitude of the row
+    * @param longitude of the first point
+    * @param longitudeStep between points
+    * @param count number of points
+    * @param sampling method
+    * @param[out] elevations count values
+    * @return false if no valid data, elevations are set to NaN
+    */
+    bool elevationRow(double latitude, double longitude, double longitudeStep, int count, Sampling sampling, double* elevations) const;
+
     /**
     * Accessor for the minimum elevation of the tile
     *
@@ -84,6 +113,13 @@ public:
     */
     QGeoCoordinate centerCoordinate(void) const;
 
+    /**
+    * Accessor for the memory used by the elevation grid
+    *
+    * @return size in bytes
+    */
+    int dataBytes(void) const { return _data.count() * static_cast<int>(sizeof(int16_t)); }
+
     /**
     * Serialize data
     *
@@ -114,7 +150,7 @@ private:
     int16_t             _maxElevation;                                  /// Maximum elevation in tile
     double              _avgElevation;                                  /// Average elevation of the tile
 
-    int16_t**           _data;                                          /// 2D elevation data array
+    QVector<int16_t>    _data;                                          /// Elevation data grid, row major by latitude
     int16_t             _gridSizeLat;                                   /// data grid size in latitude direction
     int16_t             _gridSizeLon;                                   /// data grid size in longitude direction
     bool                _isValid;                                       /// data loaded is valid
@@ -32,6 +32,9 @@ FTPManager::FTPManager(Vehicle* vehicle)
         _ackTimer.setInterval(_ackTimerTimeoutMsecs);
     }
     connect(&_ackTimer, &QTimer::timeout, this, &FTPManager::_ackTimeout);
+
+    _vehicle->messageDispatcher()->registerHandler(this, MAVLinkMessageDispatcher::anyId, MAVLinkMessageDispatcher::anyId, MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL,
+                                                   [this](LinkInterface* /*link*/, const mavlink_message_t& message) { _mavlinkMessageReceived(message); });
     
     _lastOutgoingRequest.hdr.seqNumber = 0;
     
@@ -39,99 +42,10 @@ FTPManager::FTPManager(Vehicle* vehicle)
     Q_ASSERT(sizeof(MavlinkFTP::RequestHeader) == 12);
 }
 
-void FTPManager::_handlOpenFileROAck(MavlinkFTP::Request* ack)
+FTPManager::~FTPManager()
 {
-    qCDebug(FTPManagerLog) << QString("_handlOpenFileROAck: _waitState(%1) _readFileLength(%3)").arg(MavlinkFTP::opCodeToString(_waitState)).arg(ack->openFileLength);
-    
-    if (_waitState != MavlinkFTP::kCmdOpenFileRO) {
-        qCDebug(FTPManagerLog) << "Received OpenFileRO Ack while not waiting for it";
-        return;
-    }
-
-    if (ack->hdr.size != sizeof(uint32_t)) {
-        qCDebug(FTPManagerLog) << "_handlOpenFileROAck: ack->hdr.size != sizeof(uint32_t)" << ack->hdr.size << sizeof(uint32_t);
-        _downloadComplete(tr("Download failed"));
-        return;
-    }
-
-    _downloadState.reset();
-
-    _waitState                          = MavlinkFTP::kCmdBurstReadFile;
-    _activeSession                      = ack->hdr.session;
-    _downloadState.fileSize             = ack->openFileLength;
-    _downloadState.expectedBurstOffset  = 0;
-
-    _downloadState.file.setFileName(_downloadState.toDir.filePath(_downloadState.fileName));
-    if (!_downloadState.file.open(QFile::WriteOnly | QFile::Truncate)) {
-        qCDebug(FTPManagerLog) << "_handlOpenFileROAck: _downloadState.file open failed" << _downloadState.file.errorString();
-        _downloadComplete(tr("Download failed"));
-        return;
-    }
-
-    MavlinkFTP::Request request;
-    request.hdr.session = _activeSession;
-    request.hdr.opcode  = MavlinkFTP::kCmdBurstReadFile;
-    request.hdr.offset  = _downloadState.expectedBurstOffset;
-    request.hdr.size    = sizeof(request.data);
-    _sendRequestExpectAck(&request);
-}
-
-void FTPManager::_requestMissingBurstData()
-{
-    MavlinkFTP::Request request;
-
-    if (_downloadState.missingData.count()) {
-        MissingData_t& missingData = _downloadState.missingData.first();
-
-        uint32_t cBytesToRead = qMin((uint32_t)sizeof(request.data), missingData.cBytes);
-
-        qCDebug(FTPManagerLog) << "_requestMissingBurstData: offset:cBytesToRead" << missingData.offset << cBytesToRead;
-
-        request.hdr.session                 = _activeSession;
-        request.hdr.opcode                  = MavlinkFTP::kCmdReadFile;
-        request.hdr.offset                  = missingData.offset;
-        request.hdr.size                    = cBytesToRead;
-        _waitState                          = MavlinkFTP::kCmdReadFile;
-        _downloadState.retryCount           = 0;
-        _downloadState.expectedReadOffset   = request.hdr.offset;
-
-        if (cBytesToRead < missingData.cBytes) {
-            missingData.offset += cBytesToRead;
-            missingData.cBytes -= cBytesToRead;
-        } else {
-            _downloadState.missingData.takeFirst();
-        }
-    } else {
-        qCDebug(FTPManagerLog) << "_requestMissingBurstData: starting next burst" << _downloadState.expectedBurstOffset;
-        request.hdr.session = _activeSession;
-        request.hdr.opcode  = MavlinkFTP::kCmdBurstReadFile;
-        request.hdr.offset  = _downloadState.expectedBurstOffset;
-        request.hdr.size    = sizeof(request.data);
-        _waitState = MavlinkFTP::kCmdBurstReadFile;
-    }
-
-    _sendRequestExpectAck(&request);
-}
-
-/// Closes out a download session by writing the file and doing cleanup.
-///     @param success true: successful download completion, false: error during download
-void FTPManager::_downloadComplete(const QString& errorMsg)
-{
-    qCDebug(FTPManagerLog) << QString("_downloadComplete: errorMsg(%1)").arg(errorMsg);
-    
-    QString downloadFilePath    = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
-    QString error               = errorMsg;
-
-    _ackTimer.stop();
-    _waitState = MavlinkFTP::kCmdNone;
-
-    if (error.isEmpty()) {
-        _downloadState.file.close();
-    }
-    
-    _downloadState.reset();
-    _sendResetCommand(); // Close the open session
-    emit downloadComplete(downloadFilePath, error);
+    qDeleteAll(_downloads);
+    qDeleteAll(_downloadQueue);
 }
 
 /// Closes out an upload session doing cleanup.
@@ -147,92 +61,6 @@ void FTPManager::_uploadComplete(const QString& errorMsg)
     emit uploadComplete(errorMsg);
 }
 
-// We only do read files to fill in holes from a burst read
-void FTPManager::_handleReadFileAck(MavlinkFTP::Request* ack)
-{
-    if (ack->hdr.session != _activeSession) {
-        return;
-    }
-
-    qCDebug(FTPManagerLog) << "_handleReadFileAck: offset:size" << ack->hdr.offset << ack->hdr.size;
-
-    if (ack->hdr.offset != _downloadState.expectedReadOffset) {
-        if (++_downloadState.retryCount > _maxRetry) {
-            qCDebug(FTPManagerLog) << QString("_handleReadFileAck: retries exceeded");
-            _downloadComplete(tr("Download failed: Unable to retrieve specified file contents"));
-            return;
-        }
-
-        // Ask for current offset again
-        qCDebug(FTPManagerLog) << QString("_handleReadFileAck: retry retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedReadOffset);
-        MavlinkFTP::Request request;
-        request.hdr.session = _activeSession;
-        request.hdr.opcode  = _waitState;
-        request.hdr.offset  = _downloadState.expectedReadOffset;
-        request.hdr.size    = 0;
-        _sendRequestExpectAck(&request);
-        return;
-    }
-
-    _downloadState.file.seek(ack->hdr.offset);
-    int bytesWritten = _downloadState.file.write((const char*)ack->data, ack->hdr.size);
-    if (bytesWritten != ack->hdr.size) {
-        _downloadComplete(tr("Download failed: Error saving file"));
-        return;
-    }
-    _downloadState.bytesWritten += ack->hdr.size;
-    
-    if (_downloadState.fileSize != 0) {
-        emit commandProgress(100 * ((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize));
-    }
-
-    // Move on to fill in possible next hole
-    _requestMissingBurstData();
-}
-
-void FTPManager::_handleBurstReadFileAck(MavlinkFTP::Request* ack)
-{
-    if (ack->hdr.session != _activeSession) {
-        return;
-    }
-
-    qCDebug(FTPManagerLog) << QString("_handleBurstReadFileAck: offset(%1) size(%2) burstComplete(%3)").arg(ack->hdr.offset).arg(ack->hdr.size).arg(ack->hdr.burstComplete);
-
-    if (ack->hdr.offset != _downloadState.expectedBurstOffset) {
-        if (ack->hdr.offset > _downloadState.expectedBurstOffset) {
-            MissingData_t missingData;
-            missingData.offset = _downloadState.expectedBurstOffset;
-            missingData.cBytes = ack->hdr.offset - _downloadState.expectedBurstOffset;
-            _downloadState.missingData.append(missingData);
-            qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: adding missing data offset:cBytes" << missingData.offset << missingData.cBytes;
-        } else {
-            qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: received offset less than expected offset received:expected" << ack->hdr.offset << _downloadState.expectedBurstOffset;
-            _ackTimer.start();
-            return;
-        }
-    }
-
-    _downloadState.file.seek(ack->hdr.offset);
-    int bytesWritten = _downloadState.file.write((const char*)ack->data, ack->hdr.size);
-    if (bytesWritten != ack->hdr.size) {
-        _downloadComplete(tr("Download failed: Error saving file"));
-        return;
-    }
-    _downloadState.bytesWritten += ack->hdr.size;
-    _downloadState.expectedBurstOffset = ack->hdr.offset + ack->hdr.size;
-
-    if (_downloadState.fileSize != 0) {
-        emit commandProgress(100 * ((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize));
-    }
-
-    if (ack->hdr.burstComplete) {
-        _requestMissingBurstData();
-    } else {
-        // Still within a burst, next ack should come automatically
-        _ackTimer.start();
-    }
-}
-
 void FTPManager::_listAckResponse(MavlinkFTP::Request* /*listAck*/)
 {
 #if 0
@@ -383,16 +211,6 @@ void FTPManager::_handleAck(MavlinkFTP::Request* ack)
 {
 
     switch (ack->hdr.req_opcode) {
-    case MavlinkFTP::kCmdOpenFileRO:
-        _handlOpenFileROAck(ack);
-        break;
-    case MavlinkFTP::kCmdReadFile:
-        _handleReadFileAck(ack);
-        break;
-    case MavlinkFTP::kCmdBurstReadFile:
-        _handleBurstReadFileAck(ack);
-        break;
-
 #if 0
     case MavlinkFTP::kCmdListDirectory:
         _listAckResponse(request);
@@ -420,55 +238,27 @@ void FTPManager::_handleAck(MavlinkFTP::Request* ack)
 
 void FTPManager::_handleNak(MavlinkFTP::Request* nak)
 {
-    QString                 errorMsg;
-    MavlinkFTP::OpCode_t    requestOpCode = static_cast<MavlinkFTP::OpCode_t>(nak->hdr.req_opcode);
-    MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(nak->data[0]);
+    qCDebug(FTPManagerLog) << "_handleNak" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(nak->hdr.req_opcode)) << _errorMsgFromNak(nak);
 
-    if (errorCode == MavlinkFTP::kErrEOF) {
-        qCDebug(FTPManagerLog) << "_handleNak EOF";
-        if (requestOpCode == MavlinkFTP::kCmdReadFile && _downloadState.bytesWritten == _downloadState.fileSize) {
-            // This could be an EOF on a normal read sequence, or an EOF for a read to fill in holes from a burst read.
-            // Either way it means we should be done.
-            _downloadComplete(QString());
-            return;
-        } else if (requestOpCode == MavlinkFTP::kCmdBurstReadFile) {
-            // This is an EOF during a burst read, we still have to check for filling in missing data
-            if (_downloadState.missingData.count()) {
-                // We only call _requestMissingBurstData if there are no missing blocks since _requestMissingBurstData will start a new
-                // burst sequence if you call it with no missing blocks which would put us into an infinite loop on EOFs.
-                _requestMissingBurstData();
-                return;
-            } else if (_downloadState.bytesWritten == _downloadState.fileSize) {
-                _downloadComplete(QString());
-                return;
-            }
-        }
-    }
+    // FIXME: Error handling for the remaining commands is NYI
+    _waitState = MavlinkFTP::kCmdNone;
+}
+
+QString FTPManager::_errorMsgFromNak(MavlinkFTP::Request* nak)
+{
+    MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(nak->data[0]);
 
     // Nak's normally have 1 byte of data for error code, except for MavlinkFTP::kErrFailErrno which has additional byte for errno
     if ((errorCode == MavlinkFTP::kErrFailErrno && nak->hdr.size != 2) || ((errorCode != MavlinkFTP::kErrFailErrno) && nak->hdr.size != 1)) {
-        errorMsg = tr("Invalid Nak format");
+        return tr("Invalid Nak format");
     } else if (errorCode == MavlinkFTP::kErrFailErrno) {
-        errorMsg = tr("errno %1").arg(nak->data[1]);
+        return tr("errno %1").arg(nak->data[1]);
     } else {
-        errorMsg = MavlinkFTP::errorCodeToString(errorCode);
-    }
-
-    _waitState = MavlinkFTP::kCmdNone;
-
-    switch (nak->hdr.req_opcode) {
-    case MavlinkFTP::kCmdOpenFileRO:
-    case MavlinkFTP::kCmdReadFile:
-    case MavlinkFTP::kCmdBurstReadFile:
-        _downloadComplete(tr("Download failed: %1").arg(errorMsg));
-        break;
-    default:
-        // FIXME: Rest is NYI
-        break;
+        return MavlinkFTP::errorCodeToString(errorCode);
     }
 }
 
-void FTPManager::mavlinkMessageReceived(mavlink_message_t message)
+void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
 {
     if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
         return;
@@ -485,6 +275,14 @@ void FTPManager::mavlinkMessageReceived(mavlink_message_t message)
     
     MavlinkFTP::Request* request = (MavlinkFTP::Request*)&data.payload[0];
 
+    // Downloads have their own state and can have many requests in flight, so they don't go through the sequence checks below
+    DownloadState_t* downloadState = _findDownload(request);
+    if (downloadState) {
+        _advanceSeqNumber(request->hdr.seqNumber);
+        _handleDownloadResponse(downloadState, request);
+        return;
+    }
+
     uint16_t incomingSeqNumber = request->hdr.seqNumber;
     uint16_t expectedSeqNumber = _lastOutgoingRequest.hdr.seqNumber + 1;
 
@@ -500,13 +298,6 @@ void FTPManager::mavlinkMessageReceived(mavlink_message_t message)
 
     if (incomingSeqNumber != expectedSeqNumber) {
         switch (_waitState) {
-        case MavlinkFTP::kCmdOpenFileRO:
-            _downloadComplete(tr("Download failed: Unable to handle packet loss"));
-            break;
-        case MavlinkFTP::kCmdReadFile:
-        case MavlinkFTP::kCmdBurstReadFile:
-            // These can handle packet loss
-            break;
 #if 0
         case kCOWrite:
             _closeUploadSession(false /* failure */);
@@ -584,15 +375,6 @@ void FTPManager::_sendListCommand(void)
 bool FTPManager::download(const QString& from, const QString& toDir)
 {
     qCDebug(FTPManagerLog) << "download from:" << from << "to:" << toDir;
-    return _downloadWorker(from, toDir);
-}
-
-bool FTPManager::_downloadWorker(const QString& from, const QString& toDir)
-{
-    if (_waitState != MavlinkFTP::kCmdNone) {
-        qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
-        return false;
-    }
 
     _dedicatedLink = _vehicle->priorityLink();
     if (!_dedicatedLink) {
@@ -600,9 +382,6 @@ bool FTPManager::_downloadWorker(const QString& from, const QString& toDir)
         return false;
     }
 
-    _downloadState.reset();
-    _downloadState.toDir.setPath(toDir);
-
     QString strippedFrom;
     QString ftpPrefix("mavlinkftp://");
     if (from.startsWith(ftpPrefix, Qt::CaseInsensitive)) {
@@ -621,20 +400,546 @@ bool FTPManager::_downloadWorker(const QString& from, const QString& toDir)
     }
     lastDirSlashIndex++; // move past slash
 
-    _downloadState.fileName = strippedFrom.right(strippedFrom.size() - lastDirSlashIndex);
-    _waitState              = MavlinkFTP::kCmdOpenFileRO;
+    DownloadState_t* downloadState = new DownloadState_t;
+    downloadState->from             = strippedFrom;
+    downloadState->toDir.setPath(toDir);
+    downloadState->fileName         = strippedFrom.right(strippedFrom.size() - lastDirSlashIndex);
+    downloadState->waitState        = MavlinkFTP::kCmdNone;
+    downloadState->sessionOpen      = false;
+    downloadState->session          = 0;
+    downloadState->fileSize         = 0;
+    downloadState->nextReadOffset   = 0;
+    downloadState->bytesWritten     = 0;
+    downloadState->fileMap          = nullptr;
+    downloadState->localCrc         = 0;
+    downloadState->crcOffset        = 0;
+    downloadState->controlRequestHeld = false;
+    downloadState->retryCount       = 0;
+    downloadState->ackTimer         = new QTimer(this);
+    downloadState->ackTimer->setSingleShot(true);
+    downloadState->ackTimer->setInterval(_ackTimer.interval());
+    connect(downloadState->ackTimer, &QTimer::timeout, this, [this, downloadState]() { _downloadAckTimeout(downloadState); });
+
+    _downloadQueue.enqueue(downloadState);
+    _startQueuedDownloads();
 
-    MavlinkFTP::Request request;
-    request.hdr.session = 0;
-    request.hdr.opcode  = MavlinkFTP::kCmdOpenFileRO;
+    return true;
+}
+
+void FTPManager::_startQueuedDownloads(void)
+{
+    // Sessions are opened one at a time, the next one is started once the outstanding OpenFileRO is answered
+    if (!_openingDownload && _downloadQueue.count() && _downloads.count() < _maxDownloadSessions) {
+        DownloadState_t* downloadState = _downloadQueue.dequeue();
+        _downloads.append(downloadState);
+        qCDebug(FTPManagerLog) << "_startQueuedDownloads: opening" << downloadState->from;
+        downloadState->retryCount = 0;
+        _openingDownload = downloadState;
+        _sendDownloadControlRequest(downloadState, MavlinkFTP::kCmdOpenFileRO, downloadState->from);
+    }
+}
+
+/// The vehicle only recognizes a resent request as a duplicate if nothing else was sent in between, it then repeats its
+/// last response. An OpenFileRO which is not recognized is run again, which leaks the session opened by the first one
+/// when only its ack was lost. So while an OpenFileRO is outstanding the requests of all other downloads are held back.
+///     @return true: request was held, it is sent by _releaseHeldDownloads
+bool FTPManager::_holdDownloadRequest(DownloadState_t* downloadState, MavlinkFTP::Request* request)
+{
+    if (!_openingDownload || _openingDownload == downloadState) {
+        return false;
+    }
+
+    if (request->hdr.opcode == MavlinkFTP::kCmdReadFile) {
+        if (!downloadState->heldReads.contains(request->hdr.offset)) {
+            downloadState->heldReads.append(request->hdr.offset);
+        }
+    } else {
+        downloadState->controlRequestHeld = true;
+    }
+    return true;
+}
+
+/// Sends the requests held back while a download was opening, then opens the next queued download
+void FTPManager::_releaseHeldDownloads(void)
+{
+    if (_openingDownload) {
+        return;
+    }
+
+    for (DownloadState_t* downloadState: _downloads) {
+        QList<uint32_t> heldReads = downloadState->heldReads;
+        downloadState->heldReads.clear();
+        for (uint32_t offset: heldReads) {
+            MavlinkFTP::Request request;
+
+            request.hdr.session = downloadState->session;
+            request.hdr.opcode  = MavlinkFTP::kCmdReadFile;
+            request.hdr.offset  = offset;
+            request.hdr.size    = static_cast<uint8_t>(qMin(static_cast<uint32_t>(sizeof(request.data)), downloadState->fileSize - offset));
+            _sendDownloadRequest(downloadState, &request);
+        }
+        if (downloadState->controlRequestHeld) {
+            downloadState->controlRequestHeld = false;
+            _sendDownloadRequest(downloadState, &downloadState->controlRequest);
+        }
+    }
+
+    _startQueuedDownloads();
+}
+
+/// Sends the request which moves a download to its next state. Only one of these is outstanding per download, so the response is
+/// matched by sequence number.
+void FTPManager::_sendDownloadControlRequest(DownloadState_t* downloadState, MavlinkFTP::OpCode_t opcode, const QString& path)
+{
+    MavlinkFTP::Request& request = downloadState->controlRequest;
+
+    request.hdr.session = opcode == MavlinkFTP::kCmdTerminateSession ? downloadState->session : 0;
+    request.hdr.opcode  = opcode;
     request.hdr.offset  = 0;
     request.hdr.size    = 0;
-    _fillRequestWithString(&request, strippedFrom);
-    _sendRequestExpectAck(&request);
+    if (!path.isEmpty()) {
+        _fillRequestWithString(&request, path);
+    }
+
+    downloadState->waitState = opcode;
+    _sendDownloadRequest(downloadState, &request);
+}
+
+void FTPManager::_sendDownloadRequest(DownloadState_t* downloadState, MavlinkFTP::Request* request)
+{
+    if (_holdDownloadRequest(downloadState, request)) {
+        qCDebug(FTPManagerLog) << "_sendDownloadRequest held while another download opens" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode));
+        return;
+    }
+
+    request->hdr.seqNumber = ++_lastOutgoingRequest.hdr.seqNumber;
+    qCDebug(FTPManagerLog) << "_sendDownloadRequest opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber << "offset:" << request->hdr.offset;
+
+    downloadState->ackTimer->start();
+    _sendRequestNoAck(request);
+}
+
+/// Keeps our outgoing sequence numbers ahead of everything received from the vehicle. With several requests in flight responses
+/// arrive for requests older than the last one sent, those must not move the sequence number back.
+void FTPManager::_advanceSeqNumber(uint16_t incomingSeqNumber)
+{
+    if ((uint16_t)(incomingSeqNumber - _lastOutgoingRequest.hdr.seqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+        _lastOutgoingRequest.hdr.seqNumber = incomingSeqNumber;
+    }
+}
+
+FTPManager::DownloadState_t* FTPManager::_findDownload(MavlinkFTP::Request* response)
+{
+    for (DownloadState_t* downloadState: _downloads) {
+        if (downloadState->waitState == MavlinkFTP::kCmdReadFile || downloadState->waitState == MavlinkFTP::kCmdBurstReadFile) {
+            if (response->hdr.req_opcode == downloadState->waitState && response->hdr.session == downloadState->session) {
+                return downloadState;
+            }
+        } else if (downloadState->waitState != MavlinkFTP::kCmdNone && response->hdr.req_opcode == downloadState->waitState) {
+            if (response->hdr.seqNumber == (uint16_t)(downloadState->controlRequest.hdr.seqNumber + 1)) {
+                return downloadState;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void FTPManager::_handleDownloadResponse(DownloadState_t* downloadState, MavlinkFTP::Request* response)
+{
+    qCDebug(FTPManagerLog) << "_handleDownloadResponse" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(response->hdr.opcode)) << MavlinkFTP::opCodeToString(downloadState->waitState) << "session:offset:size" << response->hdr.session << response->hdr.offset << response->hdr.size;
+
+    downloadState->ackTimer->stop();
+    downloadState->retryCount = 0;
+
+    switch (downloadState->waitState) {
+    case MavlinkFTP::kCmdOpenFileRO:
+        _handleDownloadOpenResponse(downloadState, response);
+        break;
+    case MavlinkFTP::kCmdReadFile:
+        _handleDownloadReadResponse(downloadState, response);
+        break;
+    case MavlinkFTP::kCmdBurstReadFile:
+        _handleDownloadBurstResponse(downloadState, response);
+        break;
+    case MavlinkFTP::kCmdCalcFileCRC32:
+        _handleDownloadCrcResponse(downloadState, response);
+        break;
+    case MavlinkFTP::kCmdTerminateSession:
+        // Ack or Nak, either way the session is gone
+        _deleteDownload(downloadState);
+        break;
+    default:
+        break;
+    }
+}
+
+void FTPManager::_handleDownloadOpenResponse(DownloadState_t* downloadState, MavlinkFTP::Request* response)
+{
+    // The other downloads continue once this one is set up or has failed
+    _openingDownload = nullptr;
+
+    if (response->hdr.opcode == MavlinkFTP::kRspNak) {
+        if (response->data[0] == MavlinkFTP::kErrNoSessionsAvailable && _downloads.count() > 1) {
+            // The vehicle has fewer sessions than we are using, wait for one of the other downloads to finish
+            qCDebug(FTPManagerLog) << "_handleDownloadOpenResponse: no sessions available, limiting sessions to" << _downloads.count() - 1;
+            _maxDownloadSessions = _downloads.count() - 1;
+            downloadState->waitState = MavlinkFTP::kCmdNone;
+            _downloads.removeOne(downloadState);
+            _downloadQueue.prepend(downloadState);
+            _releaseHeldDownloads();
+            return;
+        }
+        _downloadComplete(downloadState, tr("Download failed: %1").arg(_errorMsgFromNak(response)));
+        return;
+    }
+
+    if (response->hdr.size != sizeof(uint32_t)) {
+        qCDebug(FTPManagerLog) << "_handleDownloadOpenResponse: ack->hdr.size != sizeof(uint32_t)" << response->hdr.size << sizeof(uint32_t);
+        _downloadComplete(downloadState, tr("Download failed"));
+        return;
+    }
+
+    downloadState->sessionOpen  = true;
+    downloadState->session      = response->hdr.session;
+    downloadState->fileSize     = response->openFileLength;
+
+    downloadState->file.setFileName(downloadState->toDir.filePath(downloadState->fileName));
+    if (!downloadState->file.open(QFile::ReadWrite | QFile::Truncate)) {
+        qCDebug(FTPManagerLog) << "_handleDownloadOpenResponse: file open failed" << downloadState->file.errorString();
+        _downloadComplete(downloadState, tr("Download failed"));
+        return;
+    }
+
+    // Data is written straight into a mapping of the full size file as it arrives, in whatever order that is
+    if (downloadState->fileSize && downloadState->file.resize(downloadState->fileSize)) {
+        downloadState->fileMap = downloadState->file.map(0, downloadState->fileSize);
+    }
+    if (!downloadState->fileMap) {
+        qCDebug(FTPManagerLog) << "_handleDownloadOpenResponse: file not mapped, using seek/write" << downloadState->file.errorString();
+    }
+
+    downloadState->waitState = MavlinkFTP::kCmdReadFile;
+    if (downloadState->fileSize == 0) {
+        _verifyDownload(downloadState);
+    } else if (_maxDownloadSessions == 1) {
+        // Nothing else shares the link, let the vehicle stream the file
+        _sendBurstReadRequest(downloadState);
+    } else {
+        _fillReadWindow(downloadState);
+    }
+    _releaseHeldDownloads();
+}
+
+void FTPManager::_fillReadWindow(DownloadState_t* downloadState)
+{
+    MavlinkFTP::Request request;
+
+    while (downloadState->readsInFlight.count() < _readWindow && downloadState->nextReadOffset < downloadState->fileSize) {
+        _sendReadRequest(downloadState, downloadState->nextReadOffset);
+        downloadState->nextReadOffset += sizeof(request.data);
+    }
+}
+
+void FTPManager::_sendReadRequest(DownloadState_t* downloadState, uint32_t offset)
+{
+    MavlinkFTP::Request request;
+
+    request.hdr.session = downloadState->session;
+    request.hdr.opcode  = MavlinkFTP::kCmdReadFile;
+    request.hdr.offset  = offset;
+    request.hdr.size    = static_cast<uint8_t>(qMin(static_cast<uint32_t>(sizeof(request.data)), downloadState->fileSize - offset));
+
+    downloadState->readsInFlight.append(offset);
+    _sendDownloadRequest(downloadState, &request);
+}
+
+void FTPManager::_handleDownloadReadResponse(DownloadState_t* downloadState, MavlinkFTP::Request* response)
+{
+    if (response->hdr.opcode == MavlinkFTP::kRspNak) {
+        _downloadComplete(downloadState, tr("Download failed: %1").arg(_errorMsgFromNak(response)));
+        return;
+    }
+
+    int inFlightIndex = downloadState->readsInFlight.indexOf(response->hdr.offset);
+    if (inFlightIndex == -1) {
+        qCDebug(FTPManagerLog) << "_handleDownloadReadResponse: duplicate or unrequested offset" << response->hdr.offset;
+        if (downloadState->readsInFlight.count()) {
+            downloadState->ackTimer->start();
+        }
+        return;
+    }
+
+    // Responses arrive in request order, so reads requested before this one which are still outstanding were lost
+    QList<uint32_t> lostOffsets = downloadState->readsInFlight.mid(0, inFlightIndex);
+    downloadState->readsInFlight = downloadState->readsInFlight.mid(inFlightIndex + 1);
+
+    uint32_t expectedSize = qMin(static_cast<uint32_t>(sizeof(response->data)), downloadState->fileSize - response->hdr.offset);
+    if (response->hdr.size != expectedSize) {
+        qCDebug(FTPManagerLog) << "_handleDownloadReadResponse: unexpected size offset:size:expected" << response->hdr.offset << response->hdr.size << expectedSize;
+        _downloadComplete(downloadState, tr("Download failed: Unable to retrieve specified file contents"));
+        return;
+    }
+    if (!_writeDownloadData(downloadState, response->hdr.offset, response->data, response->hdr.size)) {
+        _downloadComplete(downloadState, tr("Download failed: Error saving file"));
+        return;
+    }
+    _emitDownloadProgress();
+
+    if (downloadState->bytesWritten == downloadState->fileSize) {
+        _verifyDownload(downloadState);
+        return;
+    }
+
+    for (uint32_t lostOffset: lostOffsets) {
+        qCDebug(FTPManagerLog) << "_handleDownloadReadResponse: requesting lost offset again" << lostOffset;
+        _sendReadRequest(downloadState, lostOffset);
+    }
+    _fillReadWindow(downloadState);
+    if (downloadState->readsInFlight.count()) {
+        downloadState->ackTimer->start();
+    }
+}
+
+/// Burst reads are a single request per burst, so they are sent and held like a control request. The burst starts at the
+/// first byte we don't have yet.
+void FTPManager::_sendBurstReadRequest(DownloadState_t* downloadState)
+{
+    MavlinkFTP::Request& request = downloadState->controlRequest;
+
+    request.hdr.session = downloadState->session;
+    request.hdr.opcode  = MavlinkFTP::kCmdBurstReadFile;
+    request.hdr.offset  = downloadState->bytesWritten;
+    request.hdr.size    = sizeof(request.data);
+
+    downloadState->waitState = MavlinkFTP::kCmdBurstReadFile;
+    _sendDownloadRequest(downloadState, &request);
+}
+
+void FTPManager::_handleDownloadBurstResponse(DownloadState_t* downloadState, MavlinkFTP::Request* response)
+{
+    if (response->hdr.opcode == MavlinkFTP::kRspNak) {
+        if (response->data[0] == MavlinkFTP::kErrEOF && downloadState->bytesWritten != downloadState->controlRequest.hdr.offset) {
+            // The burst reached the end of the file but some of it was lost, the next burst picks up from there
+            _sendBurstReadRequest(downloadState);
+            return;
+        }
+        _downloadComplete(downloadState, tr("Download failed: %1").arg(_errorMsgFromNak(response)));
+        return;
+    }
+
+    // Data is only taken in order. Anything after a lost packet is sent again by the next burst.
+    if (response->hdr.offset == downloadState->bytesWritten) {
+        if (response->hdr.size == 0) {
+            _downloadComplete(downloadState, tr("Download failed: Unable to retrieve specified file contents"));
+            return;
+        }
+        if (!_writeDownloadData(downloadState, response->hdr.offset, response->data, response->hdr.size)) {
+            _downloadComplete(downloadState, tr("Download failed: Error saving file"));
+            return;
+        }
+        _emitDownloadProgress();
+
+        if (downloadState->bytesWritten == downloadState->fileSize) {
+            _verifyDownload(downloadState);
+            return;
+        }
+    } else {
+        qCDebug(FTPManagerLog) << "_handleDownloadBurstResponse: out of order offset:expected" << response->hdr.offset << downloadState->bytesWritten;
+    }
+
+    if (response->hdr.burstComplete) {
+        _sendBurstReadRequest(downloadState);
+    } else {
+        downloadState->ackTimer->start();
+    }
+}
+
+bool FTPManager::_writeDownloadData(DownloadState_t* downloadState, uint32_t offset, const uint8_t* data, uint32_t cBytes)
+{
+    if (static_cast<quint64>(offset) + cBytes > downloadState->fileSize) {
+        qCDebug(FTPManagerLog) << "_writeDownloadData: data past end of file offset:cBytes:fileSize" << offset << cBytes << downloadState->fileSize;
+        return false;
+    }
+
+    if (downloadState->fileMap) {
+        memcpy(downloadState->fileMap + offset, data, cBytes);
+    } else if (!downloadState->file.seek(offset) || downloadState->file.write(reinterpret_cast<const char*>(data), cBytes) != cBytes) {
+        return false;
+    }
+    downloadState->bytesWritten += cBytes;
+    _updateDownloadCrc(downloadState, offset, data, cBytes);
 
     return true;
 }
 
+/// Adds newly written data to localCrc. Data written past a gap is added once the gap is filled, so the CRC is complete as
+/// soon as the last byte arrives.
+void FTPManager::_updateDownloadCrc(DownloadState_t* downloadState, uint32_t offset, const uint8_t* data, uint32_t cBytes)
+{
+    if (offset != downloadState->crcOffset) {
+        if (offset > downloadState->crcOffset) {
+            downloadState->crcPending[offset] = cBytes;
+        }
+        return;
+    }
+
+    downloadState->localCrc = QGC::crc32(data, cBytes, downloadState->localCrc);
+    downloadState->crcOffset += cBytes;
+
+    while (downloadState->crcPending.contains(downloadState->crcOffset)) {
+        uint32_t pendingOffset  = downloadState->crcOffset;
+        uint32_t pendingBytes   = downloadState->crcPending.take(pendingOffset);
+
+        if (downloadState->fileMap) {
+            downloadState->localCrc = QGC::crc32(downloadState->fileMap + pendingOffset, pendingBytes, downloadState->localCrc);
+        } else {
+            downloadState->file.seek(pendingOffset);
+            QByteArray bytes = downloadState->file.read(pendingBytes);
+            downloadState->localCrc = QGC::crc32(reinterpret_cast<const quint8*>(bytes.constData()), bytes.size(), downloadState->localCrc);
+        }
+        downloadState->crcOffset += pendingBytes;
+    }
+}
+
+/// Asks the vehicle for the CRC of the file, our own was calculated as the data arrived
+void FTPManager::_verifyDownload(DownloadState_t* downloadState)
+{
+    if (downloadState->crcOffset != downloadState->fileSize) {
+        qCWarning(FTPManagerLog) << "_verifyDownload: local CRC incomplete crcOffset:fileSize" << downloadState->crcOffset << downloadState->fileSize;
+    }
+
+    downloadState->retryCount = 0;
+    _sendDownloadControlRequest(downloadState, MavlinkFTP::kCmdCalcFileCRC32, downloadState->from);
+}
+
+void FTPManager::_handleDownloadCrcResponse(DownloadState_t* downloadState, MavlinkFTP::Request* response)
+{
+    if (response->hdr.opcode == MavlinkFTP::kRspNak) {
+        // Not all vehicles support CalcFileCRC32, the file has still been downloaded completely
+        qCDebug(FTPManagerLog) << "_handleDownloadCrcResponse: download not verified" << _errorMsgFromNak(response);
+        _downloadComplete(downloadState, QString());
+        return;
+    }
+
+    uint32_t vehicleCrc = 0;
+    if (response->hdr.size == sizeof(vehicleCrc)) {
+        memcpy(&vehicleCrc, response->data, sizeof(vehicleCrc));
+    }
+    if (response->hdr.size != sizeof(vehicleCrc) || vehicleCrc != downloadState->localCrc) {
+        qCDebug(FTPManagerLog) << "_handleDownloadCrcResponse: CRC mismatch vehicle:local" << vehicleCrc << downloadState->localCrc;
+        _downloadComplete(downloadState, tr("Download failed: Downloaded file does not match file on vehicle"));
+        return;
+    }
+
+    _downloadComplete(downloadState, QString());
+}
+
+void FTPManager::_downloadAckTimeout(DownloadState_t* downloadState)
+{
+    qCDebug(FTPManagerLog) << "_downloadAckTimeout" << MavlinkFTP::opCodeToString(downloadState->waitState) << downloadState->retryCount;
+
+    if (++downloadState->retryCount > _ackTimerMaxRetries) {
+        switch (downloadState->waitState) {
+        case MavlinkFTP::kCmdCalcFileCRC32:
+            // Calculating the CRC of a large file can take the vehicle a long time, that should not fail a complete download
+            qCWarning(FTPManagerLog) << "Vehicle did not respond to CalcFileCRC32, download not verified" << downloadState->from;
+            _downloadComplete(downloadState, QString());
+            break;
+        case MavlinkFTP::kCmdTerminateSession:
+            _deleteDownload(downloadState);
+            break;
+        default:
+            _downloadComplete(downloadState, tr("Download failed: Vehicle did not respond to %1").arg(MavlinkFTP::opCodeToString(downloadState->waitState)));
+            break;
+        }
+        return;
+    }
+
+    if (downloadState->waitState == MavlinkFTP::kCmdReadFile) {
+        // Ask again for everything which is outstanding
+        QList<uint32_t> offsets = downloadState->readsInFlight;
+        downloadState->readsInFlight.clear();
+        for (uint32_t offset: offsets) {
+            _sendReadRequest(downloadState, offset);
+        }
+    } else if (downloadState->waitState == MavlinkFTP::kCmdBurstReadFile) {
+        // Start a new burst from where the data stopped
+        _sendBurstReadRequest(downloadState);
+    } else if (!_holdDownloadRequest(downloadState, &downloadState->controlRequest)) {
+        // Resent with the same sequence number so the vehicle can tell it is a duplicate and repeat its last response
+        downloadState->ackTimer->start();
+        _sendRequestNoAck(&downloadState->controlRequest);
+    }
+}
+
+void FTPManager::_emitDownloadProgress(void)
+{
+    quint64 bytesWritten    = 0;
+    quint64 fileSize        = 0;
+
+    for (const DownloadState_t* downloadState: _downloads) {
+        bytesWritten    += downloadState->bytesWritten;
+        fileSize        += downloadState->fileSize;
+    }
+    if (fileSize != 0) {
+        emit commandProgress(static_cast<int>((100 * bytesWritten) / fileSize));
+    }
+}
+
+/// Closes out a download by closing the file, signalling the result and releasing the session on the vehicle.
+///     @param errorMsg Empty for a successful download
+void FTPManager::_downloadComplete(DownloadState_t* downloadState, const QString& errorMsg)
+{
+    QString downloadFilePath = downloadState->toDir.absoluteFilePath(downloadState->fileName);
+
+    qCDebug(FTPManagerLog) << QString("_downloadComplete: file(%1) errorMsg(%2)").arg(downloadFilePath, errorMsg);
+
+    downloadState->ackTimer->stop();
+    downloadState->readsInFlight.clear();
+    downloadState->heldReads.clear();
+    downloadState->controlRequestHeld = false;
+    if (downloadState->fileMap) {
+        downloadState->file.unmap(downloadState->fileMap);
+        downloadState->fileMap = nullptr;
+    }
+    downloadState->file.close();
+    if (!errorMsg.isEmpty() && !downloadState->file.fileName().isEmpty()) {
+        // The file was created at its full size up front, don't leave a partial download behind looking complete
+        downloadState->file.remove();
+    }
+    downloadState->waitState = MavlinkFTP::kCmdNone;
+
+    // The download stays in _downloads until its session is closed so a download started from this signal queues behind it
+    emit downloadComplete(downloadFilePath, errorMsg);
+
+    if (downloadState->sessionOpen) {
+        _closeDownloadSession(downloadState);
+    } else {
+        _deleteDownload(downloadState);
+    }
+}
+
+void FTPManager::_closeDownloadSession(DownloadState_t* downloadState)
+{
+    downloadState->retryCount = 0;
+    _sendDownloadControlRequest(downloadState, MavlinkFTP::kCmdTerminateSession, QString());
+}
+
+void FTPManager::_deleteDownload(DownloadState_t* downloadState)
+{
+    // This can be called from the timer's own timeout signal
+    downloadState->ackTimer->stop();
+    downloadState->ackTimer->deleteLater();
+    _downloads.removeOne(downloadState);
+    if (_openingDownload == downloadState) {
+        _openingDownload = nullptr;
+    }
+    delete downloadState;
+
+    _releaseHeldDownloads();
+}
+
 /// @brief Uploads the specified file.
 ///     @param toPath File in UAS to upload to, fully qualified path
 ///     @param uploadFile Local file to upload from
@@ -736,17 +1041,6 @@ void FTPManager::_ackTimeout(void)
 {
     qCDebug(FTPManagerLog) << "_ackTimeout" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(_waitState));
 
-    switch (_waitState) {
-    case MavlinkFTP::kCmdReadFile:
-        // FIXME: retry count?
-        // Resend last request
-        _lastOutgoingRequest.hdr.seqNumber--;
-        _sendRequestExpectAck(&_lastOutgoingRequest);
-        return;
-    default:
-        break;
-    }
-
 #if 0
     if (++_ackNumTries <= _ackTimerMaxRetries) {
         qCDebug(FTPManagerLog) << "ack timeout - retrying";
@@ -772,11 +1066,6 @@ void FTPManager::_ackTimeout(void)
     // to idle. FileView UI works this way with the List command.
 
     switch (_waitState) {
-    case MavlinkFTP::kCmdOpenFileRO:
-    case MavlinkFTP::kCmdBurstReadFile:
-    case MavlinkFTP::kCmdReadFile:
-        _downloadComplete(tr("Download failed: Vehicle did not respond to %1").arg(MavlinkFTP::opCodeToString(_waitState)));
-        break;
 #if 0
         // FIXME: NYI
     case kCOOpenRead:
@@ -14,6 +14,7 @@
 #include <QDir>
 #include <QTimer>
 #include <QQueue>
+#include <QMap>
 
 #include "UASInterface.h"
 #include "QGCLoggingCategory.h"
@@ -29,13 +30,24 @@ class FTPManager : public QObject
     
 public:
     FTPManager(Vehicle* vehicle);
+    ~FTPManager();
 
-	/// Downloads the specified file.
+	/// Downloads the specified file. Several downloads can be in progress at the same time, each using its own session.
+    /// Downloads beyond the session limit are queued until a session is free.
     ///     @param from     File to download from vehicle, fully qualified path. May be in the format mavlinkftp://...
     ///     @param toDir    Local directory to download file to
-    /// @return true: download has started, false: error, no download
+    /// @return true: download has started or is queued, false: error, no download
     /// Signals downloadComplete, commandError, commandProgress
     bool download(const QString& from, const QString& toDir);
+
+    /// Maximum number of sessions used for concurrent downloads. Lowered automatically if the vehicle runs out of sessions.
+    /// With a single session files are downloaded using burst reads.
+    void setMaxDownloadSessions(int maxDownloadSessions) { _maxDownloadSessions = qMax(maxDownloadSessions, 1); }
+    int  maxDownloadSessions(void) const { return _maxDownloadSessions; }
+
+    /// Number of ReadFile requests kept in flight for each download session, not used for burst reads
+    void setReadWindow(int readWindow) { _readWindow = qMax(readWindow, 1); }
+    int  readWindow(void) const { return _readWindow; }
 	
 	/// Stream downloads the specified file.
     ///     @param from     File to download from UAS, fully qualified path. May be in the format mavlinkftp://...
@@ -54,8 +66,6 @@ public:
     /// Create a remote directory
     void createDirectory(const QString& directory);
 
-    void mavlinkMessageReceived(mavlink_message_t message);
-
 signals:
     void downloadComplete   (const QString& file, const QString& errorMsg);
     void uploadComplete     (const QString& errorMsg);
@@ -78,6 +88,7 @@ private slots:
 	void _ackTimeout(void);
 
 private:
+    void    _mavlinkMessageReceived (const mavlink_message_t& message);
     bool    _sendOpcodeOnlyCmd      (MavlinkFTP::OpCode_t opcode, MavlinkFTP::OpCode_t newWaitState);
     void    _emitErrorMessage       (const QString& msg);
     void    _emitListEntry          (const QString& entry);
@@ -85,19 +96,13 @@ private:
     void    _sendRequestNoAck       (MavlinkFTP::Request* request);
     void    _sendMessageOnLink      (LinkInterface* link, mavlink_message_t message);
     void    _fillRequestWithString  (MavlinkFTP::Request* request, const QString& str);
-    void    _handlOpenFileROAck     (MavlinkFTP::Request* ack);
-    void    _handleReadFileAck      (MavlinkFTP::Request* ack);
-    void    _handleBurstReadFileAck (MavlinkFTP::Request* ack);
     void    _listAckResponse        (MavlinkFTP::Request* listAck);
     void    _createAckResponse      (MavlinkFTP::Request* createAck);
     void    _writeAckResponse       (MavlinkFTP::Request* writeAck);
     void    _writeFileDatablock     (void);
     void    _sendListCommand        (void);
     void    _sendResetCommand       (void);
-    void    _downloadComplete       (const QString& errorMsg);
     void    _uploadComplete         (const QString& errorMsg);
-    bool    _downloadWorker         (const QString& from, const QString& toDir);
-    void    _requestMissingBurstData(void);
     void    _handleAck              (MavlinkFTP::Request* ack);
     void    _handleNak              (MavlinkFTP::Request* nak);
 
@@ -110,38 +115,66 @@ private:
     unsigned                _listOffset;                                        ///< offset for the current List operation
     QString                 _listPath;                                          ///< path for the current List operation
     uint8_t                 _activeSession          = 0;                        ///< currently active session, 0 for none
-    uint32_t                _readOffset;                                        ///< current read offset
     
     uint32_t    _writeOffset;               ///< current write offset
     uint32_t    _writeSize;                 ///< current write data size
     uint32_t    _writeFileSize;             ///< Size of file being uploaded
     QByteArray  _writeFileAccumulator;      ///< Holds file being uploaded
     
-    typedef struct  {
-        uint32_t offset;
-        uint32_t cBytes;
-    } MissingData_t;
-
-    struct {
-        uint32_t                expectedBurstOffset;    ///< offset which should be coming next in a burst sequence
-        uint32_t                expectedReadOffset;     ///< offset which should be coming from a hole filling read request
-        uint32_t                bytesWritten;
-        QList<MissingData_t>    missingData;
+    /// State for a single download. Downloads run independently of each other and of the other commands, each in its own session.
+    typedef struct {
+        QString                 from;                   ///< Fully qualified path of file on vehicle
         QDir                    toDir;                  ///< Directory to download file to
         QString                 fileName;               ///< Filename (no path) for download file
+        MavlinkFTP::OpCode_t    waitState;              ///< Current operation of this download
+        MavlinkFTP::Request     controlRequest;         ///< Outstanding OpenFileRO/CalcFileCRC32/TerminateSession request, resent as is on timeout
+        bool                    sessionOpen;
+        uint8_t                 session;                ///< Session returned by OpenFileRO
         uint32_t                fileSize;               ///< Size of file being downloaded
+        uint32_t                nextReadOffset;         ///< Lowest offset which has never been requested
+        uint32_t                bytesWritten;
+        QList<uint32_t>         readsInFlight;          ///< Offsets of ReadFile requests which have not been answered yet, in request order
         QFile                   file;
+        uchar*                  fileMap;                ///< File mapped for positional writes, nullptr: writes go through seek/write
+        quint32                 localCrc;               ///< CRC32 of the downloaded file, calculated as the data arrives
+        uint32_t                crcOffset;              ///< localCrc covers the file up to this offset
+        QMap<uint32_t, uint32_t> crcPending;            ///< offset:size of data written past a gap at crcOffset
+        QList<uint32_t>         heldReads;              ///< Offsets of ReadFile requests held back while another download opens
+        bool                    controlRequestHeld;     ///< controlRequest was held back while another download opens
         int                     retryCount;
-
-        void reset() {
-            expectedBurstOffset = 0;
-            expectedReadOffset  = 0;
-            bytesWritten        = 0;
-            retryCount          = 0;
-            missingData.clear();
-            file.close();
-        }
-    } _downloadState;
+        QTimer*                 ackTimer;
+    } DownloadState_t;
+
+    void                _startQueuedDownloads           (void);
+    bool                _holdDownloadRequest            (DownloadState_t* downloadState, MavlinkFTP::Request* request);
+    void                _releaseHeldDownloads           (void);
+    DownloadState_t*    _findDownload                   (MavlinkFTP::Request* response);
+    void                _handleDownloadResponse         (DownloadState_t* downloadState, MavlinkFTP::Request* response);
+    void                _handleDownloadOpenResponse     (DownloadState_t* downloadState, MavlinkFTP::Request* response);
+    void                _handleDownloadReadResponse     (DownloadState_t* downloadState, MavlinkFTP::Request* response);
+    void                _handleDownloadBurstResponse    (DownloadState_t* downloadState, MavlinkFTP::Request* response);
+    void                _handleDownloadCrcResponse      (DownloadState_t* downloadState, MavlinkFTP::Request* response);
+    void                _downloadAckTimeout             (DownloadState_t* downloadState);
+    void                _fillReadWindow                 (DownloadState_t* downloadState);
+    void                _sendReadRequest                (DownloadState_t* downloadState, uint32_t offset);
+    void                _sendBurstReadRequest           (DownloadState_t* downloadState);
+    bool                _writeDownloadData              (DownloadState_t* downloadState, uint32_t offset, const uint8_t* data, uint32_t cBytes);
+    void                _updateDownloadCrc              (DownloadState_t* downloadState, uint32_t offset, const uint8_t* data, uint32_t cBytes);
+    void                _verifyDownload                 (DownloadState_t* downloadState);
+    void                _sendDownloadControlRequest     (DownloadState_t* downloadState, MavlinkFTP::OpCode_t opcode, const QString& path);
+    void                _sendDownloadRequest            (DownloadState_t* downloadState, MavlinkFTP::Request* request);
+    void                _downloadComplete               (DownloadState_t* downloadState, const QString& errorMsg);
+    void                _closeDownloadSession           (DownloadState_t* downloadState);
+    void                _deleteDownload                 (DownloadState_t* downloadState);
+    void                _emitDownloadProgress           (void);
+    void                _advanceSeqNumber               (uint16_t incomingSeqNumber);
+    QString             _errorMsgFromNak                (MavlinkFTP::Request* nak);
+
+    QList<DownloadState_t*>     _downloads;                                     ///< Downloads which are opening, running or closing their session
+    QQueue<DownloadState_t*>    _downloadQueue;                                 ///< Downloads waiting for a free session
+    DownloadState_t*            _openingDownload        = nullptr;              ///< Download with an outstanding OpenFileRO, see _holdDownloadRequest
+    int                         _maxDownloadSessions    = 2;
+    int                         _readWindow             = 8;
 
     static const int _ackTimerTimeoutMsecs  = 1000;
     static const int _ackTimerMaxRetries    = 6;
@@ -13,6 +13,8 @@
 #include "MockLink.h"
 #include "FTPManager.h"
 
+#include <QElapsedTimer>
+
 const FTPManagerTest::TestCase_t FTPManagerTest::_rgTestCases[] = {
     {  "/version.json" },
 };
@@ -101,16 +103,108 @@ void FTPManagerTest::_testLostPackets(void)
     QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
 
     _mockLink->mockLinkFTP()->enableRandromDrops(true);
-    ftpManager->download(filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation));
 
-    QCOMPARE(spyDownloadComplete.wait(10000), true);
-    QCOMPARE(spyDownloadComplete.count(), 1);
+    // A single session downloads with burst reads, more sessions use pipelined reads
+    for (int sessions=1; sessions<=2; sessions++) {
+        ftpManager->setMaxDownloadSessions(sessions);
+        ftpManager->download(filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation));
 
-    // void downloadComplete   (const QString& file, const QString& errorMsg);
-    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
-    QVERIFY(arguments[1].toString().isEmpty());
+        QCOMPARE(spyDownloadComplete.wait(10000), true);
+        QCOMPARE(spyDownloadComplete.count(), 1);
 
-    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+        // void downloadComplete   (const QString& file, const QString& errorMsg);
+        QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+        QVERIFY(arguments[1].toString().isEmpty());
+
+        _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+    }
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_downloadFiles(const QList<int>& fileSizes, int timeoutMSecs)
+{
+    FTPManager*     ftpManager = _vehicle->ftpManager();
+    QElapsedTimer   timer;
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    for (int fileSize: fileSizes) {
+        QVERIFY(ftpManager->download(QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize), QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+    }
+
+    timer.start();
+    while (spyDownloadComplete.count() < fileSizes.count() && timer.elapsed() < timeoutMSecs) {
+        spyDownloadComplete.wait(timeoutMSecs - static_cast<int>(timer.elapsed()));
+    }
+    QCOMPARE(spyDownloadComplete.count(), fileSizes.count());
+
+    // Downloads complete in any order
+    for (const QList<QVariant>& arguments: spyDownloadComplete) {
+        QVERIFY(arguments[1].toString().isEmpty());
+        QString filename = arguments[0].toString();
+        int fileSize = filename.right(filename.length() - filename.lastIndexOf('-') - 1).toInt();
+        QVERIFY(fileSizes.contains(fileSize));
+        _verifyFileSizeAndDelete(filename, fileSize);
+    }
+}
+
+void FTPManagerTest::_testConcurrentDownloads(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager = _vehicle->ftpManager();
+
+    // More downloads than sessions, so some have to queue. Completed downloads are verified with a CRC from the vehicle.
+    ftpManager->setMaxDownloadSessions(2);
+    ftpManager->setReadWindow(4);
+    _downloadFiles({ 100, 1000, 3000, 5000, 0 }, 10000);
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testThroughputBenchmark(void)
+{
+    UT_BENCHMARK();
+
+    typedef struct {
+        int sessions;
+        int readWindow;
+    } BenchmarkCase_t;
+
+    // A single session is the burst read baseline, the read window only applies to pipelined reads with more sessions
+    static const BenchmarkCase_t rgBenchmarkCases[] = {
+        { 1, 1 },
+        { 2, 1 },
+        { 2, 8 },
+        { _benchmarkFileCount, 8 },
+    };
+
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager = _vehicle->ftpManager();
+    QList<int>  fileSizes;
+
+    for (int i=0; i<_benchmarkFileCount; i++) {
+        // Unique sizes so the downloaded files don't overwrite each other
+        fileSizes.append(_benchmarkFileSize + i);
+    }
+
+    _mockLink->setLinkSimulation(_benchmarkLatencyMSecs, 0);
+    for (const BenchmarkCase_t& benchmarkCase: rgBenchmarkCases) {
+        QElapsedTimer timer;
+
+        ftpManager->setMaxDownloadSessions(benchmarkCase.sessions);
+        ftpManager->setReadWindow(benchmarkCase.readWindow);
+
+        timer.start();
+        _downloadFiles(fileSizes, 120000);
+        qint64 elapsedMSecs = qMax(timer.elapsed(), static_cast<qint64>(1));
+
+        qDebug() << "Downloaded" << _benchmarkFileCount << "x" << _benchmarkFileSize << "bytes, sessions" << benchmarkCase.sessions << (benchmarkCase.sessions == 1 ? "burst reads" : "read window") << benchmarkCase.readWindow << "latency" << _benchmarkLatencyMSecs << "msecs:"
+                 << elapsedMSecs << "msecs," << (_benchmarkFileCount * _benchmarkFileSize * 1000LL) / (elapsedMSecs * 1024) << "KB/sec";
+    }
+    _mockLink->setLinkSimulation(0, 0);
 
     _disconnectMockLink();
 }
@@ -19,6 +19,8 @@ private slots:
     void _performSizeBasedTestCases (void);
     void _performTestCases          (void);
     void _testLostPackets           (void);
+    void _testConcurrentDownloads   (void);
+    void _testThroughputBenchmark   (void);
 
 private:
     typedef struct {
@@ -28,6 +30,11 @@ private:
     void _testCaseWorker            (const TestCase_t& testCase);
     void _sizeTestCaseWorker        (int fileSize);
     void _verifyFileSizeAndDelete   (const QString& filename, int expectedSize);
+    void _downloadFiles             (const QList<int>& fileSizes, int timeoutMSecs);
+
+    static const int _benchmarkFileCount    = 4;
+    static const int _benchmarkFileSize     = 64 * 1024;
+    static const int _benchmarkLatencyMSecs = 2;
 
     static const TestCase_t _rgTestCases[];
 };
@@ -0,0 +1,345 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryHistory.h"
+#include "Fact.h"
+#include "Vehicle.h"
+#include "QGC.h"
+
+#include <string.h>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(TelemetryHistoryLog, "TelemetryHistoryLog")
+
+TelemetryHistory::TelemetryHistory(QObject* parent)
+    : QObject(parent)
+{
+
+}
+
+int TelemetryHistory::column(const QString& name, int capacity)
+{
+    int index = findColumn(name);
+    if (index != -1) {
+        return index;
+    }
+
+    Column_t column;
+    column.name     = name;
+    column.first    = 0;
+    column.count    = 0;
+    column.times.resize(qMax(capacity, 1));
+    column.values.resize(qMax(capacity, 1));
+
+    index = _columns.count();
+    _columns.append(column);
+    _columnIndexByName[name] = index;
+
+    qCDebug(TelemetryHistoryLog) << "Column added" << name << capacity;
+    emit columnAdded(index, name);
+
+    return index;
+}
+
+QStringList TelemetryHistory::columnNames(void) const
+{
+    QStringList names;
+    for (const Column_t& column: _columns) {
+        names.append(column.name);
+    }
+    return names;
+}
+
+int TelemetryHistory::trackFact(Fact* fact, const QString& name, int capacity)
+{
+    int index = column(name, capacity);
+    connect(fact, &Fact::rawValueChanged, this, [this, index](QVariant value) {
+        append(index, static_cast<qint64>(QGC::bootTimeMilliseconds()), value.toDouble());
+    });
+    return index;
+}
+
+QString TelemetryHistory::messageFieldColumnName(const QString& messageName, const QString& fieldName, int compid)
+{
+    if (compid == MAVLinkMessageDispatcher::anyId) {
+        return QStringLiteral("%1.%2").arg(messageName, fieldName);
+    }
+    return QStringLiteral("%1[%2].%3").arg(messageName).arg(compid).arg(fieldName);
+}
+
+int TelemetryHistory::trackMessageField(Vehicle* vehicle, uint32_t msgid, const QString& fieldName, int compid, int capacity)
+{
+    const mavlink_message_info_t* msgInfo = mavlink_get_message_info_by_id(msgid);
+    if (!msgInfo) {
+        qWarning() << "TelemetryHistory::trackMessageField unknown msgid" << msgid;
+        return -1;
+    }
+
+    for (unsigned int i=0; i<msgInfo->num_fields; i++) {
+        const mavlink_field_info_t& field = msgInfo->fields[i];
+        if (fieldName != QLatin1String(field.name)) {
+            continue;
+        }
+
+        // Field info lives in the static message info table so it is safe to hold on to
+        const mavlink_field_info_t* fieldInfo   = &field;
+        int                         index       = column(messageFieldColumnName(msgInfo->name, fieldName, compid), capacity);
+        if (_trackedMessageColumns.contains(index)) {
+            // A second handler would record every sample twice
+            _trackedMessageColumns[index].trackCount++;
+            return index;
+        }
+        TrackedField_t trackedField;
+        trackedField.vehicle        = vehicle;
+        trackedField.trackCount     = 1;
+        trackedField.registrationId = vehicle->messageDispatcher()->registerHandler(this, vehicle->id(), compid, static_cast<int>(msgid),
+                                                                                    [this, index, fieldInfo](LinkInterface*, const mavlink_message_t& message) {
+            double value;
+            if (fieldValue(message, *fieldInfo, value)) {
+                append(index, static_cast<qint64>(QGC::bootTimeMilliseconds()), value);
+            }
+        });
+        _trackedMessageColumns[index] = trackedField;
+        return index;
+    }
+
+    qWarning() << "TelemetryHistory::trackMessageField unknown field" << msgInfo->name << fieldName;
+    return -1;
+}
+
+void TelemetryHistory::untrackMessageField(int column)
+{
+    auto it = _trackedMessageColumns.find(column);
+    if (it == _trackedMessageColumns.end()) {
+        qWarning() << "TelemetryHistory::untrackMessageField column not tracked" << column;
+        return;
+    }
+    if (--it->trackCount > 0) {
+        return;
+    }
+    if (it->vehicle) {
+        it->vehicle->messageDispatcher()->unregisterHandler(it->registrationId);
+    }
+    _trackedMessageColumns.erase(it);
+    qCDebug(TelemetryHistoryLog) << "Column no longer tracked" << _columns[column].name;
+}
+
+void TelemetryHistory::append(int column, qint64 timeMSecs, double value)
+{
+    Column_t&   col         = _columns[column];
+    int         capacity    = col.times.count();
+    int         index;
+
+    if (col.count < capacity) {
+        index = _physicalIndex(col, col.count);
+        col.count++;
+    } else {
+        index = col.first;
+        col.first = col.first + 1 == capacity ? 0 : col.first + 1;
+    }
+
+    col.times[index]    = timeMSecs;
+    col.values[index]   = value;
+}
+
+bool TelemetryHistory::lastSample(int column, qint64& timeMSecs, double& value) const
+{
+    const Column_t& col = _columns[column];
+    if (col.count == 0) {
+        return false;
+    }
+
+    int index = _physicalIndex(col, col.count - 1);
+    timeMSecs   = col.times[index];
+    value       = col.values[index];
+    return true;
+}
+
+int TelemetryHistory::_physicalIndex(const Column_t& column, int logicalIndex) const
+{
+    int index = column.first + logicalIndex;
+    return index >= column.times.count() ? index - column.times.count() : index;
+}
+
+int TelemetryHistory::_lowerBound(const Column_t& column, qint64 timeMSecs) const
+{
+    int low     = 0;
+    int high    = column.count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (column.times[_physicalIndex(column, middle)] < timeMSecs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+int TelemetryHistory::range(int column, qint64 startMSecs, qint64 endMSecs, int maxPoints, QVector<QPointF>& points) const
+{
+    const Column_t& col     = _columns[column];
+    int             first   = _lowerBound(col, startMSecs);
+    int             last    = endMSecs == std::numeric_limits<qint64>::max() ? col.count : _lowerBound(col, endMSecs + 1);
+    int             count   = last - first;
+
+    if (count <= 0) {
+        return 0;
+    }
+
+    if (count <= maxPoints || maxPoints < 2) {
+        points.reserve(points.count() + count);
+        for (int i=first; i<last; i++) {
+            int index = _physicalIndex(col, i);
+            points.append(QPointF(col.times[index], col.values[index]));
+        }
+        return count;
+    }
+
+    int bucketCount = maxPoints / 2;
+    int added       = 0;
+    points.reserve(points.count() + bucketCount * 2);
+
+    for (int bucket=0; bucket<bucketCount; bucket++) {
+        int bucketFirst = first + static_cast<int>(static_cast<qint64>(count) * bucket / bucketCount);
+        int bucketLast  = first + static_cast<int>(static_cast<qint64>(count) * (bucket + 1) / bucketCount);
+        if (bucketFirst == bucketLast) {
+            continue;
+        }
+
+        int minIndex = _physicalIndex(col, bucketFirst);
+        int maxIndex = minIndex;
+        for (int i=bucketFirst+1; i<bucketLast; i++) {
+            int index = _physicalIndex(col, i);
+            if (col.values[index] < col.values[minIndex]) {
+                minIndex = index;
+            }
+            if (col.values[index] > col.values[maxIndex]) {
+                maxIndex = index;
+            }
+        }
+
+        // Keep time order within the bucket
+        bool minFirst = col.times[minIndex] <= col.times[maxIndex];
+        int  index1   = minFirst ? minIndex : maxIndex;
+        int  index2   = minFirst ? maxIndex : minIndex;
+        points.append(QPointF(col.times[index1], col.values[index1]));
+        added++;
+        if (index2 != index1) {
+            points.append(QPointF(col.times[index2], col.values[index2]));
+            added++;
+        }
+    }
+
+    return added;
+}
+
+bool TelemetryHistory::minMax(int column, qint64 startMSecs, qint64 endMSecs, double& min, double& max) const
+{
+    const Column_t& col     = _columns[column];
+    int             first   = _lowerBound(col, startMSecs);
+    int             last    = endMSecs == std::numeric_limits<qint64>::max() ? col.count : _lowerBound(col, endMSecs + 1);
+
+    if (first >= last) {
+        return false;
+    }
+
+    min = max = col.values[_physicalIndex(col, first)];
+    for (int i=first+1; i<last; i++) {
+        double value = col.values[_physicalIndex(col, i)];
+        min = qMin(min, value);
+        max = qMax(max, value);
+    }
+    return true;
+}
+
+void TelemetryHistory::clear(int column)
+{
+    _columns[column].first = 0;
+    _columns[column].count = 0;
+}
+
+void TelemetryHistory::clearAll(void)
+{
+    for (int i=0; i<_columns.count(); i++) {
+        clear(i);
+    }
+}
+
+bool TelemetryHistory::fieldValue(const mavlink_message_t& message, const mavlink_field_info_t& field, double& value)
+{
+    const char* data = _MAV_PAYLOAD(&message) + field.wire_offset;
+
+    switch (field.type) {
+    case MAVLINK_TYPE_CHAR:
+        return false;
+    case MAVLINK_TYPE_UINT8_T:
+        value = *reinterpret_cast<const uint8_t*>(data);
+        break;
+    case MAVLINK_TYPE_INT8_T:
+        value = *reinterpret_cast<const int8_t*>(data);
+        break;
+    case MAVLINK_TYPE_UINT16_T:
+    {
+        uint16_t v;
+        memcpy(&v, data, sizeof(v));
+        value = v;
+    }
+        break;
+    case MAVLINK_TYPE_INT16_T:
+    {
+        int16_t v;
+        memcpy(&v, data, sizeof(v));
+        value = v;
+    }
+        break;
+    case MAVLINK_TYPE_UINT32_T:
+    {
+        uint32_t v;
+        memcpy(&v, data, sizeof(v));
+        value = v;
+    }
+        break;
+    case MAVLINK_TYPE_INT32_T:
+    {
+        int32_t v;
+        memcpy(&v, data, sizeof(v));
+        value = v;
+    }
+        break;
+    case MAVLINK_TYPE_FLOAT:
+    {
+        float v;
+        memcpy(&v, data, sizeof(v));
+        value = static_cast<double>(v);
+    }
+        break;
+    case MAVLINK_TYPE_DOUBLE:
+        memcpy(&value, data, sizeof(value));
+        break;
+    case MAVLINK_TYPE_UINT64_T:
+    {
+        uint64_t v;
+        memcpy(&v, data, sizeof(v));
+        value = static_cast<double>(v);
+    }
+        break;
+    case MAVLINK_TYPE_INT64_T:
+    {
+        int64_t v;
+        memcpy(&v, data, sizeof(v));
+        value = static_cast<double>(v);
+    }
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QPointF>
+#include <QStringList>
+#include <QVector>
+
+#include "QGCMAVLink.h"
+#include "QGCLoggingCategory.h"
+#include "MAVLinkMessageDispatcher.h"
+
+class Fact;
+class Vehicle;
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryHistoryLog)
+
+/// Fixed memory store of recent telemetry for a Vehicle.
+///
+/// Each column is a ring buffer of timestamped values with a capacity fixed at creation. Timestamps and values are kept
+/// in separate arrays so range queries only touch what they need. Appending is O(1), range queries binary search the
+/// timestamps and can reduce the result to per bucket min/max pairs for plotting. Columns can be fed from Facts, from
+/// fields of MAVLink messages or directly through append.
+class TelemetryHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    TelemetryHistory(QObject* parent = nullptr);
+
+    static const int defaultCapacity = 50 * 60 * 5;     ///< 5 minutes at 50Hz
+
+    /// @return Column index for the specified name, the column is created with the specified capacity if it does not exist yet
+    int column(const QString& name, int capacity = defaultCapacity);
+
+    /// @return Column index for the specified name, -1 if not found
+    int findColumn(const QString& name) const { return _columnIndexByName.value(name, -1); }
+
+    QStringList columnNames(void) const;
+
+    /// Records every raw value change of the Fact. Facts in a FactGroup with an update rate only change at that rate.
+    ///     @return Column index
+    int trackFact(Fact* fact, const QString& name, int capacity = defaultCapacity);
+
+    /// Records the first element of a numeric field of a MAVLink message from the vehicle at the rate it is received.
+    /// The column is named by messageFieldColumnName. Tracking the same field again returns the existing column.
+    ///     @param compid Component to record the field from, MAVLinkMessageDispatcher::anyId for all of them
+    ///     @return Column index, -1 for an unknown message or field
+    int trackMessageField(Vehicle* vehicle, uint32_t msgid, const QString& fieldName, int compid = MAVLinkMessageDispatcher::anyId, int capacity = defaultCapacity);
+
+    /// Releases a column returned by trackMessageField. The message handler is removed once every caller which tracked
+    /// the field has released it, the samples recorded so far are kept.
+    void untrackMessageField(int column);
+
+    /// @return "MESSAGE_NAME.field_name" for all components, "MESSAGE_NAME[compid].field_name" for a single component
+    static QString messageFieldColumnName(const QString& messageName, const QString& fieldName, int compid = MAVLinkMessageDispatcher::anyId);
+
+    /// Appends a sample to the column, overwriting the oldest sample once the column is full. Timestamps within a
+    /// column must not go backwards.
+    void append(int column, qint64 timeMSecs, double value);
+
+    int     count       (int column) const { return _columns[column].count; }
+    int     capacity    (int column) const { return _columns[column].times.count(); }
+    bool    lastSample  (int column, qint64& timeMSecs, double& value) const;
+
+    /// Adds the samples within [startMSecs, endMSecs] to points as (time, value) in time order. If there are more than
+    /// maxPoints samples they are split into maxPoints / 2 buckets and each bucket is reduced to its min and max sample.
+    ///     @return Number of points added
+    int range(int column, qint64 startMSecs, qint64 endMSecs, int maxPoints, QVector<QPointF>& points) const;
+
+    /// @return false: no samples in range
+    bool minMax(int column, qint64 startMSecs, qint64 endMSecs, double& min, double& max) const;
+
+    void clear(int column);
+    void clearAll(void);
+
+    /// Decodes the first element of a numeric MAVLink field
+    ///     @return false: field is not numeric
+    static bool fieldValue(const mavlink_message_t& message, const mavlink_field_info_t& field, double& value);
+
+signals:
+    void columnAdded(int column, const QString& name);
+
+private:
+    typedef struct {
+        QString         name;
+        QVector<qint64> times;
+        QVector<double> values;
+        int             first;      ///< Physical index of the oldest sample
+        int             count;
+    } Column_t;
+
+    typedef struct {
+        QPointer<Vehicle>   vehicle;
+        int                 registrationId;
+        int                 trackCount;     ///< Number of trackMessageField calls not released yet
+    } TrackedField_t;
+
+    int _physicalIndex  (const Column_t& column, int logicalIndex) const;
+    int _lowerBound     (const Column_t& column, qint64 timeMSecs) const;
+
+    QVector<Column_t>   _columns;
+    QHash<QString, int> _columnIndexByName;
+    QHash<int, TrackedField_t>  _trackedMessageColumns; ///< Columns fed by a trackMessageField handler
+};
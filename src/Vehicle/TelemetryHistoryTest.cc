@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryHistoryTest.h"
+#include "Vehicle.h"
+
+#include <limits>
+
+TelemetryHistoryTest::TelemetryHistoryTest(void)
+{
+
+}
+
+void TelemetryHistoryTest::_ringBuffer_test(void)
+{
+    TelemetryHistory history;
+
+    int column = history.column("test", 4);
+    QCOMPARE(history.column("test"), column);
+    QCOMPARE(history.findColumn("test"), column);
+    QCOMPARE(history.findColumn("missing"), -1);
+    QCOMPARE(history.capacity(column), 4);
+
+    qint64 timeMSecs;
+    double value;
+    QVERIFY(!history.lastSample(column, timeMSecs, value));
+
+    for (int i=0; i<6; i++) {
+        history.append(column, i * 10, i);
+    }
+    QCOMPARE(history.count(column), 4);
+    QVERIFY(history.lastSample(column, timeMSecs, value));
+    QCOMPARE(timeMSecs, Q_INT64_C(50));
+    QCOMPARE(value, 5.0);
+
+    // Oldest two samples were overwritten
+    QVector<QPointF> points;
+    QCOMPARE(history.range(column, 0, std::numeric_limits<qint64>::max(), 100, points), 4);
+    QCOMPARE(points.first(), QPointF(20, 2));
+    QCOMPARE(points.last(),  QPointF(50, 5));
+
+    history.clear(column);
+    QCOMPARE(history.count(column), 0);
+}
+
+void TelemetryHistoryTest::_range_test(void)
+{
+    TelemetryHistory    history;
+    int                 column = history.column("test", 100);
+
+    for (int i=0; i<150; i++) {
+        history.append(column, i * 10, -i);
+    }
+
+    // Samples 50..149 are left, which is times 500..1490
+    QVector<QPointF> points;
+    QCOMPARE(history.range(column, 995, 1199, 100, points), 20);
+    QCOMPARE(points.first(), QPointF(1000, -100));
+    QCOMPARE(points.last(),  QPointF(1190, -119));
+
+    points.clear();
+    QCOMPARE(history.range(column, 0, 400, 100, points), 0);
+
+    double min, max;
+    QVERIFY(history.minMax(column, 600, 700, min, max));
+    QCOMPARE(min, -70.0);
+    QCOMPARE(max, -60.0);
+    QVERIFY(!history.minMax(column, 2000, 3000, min, max));
+}
+
+void TelemetryHistoryTest::_downsample_test(void)
+{
+    TelemetryHistory    history;
+    int                 column = history.column("test", 1000);
+
+    // Single spike in the middle must survive downsampling
+    for (int i=0; i<1000; i++) {
+        history.append(column, i, i == 500 ? 100 : 0);
+    }
+
+    QVector<QPointF> points;
+    int count = history.range(column, 0, std::numeric_limits<qint64>::max(), 20, points);
+    QVERIFY(count <= 20);
+    QCOMPARE(count, points.count());
+
+    bool    spikeFound  = false;
+    qreal   lastTime    = -1;
+    for (const QPointF& point: points) {
+        QVERIFY(point.x() > lastTime);
+        lastTime = point.x();
+        if (point.y() == 100) {
+            spikeFound = true;
+        }
+    }
+    QVERIFY(spikeFound);
+}
+
+void TelemetryHistoryTest::_messageField_test(void)
+{
+    mavlink_message_t message;
+    mavlink_msg_vfr_hud_pack_chan(1, 1, 0, &message, 12.5f, 10.0f, 270, 55, 100.0f, 1.5f);
+
+    const mavlink_message_info_t* msgInfo = mavlink_get_message_info(&message);
+    QVERIFY(msgInfo);
+
+    bool headingFound = false;
+    for (unsigned int i=0; i<msgInfo->num_fields; i++) {
+        double value;
+        if (QString(msgInfo->fields[i].name) == QStringLiteral("heading")) {
+            QVERIFY(TelemetryHistory::fieldValue(message, msgInfo->fields[i], value));
+            QCOMPARE(value, 270.0);
+            headingFound = true;
+        } else if (QString(msgInfo->fields[i].name) == QStringLiteral("airspeed")) {
+            QVERIFY(TelemetryHistory::fieldValue(message, msgInfo->fields[i], value));
+            QCOMPARE(value, 12.5);
+        }
+    }
+    QVERIFY(headingFound);
+}
+
+void TelemetryHistoryTest::_trackMessageField_test(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    TelemetryHistory history;
+
+    QCOMPARE(TelemetryHistory::messageFieldColumnName("VFR_HUD", "heading"),    QStringLiteral("VFR_HUD.heading"));
+    QCOMPARE(TelemetryHistory::messageFieldColumnName("VFR_HUD", "heading", 1), QStringLiteral("VFR_HUD[1].heading"));
+
+    // Tracking the same field twice must not register a second handler
+    int column = history.trackMessageField(_vehicle, MAVLINK_MSG_ID_VFR_HUD, "heading", 1);
+    QVERIFY(column != -1);
+    QCOMPARE(history.trackMessageField(_vehicle, MAVLINK_MSG_ID_VFR_HUD, "heading", 1), column);
+    QCOMPARE(history.findColumn("VFR_HUD[1].heading"), column);
+    int anyColumn = history.trackMessageField(_vehicle, MAVLINK_MSG_ID_VFR_HUD, "heading");
+    QVERIFY(anyColumn != column);
+
+    // Only messages from the tracked component are recorded, once each
+    mavlink_message_t message;
+    mavlink_msg_vfr_hud_pack_chan(static_cast<uint8_t>(_vehicle->id()), 1, 0, &message, 12.5f, 10.0f, 270, 55, 100.0f, 1.5f);
+    _vehicle->messageDispatcher()->dispatch(nullptr, message);
+    mavlink_msg_vfr_hud_pack_chan(static_cast<uint8_t>(_vehicle->id()), 2, 0, &message, 12.5f, 10.0f, 90, 55, 100.0f, 1.5f);
+    _vehicle->messageDispatcher()->dispatch(nullptr, message);
+    QCOMPARE(history.count(column), 1);
+
+    qint64 timeMSecs;
+    double value;
+    QVERIFY(history.lastSample(column, timeMSecs, value));
+    QCOMPARE(value, 270.0);
+
+    QCOMPARE(history.count(anyColumn), 2);
+
+    // The handler stays until every tracker has released the field, recorded samples are kept
+    mavlink_msg_vfr_hud_pack_chan(static_cast<uint8_t>(_vehicle->id()), 1, 0, &message, 12.5f, 10.0f, 180, 55, 100.0f, 1.5f);
+    history.untrackMessageField(column);
+    _vehicle->messageDispatcher()->dispatch(nullptr, message);
+    QCOMPARE(history.count(column), 2);
+    history.untrackMessageField(column);
+    _vehicle->messageDispatcher()->dispatch(nullptr, message);
+    QCOMPARE(history.count(column), 2);
+    QCOMPARE(history.count(anyColumn), 4);
+
+    history.untrackMessageField(anyColumn);
+    _vehicle->messageDispatcher()->dispatch(nullptr, message);
+    QCOMPARE(history.count(anyColumn), 4);
+
+    _disconnectMockLink();
+}
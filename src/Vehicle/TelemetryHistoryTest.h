@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "TelemetryHistory.h"
+
+class TelemetryHistoryTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    TelemetryHistoryTest(void);
+
+private slots:
+    void _ringBuffer_test   (void);
+    void _range_test        (void);
+    void _downsample_test   (void);
+    void _messageField_test (void);
+    void _trackMessageField_test(void);
+};
@@ -21,19 +21,21 @@ TerrainProtocolHandler::TerrainProtocolHandler(Vehicle* vehicle, TerrainFactGrou
     _terrainDataSendTimer.setSingleShot(false);
     _terrainDataSendTimer.setInterval(1000.0/12.0);
     connect(&_terrainDataSendTimer, &QTimer::timeout, this, &TerrainProtocolHandler::_sendNextTerrainData);
+
+    _vehicle->messageDispatcher()->registerHandler(this, MAVLinkMessageDispatcher::anyId, MAVLinkMessageDispatcher::anyId,
+                                                   QList<int>({ MAVLINK_MSG_ID_TERRAIN_REQUEST, MAVLINK_MSG_ID_TERRAIN_REPORT }),
+                                                   [this](LinkInterface* /*link*/, const mavlink_message_t& message) { _mavlinkMessageReceived(message); });
 }
 
-bool TerrainProtocolHandler::mavlinkMessageReceived(const mavlink_message_t message)
+void TerrainProtocolHandler::_mavlinkMessageReceived(const mavlink_message_t& message)
 {
     switch (message.msgid) {
     case MAVLINK_MSG_ID_TERRAIN_REQUEST:
         _handleTerrainRequest(message);
-        return false;
+        break;
     case MAVLINK_MSG_ID_TERRAIN_REPORT:
         _handleTerrainReport(message);
-        return false;
-    default:
-        return true;
+        break;
     }
 }
 
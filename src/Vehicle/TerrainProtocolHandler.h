@@ -27,13 +27,11 @@ class TerrainProtocolHandler : public QObject
 public:
     explicit TerrainProtocolHandler(Vehicle* vehicle, TerrainFactGroup* terrainFactGroup, QObject *parent = nullptr);
 
-    /// @return true: Allow vehicle to continue processing, false: Vehicle should not process message
-    bool mavlinkMessageReceived(const mavlink_message_t message);
-
 private slots:
     void _sendNextTerrainData(void);
 
 private:
+    void _mavlinkMessageReceived(const mavlink_message_t& message);
     void _handleTerrainRequest  (const mavlink_message_t& message);
     void _handleTerrainReport   (const mavlink_message_t& message);
     void _sendTerrainData       (const QGeoCoordinate& swCorner, uint8_t gridBit);
@@ -42,6 +42,7 @@
 #include "PositionManager.h"
 #include "VehicleObjectAvoidance.h"
 #include "TrajectoryPoints.h"
+#include "TelemetryHistory.h"
 #include "QGCGeo.h"
 #include "TerrainProtocolHandler.h"
 #include "ParameterManager.h"
@@ -166,6 +167,7 @@ Vehicle::Vehicle(LinkInterface*             link,
     , _custom_mode(0)
     , _nextSendMessageMultipleIndex(0)
     , _trajectoryPoints(new TrajectoryPoints(this, this))
+    , _telemetryHistory(new TelemetryHistory(this))
     , _firmwarePluginManager(firmwarePluginManager)
     , _joystickManager(joystickManager)
     , _flowImageIndex(0)
@@ -228,7 +230,7 @@ Vehicle::Vehicle(LinkInterface*             link,
     _mavlink = _toolbox->mavlinkProtocol();
     qCDebug(VehicleLog) << "Link started with Mavlink " << (_mavlink->getCurrentVersion() >= 200 ? "V2" : "V1");
 
-    connect(_mavlink, &MAVLinkProtocol::messageReceived,        this, &Vehicle::_mavlinkMessageReceived);
+    _registerMessageHandlers();
     connect(_mavlink, &MAVLinkProtocol::mavlinkMessageStatus,   this, &Vehicle::_mavlinkMessageStatus);
 
     _addLink(link);
@@ -357,6 +359,7 @@ Vehicle::Vehicle(MAV_AUTOPILOT              firmwareType,
     , _custom_mode(0)
     , _nextSendMessageMultipleIndex(0)
     , _trajectoryPoints(new TrajectoryPoints(this, this))
+    , _telemetryHistory(new TelemetryHistory(this))
     , _firmwarePluginManager(firmwarePluginManager)
     , _joystickManager(nullptr)
     , _flowImageIndex(0)
@@ -559,6 +562,10 @@ Vehicle::~Vehicle()
 {
     qCDebug(VehicleLog) << "~Vehicle" << this;
 
+    if (_mavlink) {
+        _mavlink->messageDispatcher()->unregisterHandlers(this);
+    }
+
     delete _missionManager;
     _missionManager = nullptr;
 
@@ -656,6 +663,17 @@ void Vehicle::resetCounters()
     _heardFrom          = false;
 }
 
+/// Only messages from this vehicle, broadcasts and radio status messages are routed to the vehicle
+void Vehicle::_registerMessageHandlers(void)
+{
+    const int anyId = MAVLinkMessageDispatcher::anyId;
+
+    // Registered as a single subscriber so radio status from our own system id is only handled once
+    _mavlink->messageDispatcher()->registerHandler(this,
+                                                   QList<MAVLinkMessageDispatcher::Key_t>({ { _id, anyId, anyId }, { 0, anyId, anyId }, { anyId, anyId, MAVLINK_MSG_ID_RADIO_STATUS } }),
+                                                   [this](LinkInterface* link, const mavlink_message_t& message) { _mavlinkMessageReceived(link, message); });
+}
+
 void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
     // If the link is already running at Mavlink V2 set our max proto version to it.
@@ -712,11 +730,6 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
         return;
     }
 
-    if (!_terrainProtocolHandler->mavlinkMessageReceived(message)) {
-        return;
-    }
-    _ftpManager->mavlinkMessageReceived(message);
-
     _waitForMavlinkMessageMessageReceived(message);
 
     switch (message.msgid) {
@@ -859,6 +872,7 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
 
     // This must be emitted after the vehicle processes the message. This way the vehicle state is up to date when anyone else
     // does processing.
+    _messageDispatcher.dispatch(link, message);
     emit mavlinkMessageReceived(message);
 
     _uas->receiveMessage(message);
@@ -1050,10 +1064,10 @@ void Vehicle::_handleVfrHud(mavlink_message_t& message)
     mavlink_vfr_hud_t vfrHud;
     mavlink_msg_vfr_hud_decode(&message, &vfrHud);
 
-    _airSpeedFact.setRawValue(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
-    _groundSpeedFact.setRawValue(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
-    _climbRateFact.setRawValue(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
-    _throttlePctFact.setRawValue(static_cast<int16_t>(vfrHud.throttle));
+    _airSpeedFact.setTelemetryValue(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
+    _groundSpeedFact.setTelemetryValue(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
+    _climbRateFact.setTelemetryValue(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
+    _throttlePctFact.setTelemetryValue(static_cast<int16_t>(vfrHud.throttle));
 }
 
 void Vehicle::_handleEstimatorStatus(mavlink_message_t& message)
@@ -1061,26 +1075,26 @@ void Vehicle::_handleEstimatorStatus(mavlink_message_t& message)
     mavlink_estimator_status_t estimatorStatus;
     mavlink_msg_estimator_status_decode(&message, &estimatorStatus);
 
-    _estimatorStatusFactGroup.goodAttitudeEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_ATTITUDE));
-    _estimatorStatusFactGroup.goodHorizVelEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_VELOCITY_HORIZ));
-    _estimatorStatusFactGroup.goodVertVelEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_VELOCITY_VERT));
-    _estimatorStatusFactGroup.goodHorizPosRelEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_POS_HORIZ_REL));
-    _estimatorStatusFactGroup.goodHorizPosAbsEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_POS_HORIZ_ABS));
-    _estimatorStatusFactGroup.goodVertPosAbsEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_POS_VERT_ABS));
-    _estimatorStatusFactGroup.goodVertPosAGLEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_POS_VERT_AGL));
-    _estimatorStatusFactGroup.goodConstPosModeEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_CONST_POS_MODE));
-    _estimatorStatusFactGroup.goodPredHorizPosRelEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_PRED_POS_HORIZ_REL));
-    _estimatorStatusFactGroup.goodPredHorizPosAbsEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_PRED_POS_HORIZ_ABS));
-    _estimatorStatusFactGroup.gpsGlitch()->setRawValue(estimatorStatus.flags & ESTIMATOR_GPS_GLITCH ? true : false);
-    _estimatorStatusFactGroup.accelError()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_ACCEL_ERROR));
-    _estimatorStatusFactGroup.velRatio()->setRawValue(estimatorStatus.vel_ratio);
-    _estimatorStatusFactGroup.horizPosRatio()->setRawValue(estimatorStatus.pos_horiz_ratio);
-    _estimatorStatusFactGroup.vertPosRatio()->setRawValue(estimatorStatus.pos_vert_ratio);
-    _estimatorStatusFactGroup.magRatio()->setRawValue(estimatorStatus.mag_ratio);
-    _estimatorStatusFactGroup.haglRatio()->setRawValue(estimatorStatus.hagl_ratio);
-    _estimatorStatusFactGroup.tasRatio()->setRawValue(estimatorStatus.tas_ratio);
-    _estimatorStatusFactGroup.horizPosAccuracy()->setRawValue(estimatorStatus.pos_horiz_accuracy);
-    _estimatorStatusFactGroup.vertPosAccuracy()->setRawValue(estimatorStatus.pos_vert_accuracy);
+    _estimatorStatusFactGroup.goodAttitudeEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_ATTITUDE));
+    _estimatorStatusFactGroup.goodHorizVelEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_VELOCITY_HORIZ));
+    _estimatorStatusFactGroup.goodVertVelEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_VELOCITY_VERT));
+    _estimatorStatusFactGroup.goodHorizPosRelEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_POS_HORIZ_REL));
+    _estimatorStatusFactGroup.goodHorizPosAbsEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_POS_HORIZ_ABS));
+    _estimatorStatusFactGroup.goodVertPosAbsEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_POS_VERT_ABS));
+    _estimatorStatusFactGroup.goodVertPosAGLEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_POS_VERT_AGL));
+    _estimatorStatusFactGroup.goodConstPosModeEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_CONST_POS_MODE));
+    _estimatorStatusFactGroup.goodPredHorizPosRelEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_PRED_POS_HORIZ_REL));
+    _estimatorStatusFactGroup.goodPredHorizPosAbsEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_PRED_POS_HORIZ_ABS));
+    _estimatorStatusFactGroup.gpsGlitch()->setTelemetryValue(estimatorStatus.flags & ESTIMATOR_GPS_GLITCH ? true : false);
+    _estimatorStatusFactGroup.accelError()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_ACCEL_ERROR));
+    _estimatorStatusFactGroup.velRatio()->setTelemetryValue(estimatorStatus.vel_ratio);
+    _estimatorStatusFactGroup.horizPosRatio()->setTelemetryValue(estimatorStatus.pos_horiz_ratio);
+    _estimatorStatusFactGroup.vertPosRatio()->setTelemetryValue(estimatorStatus.pos_vert_ratio);
+    _estimatorStatusFactGroup.magRatio()->setTelemetryValue(estimatorStatus.mag_ratio);
+    _estimatorStatusFactGroup.haglRatio()->setTelemetryValue(estimatorStatus.hagl_ratio);
+    _estimatorStatusFactGroup.tasRatio()->setTelemetryValue(estimatorStatus.tas_ratio);
+    _estimatorStatusFactGroup.horizPosAccuracy()->setTelemetryValue(estimatorStatus.pos_horiz_accuracy);
+    _estimatorStatusFactGroup.vertPosAccuracy()->setTelemetryValue(estimatorStatus.pos_vert_accuracy);
 
 #if 0
     typedef enum ESTIMATOR_STATUS_FLAGS
@@ -1142,7 +1156,7 @@ void Vehicle::_handleDistanceSensor(mavlink_message_t& message)
     for (size_t i=0; i<sizeof(rgOrientation2Fact)/sizeof(rgOrientation2Fact[0]); i++) {
         const orientation2Fact_s& orientation2Fact = rgOrientation2Fact[i];
         if (orientation2Fact.orientation == distanceSensor.orientation) {
-            orientation2Fact.fact->setRawValue(distanceSensor.current_distance / 100.0); // cm to meters
+            orientation2Fact.fact->setTelemetryValue(distanceSensor.current_distance / 100.0); // cm to meters
         }
     }
 }
@@ -1174,13 +1188,13 @@ void Vehicle::_handleAttitudeTarget(mavlink_message_t& message)
     float roll, pitch, yaw;
     mavlink_quaternion_to_euler(attitudeTarget.q, &roll, &pitch, &yaw);
 
-    _setpointFactGroup.roll()->setRawValue(qRadiansToDegrees(roll));
-    _setpointFactGroup.pitch()->setRawValue(qRadiansToDegrees(pitch));
-    _setpointFactGroup.yaw()->setRawValue(qRadiansToDegrees(yaw));
+    _setpointFactGroup.roll()->setTelemetryValue(qRadiansToDegrees(roll));
+    _setpointFactGroup.pitch()->setTelemetryValue(qRadiansToDegrees(pitch));
+    _setpointFactGroup.yaw()->setTelemetryValue(qRadiansToDegrees(yaw));
 
-    _setpointFactGroup.rollRate()->setRawValue(qRadiansToDegrees(attitudeTarget.body_roll_rate));
-    _setpointFactGroup.pitchRate()->setRawValue(qRadiansToDegrees(attitudeTarget.body_pitch_rate));
-    _setpointFactGroup.yawRate()->setRawValue(qRadiansToDegrees(attitudeTarget.body_yaw_rate));
+    _setpointFactGroup.rollRate()->setTelemetryValue(qRadiansToDegrees(attitudeTarget.body_roll_rate));
+    _setpointFactGroup.pitchRate()->setTelemetryValue(qRadiansToDegrees(attitudeTarget.body_pitch_rate));
+    _setpointFactGroup.yawRate()->setTelemetryValue(qRadiansToDegrees(attitudeTarget.body_yaw_rate));
 }
 
 void Vehicle::_handleAttitudeWorker(double rollRadians, double pitchRadians, double yawRadians)
@@ -1201,9 +1215,9 @@ void Vehicle::_handleAttitudeWorker(double rollRadians, double pitchRadians, dou
     // truncate to integer so widget never displays 360
     yaw = trunc(yaw);
 
-    _rollFact.setRawValue(roll);
-    _pitchFact.setRawValue(pitch);
-    _headingFact.setRawValue(yaw);
+    _rollFact.setTelemetryValue(roll);
+    _pitchFact.setTelemetryValue(pitch);
+    _headingFact.setTelemetryValue(yaw);
 }
 
 void Vehicle::_handleAttitude(mavlink_message_t& message)
@@ -1241,9 +1255,9 @@ void Vehicle::_handleAttitudeQuaternion(mavlink_message_t& message)
 
     _handleAttitudeWorker(roll, pitch, yaw);
 
-    rollRate()->setRawValue(qRadiansToDegrees(rates[0]));
-    pitchRate()->setRawValue(qRadiansToDegrees(rates[1]));
-    yawRate()->setRawValue(qRadiansToDegrees(rates[2]));
+    rollRate()->setTelemetryValue(qRadiansToDegrees(rates[0]));
+    pitchRate()->setTelemetryValue(qRadiansToDegrees(rates[1]));
+    yawRate()->setTelemetryValue(qRadiansToDegrees(rates[2]));
 }
 
 void Vehicle::_handleGpsRawInt(mavlink_message_t& message)
@@ -1260,18 +1274,18 @@ void Vehicle::_handleGpsRawInt(mavlink_message_t& message)
                 _coordinate = newPosition;
                 emit coordinateChanged(_coordinate);
             }
-            _altitudeAMSLFact.setRawValue(gpsRawInt.alt / 1000.0);
+            _altitudeAMSLFact.setTelemetryValue(gpsRawInt.alt / 1000.0);
         }
     }
 
-    _gpsFactGroup.lat()->setRawValue(gpsRawInt.lat * 1e-7);
-    _gpsFactGroup.lon()->setRawValue(gpsRawInt.lon * 1e-7);
+    _gpsFactGroup.lat()->setTelemetryValue(gpsRawInt.lat * 1e-7);
+    _gpsFactGroup.lon()->setTelemetryValue(gpsRawInt.lon * 1e-7);
     _gpsFactGroup.mgrs()->setRawValue(convertGeoToMGRS(QGeoCoordinate(gpsRawInt.lat * 1e-7, gpsRawInt.lon * 1e-7)));
-    _gpsFactGroup.count()->setRawValue(gpsRawInt.satellites_visible == 255 ? 0 : gpsRawInt.satellites_visible);
-    _gpsFactGroup.hdop()->setRawValue(gpsRawInt.eph == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.eph / 100.0);
-    _gpsFactGroup.vdop()->setRawValue(gpsRawInt.epv == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.epv / 100.0);
-    _gpsFactGroup.courseOverGround()->setRawValue(gpsRawInt.cog == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.cog / 100.0);
-    _gpsFactGroup.lock()->setRawValue(gpsRawInt.fix_type);
+    _gpsFactGroup.count()->setTelemetryValue(gpsRawInt.satellites_visible == 255 ? 0 : gpsRawInt.satellites_visible);
+    _gpsFactGroup.hdop()->setTelemetryValue(gpsRawInt.eph == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.eph / 100.0);
+    _gpsFactGroup.vdop()->setTelemetryValue(gpsRawInt.epv == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.epv / 100.0);
+    _gpsFactGroup.courseOverGround()->setTelemetryValue(gpsRawInt.cog == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.cog / 100.0);
+    _gpsFactGroup.lock()->setTelemetryValue(gpsRawInt.fix_type);
 }
 
 void Vehicle::_handleGlobalPositionInt(mavlink_message_t& message)
@@ -1279,8 +1293,8 @@ void Vehicle::_handleGlobalPositionInt(mavlink_message_t& message)
     mavlink_global_position_int_t globalPositionInt;
     mavlink_msg_global_position_int_decode(&message, &globalPositionInt);
 
-    _altitudeRelativeFact.setRawValue(globalPositionInt.relative_alt / 1000.0);
-    _altitudeAMSLFact.setRawValue(globalPositionInt.alt / 1000.0);
+    _altitudeRelativeFact.setTelemetryValue(globalPositionInt.relative_alt / 1000.0);
+    _altitudeAMSLFact.setTelemetryValue(globalPositionInt.alt / 1000.0);
 
     // ArduPilot sends bogus GLOBAL_POSITION_INT messages with lat/lat 0/0 even when it has no gps signal
     // Apparently, this is in order to transport relative altitude information.
@@ -1575,10 +1589,10 @@ void Vehicle::_batteryStatusWorker(int batteryId, double voltage, double current
         return;
     }
 
-    pBatteryFactGroup->voltage()->setRawValue(voltage);
-    pBatteryFactGroup->current()->setRawValue(current);
-    pBatteryFactGroup->instantPower()->setRawValue(voltage * current);
-    pBatteryFactGroup->percentRemaining()->setRawValue(batteryRemainingPct);
+    pBatteryFactGroup->voltage()->setTelemetryValue(voltage);
+    pBatteryFactGroup->current()->setTelemetryValue(current);
+    pBatteryFactGroup->instantPower()->setTelemetryValue(voltage * current);
+    pBatteryFactGroup->percentRemaining()->setTelemetryValue(batteryRemainingPct);
 
     //-- Low battery warning
     if (batteryId == 0 && !qIsNaN(batteryRemainingPct)) {
@@ -1659,10 +1673,10 @@ void Vehicle::_handleBatteryStatus(mavlink_message_t& message)
         }
     }
 
-    pBatteryFactGroup->temperature()->setRawValue(bat_status.temperature == INT16_MAX ? qQNaN() : static_cast<double>(bat_status.temperature) / 100.0);
-    pBatteryFactGroup->mahConsumed()->setRawValue(bat_status.current_consumed == -1  ? qQNaN() : bat_status.current_consumed);
-    pBatteryFactGroup->chargeState()->setRawValue(bat_status.charge_state);
-    pBatteryFactGroup->timeRemaining()->setRawValue(bat_status.time_remaining == 0 ? qQNaN() : bat_status.time_remaining);
+    pBatteryFactGroup->temperature()->setTelemetryValue(bat_status.temperature == INT16_MAX ? qQNaN() : static_cast<double>(bat_status.temperature) / 100.0);
+    pBatteryFactGroup->mahConsumed()->setTelemetryValue(bat_status.current_consumed == -1  ? qQNaN() : bat_status.current_consumed);
+    pBatteryFactGroup->chargeState()->setTelemetryValue(bat_status.charge_state);
+    pBatteryFactGroup->timeRemaining()->setTelemetryValue(bat_status.time_remaining == 0 ? qQNaN() : bat_status.time_remaining);
 
     // BATTERY_STATUS is currently unreliable on PX4 stack so we rely on SYS_STATUS for partial battery 0 information to work around it
     if (bat_status.id != 0) {
@@ -4458,14 +4472,19 @@ VehicleClockFactGroup::VehicleClockFactGroup(QObject* parent)
     // Start out as not available "--.--"
     _currentTimeFact.setRawValue    (std::numeric_limits<float>::quiet_NaN());
     _currentDateFact.setRawValue    (std::numeric_limits<float>::quiet_NaN());
+
+    connect(&_clockTimer, &QTimer::timeout, this, &VehicleClockFactGroup::_updateClock);
+    _clockTimer.setSingleShot(false);
+    _clockTimer.start(_updateRateMSecs);
 }
 
-void VehicleClockFactGroup::_updateAllValues()
+void VehicleClockFactGroup::_updateClock(void)
 {
     _currentTimeFact.setRawValue(QTime::currentTime().toString());
     _currentDateFact.setRawValue(QDateTime::currentDateTime().toString(QLocale::system().dateFormat(QLocale::ShortFormat)));
 
-    FactGroup::_updateAllValues();
+    // Show the new time right away instead of one update later
+    _updateAllValues();
 }
 
 const char* VehicleSetpointFactGroup::_rollFactName =       "roll";
@@ -42,6 +42,7 @@ class QGCCameraManager;
 class Joystick;
 class VehicleObjectAvoidance;
 class TrajectoryPoints;
+class TelemetryHistory;
 class TerrainProtocolHandler;
 class ComponentInformationManager;
 class FTPManager;
@@ -347,11 +348,12 @@ public:
     static const char* _settingsGroup;
 
 private slots:
-    void _updateAllValues() override;
+    void _updateClock(void);
 
 private:
     Fact            _currentTimeFact;
     Fact            _currentDateFact;
+    QTimer          _clockTimer;    ///< FactGroup updates only run when something changed, the clock needs its own tick
 };
 
 class VehicleEstimatorStatusFactGroup : public FactGroup
@@ -1010,6 +1012,11 @@ public:
     ParameterManager*               parameterManager    () { return _parameterManager; }
     ParameterManager*               parameterManager    () const { return _parameterManager; }
     FTPManager*                     ftpManager          () { return _ftpManager; }
+
+    /// Routes messages for this vehicle to handlers registered by message id. Handlers are called after the vehicle has
+    /// processed the message, at the same point mavlinkMessageReceived is signalled.
+    MAVLinkMessageDispatcher*       messageDispatcher   () { return &_messageDispatcher; }
+    TelemetryHistory*               telemetryHistory    () { return _telemetryHistory; }
     ComponentInformationManager*    compInfoManager     () { return _componentInformationManager; }
     VehicleObjectAvoidance* objectAvoidance     () { return _objectAvoidance; }
 
@@ -1313,6 +1320,7 @@ private:
     void _saveSettings                  ();
     void _startJoystick                 (bool start);
     void _handlePing                    (LinkInterface* link, mavlink_message_t& message);
+    void _registerMessageHandlers       (void);
     void _handleHomePosition            (mavlink_message_t& message);
     void _handleHeartbeat               (mavlink_message_t& message);
     void _handleRadioStatus             (mavlink_message_t& message);
@@ -1462,6 +1470,7 @@ private:
 
     ParameterManager*               _parameterManager               = nullptr;
     FTPManager*                     _ftpManager                     = nullptr;
+    MAVLinkMessageDispatcher        _messageDispatcher;
     ComponentInformationManager*    _componentInformationManager    = nullptr;
     InitialConnectStateMachine*     _initialConnectStateMachine     = nullptr;
     VehicleObjectAvoidance*         _objectAvoidance                = nullptr;
@@ -1491,6 +1500,7 @@ private:
     QElapsedTimer                   _flightTimer;
     QTimer                          _flightTimeUpdater;
     TrajectoryPoints*               _trajectoryPoints;
+    TelemetryHistory*               _telemetryHistory;
     QmlObjectListModel              _cameraTriggerPoints;
     //QMap<QString, ADSBVehicle*>     _trafficVehicleMap;
 
@@ -36,6 +36,8 @@ LinkConfiguration::LinkConfiguration(const QString& name)
     , _dynamic(false)
     , _autoConnect(false)
     , _highLatency(false)
+    , _blockParsing(false)
+    , _threadedParsing(false)
 {
     _name = name;
     if (_name.isEmpty()) {
@@ -50,6 +52,8 @@ LinkConfiguration::LinkConfiguration(LinkConfiguration* copy)
     _dynamic    = copy->isDynamic();
     _autoConnect= copy->isAutoConnect();
     _highLatency= copy->isHighLatency();
+    _blockParsing= copy->isBlockParsing();
+    _threadedParsing= copy->isThreadedParsing();
     Q_ASSERT(!_name.isEmpty());
 }
 
@@ -61,6 +65,8 @@ void LinkConfiguration::copyFrom(LinkConfiguration* source)
     _dynamic    = source->isDynamic();
     _autoConnect= source->isAutoConnect();
     _highLatency= source->isHighLatency();
+    _blockParsing= source->isBlockParsing();
+    _threadedParsing= source->isThreadedParsing();
 }
 
 /*!
@@ -33,6 +33,8 @@ public:
     Q_PROPERTY(QString          settingsTitle       READ settingsTitle                          CONSTANT)
     Q_PROPERTY(bool             highLatency         READ isHighLatency  WRITE setHighLatency    NOTIFY highLatencyChanged)
     Q_PROPERTY(bool             highLatencyAllowed  READ isHighLatencyAllowed                   CONSTANT)
+    Q_PROPERTY(bool             blockParsing        READ isBlockParsing WRITE setBlockParsing   NOTIFY blockParsingChanged)
+    Q_PROPERTY(bool             threadedParsing     READ isThreadedParsing WRITE setThreadedParsing NOTIFY threadedParsingChanged)
 
     // Property accessors
 
@@ -82,6 +84,21 @@ public:
      */
     bool isHighLatency() { return _highLatency; }
 
+    /*!
+     *
+     * Does this link use the block based MAVLink parser?
+     * @return True if incoming data is parsed by MAVLinkBlockParser instead of byte by byte through mavlink_parse_char.
+     */
+    bool isBlockParsing() { return _blockParsing; }
+
+    /*!
+     *
+     * Does this link parse MAVLink on its own thread?
+     * @return True if incoming data is parsed on the link thread and only decoded messages are handed to the main thread.
+     * Takes effect the next time the link is connected.
+     */
+    bool isThreadedParsing() { return _threadedParsing; }
+
     /*!
      * Set if this is this a dynamic configuration. (decided at runtime)
     */
@@ -97,6 +114,16 @@ public:
     */
     void setHighLatency(bool hl = false) { _highLatency = hl; emit highLatencyChanged(); }
 
+    /*!
+     * Set if this link uses the block based MAVLink parser.
+    */
+    void setBlockParsing(bool blockParsing = false) { _blockParsing = blockParsing; emit blockParsingChanged(); }
+
+    /*!
+     * Set if this link parses MAVLink on its own thread.
+    */
+    void setThreadedParsing(bool threadedParsing = false) { _threadedParsing = threadedParsing; emit threadedParsingChanged(); }
+
     /// Virtual Methods
 
     /*!
@@ -200,6 +227,8 @@ signals:
     void autoConnectChanged ();
     void linkChanged        (LinkInterface* link);
     void highLatencyChanged ();
+    void blockParsingChanged();
+    void threadedParsingChanged();
 
 protected:
     LinkInterface* _link; ///< Link currently using this configuration (if any)
@@ -208,6 +237,8 @@ private:
     bool    _dynamic;       ///< A connection added automatically and not persistent (unless it's edited).
     bool    _autoConnect;   ///< This connection is started automatically at boot
     bool    _highLatency;
+    bool    _blockParsing;  ///< Incoming data is parsed using MAVLinkBlockParser
+    bool    _threadedParsing;///< Incoming data is parsed on the link thread
 };
 
 typedef QSharedPointer<LinkConfiguration> SharedLinkConfigurationPointer;
@@ -47,6 +47,9 @@ LinkInterface::LinkInterface(SharedLinkConfigurationPointer& config, bool isPX4F
     , _config                   (config)
     , _highLatency              (config->isHighLatency())
     , _mavlinkChannelSet        (false)
+    , _sendQueue                (_sendQueueCapacity)
+    , _sendLatencyLogNSecs      (0)
+    , _receiveDroppedReported   (0)
     , _enableRateCollection     (false)
     , _decodedFirstMavlinkPacket(false)
     , _isPX4Flow                (isPX4Flow)
@@ -66,6 +69,11 @@ LinkInterface::LinkInterface(SharedLinkConfigurationPointer& config, bool isPX4F
     memset(_outDataWriteTimes,  0, sizeof(_outDataWriteTimes));
 
     qRegisterMetaType<LinkInterface*>("LinkInterface*");
+
+    _sendBatch.reserve(LinkSendQueue::maxFrameLength);
+    // Queued connections are delivered to whichever thread the link lives in at the time of the write
+    QObject::connect(this, &LinkInterface::_sendQueueReady,           this, &LinkInterface::_drainSendQueue,   Qt::QueuedConnection);
+    QObject::connect(this, &LinkInterface::_writeLargeBytesQueued,    this, &LinkInterface::_writeLargeBytes,  Qt::QueuedConnection);
 }
 
 /// This function logs the send times and amounts of datas for input. Data is used for calculating
@@ -212,8 +220,50 @@ void LinkInterface::stopMavlinkMessagesTimer() {
 
 void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
 {
-    QByteArray byteArray(bytes, length);
-    _writeBytesMutex.lock();
-    _writeBytes(byteArray);
-    _writeBytesMutex.unlock();
+    // Frames which are not MAVLink or don't fit in the queue are rare enough to take the slow path. Nothing is
+    // dropped here, callers such as the parameter and mission protocols rely on their frames going out.
+    if (length > LinkSendQueue::maxFrameLength || !_sendQueue.push(bytes, length)) {
+        emit _writeLargeBytesQueued(QByteArray(bytes, length));
+        return;
+    }
+    // Only a single drain is queued to the link thread no matter how many frames come in before it runs
+    if (_sendQueue.requestDrain()) {
+        emit _sendQueueReady();
+    }
+}
+
+void LinkInterface::_drainSendQueue(void)
+{
+    _sendQueue.drainStarted();
+
+    const int                       batchBytes = _writeBatchBytes();
+    const LinkSendQueue::Slot_t*    slot;
+    while ((slot = _sendQueue.front())) {
+        if (!_sendBatch.isEmpty() && _sendBatch.size() + slot->length > batchBytes) {
+            _writeBytes(_sendBatch);
+            _sendBatch.resize(0);
+        }
+        _sendBatch.append(slot->bytes, slot->length);
+        _sendLatencyHistogram.addSample(_sendQueue.elapsedNSecs() - slot->pushTimeNSecs);
+        _sendQueue.popFront();
+    }
+    if (!_sendBatch.isEmpty()) {
+        _writeBytes(_sendBatch);
+        // Reserved capacity is kept, so this only allocates if the link still holds on to the previous batch
+        _sendBatch.resize(0);
+    }
+
+    qint64 now = _sendQueue.elapsedNSecs();
+    if (now - _sendLatencyLogNSecs > _sendLatencyLogIntervalNSecs) {
+        _sendLatencyLogNSecs = now;
+        qCDebug(LinkSendQueueLog) << getName() << "send latency" << _sendLatencyHistogram.toString()
+                                  << "max depth" << _sendQueue.maxDepth() << "overflowed" << _sendQueue.droppedCount();
+    }
+}
+
+void LinkInterface::_writeLargeBytes(const QByteArray bytes)
+{
+    // Frames queued ahead of these bytes go out first
+    _drainSendQueue();
+    _writeBytes(bytes);
 }
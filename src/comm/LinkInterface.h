@@ -17,10 +17,13 @@
 #include <QSharedPointer>
 #include <QDebug>
 #include <QTimer>
+#include <QScopedPointer>
 
 #include "QGCMAVLink.h"
 #include "LinkConfiguration.h"
 #include "MavlinkMessagesTimer.h"
+#include "LinkSendQueue.h"
+#include "MAVLinkBlockParser.h"
 
 class LinkManager;
 
@@ -35,6 +38,9 @@ class LinkInterface : public QThread
     // Only LinkManager is allowed to create/delete or _connect/_disconnect a link
     friend class LinkManager;
 
+    // MAVLinkProtocol sets up and drains the receive state of links using threaded parsing
+    friend class MAVLinkProtocol;
+
 public:    
     virtual ~LinkInterface() {
         stopMavlinkMessagesTimer();
@@ -136,8 +142,18 @@ public:
     bool connect(void);
     bool disconnect(void);
 
+    /// Queues the bytes for sending on the link thread. Safe to call from any thread, does not lock or allocate for
+    /// writes of up to LinkSendQueue::maxFrameLength bytes.
     void writeBytesThreadSafe(const char *bytes, int length);
 
+    /// Send queue statistics, safe to read from any thread
+    int         sendQueueDepth          (void) const { return _sendQueue.depth(); }
+    int         sendQueueMaxDepth       (void) const { return _sendQueue.maxDepth(); }
+    uint32_t    sendQueueDroppedCount   (void) const { return _sendQueue.droppedCount(); }
+
+    /// Time from writeBytesThreadSafe to the bytes being handed to the link. Only safe to read on the link thread.
+    const MAVLinkLatencyHistogram& sendLatencyHistogram(void) const { return _sendLatencyHistogram; }
+
 signals:
     void autoconnectChanged(bool autoconnect);
     void activeChanged(LinkInterface* link, bool active, int vehicle_id);
@@ -190,6 +206,10 @@ signals:
 
     void communicationUpdate(const QString& linkname, const QString& text);
 
+    // Internal signals used to move writes over to the link thread
+    void _sendQueueReady(void);
+    void _writeLargeBytesQueued(const QByteArray bytes);
+
 protected:
     // Links are only created by LinkManager so constructor is not public
     LinkInterface(SharedLinkConfigurationPointer& config, bool isPX4Flow = false);
@@ -206,11 +226,17 @@ protected:
     ///     @param time Time in ms receive occurred
     void _logOutputDataRate(quint64 byteCount, qint64 time);
 
+    /// @return Maximum number of bytes from queued writes which are combined into a single _writeBytes call. Frames
+    /// are never split, 0 writes each frame on its own.
+    virtual int _writeBatchBytes(void) const { return 4096; }
+
     SharedLinkConfigurationPointer _config;
     bool _highLatency;
 
 private slots:
     void _activeChanged(bool active, int vehicle_id);
+    void _drainSendQueue(void);
+    void _writeLargeBytes(const QByteArray bytes);
 
 private:
     /**
@@ -291,7 +317,20 @@ private:
     qint64  _outDataWriteTimes[_dataRateBufferSize]; // in ms
     
     mutable QMutex _dataRateMutex;
-    mutable QMutex _writeBytesMutex;
+
+    LinkSendQueue           _sendQueue;
+    QByteArray              _sendBatch;                 ///< Frames gathered for the next _writeBytes, only used on the link thread
+    MAVLinkLatencyHistogram _sendLatencyHistogram;
+    qint64                  _sendLatencyLogNSecs;       ///< Time the send latency was last logged
+
+    static const int    _sendQueueCapacity = 512;                           ///< Frames, several seconds of normal outgoing traffic
+    static const qint64 _sendLatencyLogIntervalNSecs = 10000000000LL;      ///< Log send latency every 10 seconds
+
+    // Threaded parsing state, see MAVLinkProtocol::setupThreadedParsing. Owned by the link so that it can never go away
+    // while the link thread is still parsing into it.
+    QScopedPointer<MAVLinkReceiveQueue> _receiveQueue;              ///< nullptr unless the link uses threaded parsing
+    MAVLinkBlockParser                  _receiveParser;             ///< Only used on the link thread once connected
+    uint32_t                            _receiveDroppedReported;    ///< Queue drops already logged, only used on the main thread
 
     bool _enableRateCollection;
     bool _decodedFirstMavlinkPacket;    ///< true: link has correctly decoded it's first mavlink packet
@@ -90,7 +90,8 @@ void LinkManager::setToolbox(QGCToolbox *toolbox)
     _autoConnectSettings = toolbox->settingsManager()->autoConnectSettings();
     _mavlinkProtocol = _toolbox->mavlinkProtocol();
 
-    connect(_mavlinkProtocol, &MAVLinkProtocol::messageReceived, this, &LinkManager::_mavlinkMessageReceived);
+    _mavlinkProtocol->messageDispatcher()->registerHandler(this, MAVLinkMessageDispatcher::anyId, MAVLinkMessageDispatcher::anyId, MAVLinkMessageDispatcher::anyId,
+                                                           [this](LinkInterface* link, const mavlink_message_t& message) { _mavlinkMessageReceived(link, message); });
 
     connect(&_portListTimer, &QTimer::timeout, this, &LinkManager::_updateAutoConnectLinks);
     _portListTimer.start(_autoconnectUpdateTimerMSecs); // timeout must be long enough to get past bootloader on second pass
@@ -216,7 +217,13 @@ void LinkManager::_addLink(LinkInterface* link)
     }
 
     connect(link, &LinkInterface::communicationError,   _app,               &QGCApplication::criticalMessageBoxOnMainThread);
-    connect(link, &LinkInterface::bytesReceived,        _mavlinkProtocol,   &MAVLinkProtocol::receiveBytes);
+    if (link->getLinkConfiguration()->isThreadedParsing()) {
+        // Parsing happens directly on the link thread, only decoded messages are handed to the main thread
+        _mavlinkProtocol->setupThreadedParsing(link);
+        connect(link, &LinkInterface::bytesReceived,    _mavlinkProtocol,   &MAVLinkProtocol::receiveBytesOnLinkThread, Qt::DirectConnection);
+    } else {
+        connect(link, &LinkInterface::bytesReceived,    _mavlinkProtocol,   &MAVLinkProtocol::receiveBytes);
+    }
     connect(link, &LinkInterface::bytesSent,            _mavlinkProtocol,   &MAVLinkProtocol::logSentBytes);
 
     _mavlinkProtocol->resetMetadataForLink(link);
@@ -362,6 +369,8 @@ void LinkManager::saveLinkConfigurationList()
                 settings.setValue(root + "/type", linkConfig->type());
                 settings.setValue(root + "/auto", linkConfig->isAutoConnect());
                 settings.setValue(root + "/high_latency", linkConfig->isHighLatency());
+                settings.setValue(root + "/block_parsing", linkConfig->isBlockParsing());
+                settings.setValue(root + "/threaded_parsing", linkConfig->isThreadedParsing());
                 // Have the instance save its own values
                 linkConfig->saveSettings(settings, root);
             }
@@ -394,6 +403,8 @@ void LinkManager::loadLinkConfigurationList()
                             LinkConfiguration* pLink = nullptr;
                             bool autoConnect = settings.value(root + "/auto").toBool();
                             bool highLatency = settings.value(root + "/high_latency").toBool();
+                            bool blockParsing = settings.value(root + "/block_parsing").toBool();
+                            bool threadedParsing = settings.value(root + "/threaded_parsing").toBool();
 
                             switch(type) {
 #ifndef NO_SERIAL_LINK
@@ -427,6 +438,8 @@ void LinkManager::loadLinkConfigurationList()
                                 //-- Have the instance load its own values
                                 pLink->setAutoConnect(autoConnect);
                                 pLink->setHighLatency(highLatency);
+                                pLink->setBlockParsing(blockParsing);
+                                pLink->setThreadedParsing(threadedParsing);
                                 pLink->loadSettings(settings, root);
                                 addConfiguration(pLink);
                                 linksChanged = true;
@@ -1058,7 +1071,7 @@ void LinkManager::_freeMavlinkChannel(int channel)
     _mavlinkChannelsUsedBitMask &= ~(1 << channel);
 }
 
-void LinkManager::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message) {
+void LinkManager::_mavlinkMessageReceived(LinkInterface* link, const mavlink_message_t& message) {
     link->startMavlinkMessagesTimer(message.sysid);
 }
 
@@ -205,7 +205,7 @@ private:
     SerialConfiguration* _autoconnectConfigurationsContainsPort(const QString& portName);
 #endif
 
-    void _mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message);
+    void _mavlinkMessageReceived(LinkInterface* link, const mavlink_message_t& message);
 
     bool    _configUpdateSuspended;                     ///< true: stop updating configuration list
     bool    _configurationsLoaded;                      ///< true: Link configurations have been loaded
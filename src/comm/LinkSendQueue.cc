@@ -0,0 +1,95 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkSendQueue.h"
+
+#include <string.h>
+
+QGC_LOGGING_CATEGORY(LinkSendQueueLog, "LinkSendQueueLog")
+
+// Each slot carries a sequence number which says who owns it:
+//  sequence == position            free, the producer which claims position may write it
+//  sequence == position + 1        written, the consumer may read it
+//  sequence == position + capacity read, free again for the next lap around the ring
+// Producers claim a position by moving _tail forward with a compare and swap, so they never wait on each other.
+
+LinkSendQueue::LinkSendQueue(int capacity)
+    : _head         (0)
+    , _tail         (0)
+    , _drainPending (false)
+    , _maxDepth     (0)
+    , _droppedCount (0)
+{
+    uint32_t size = 1;
+    while (size < static_cast<uint32_t>(capacity)) {
+        size <<= 1;
+    }
+    _slots = new Slot_t[size];
+    _mask = size - 1;
+    for (uint32_t i=0; i<size; i++) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _timer.start();
+}
+
+LinkSendQueue::~LinkSendQueue()
+{
+    delete[] _slots;
+}
+
+bool LinkSendQueue::push(const char* bytes, int length)
+{
+    Slot_t*     slot;
+    uint32_t    position = _tail.load(std::memory_order_relaxed);
+    forever {
+        slot = &_slots[position & _mask];
+        int32_t diff = static_cast<int32_t>(slot->sequence.load(std::memory_order_acquire) - position);
+        if (diff == 0) {
+            if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Slot from the previous lap has not been read yet
+            _droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = _tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    memcpy(slot->bytes, bytes, static_cast<size_t>(length));
+    slot->length        = length;
+    slot->pushTimeNSecs = _timer.nsecsElapsed();
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    int depth       = static_cast<int>(position + 1 - _head.load(std::memory_order_relaxed));
+    int maxDepth    = _maxDepth.load(std::memory_order_relaxed);
+    while (depth > maxDepth && !_maxDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+const LinkSendQueue::Slot_t* LinkSendQueue::front(void) const
+{
+    uint32_t        head = _head.load(std::memory_order_relaxed);
+    const Slot_t*   slot = &_slots[head & _mask];
+    if (slot->sequence.load(std::memory_order_acquire) != head + 1) {
+        // Empty, or the producer which claimed this slot is still writing it. In the latter case that producer
+        // will schedule another drain once it is done.
+        return nullptr;
+    }
+    return slot;
+}
+
+void LinkSendQueue::popFront(void)
+{
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    _slots[head & _mask].sequence.store(head + _mask + 1, std::memory_order_release);
+    _head.store(head + 1, std::memory_order_release);
+}
@@ -0,0 +1,75 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QElapsedTimer>
+
+#include <atomic>
+
+#include "QGCMAVLink.h"
+#include "QGCLoggingCategory.h"
+#include "MAVLinkReceiveQueue.h"
+
+Q_DECLARE_LOGGING_CATEGORY(LinkSendQueueLog)
+
+/// Lock-free, allocation free multiple producer/single consumer queue of outgoing frames for a link.
+///
+/// Any thread may push a frame, the link thread is the only consumer. Frames are copied into fixed size slots which are
+/// allocated once up front. Frames which do not fit in the queue are rejected and counted.
+class LinkSendQueue
+{
+public:
+    typedef struct {
+        std::atomic<uint32_t>   sequence;           ///< Slot state, see push/front
+        int                     length;
+        qint64                  pushTimeNSecs;
+        char                    bytes[MAVLINK_MAX_PACKET_LEN];
+    } Slot_t;
+
+    /// @param capacity Maximum number of queued frames, rounded up to a power of two
+    LinkSendQueue(int capacity);
+    ~LinkSendQueue();
+
+    static const int maxFrameLength = MAVLINK_MAX_PACKET_LEN;
+
+    // Producer side
+
+    /// @param length Must not be larger than maxFrameLength
+    /// @return false: queue full, frame not queued
+    bool push(const char* bytes, int length);
+
+    /// Should be called after pushing a frame.
+    ///     @return true: caller must schedule a drain of the queue, false: a drain is already pending
+    bool requestDrain(void) { return !_drainPending.exchange(true, std::memory_order_acq_rel); }
+
+    // Consumer side
+
+    /// Must be called before draining so that frames pushed during the drain schedule a new one
+    void drainStarted(void) { _drainPending.store(false, std::memory_order_release); }
+
+    /// @return Oldest frame in the queue, nullptr if empty. Stays valid until popFront is called.
+    const Slot_t* front(void) const;
+    void popFront(void);
+
+    qint64  elapsedNSecs    (void) const { return _timer.nsecsElapsed(); }
+    int     depth           (void) const { return static_cast<int>(_tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_relaxed)); }
+    int     maxDepth        (void) const { return _maxDepth.load(std::memory_order_relaxed); }
+    uint32_t droppedCount   (void) const { return _droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    Slot_t*                 _slots;
+    uint32_t                _mask;
+    QElapsedTimer           _timer;
+    std::atomic<uint32_t>   _head;          ///< Next slot to read, only written by consumer
+    std::atomic<uint32_t>   _tail;          ///< Next slot to claim, shared by all producers
+    std::atomic<bool>       _drainPending;
+    std::atomic<int>        _maxDepth;
+    std::atomic<uint32_t>   _droppedCount;
+};
@@ -11,15 +11,26 @@
 #include "LogReplayLink.h"
 #include "LinkManager.h"
 #include "QGCApplication.h"
+#include "MAVLinkBlockParser.h"
 
 #include <QFileInfo>
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QPointer>
 #include <QtEndian>
 #include <QSignalSpy>
 
+#include <string.h>
+
+QGC_LOGGING_CATEGORY(LogReplayLinkLog, "LogReplayLinkLog")
+
 const char*  LogReplayLinkConfiguration::_logFilenameKey = "logFilename";
+const char*  LogReplayLink::_indexFileExtension = ".qgcindex";
 
 LogReplayLinkConfiguration::LogReplayLinkConfiguration(const QString& name)
     : LinkConfiguration(name)
+    , _maxSpeed(false)
 {
     
 }
@@ -28,6 +39,7 @@ LogReplayLinkConfiguration::LogReplayLinkConfiguration(LogReplayLinkConfiguratio
     : LinkConfiguration(copy)
 {
     _logFilename = copy->logFilename();
+    _maxSpeed = copy->maxSpeed();
 }
 
 void LogReplayLinkConfiguration::copyFrom(LinkConfiguration *source)
@@ -36,6 +48,7 @@ void LogReplayLinkConfiguration::copyFrom(LinkConfiguration *source)
     auto* ssource = qobject_cast<LogReplayLinkConfiguration*>(source);
     if (ssource) {
         _logFilename = ssource->logFilename();
+        _maxSpeed = ssource->maxSpeed();
     } else {
         qWarning() << "Internal error";
     }
@@ -71,6 +84,10 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPointer& config)
     , _logReplayConfig  (qobject_cast<LogReplayLinkConfiguration*>(config.data()))
     , _connected        (false)
     , _playbackSpeed    (1)
+    , _logFileSize      (0)
+    , _logData          (nullptr)
+    , _logPos           (0)
+    , _maxSpeedPlaying  (false)
 {
     if (!_logReplayConfig) {
         qWarning() << "Internal error";
@@ -84,6 +101,7 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPointer& config)
     QObject::connect(this, &LogReplayLink::_playOnThread,               this, &LogReplayLink::_play);
     QObject::connect(this, &LogReplayLink::_pauseOnThread,              this, &LogReplayLink::_pause);
     QObject::connect(this, &LogReplayLink::_setPlaybackSpeedOnThread,   this, &LogReplayLink::_setPlaybackSpeed);
+    QObject::connect(this, &LogReplayLink::_readNextBlockOnThread,      this, &LogReplayLink::_readNextBlock, Qt::QueuedConnection);
     
     moveToThread(this);
 }
@@ -147,6 +165,7 @@ void LogReplayLink::run(void)
     exec();
     
     _readTickTimer.stop();
+    _maxSpeedPlaying = false;
 }
 
 void LogReplayLink::_replayError(const QString& errorMsg)
@@ -161,11 +180,15 @@ void LogReplayLink::_writeBytes(const QByteArray bytes)
     Q_UNUSED(bytes);
 }
 
-/// Parses a BigEndian quint64 timestamp
+/// Parses the BigEndian quint64 timestamp at the specified offset
 /// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_parseTimestamp(const QByteArray& bytes)
+quint64 LogReplayLink::_parseTimestamp(qint64 offset)
 {
-    quint64 timestamp = qFromBigEndian(*((quint64*)(bytes.constData())));
+    if (offset < 0 || offset + cbTimestamp > _logFileSize) {
+        return 0;
+    }
+
+    quint64 timestamp = qFromBigEndian<quint64>(_logData + offset);
     quint64 currentTimestamp = ((quint64)QDateTime::currentMSecsSinceEpoch()) * 1000;
     
     // Now if the parsed timestamp is in the future, it must be an old file where the timestamp was stored as
@@ -177,90 +200,153 @@ quint64 LogReplayLink::_parseTimestamp(const QByteArray& bytes)
     return timestamp;
 }
 
+/// Finds the first log record at or after the specified offset which holds a valid mavlink message. Normally that is
+/// the record at offset itself, otherwise we resync on the next valid message the same way mavlink_parse_char would.
+///     @param frameOffset[out] Offset of the mavlink message, the timestamp for it precedes it
+///     @param frameLength[out] Length of the mavlink message
+/// @return false: no more messages in the log
+bool LogReplayLink::_findRecord(qint64 offset, qint64& frameOffset, int& frameLength)
+{
+    mavlink_message_t message;
+
+    for (frameOffset = offset + cbTimestamp; frameOffset < _logFileSize; frameOffset++) {
+        uint8_t stx = _logData[frameOffset];
+        if (stx != MAVLINK_STX && stx != MAVLINK_STX_MAVLINK1) {
+            continue;
+        }
+        int available = static_cast<int>(qMin(_logFileSize - frameOffset, static_cast<qint64>(MAVLINK_MAX_PACKET_LEN)));
+        if (MAVLinkBlockParser::parseFrame(_logData + frameOffset, available, message, frameLength) == MAVLinkBlockParser::FrameComplete) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /// Reads the next mavlink message from the log
 ///     @param bytes[output] Bytes for mavlink message
 /// @return Unix timestamp in microseconds UTC for NEXT mavlink message or 0 if no message found
 quint64 LogReplayLink::_readNextMavlinkMessage(QByteArray& bytes)
 {
-    char                nextByte;
-    mavlink_status_t    status;
-
-    bytes.clear();
+    qint64  frameOffset;
+    int     frameLength;
 
-    while (_logFile.getChar(&nextByte)) { // Loop over every byte
-        mavlink_message_t message;
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, &message, &status);
+    if (!_findRecord(_logPos, frameOffset, frameLength)) {
+        bytes.clear();
+        _logPos = _logFileSize;
+        return 0;
+    }
 
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message, clear any partial bytes
-            bytes.clear();
-        }
-        bytes.append(nextByte);
+    // Copy out of the log data since the bytes are handed to other threads which may still hold them after unmap
+    bytes = QByteArray(reinterpret_cast<const char*>(_logData + frameOffset), frameLength);
+    _logPos = frameOffset + frameLength;
 
-        if (messageFound) {
-            // Return the timestamp for the next message
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
-        }
-    }
+    return _parseTimestamp(_logPos);
+}
 
-    return 0;
+QString LogReplayLink::_indexFilename(void) const
+{
+    return _logFile.fileName() + _indexFileExtension;
 }
 
-/// Seeks to the beginning of the next successfully parsed mavlink message in the log file.
-///     @param nextMsg[output] Parsed next message that was found
-/// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_seekToNextMavlinkMessage(mavlink_message_t* nextMsg)
+/// Walks the whole log once to build the sparse timestamp index as well as find the start and end time
+void LogReplayLink::_buildIndex(void)
 {
-    char                nextByte;
-    mavlink_status_t    status;
-    qint64              messageStartPos = -1;
+    QElapsedTimer   timer;
+    qint64          offset = 0;
+    qint64          frameOffset;
+    int             frameLength;
 
-    mavlink_reset_channel_status(_mavlinkChannel);
+    timer.start();
+    _index.clear();
+    _logStartTimeUSecs  = 0;
+    _logEndTimeUSecs    = 0;
 
-    while (_logFile.getChar(&nextByte)) {
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, nextMsg, &status);
+    while (_findRecord(offset, frameOffset, frameLength)) {
+        qint64  recordOffset    = frameOffset - cbTimestamp;
+        quint64 timeUSecs       = _parseTimestamp(recordOffset);
 
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message
-            messageStartPos = _logFile.pos() - 1;
+        if (_index.isEmpty()) {
+            _logStartTimeUSecs = timeUSecs;
         }
-        
-        // If we've found a message, jump back to the start of the message, grab the timestamp,
-        // and go back to the end of this file.
-        if (messageFound && messageStartPos != -1) {
-            _logFile.seek(messageStartPos - cbTimestamp);
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
+        if (_index.isEmpty() || timeUSecs >= _index.last().timeUSecs + _indexIntervalUSecs) {
+            _index.append({ timeUSecs, recordOffset });
         }
+        // Keep the index monotonic even if the log has timestamps which go backwards
+        _logEndTimeUSecs = qMax(_logEndTimeUSecs, timeUSecs);
+
+        offset = frameOffset + frameLength;
     }
-    
-    return 0;
+
+    qCDebug(LogReplayLinkLog) << "Index built entries:msecs" << _index.count() << timer.elapsed();
 }
 
-quint64 LogReplayLink::_findLastTimestamp(void)
+bool LogReplayLink::_loadIndex(void)
 {
-    char                nextByte;
-    mavlink_status_t    status;
-    quint64             lastTimestamp = 0;
-    mavlink_message_t   msg;
+    QFile indexFile(_indexFilename());
+    if (!indexFile.open(QFile::ReadOnly)) {
+        return false;
+    }
 
-    // We read through the entire file looking for the last good timestamp. This can be somewhat slow, but trying to work from the
-    // end of the file can be way slower due to all the seeking back and forth required. So instead we take the simple reliable approach.
+    QDataStream stream(&indexFile);
+    quint32     magic;
+    quint32     version;
+    qint64      logFileSize;
+    qint64      logFileModifiedMSecs;
+    quint32     entryCount;
+
+    stream >> magic >> version >> logFileSize >> logFileModifiedMSecs;
+    if (magic != _indexFileMagic || version != _indexFileVersion ||
+            logFileSize != _logFileSize || logFileModifiedMSecs != QFileInfo(_logFile).lastModified().toMSecsSinceEpoch()) {
+        qCDebug(LogReplayLinkLog) << "Index file out of date" << indexFile.fileName();
+        return false;
+    }
 
-    _logFile.reset();
-    mavlink_reset_channel_status(_mavlinkChannel);
+    stream >> _logStartTimeUSecs >> _logEndTimeUSecs >> entryCount;
+    if (stream.status() != QDataStream::Ok || static_cast<qint64>(entryCount) * 16 > indexFile.size()) {
+        return false;
+    }
 
-    while (_logFile.bytesAvailable() > cbTimestamp) {
-        lastTimestamp = _parseTimestamp(_logFile.read(cbTimestamp));
+    _index.resize(static_cast<int>(entryCount));
+    for (IndexEntry_t& entry: _index) {
+        stream >> entry.timeUSecs >> entry.offset;
+    }
+    if (stream.status() != QDataStream::Ok) {
+        _index.clear();
+        return false;
+    }
 
-        bool endOfMessage = false;
-        while (!endOfMessage && _logFile.getChar(&nextByte)) {
-            endOfMessage = mavlink_parse_char(_mavlinkChannel, nextByte, &msg, &status);
+    // Seeking trusts the index, so a damaged one must not point outside the log or out of order
+    for (int i=0; i<_index.count(); i++) {
+        const IndexEntry_t& entry = _index[i];
+        if (entry.offset < 0 || entry.offset >= _logFileSize ||
+                entry.timeUSecs < _logStartTimeUSecs || entry.timeUSecs > _logEndTimeUSecs ||
+                (i > 0 && (entry.offset < _index[i - 1].offset || entry.timeUSecs < _index[i - 1].timeUSecs))) {
+            qCDebug(LogReplayLinkLog) << "Index file corrupt" << indexFile.fileName() << "entry" << i;
+            _index.clear();
+            return false;
         }
     }
 
-    return lastTimestamp;
+    qCDebug(LogReplayLinkLog) << "Index loaded entries" << _index.count();
+    return true;
+}
+
+void LogReplayLink::_saveIndex(void)
+{
+    // The index is only a cache, so failing to write it (read only location for example) is not an error
+    QFile indexFile(_indexFilename());
+    if (!indexFile.open(QFile::WriteOnly | QFile::Truncate)) {
+        qCDebug(LogReplayLinkLog) << "Unable to write index file" << indexFile.fileName() << indexFile.errorString();
+        return;
+    }
+
+    QDataStream stream(&indexFile);
+    stream << static_cast<quint32>(_indexFileMagic) << static_cast<quint32>(_indexFileVersion) << _logFileSize << QFileInfo(_logFile).lastModified().toMSecsSinceEpoch();
+    stream << _logStartTimeUSecs << _logEndTimeUSecs << static_cast<quint32>(_index.count());
+    for (const IndexEntry_t& entry: _index) {
+        stream << entry.timeUSecs << entry.offset;
+    }
 }
 
 bool LogReplayLink::_loadLogFile(void)
@@ -269,8 +355,6 @@ bool LogReplayLink::_loadLogFile(void)
     QString logFilename = _logReplayConfig->logFilename();
     QFileInfo logFileInfo;
     int logDurationSecondsTotal;
-    quint64 startTimeUSecs;
-    quint64 endTimeUSecs;
 
     if (_logFile.isOpen()) {
         errorMsg = tr("Attempt to load new log while log being played");
@@ -284,23 +368,37 @@ bool LogReplayLink::_loadLogFile(void)
     }
     logFileInfo.setFile(logFilename);
     _logFileSize = logFileInfo.size();
-    
-    startTimeUSecs = _parseTimestamp(_logFile.read(cbTimestamp));
-    endTimeUSecs = _findLastTimestamp();
 
-    if (endTimeUSecs <= startTimeUSecs) {
+    _logData = _logFile.map(0, _logFileSize);
+    if (!_logData) {
+        // Some file systems do not support mapping, fall back to holding the whole log in memory
+        qCDebug(LogReplayLinkLog) << "Unable to map log file, reading it instead" << _logFile.errorString();
+        _logBuffer = _logFile.readAll();
+        if (_logBuffer.size() != _logFileSize) {
+            errorMsg = tr("Unable to read log file: '%1', error: %2").arg(logFilename).arg(_logFile.errorString());
+            goto Error;
+        }
+        _logData = reinterpret_cast<const uchar*>(_logBuffer.constData());
+    }
+
+    if (!_loadIndex()) {
+        _buildIndex();
+        if (!_index.isEmpty()) {
+            _saveIndex();
+        }
+    }
+
+    if (_index.isEmpty() || _logEndTimeUSecs <= _logStartTimeUSecs) {
         errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
         goto Error;
     }
 
     // Remember the start and end time so we can move around this _logFile with the slider.
-    _logEndTimeUSecs = endTimeUSecs;
-    _logStartTimeUSecs = startTimeUSecs;
-    _logDurationUSecs = endTimeUSecs - startTimeUSecs;
-    _logCurrentTimeUSecs = startTimeUSecs;
+    _logDurationUSecs = _logEndTimeUSecs - _logStartTimeUSecs;
+    _logCurrentTimeUSecs = _logStartTimeUSecs;
 
     // Reset our log file so when we go to read it for the first time, we start at the beginning.
-    _logFile.reset();
+    _logPos = 0;
 
     logDurationSecondsTotal = (_logDurationUSecs) / 1000000;
     
@@ -312,6 +410,8 @@ Error:
     if (_logFile.isOpen()) {
         _logFile.close();
     }
+    _logData = nullptr;
+    _logBuffer.clear();
     _replayError(errorMsg);
     return false;
 }
@@ -337,7 +437,7 @@ void LogReplayLink::_readNextLogEntry(void)
         emit bytesReceived(this, bytes);
         emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
 
-        if (_logFile.atEnd()) {
+        if (_atEnd()) {
             _finishPlayback();
             return;
         }
@@ -360,6 +460,47 @@ void LogReplayLink::_readNextLogEntry(void)
     _readTickTimer.start(timeToNextExecutionMSecs);
 }
 
+/// Max speed replay: sends the log in blocks of whole messages as fast as the receiving side can take them. The next
+/// block is only read once the main thread has processed the previous one, so the main thread event queue never
+/// backs up no matter how fast the log can be read.
+void LogReplayLink::_readNextBlock(void)
+{
+    if (!_maxSpeedPlaying) {
+        return;
+    }
+
+    QByteArray  block;
+    QByteArray  bytes;
+
+    block.reserve(_maxSpeedBlockSize + MAVLINK_MAX_PACKET_LEN);
+    while (block.size() < _maxSpeedBlockSize && !_atEnd()) {
+        quint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
+        block.append(bytes);
+        if (nextTimeUSecs != 0) {
+            _logCurrentTimeUSecs = nextTimeUSecs;
+        }
+    }
+
+    if (!block.isEmpty()) {
+        emit bytesReceived(this, block);
+    }
+    emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
+    _signalCurrentLogTimeSecs();
+
+    if (_atEnd()) {
+        _finishPlayback();
+        return;
+    }
+
+    // This is queued to the main thread behind the block we just sent, so it runs once the block has been processed
+    QPointer<LogReplayLink> link = this;
+    QMetaObject::invokeMethod(qgcApp(), [link]() {
+        if (link) {
+            emit link->_readNextBlockOnThread();
+        }
+    }, Qt::QueuedConnection);
+}
+
 void LogReplayLink::_play(void)
 {
     qgcApp()->toolbox()->linkManager()->setConnectionsSuspended(tr("Connect not allowed during Flight Data replay."));
@@ -368,13 +509,18 @@ void LogReplayLink::_play(void)
 #endif
     
     // Make sure we aren't at the end of the file, if we are, reset to the beginning and play from there.
-    if (_logFile.atEnd()) {
+    if (_atEnd()) {
         _resetPlaybackToBeginning();
     }
     
     _playbackStartTimeMSecs = (quint64)QDateTime::currentMSecsSinceEpoch();
     _playbackStartLogTimeUSecs = _logCurrentTimeUSecs;
-    _readTickTimer.start(1);
+    if (_logReplayConfig->maxSpeed()) {
+        _maxSpeedPlaying = true;
+        _readNextBlock();
+    } else {
+        _readTickTimer.start(1);
+    }
     
     emit playbackStarted();
 }
@@ -387,15 +533,14 @@ void LogReplayLink::_pause(void)
 #endif
     
     _readTickTimer.stop();
+    _maxSpeedPlaying = false;
     
     emit playbackPaused();
 }
 
 void LogReplayLink::_resetPlaybackToBeginning(void)
 {
-    if (_logFile.isOpen()) {
-        _logFile.reset();
-    }
+    _logPos = 0;
     
     // And since we haven't starting playback, clear the time of initial playback and the current timestamp.
     _playbackStartTimeMSecs = 0;
@@ -421,45 +566,40 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
         percentComplete = 100;
     }
     
-    qreal percentCompleteMult = percentComplete / 100.0;
-    
-    // But if we have a timestamped MAVLink log, then actually aim to hit that percentage in terms of
-    // time through the file.
-    qint64 newFilePos = (qint64)(percentCompleteMult * (qreal)_logFile.size());
-
-    // Now seek to the appropriate position, failing gracefully if we can't.
-    if (!_logFile.seek(newFilePos)) {
-        _replayError(tr("Unable to seek to new position"));
-        return;
+    quint64 desiredTimeUSecs = _logStartTimeUSecs + static_cast<quint64>(percentComplete / 100.0 * _logDurationUSecs);
+
+    // Jump to the last index entry at or before the desired time
+    int low     = 0;
+    int high    = _index.count() - 1;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (_index[middle].timeUSecs <= desiredTimeUSecs) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
     }
-
-    // But we do align to the next MAVLink message for consistency.
-    mavlink_message_t dummy;
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
-
-    // Now calculate the current file location based on time.
-    qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
-
-    // Calculate the effective baud rate of the file in bytes/s.
-    qreal baudRate = _logFile.size() / (qreal)_logDurationUSecs / 1e6;
-
-    // And the desired time is:
-    qreal desiredTimeUSecs = percentCompleteMult * _logDurationUSecs;
-
-    // And now jump the necessary number of bytes in the proper direction
-    qint64 offset = (newRelativeTimeUSecs - desiredTimeUSecs) * baudRate;
-    if (!_logFile.seek(_logFile.pos() + offset)) {
-        _replayError(tr("Unable to seek to new position"));
-        return;
+    qint64 offset = _index[low].offset;
+
+    // Then walk forward to the first message at or after the desired time, which is at most one index interval away
+    qint64  frameOffset;
+    int     frameLength;
+    _logPos = _logFileSize;
+    _logCurrentTimeUSecs = _logEndTimeUSecs;
+    while (_findRecord(offset, frameOffset, frameLength)) {
+        qint64  recordOffset    = frameOffset - cbTimestamp;
+        quint64 timeUSecs       = _parseTimestamp(recordOffset);
+        if (timeUSecs >= desiredTimeUSecs) {
+            _logPos = recordOffset;
+            _logCurrentTimeUSecs = timeUSecs;
+            break;
+        }
+        offset = frameOffset + frameLength;
     }
-
-    // And scan until we reach the start of a MAVLink message. We make sure to record this timestamp for
-    // smooth jumping around the file.
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
     _signalCurrentLogTimeSecs();
 
     // Now update the UI with our actual final position.
-    newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
+    qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
     percentComplete = (newRelativeTimeUSecs / _logDurationUSecs) * 100;
     emit playbackPercentCompleteChanged(percentComplete);
 }
@@ -467,6 +607,10 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
 void LogReplayLink::_setPlaybackSpeed(qreal playbackSpeed)
 {
     _playbackSpeed = playbackSpeed;
+
+    if (_logReplayConfig->maxSpeed()) {
+        return;
+    }
     
     // Let _readNextLogEntry update to correct speed
     _playbackStartTimeMSecs = (quint64)QDateTime::currentMSecsSinceEpoch();
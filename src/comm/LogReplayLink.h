@@ -14,6 +14,9 @@
 
 #include <QTimer>
 #include <QFile>
+#include <QVector>
+
+Q_DECLARE_LOGGING_CATEGORY(LogReplayLinkLog)
 
 class LogReplayLinkConfiguration : public LinkConfiguration
 {
@@ -30,6 +33,10 @@ public:
 
     QString logFilenameShort(void);
 
+    /// Max speed replays the log as fast as it can be processed, ignoring log timing and playback speed. Not persisted.
+    bool maxSpeed(void) const { return _maxSpeed; }
+    void setMaxSpeed(bool maxSpeed) { _maxSpeed = maxSpeed; }
+
     // Virtuals from LinkConfiguration
     LinkType    type                    () { return LinkConfiguration::TypeLogReplay; }
     void        copyFrom                (LinkConfiguration* source);
@@ -45,9 +52,13 @@ signals:
 private:
     static const char*  _logFilenameKey;
     QString             _logFilename;
+    bool                _maxSpeed;
 };
 
 /// Pseudo link that reads a telemetry log and feeds it into the application.
+///
+/// The log is memory mapped, or read into memory if mapping fails. A sparse timestamp to file offset index is built on first open and cached in a
+/// sidecar file next to the log, so opening a log and moving the playhead do not need to scan the file.
 class LogReplayLink : public LinkInterface
 {
     Q_OBJECT
@@ -56,7 +67,7 @@ class LogReplayLink : public LinkInterface
 
 public:
     /// @return true: log is currently playing, false: log playback is paused
-    bool isPlaying(void) { return _readTickTimer.isActive(); }
+    bool isPlaying(void) { return _readTickTimer.isActive() || _maxSpeedPlaying; }
 
     void play           (void) { emit _playOnThread(); }
     void pause          (void) { emit _pauseOnThread(); }
@@ -94,9 +105,11 @@ signals:
     void _playOnThread              (void);
     void _pauseOnThread             (void);
     void _setPlaybackSpeedOnThread  (qreal playbackSpeed);
+    void _readNextBlockOnThread     (void);
 
 private slots:
     void _readNextLogEntry  (void);
+    void _readNextBlock     (void);
     void _play              (void);
     void _pause             (void);
     void _setPlaybackSpeed  (qreal playbackSpeed);
@@ -106,11 +119,20 @@ private:
     LogReplayLink(SharedLinkConfigurationPointer& config);
     ~LogReplayLink();
 
+    typedef struct {
+        quint64 timeUSecs;
+        qint64  offset;     ///< Offset of the timestamp which precedes the message
+    } IndexEntry_t;
+
     void    _replayError                (const QString& errorMsg);
-    quint64 _parseTimestamp             (const QByteArray& bytes);
-    quint64 _seekToNextMavlinkMessage   (mavlink_message_t* nextMsg);
-    quint64 _findLastTimestamp          (void);
+    quint64 _parseTimestamp             (qint64 offset);
+    bool    _findRecord                 (qint64 offset, qint64& frameOffset, int& frameLength);
     quint64 _readNextMavlinkMessage     (QByteArray& bytes);
+    bool    _atEnd                      (void) const { return _logPos + cbTimestamp >= _logFileSize; }
+    void    _buildIndex                 (void);
+    bool    _loadIndex                  (void);
+    void    _saveIndex                  (void);
+    QString _indexFilename              (void) const;
     bool    _loadLogFile                (void);
     void    _finishPlayback             (void);
     void    _resetPlaybackToBeginning   (void);
@@ -140,11 +162,21 @@ private:
     quint64 _playbackStartTimeMSecs;    ///< The time when the logfile was first played back. This is used to pace out replaying the messages to fix long-term drift/skew. 0 indicates that the player hasn't initiated playback of this log file.
     quint64 _playbackStartLogTimeUSecs;
 
-    MAVLinkProtocol*    _mavlink;
-    QFile               _logFile;
-    quint64             _logFileSize;
-
-    static const int cbTimestamp = sizeof(quint64);
+    MAVLinkProtocol*        _mavlink;
+    QFile                   _logFile;
+    qint64                  _logFileSize;
+    const uchar*            _logData;       ///< Memory mapped log file, or _logBuffer if the file could not be mapped
+    QByteArray              _logBuffer;     ///< Log file contents when mapping is not available
+    qint64                  _logPos;        ///< Offset of the timestamp for the next message to play
+    QVector<IndexEntry_t>   _index;         ///< One entry per _indexIntervalUSecs of log time
+    bool                    _maxSpeedPlaying;
+
+    static const int        cbTimestamp = sizeof(quint64);
+    static const quint64    _indexIntervalUSecs = 1000000;
+    static const quint32    _indexFileMagic     = 0x51474C49;   // "QGLI"
+    static const quint32    _indexFileVersion   = 1;
+    static const char*      _indexFileExtension;
+    static const int        _maxSpeedBlockSize  = 16 * 1024;    ///< Keeps a block well below the receive queue capacity of threaded parsing
 };
 
 class LogReplayLinkController : public QObject
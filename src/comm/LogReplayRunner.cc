@@ -0,0 +1,181 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogReplayRunner.h"
+#include "LogReplayLink.h"
+#include "LinkManager.h"
+#include "MAVLinkProtocol.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
+#include "QmlObjectListModel.h"
+#include "QGCApplication.h"
+
+#include <QFileInfo>
+
+#include <cstdio>
+
+LogReplayRunner::LogReplayRunner(const QString& logFilename, bool dumpFacts, bool threadedParsing, QObject* parent)
+    : QObject           (parent)
+    , _logFilename      (logFilename)
+    , _dumpFacts        (dumpFacts)
+    , _threadedParsing  (threadedParsing)
+    , _messageCount     (0)
+    , _logDurationSecs  (0)
+    , _exitCode         (0)
+    , _finished         (false)
+{
+
+}
+
+int LogReplayRunner::run(void)
+{
+    if (!start()) {
+        return -1;
+    }
+
+    connect(this, &LogReplayRunner::finished, qgcApp(), &QGCApplication::exit);
+    qgcApp()->exec();
+
+    return _exitCode;
+}
+
+bool LogReplayRunner::start(void)
+{
+    if (!QFileInfo(_logFilename).isFile()) {
+        qWarning() << "Replay log not found:" << _logFilename;
+        return false;
+    }
+
+    QGCToolbox*     toolbox = qgcApp()->toolbox();
+    LinkManager*    linkMgr = toolbox->linkManager();
+
+    // Count every message through the dispatcher, that is far cheaper than connecting to messageReceived
+    toolbox->mavlinkProtocol()->messageDispatcher()->registerHandler(this,
+                                                                      MAVLinkMessageDispatcher::anyId,
+                                                                      MAVLinkMessageDispatcher::anyId,
+                                                                      MAVLinkMessageDispatcher::anyId,
+                                                                      [this](LinkInterface*, const mavlink_message_t&) { _messageCount++; });
+
+    LogReplayLinkConfiguration* linkConfig = new LogReplayLinkConfiguration(tr("Log Replay"));
+    linkConfig->setLogFilename(_logFilename);
+    linkConfig->setName(linkConfig->logFilenameShort());
+    linkConfig->setMaxSpeed(true);
+    linkConfig->setBlockParsing(true);
+    linkConfig->setThreadedParsing(_threadedParsing);
+
+    SharedLinkConfigurationPointer sharedConfig = linkMgr->addConfiguration(linkConfig);
+
+    // createConnectedLink connects the link before returning and playback starts as soon as the link thread runs.
+    // LinkManager signals newLink before connecting it, so that is where the link signals are hooked up.
+    connect(linkMgr, &LinkManager::newLink, this, &LogReplayRunner::_newLink);
+    _elapsedTimer.start();
+    LinkInterface* link = linkMgr->createConnectedLink(sharedConfig);
+    disconnect(linkMgr, &LinkManager::newLink, this, &LogReplayRunner::_newLink);
+
+    if (!link || !_link) {
+        qWarning() << "Unable to create log replay link";
+        _finish();
+        return false;
+    }
+    if (_finished) {
+        // Connecting the link failed
+        return false;
+    }
+
+    return true;
+}
+
+void LogReplayRunner::_newLink(LinkInterface* link)
+{
+    _link = qobject_cast<LogReplayLink*>(link);
+    if (_link) {
+        connect(_link, &LogReplayLink::logFileStats,        this, &LogReplayRunner::_logFileStats);
+        connect(_link, &LogReplayLink::playbackAtEnd,       this, &LogReplayRunner::_playbackAtEnd);
+        connect(_link, &LogReplayLink::communicationError,  this, &LogReplayRunner::_replayError);
+    }
+}
+
+void LogReplayRunner::_logFileStats(int logDurationSecs)
+{
+    _logDurationSecs = logDurationSecs;
+}
+
+void LogReplayRunner::_playbackAtEnd(void)
+{
+    _report();
+    _finish();
+}
+
+void LogReplayRunner::_replayError(const QString& title, const QString& error)
+{
+    qWarning() << title << error;
+    _exitCode = -1;
+    _finish();
+}
+
+void LogReplayRunner::_finish(void)
+{
+    if (_finished) {
+        return;
+    }
+    _finished = true;
+
+    qgcApp()->toolbox()->mavlinkProtocol()->messageDispatcher()->unregisterHandlers(this);
+    qgcApp()->toolbox()->linkManager()->disconnectAll();
+
+    emit finished(_exitCode);
+}
+
+void LogReplayRunner::_report(void)
+{
+    qint64  elapsedMSecs    = qMax(_elapsedTimer.elapsed(), static_cast<qint64>(1));
+    double  elapsedSecs     = elapsedMSecs / 1000.0;
+
+    QmlObjectListModel* vehicles = qgcApp()->toolbox()->multiVehicleManager()->vehicles();
+
+    // The report is the output of the run, so it goes to stdout where it can be redirected and diffed, not into the debug log
+    QTextStream stream(stdout);
+
+    stream << QStringLiteral("Replay complete: %1\n").arg(_logFilename);
+    stream << QStringLiteral("  messages:%1 secs:%2 msgs/sec:%3\n")
+              .arg(_messageCount)
+              .arg(elapsedSecs, 0, 'f', 3)
+              .arg(static_cast<quint64>(_messageCount / elapsedSecs));
+    stream << QStringLiteral("  log secs:%1 speedup:%2x vehicles:%3\n")
+              .arg(_logDurationSecs)
+              .arg(_logDurationSecs / elapsedSecs, 0, 'f', 1)
+              .arg(vehicles->count());
+    if (_threadedParsing) {
+        stream << QStringLiteral("  receive latency %1\n").arg(qgcApp()->toolbox()->mavlinkProtocol()->receiveLatencyHistogram().toString());
+    }
+
+    if (_dumpFacts) {
+        for (int i=0; i<vehicles->count(); i++) {
+            Vehicle* vehicle = vehicles->value<Vehicle*>(i);
+            _writeFacts(stream, QStringLiteral("vehicle%1").arg(vehicle->id()), vehicle);
+        }
+    }
+
+    stream.flush();
+}
+
+void LogReplayRunner::_writeFacts(QTextStream& stream, const QString& prefix, FactGroup* factGroup)
+{
+    QStringList factNames = factGroup->factNames();
+    factNames.sort();
+    for (const QString& factName: factNames) {
+        stream << QStringLiteral("%1.%2=%3\n").arg(prefix, factName, factGroup->getFact(factName)->rawValueString());
+    }
+
+    QStringList factGroupNames = factGroup->factGroupNames();
+    factGroupNames.sort();
+    for (const QString& factGroupName: factGroupNames) {
+        _writeFacts(stream, QStringLiteral("%1.%2").arg(prefix, factGroupName), factGroup->getFactGroup(factGroupName));
+    }
+}
@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QTextStream>
+
+class LogReplayLink;
+class LinkInterface;
+class FactGroup;
+
+/// Replays a telemetry log headless, at max speed, through MAVLinkProtocol and the Vehicle Fact pipeline.
+///
+/// Used from the command line (--replay-log) for batch analysis, to regression test telemetry handling and to
+/// benchmark the receive path. No QML is created. Once the log is done a summary with messages per second is
+/// written to the console, optionally followed by the final value of every vehicle Fact.
+class LogReplayRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param dumpFacts true: write all vehicle Fact values once the log is done, sorted so the output can be diffed
+    /// @param threadedParsing true: parse on the link thread, see LinkConfiguration::threadedParsing
+    LogReplayRunner(const QString& logFilename, bool dumpFacts, bool threadedParsing, QObject* parent = nullptr);
+
+    /// Runs the replay to completion using the application event loop
+    ///     @return Application exit code
+    int run(void);
+
+    /// Creates the replay link, playback starts right away and finished is signalled once it is done. Used by run,
+    /// and directly by unit tests which already have an event loop.
+    ///     @return false: replay could not be started
+    bool start(void);
+
+    quint64 messageCount    (void) const { return _messageCount; }
+    int     logDurationSecs (void) const { return _logDurationSecs; }
+
+signals:
+    void finished(int exitCode);
+
+private slots:
+    void _newLink           (LinkInterface* link);
+    void _logFileStats      (int logDurationSecs);
+    void _playbackAtEnd     (void);
+    void _replayError       (const QString& title, const QString& error);
+
+private:
+    void _finish        (void);
+    void _report        (void);
+    void _writeFacts    (QTextStream& stream, const QString& prefix, FactGroup* factGroup);
+
+    QString                 _logFilename;
+    bool                    _dumpFacts;
+    bool                    _threadedParsing;
+    QPointer<LogReplayLink> _link;
+    QElapsedTimer           _elapsedTimer;
+    quint64                 _messageCount;
+    int                     _logDurationSecs;
+    int                     _exitCode;
+    bool                    _finished;
+};
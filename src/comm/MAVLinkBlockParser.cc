@@ -0,0 +1,158 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkBlockParser.h"
+
+#include <string.h>
+
+MAVLinkBlockParser::MAVLinkBlockParser(void)
+    : _badFrameCount    (0)
+    , _skippedByteCount (0)
+{
+
+}
+
+void MAVLinkBlockParser::reset(void)
+{
+    _carryOver.clear();
+    _badFrameCount      = 0;
+    _skippedByteCount   = 0;
+}
+
+int MAVLinkBlockParser::parse(const QByteArray& bytes, QVector<mavlink_message_t>& messages)
+{
+    const uint8_t*  data;
+    int             size;
+
+    // Only pay for a copy when there is a partial frame left over from the previous block
+    if (_carryOver.isEmpty()) {
+        data = reinterpret_cast<const uint8_t*>(bytes.constData());
+        size = bytes.size();
+    } else {
+        _carryOver.append(bytes);
+        data = reinterpret_cast<const uint8_t*>(_carryOver.constData());
+        size = _carryOver.size();
+    }
+
+    int messageCount    = 0;
+    int position        = 0;
+
+    while (position < size) {
+        // Scan forward to the next start-of-frame marker
+        int scanStart = position;
+        while (position < size && data[position] != MAVLINK_STX && data[position] != MAVLINK_STX_MAVLINK1) {
+            position++;
+        }
+        _skippedByteCount += static_cast<uint64_t>(position - scanStart);
+        if (position == size) {
+            break;
+        }
+
+        int frameLength = 0;
+        int index       = messages.count();
+        messages.resize(index + 1);
+
+        FrameResult_t result = parseFrame(data + position, size - position, messages[index], frameLength);
+        if (result == FrameComplete) {
+            position += frameLength;
+            messageCount++;
+            continue;
+        }
+
+        messages.resize(index);
+        if (result == FrameIncomplete) {
+            break;
+        }
+
+        // Bad frame: the marker was most likely payload data. Resync on the next byte.
+        _badFrameCount++;
+        position++;
+    }
+
+    if (position < size) {
+        // Detach from _carryOver before re-assigning since data may point into it
+        QByteArray remainder(reinterpret_cast<const char*>(data + position), size - position);
+        _carryOver = remainder;
+    } else {
+        _carryOver.clear();
+    }
+
+    return messageCount;
+}
+
+MAVLinkBlockParser::FrameResult_t MAVLinkBlockParser::parseFrame(const uint8_t* frame, int available, mavlink_message_t& message, int& frameLength)
+{
+    bool    mavlink1        = frame[0] == MAVLINK_STX_MAVLINK1;
+    int     headerLength    = mavlink1 ? _mavlink1HeaderLength : _mavlink2HeaderLength;
+    int     signatureLength = 0;
+
+    if (available < headerLength) {
+        return FrameIncomplete;
+    }
+
+    uint8_t payloadLength = frame[1];
+
+    if (mavlink1) {
+        message.incompat_flags  = 0;
+        message.compat_flags    = 0;
+        message.seq             = frame[2];
+        message.sysid           = frame[3];
+        message.compid          = frame[4];
+        message.msgid           = frame[5];
+    } else {
+        // Same as mavlink_parse_char: frames with incompat flags we don't understand are dropped
+        if (frame[2] & ~MAVLINK_IFLAG_SIGNED) {
+            return FrameBad;
+        }
+        message.incompat_flags  = frame[2];
+        message.compat_flags    = frame[3];
+        message.seq             = frame[4];
+        message.sysid           = frame[5];
+        message.compid          = frame[6];
+        message.msgid           = frame[7] | (static_cast<uint32_t>(frame[8]) << 8) | (static_cast<uint32_t>(frame[9]) << 16);
+        if (message.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+            signatureLength = MAVLINK_SIGNATURE_BLOCK_LEN;
+        }
+    }
+
+    frameLength = headerLength + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES + signatureLength;
+    if (available < frameLength) {
+        return FrameIncomplete;
+    }
+
+    // CRC covers everything after the STX through the end of the payload, followed by the message specific crc extra
+    const mavlink_msg_entry_t* msgEntry = mavlink_get_msg_entry(message.msgid);
+    uint16_t crc = crc_calculate(frame + 1, static_cast<uint16_t>(headerLength - 1 + payloadLength));
+    crc_accumulate(msgEntry ? msgEntry->crc_extra : 0, &crc);
+
+    const uint8_t* ck = frame + headerLength + payloadLength;
+    if (ck[0] != (crc & 0xFF) || ck[1] != (crc >> 8)) {
+        return FrameBad;
+    }
+
+    message.magic       = frame[0];
+    message.len         = payloadLength;
+    message.checksum    = crc;
+    message.ck[0]       = ck[0];
+    message.ck[1]       = ck[1];
+
+    uint8_t* payload = reinterpret_cast<uint8_t*>(_MAV_PAYLOAD_NON_CONST(&message));
+    memcpy(payload, frame + headerLength, payloadLength);
+
+    // Zero fill truncated MAVLink 2 payloads the same way mavlink_parse_char does
+    if (msgEntry && payloadLength < msgEntry->max_msg_len) {
+        memset(payload + payloadLength, 0, msgEntry->max_msg_len - payloadLength);
+    }
+
+    if (signatureLength) {
+        memcpy(message.signature, ck + MAVLINK_NUM_CHECKSUM_BYTES, MAVLINK_SIGNATURE_BLOCK_LEN);
+    }
+
+    return FrameComplete;
+}
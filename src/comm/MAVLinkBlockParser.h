@@ -0,0 +1,61 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+#include "QGCMAVLink.h"
+
+/// Block based alternative to mavlink_parse_char.
+///
+/// Instead of running the MAVLink state machine once per byte, the block parser scans an incoming buffer for
+/// start-of-frame markers, validates each complete frame in place (header, length, CRC) and only copies out the
+/// frames which pass. A partial frame at the end of a block is carried over to the next call. One parser instance
+/// is needed per link since it holds the carry over state.
+class MAVLinkBlockParser
+{
+public:
+    MAVLinkBlockParser(void);
+
+    /// Parses the specified block of bytes, appending each valid message to messages.
+    ///     @return Number of messages appended
+    int parse(const QByteArray& bytes, QVector<mavlink_message_t>& messages);
+
+    /// Throws away any partial frame and resets the counters
+    void reset(void);
+
+    /// @return Number of frames which were dropped due to bad CRC or unsupported incompat flags
+    uint32_t    badFrameCount   (void) const { return _badFrameCount; }
+
+    /// @return Number of bytes which were skipped while looking for a start-of-frame marker
+    uint64_t    skippedByteCount(void) const { return _skippedByteCount; }
+
+    typedef enum {
+        FrameComplete,
+        FrameIncomplete,
+        FrameBad,
+    } FrameResult_t;
+
+    /// Validates and decodes a single frame which starts at the specified start-of-frame marker. Holds no state so it
+    /// can be used directly on buffers which are already framed, such as memory mapped logs.
+    ///     @param available Number of bytes available starting at frame
+    ///     @param frameLength[out] Length of the frame in bytes, valid for FrameComplete
+    static FrameResult_t parseFrame(const uint8_t* frame, int available, mavlink_message_t& message, int& frameLength);
+
+private:
+
+    QByteArray  _carryOver;         ///< Partial frame left over from the previous block
+    uint32_t    _badFrameCount;
+    uint64_t    _skippedByteCount;
+
+    static const int _mavlink1HeaderLength = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1;
+    static const int _mavlink2HeaderLength = MAVLINK_CORE_HEADER_LEN + 1;
+};
@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageDispatcher.h"
+
+#include <QVarLengthArray>
+
+#include <string.h>
+
+MAVLinkMessageDispatcher::MAVLinkMessageDispatcher(void)
+    : _nextRegistrationId(1)
+{
+    memset(_patternUseCount, 0, sizeof(_patternUseCount));
+}
+
+quint64 MAVLinkMessageDispatcher::_key(int sysid, int compid, int msgid)
+{
+    quint64 sysKey  = sysid  == anyId ? _anySysOrCompId : static_cast<quint64>(sysid & 0xFF);
+    quint64 compKey = compid == anyId ? _anySysOrCompId : static_cast<quint64>(compid & 0xFF);
+    quint64 msgKey  = msgid  == anyId ? _anyMsgId       : static_cast<quint64>(static_cast<uint32_t>(msgid));
+
+    return (sysKey << 48) | (compKey << 32) | msgKey;
+}
+
+int MAVLinkMessageDispatcher::_pattern(int sysid, int compid, int msgid)
+{
+    return (sysid == anyId ? 4 : 0) | (compid == anyId ? 2 : 0) | (msgid == anyId ? 1 : 0);
+}
+
+int MAVLinkMessageDispatcher::registerHandler(QObject* owner, int sysid, int compid, int msgid, MessageHandler handler)
+{
+    return _register(owner, sysid, compid, msgid, SharedHandler(new MessageHandler(handler)));
+}
+
+int MAVLinkMessageDispatcher::_register(QObject* owner, int sysid, int compid, int msgid, const SharedHandler& handler)
+{
+    SharedRegistration registration(new Registration_t);
+    registration->id        = _nextRegistrationId++;
+    registration->key       = _key(sysid, compid, msgid);
+    registration->owner     = owner;
+    registration->handler   = handler;
+    registration->active    = true;
+
+    _registrationsByKey[registration->key].append(registration);
+    _registrationsById[registration->id] = registration;
+    _patternUseCount[_pattern(sysid, compid, msgid)]++;
+
+    return registration->id;
+}
+
+QList<int> MAVLinkMessageDispatcher::registerHandler(QObject* owner, int sysid, int compid, const QList<int>& msgids, MessageHandler handler)
+{
+    QList<Key_t> keys;
+    for (int msgid: msgids) {
+        keys.append({ sysid, compid, msgid });
+    }
+    return registerHandler(owner, keys, handler);
+}
+
+QList<int> MAVLinkMessageDispatcher::registerHandler(QObject* owner, const QList<Key_t>& keys, MessageHandler handler)
+{
+    SharedHandler   sharedHandler(new MessageHandler(handler));
+    QList<int>      registrationIds;
+
+    for (const Key_t& key: keys) {
+        registrationIds.append(_register(owner, key.sysid, key.compid, key.msgid, sharedHandler));
+    }
+    return registrationIds;
+}
+
+void MAVLinkMessageDispatcher::_remove(const SharedRegistration& registration)
+{
+    // Mark inactive first so an in progress dispatch which holds a copy of the list skips it
+    registration->active = false;
+
+    quint64 key     = registration->key;
+    int     sysid   = (key >> 48) == _anySysOrCompId ? anyId : 0;
+    int     compid  = ((key >> 32) & 0xFFFF) == _anySysOrCompId ? anyId : 0;
+    int     msgid   = (key & 0xFFFFFFFF) == _anyMsgId ? anyId : 0;
+    _patternUseCount[_pattern(sysid, compid, msgid)]--;
+
+    RegistrationList& list = _registrationsByKey[key];
+    list.removeAll(registration);
+    if (list.isEmpty()) {
+        _registrationsByKey.remove(key);
+    }
+    _registrationsById.remove(registration->id);
+}
+
+void MAVLinkMessageDispatcher::unregisterHandler(int registrationId)
+{
+    SharedRegistration registration = _registrationsById.value(registrationId);
+    if (registration) {
+        _remove(registration);
+    }
+}
+
+void MAVLinkMessageDispatcher::unregisterHandlers(const QList<int>& registrationIds)
+{
+    for (int registrationId: registrationIds) {
+        unregisterHandler(registrationId);
+    }
+}
+
+void MAVLinkMessageDispatcher::unregisterHandlers(QObject* owner)
+{
+    QList<SharedRegistration> ownerRegistrations;
+    for (const SharedRegistration& registration: _registrationsById) {
+        if (registration->owner == owner) {
+            ownerRegistrations.append(registration);
+        }
+    }
+    for (const SharedRegistration& registration: ownerRegistrations) {
+        _remove(registration);
+    }
+}
+
+int MAVLinkMessageDispatcher::dispatch(LinkInterface* link, const mavlink_message_t& message)
+{
+    if (_registrationsById.isEmpty()) {
+        return 0;
+    }
+
+    int                                     handlerCount = 0;
+    QVarLengthArray<const MessageHandler*>  calledHandlers;
+
+    for (int pattern=0; pattern<8; pattern++) {
+        if (_patternUseCount[pattern] == 0) {
+            continue;
+        }
+
+        quint64 key = _key(pattern & 4 ? anyId : message.sysid,
+                           pattern & 2 ? anyId : message.compid,
+                           pattern & 1 ? anyId : static_cast<int>(message.msgid));
+
+        auto iter = _registrationsByKey.constFind(key);
+        if (iter == _registrationsByKey.constEnd()) {
+            continue;
+        }
+
+        // Iterate over a copy since handlers may change registrations
+        const RegistrationList registrations = iter.value();
+        for (const SharedRegistration& registration: registrations) {
+            if (!registration->active) {
+                continue;
+            }
+            if (!registration->owner) {
+                // Owner was destroyed without unregistering
+                _remove(registration);
+                continue;
+            }
+            if (calledHandlers.contains(registration->handler.data())) {
+                // Subscriber was already called through another of its keys
+                continue;
+            }
+            calledHandlers.append(registration->handler.data());
+            (*registration->handler)(link, message);
+            handlerCount++;
+        }
+    }
+
+    return handlerCount;
+}
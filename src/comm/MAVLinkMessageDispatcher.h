@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <functional>
+
+#include "QGCMAVLink.h"
+
+class LinkInterface;
+
+/// Subscription registry which routes MAVLink messages only to the handlers registered for them.
+///
+/// Handlers are registered against a (sysid, compid, msgid) key where any part can be a wildcard. Dispatching
+/// a message costs one hash lookup per wildcard pattern which is actually in use, independent of how many
+/// handlers are registered for other keys. Handlers may register/unregister from within a dispatch.
+/// A handler registered against several keys in one call is a single subscriber, it is called once per message
+/// even when more than one of its keys match.
+class MAVLinkMessageDispatcher
+{
+public:
+    typedef std::function<void(LinkInterface* link, const mavlink_message_t& message)> MessageHandler;
+
+    static const int anyId = -1;    ///< Wildcard for sysid, compid or msgid
+
+    typedef struct {
+        int sysid;
+        int compid;
+        int msgid;
+    } Key_t;
+
+    MAVLinkMessageDispatcher(void);
+
+    /// Registers a handler for the specified key.
+    ///     @param owner Handler is skipped once the owner is destroyed. Owners should still unregister when done.
+    ///     @return Registration id used for unregisterHandler
+    int registerHandler(QObject* owner, int sysid, int compid, int msgid, MessageHandler handler);
+
+    /// Registers the same handler for a set of message ids
+    QList<int> registerHandler(QObject* owner, int sysid, int compid, const QList<int>& msgids, MessageHandler handler);
+
+    /// Registers the same handler for a set of keys
+    QList<int> registerHandler(QObject* owner, const QList<Key_t>& keys, MessageHandler handler);
+
+    void unregisterHandler  (int registrationId);
+    void unregisterHandlers (const QList<int>& registrationIds);
+
+    /// Unregisters all handlers for the specified owner
+    void unregisterHandlers (QObject* owner);
+
+    /// Calls all handlers which match the message, exact keys first followed by wildcard keys.
+    ///     @return Number of handlers called
+    int dispatch(LinkInterface* link, const mavlink_message_t& message);
+
+    bool isEmpty(void) const { return _registrationsById.isEmpty(); }
+
+private:
+    typedef QSharedPointer<MessageHandler> SharedHandler;
+
+    typedef struct {
+        int                 id;
+        quint64             key;
+        QPointer<QObject>   owner;
+        SharedHandler       handler;    ///< Shared by all registrations of the same subscriber
+        bool                active;
+    } Registration_t;
+
+    typedef QSharedPointer<Registration_t>  SharedRegistration;
+    typedef QVector<SharedRegistration>     RegistrationList;
+
+    static quint64  _key        (int sysid, int compid, int msgid);
+    static int      _pattern    (int sysid, int compid, int msgid);
+    int             _register   (QObject* owner, int sysid, int compid, int msgid, const SharedHandler& handler);
+    void            _remove     (const SharedRegistration& registration);
+
+    QHash<quint64, RegistrationList>    _registrationsByKey;
+    QHash<int, SharedRegistration>      _registrationsById;
+    int                                 _patternUseCount[8];    ///< Number of registrations using each wildcard pattern
+    int                                 _nextRegistrationId;
+
+    static const quint64    _anySysOrCompId = 0x100;
+    static const quint64    _anyMsgId       = 0xFFFFFFFF;
+};
@@ -24,6 +24,7 @@
 #include <QStandardPaths>
 #include <QtEndian>
 #include <QMetaType>
+#include <QMetaMethod>
 #include <QDir>
 #include <QFileInfo>
 
@@ -40,6 +41,7 @@
 #include "SettingsManager.h"
 
 Q_DECLARE_METATYPE(mavlink_message_t)
+Q_DECLARE_METATYPE(QVector<mavlink_message_t>)
 
 QGC_LOGGING_CATEGORY(MAVLinkProtocolLog, "MAVLinkProtocolLog")
 
@@ -65,6 +67,8 @@ MAVLinkProtocol::MAVLinkProtocol(QGCApplication* app, QGCToolbox* toolbox)
     , _tempLogFile(QString("%2.%3").arg(_tempLogFileTemplate).arg(_logFileExtension))
     , _linkMgr(nullptr)
     , _multiVehicleManager(nullptr)
+    , _receiveLatencyLogNSecs(0)
+    , _receiveDropLogNSecs(0)
 {
     memset(totalReceiveCounter, 0, sizeof(totalReceiveCounter));
     memset(totalLossCounter,    0, sizeof(totalLossCounter));
@@ -72,6 +76,10 @@ MAVLinkProtocol::MAVLinkProtocol(QGCApplication* app, QGCToolbox* toolbox)
     memset(firstMessage,        1, sizeof(firstMessage));
     memset(&_status,            0, sizeof(_status));
     memset(&_message,           0, sizeof(_message));
+
+    _receiveTimer.start();
+
+    connect(this, &MAVLinkProtocol::_receiveQueueReady, this, &MAVLinkProtocol::_drainReceiveQueue, Qt::QueuedConnection);
 }
 
 MAVLinkProtocol::~MAVLinkProtocol()
@@ -106,6 +114,7 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
    _multiVehicleManager =   _toolbox->multiVehicleManager();
 
    qRegisterMetaType<mavlink_message_t>("mavlink_message_t");
+   qRegisterMetaType<QVector<mavlink_message_t>>("QVector<mavlink_message_t>");
 
    loadSettings();
 
@@ -157,6 +166,18 @@ void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
         firstMessage[channel][i] =  1;
     }
     link->setDecodedFirstMavlinkPacket(false);
+    // Links using threaded parsing have their own parser which is only touched on the link thread
+    _blockParsers[channel].reset();
+}
+
+void MAVLinkProtocol::setupThreadedParsing(LinkInterface* link)
+{
+    // The link thread is not running yet, after this the queue is only replaced when the link is destroyed
+    if (!link->_receiveQueue) {
+        link->_receiveQueue.reset(new MAVLinkReceiveQueue(_receiveQueueCapacity));
+        link->_receiveParser.reset();
+        link->_receiveDroppedReported = 0;
+    }
 }
 
 /**
@@ -208,186 +229,325 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
         return;
     }
 
+    if (link->getLinkConfiguration()->isBlockParsing()) {
+        _receiveBytesBlock(link, b);
+        return;
+    }
+
     uint8_t mavlinkChannel = link->mavlinkChannel();
 
+    for (int position = 0; position < b.size(); position++) {
+        if (mavlink_parse_char(mavlinkChannel, static_cast<uint8_t>(b[position]), &_message, &_status)) {
+            _handleMessage(link, _message, _forwardingLink().data());
+            // Reset message parsing
+            memset(&_status,  0, sizeof(_status));
+            memset(&_message, 0, sizeof(_message));
+        } else if (!link->decodedFirstMavlinkPacket()) {
+            // No formed message yet
+            if (!_nonMavlinkBytesReceived(link, 1)) {
+                return;
+            }
+        }
+    }
+}
+
+/// Block parsing version of receiveBytes. Messages are pulled out of the whole block at once and then
+/// handed out one by one through messageReceived.
+void MAVLinkProtocol::_receiveBytesBlock(LinkInterface* link, const QByteArray& b)
+{
+    uint8_t             mavlinkChannel  = link->mavlinkChannel();
+    MAVLinkBlockParser& parser          = _blockParsers[mavlinkChannel];
+
+    // A local buffer is used since signal handlers can end up back in here through the event loop
+    QVector<mavlink_message_t> messages;
+    messages.reserve(_blockMessagesReserve);
+
+    uint64_t skippedBytes = parser.skippedByteCount();
+    if (parser.parse(b, messages) == 0) {
+        if (!link->decodedFirstMavlinkPacket()) {
+            _nonMavlinkBytesReceived(link, static_cast<int>(parser.skippedByteCount() - skippedBytes));
+        }
+        return;
+    }
+
+    // Forwarding state only needs to be looked up once per block
+    SharedLinkInterfacePointer forwardingLink = _forwardingLink();
+
+    mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+    for (const mavlink_message_t& message: messages) {
+        // Keep the channel version flags in sync the same as mavlink_parse_char would
+        if (message.magic == MAVLINK_STX_MAVLINK1) {
+            mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        } else {
+            mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        }
+        _handleMessage(link, message, forwardingLink.data());
+    }
+}
+
+void MAVLinkProtocol::receiveBytesOnLinkThread(LinkInterface* link, QByteArray b)
+{
+    // Note: This runs on the link thread. It may only touch state which is owned by the link.
+    // Non-MAVLink data detection is not supported on threaded links.
+    MAVLinkReceiveQueue* queue = link->_receiveQueue.data();
+    if (!queue) {
+        return;
+    }
+
+    QVector<mavlink_message_t> messages;
+    messages.reserve(_blockMessagesReserve);
+    if (link->_receiveParser.parse(b, messages) == 0) {
+        return;
+    }
+
+    qint64 receiveTimeNSecs = _receiveTimer.nsecsElapsed();
+    for (const mavlink_message_t& message: messages) {
+        queue->push(message, receiveTimeNSecs);
+    }
+
+    // Only a single drain is queued to the main thread no matter how many blocks come in before it runs
+    if (queue->requestDrain()) {
+        emit _receiveQueueReady(link);
+    }
+}
+
+/// Dispatch stage for links using threaded parsing. Runs on the main thread.
+void MAVLinkProtocol::_drainReceiveQueue(LinkInterface* link)
+{
+    // The drain is queued, so the link may have been removed since. Holding a reference keeps it alive while the
+    // handlers run, even if one of them disconnects the link.
+    if (!_linkMgr->containsLink(link)) {
+        return;
+    }
+    SharedLinkInterfacePointer sharedLink = _linkMgr->sharedLinkInterfacePointerForLink(link);
+    MAVLinkReceiveQueue* queue = link->_receiveQueue.data();
+    if (!queue) {
+        return;
+    }
+
+    queue->drainStarted();
+
+    // Drops are counted on the link thread and reported here, at most once per interval so an overloaded link
+    // doesn't add a warning to every drain
+    uint32_t droppedCount = queue->droppedCount();
+    qint64 dropCheckNSecs = _receiveTimer.nsecsElapsed();
+    if (droppedCount != link->_receiveDroppedReported && dropCheckNSecs - _receiveDropLogNSecs > _receiveDropLogIntervalNSecs) {
+        _receiveDropLogNSecs = dropCheckNSecs;
+        qCWarning(MAVLinkProtocolLog) << "Receive queue full, dropped" << droppedCount - link->_receiveDroppedReported
+                                      << "messages on" << link->getName() << "total" << droppedCount;
+        link->_receiveDroppedReported = droppedCount;
+    }
+
+    SharedLinkInterfacePointer  forwardingLink  = _forwardingLink();
+    mavlink_status_t*           mavlinkStatus   = mavlink_get_channel_status(link->mavlinkChannel());
+
+    const MAVLinkReceiveQueue::Entry_t* entry;
+    while ((entry = queue->front())) {
+        if (entry->message.magic == MAVLINK_STX_MAVLINK1) {
+            mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        } else {
+            mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        }
+
+        // Handlers update the Vehicle Facts synchronously, so once this returns the Facts are up to date
+        _handleMessage(link, entry->message, forwardingLink.data());
+        _receiveLatencyHistogram.addSample(_receiveTimer.nsecsElapsed() - entry->receiveTimeNSecs);
+
+        queue->popFront();
+    }
+
+    qint64 now = _receiveTimer.nsecsElapsed();
+    if (now - _receiveLatencyLogNSecs > _receiveLatencyLogIntervalNSecs) {
+        _receiveLatencyLogNSecs = now;
+        qCDebug(MAVLinkProtocolLog) << "Receive latency" << _receiveLatencyHistogram.toString() << "dropped" << queue->droppedCount();
+    }
+}
+
+/// @return The mavlink forwarding link if forwarding is enabled, nullptr otherwise
+SharedLinkInterfacePointer MAVLinkProtocol::_forwardingLink(void)
+{
+    if (_app->toolbox()->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool()) {
+        return _linkMgr->mavlinkForwardingLink();
+    }
+    return nullptr;
+}
+
+/// Called for bytes which did not yet produce a message on a link which has not decoded a MAVLink packet yet
+///     @return false: link was disconnected since it contained no MAVLink data
+bool MAVLinkProtocol::_nonMavlinkBytesReceived(LinkInterface* link, int byteCount)
+{
     static int  nonmavlinkCount = 0;
     static bool checkedUserNonMavlink = false;
     static bool warnedUserNonMavlink  = false;
 
-    for (int position = 0; position < b.size(); position++) {
-        if (mavlink_parse_char(mavlinkChannel, static_cast<uint8_t>(b[position]), &_message, &_status)) {
-            // Got a valid message
-            if (!link->decodedFirstMavlinkPacket()) {
-                link->setDecodedFirstMavlinkPacket(true);
-                mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-                if (!(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) && (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
-                    qDebug() << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
-                    mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-                    // Set all links to v2
-                    setVersion(200);
-                }
-            }
+    nonmavlinkCount += byteCount;
+    if (nonmavlinkCount > 1000 && !warnedUserNonMavlink) {
+        // 1000 bytes with no mavlink message. Are we connected to a mavlink capable device?
+        if (!checkedUserNonMavlink) {
+            link->requestReset();
+            checkedUserNonMavlink = true;
+        } else {
+            warnedUserNonMavlink = true;
+            // Disconnect the link since it's some other device and
+            // QGC clinging on to it and feeding it data might have unintended
+            // side effects (e.g. if its a modem)
+            qDebug() << "disconnected link" << link->getName() << "as it contained no MAVLink data";
+            QMetaObject::invokeMethod(_linkMgr, "disconnectLink", Q_ARG( LinkInterface*, link ) );
+            return false;
+        }
+    }
+    return true;
+}
 
-            //-----------------------------------------------------------------
-            // MAVLink Status
-            uint8_t lastSeq = lastIndex[_message.sysid][_message.compid];
-            uint8_t expectedSeq = lastSeq + 1;
-            // Increase receive counter
-            totalReceiveCounter[mavlinkChannel]++;
-            // Determine what the next expected sequence number is, accounting for
-            // never having seen a message for this system/component pair.
-            if(firstMessage[_message.sysid][_message.compid]) {
-                firstMessage[_message.sysid][_message.compid] = 0;
-                lastSeq     = _message.seq;
-                expectedSeq = _message.seq;
-            }
-            // And if we didn't encounter that sequence number, record the error
-            //int foo = 0;
-            if (_message.seq != expectedSeq)
-            {
-                //foo = 1;
-                int lostMessages = 0;
-                //-- Account for overflow during packet loss
-                if(_message.seq < expectedSeq) {
-                    lostMessages = (_message.seq + 255) - expectedSeq;
-                } else {
-                    lostMessages = _message.seq - expectedSeq;
-                }
-                // Log how many were lost
-                totalLossCounter[mavlinkChannel] += static_cast<uint64_t>(lostMessages);
-            }
+/// Status tracking, forwarding, logging and signalling for a single fully parsed message
+void MAVLinkProtocol::_handleMessage(LinkInterface* link, const mavlink_message_t& message, LinkInterface* forwardingLink)
+{
+    uint8_t mavlinkChannel = link->mavlinkChannel();
 
-            // And update the last sequence number for this system/component pair
-            lastIndex[_message.sysid][_message.compid] = _message.seq;;
-            // Calculate new loss ratio
-            uint64_t totalSent = totalReceiveCounter[mavlinkChannel] + totalLossCounter[mavlinkChannel];
-            float receiveLossPercent = static_cast<float>(static_cast<double>(totalLossCounter[mavlinkChannel]) / static_cast<double>(totalSent));
-            receiveLossPercent *= 100.0f;
-            receiveLossPercent = (receiveLossPercent * 0.5f) + (runningLossPercent[mavlinkChannel] * 0.5f);
-            runningLossPercent[mavlinkChannel] = receiveLossPercent;
-
-            //qDebug() << foo << _message.seq << expectedSeq << lastSeq << totalLossCounter[mavlinkChannel] << totalReceiveCounter[mavlinkChannel] << totalSentCounter[mavlinkChannel] << "(" << _message.sysid << _message.compid << ")";
-
-            //-----------------------------------------------------------------
-            // MAVLink forwarding
-            bool forwardingEnabled = _app->toolbox()->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool();
-            if (forwardingEnabled) {
-                SharedLinkInterfacePointer forwardingLink = _linkMgr->mavlinkForwardingLink();
-
-                if (forwardingLink) {
-                    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-                    int len = mavlink_msg_to_send_buffer(buf, &_message);
-                    forwardingLink->writeBytesThreadSafe((const char*)buf, len);
-                }
-            }
+    if (!link->decodedFirstMavlinkPacket()) {
+        link->setDecodedFirstMavlinkPacket(true);
+        mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+        if (!(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) && (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
+            qDebug() << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
+            mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+            // Set all links to v2
+            setVersion(200);
+        }
+    }
 
-            //-----------------------------------------------------------------
-            // Log data
-            if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
-                uint8_t buf[MAVLINK_MAX_PACKET_LEN+sizeof(quint64)];
-
-                // Write the uint64 time in microseconds in big endian format before the message.
-                // This timestamp is saved in UTC time. We are only saving in ms precision because
-                // getting more than this isn't possible with Qt without a ton of extra code.
-                quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-                qToBigEndian(time, buf);
-
-                // Then write the message to the buffer
-                int len = mavlink_msg_to_send_buffer(buf + sizeof(quint64), &_message);
-
-                // Determine how many bytes were written by adding the timestamp size to the message size
-                len += sizeof(quint64);
-
-                // Now write this timestamp/message pair to the log.
-                QByteArray b(reinterpret_cast<const char*>(buf), len);
-                if(_tempLogFile.write(b) != len)
-                {
-                    // If there's an error logging data, raise an alert and stop logging.
-                    emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
-                    _stopLogging();
-                    _logSuspendError = true;
-                }
-
-                // Check for the vehicle arming going by. This is used to trigger log save.
-                if (!_vehicleWasArmed && _message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                    mavlink_heartbeat_t state;
-                    mavlink_msg_heartbeat_decode(&_message, &state);
-                    if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
-                        _vehicleWasArmed = true;
-                    }
-                }
-            }
+    //-----------------------------------------------------------------
+    // MAVLink Status
+    uint8_t lastSeq = lastIndex[message.sysid][message.compid];
+    uint8_t expectedSeq = lastSeq + 1;
+    // Increase receive counter
+    totalReceiveCounter[mavlinkChannel]++;
+    // Determine what the next expected sequence number is, accounting for
+    // never having seen a message for this system/component pair.
+    if(firstMessage[message.sysid][message.compid]) {
+        firstMessage[message.sysid][message.compid] = 0;
+        lastSeq     = message.seq;
+        expectedSeq = message.seq;
+    }
+    // And if we didn't encounter that sequence number, record the error
+    if (message.seq != expectedSeq)
+    {
+        int lostMessages = 0;
+        //-- Account for overflow during packet loss
+        if(message.seq < expectedSeq) {
+            lostMessages = (message.seq + 255) - expectedSeq;
+        } else {
+            lostMessages = message.seq - expectedSeq;
+        }
+        // Log how many were lost
+        totalLossCounter[mavlinkChannel] += static_cast<uint64_t>(lostMessages);
+    }
 
-            if (_message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                _startLogging();
-                mavlink_heartbeat_t heartbeat;
-                mavlink_msg_heartbeat_decode(&_message, &heartbeat);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, heartbeat.autopilot, heartbeat.type);
-            }
+    // And update the last sequence number for this system/component pair
+    lastIndex[message.sysid][message.compid] = message.seq;
+    // Calculate new loss ratio
+    uint64_t totalSent = totalReceiveCounter[mavlinkChannel] + totalLossCounter[mavlinkChannel];
+    float receiveLossPercent = static_cast<float>(static_cast<double>(totalLossCounter[mavlinkChannel]) / static_cast<double>(totalSent));
+    receiveLossPercent *= 100.0f;
+    receiveLossPercent = (receiveLossPercent * 0.5f) + (runningLossPercent[mavlinkChannel] * 0.5f);
+    runningLossPercent[mavlinkChannel] = receiveLossPercent;
+
+    //-----------------------------------------------------------------
+    // MAVLink forwarding
+    if (forwardingLink) {
+        uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+        int len = mavlink_msg_to_send_buffer(buf, &message);
+        forwardingLink->writeBytesThreadSafe((const char*)buf, len);
+    }
+
+    //-----------------------------------------------------------------
+    // Log data
+    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
+        uint8_t buf[MAVLINK_MAX_PACKET_LEN+sizeof(quint64)];
 
-            if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-                _startLogging();
-                mavlink_high_latency2_t highLatency2;
-                mavlink_msg_high_latency2_decode(&_message, &highLatency2);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, highLatency2.autopilot, highLatency2.type);
+        // Write the uint64 time in microseconds in big endian format before the message.
+        // This timestamp is saved in UTC time. We are only saving in ms precision because
+        // getting more than this isn't possible with Qt without a ton of extra code.
+        quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
+        qToBigEndian(time, buf);
+
+        // Then write the message to the buffer
+        int len = mavlink_msg_to_send_buffer(buf + sizeof(quint64), &message);
+
+        // Determine how many bytes were written by adding the timestamp size to the message size
+        len += sizeof(quint64);
+
+        // Now write this timestamp/message pair to the log.
+        QByteArray b(reinterpret_cast<const char*>(buf), len);
+        if(_tempLogFile.write(b) != len)
+        {
+            // If there's an error logging data, raise an alert and stop logging.
+            emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
+            _stopLogging();
+            _logSuspendError = true;
+        }
+
+        // Check for the vehicle arming going by. This is used to trigger log save.
+        if (!_vehicleWasArmed && message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+            mavlink_heartbeat_t state;
+            mavlink_msg_heartbeat_decode(&message, &state);
+            if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
+                _vehicleWasArmed = true;
             }
+        }
+    }
+
+    if (message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+        _startLogging();
+        mavlink_heartbeat_t heartbeat;
+        mavlink_msg_heartbeat_decode(&message, &heartbeat);
+        emit vehicleHeartbeatInfo(link, message.sysid, message.compid, heartbeat.autopilot, heartbeat.type);
+    }
+
+    if (message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
+        _startLogging();
+        mavlink_high_latency2_t highLatency2;
+        mavlink_msg_high_latency2_decode(&message, &highLatency2);
+        emit vehicleHeartbeatInfo(link, message.sysid, message.compid, highLatency2.autopilot, highLatency2.type);
+    }
 
 #if 0
-            // Given the current state of SiK Radio firmwares there is no way to make the code below work.
-            // The ArduPilot implementation of SiK Radio firmware always sends MAVLINK_MSG_ID_RADIO_STATUS as a mavlink 1
-            // packet even if the vehicle is sending Mavlink 2.
-
-            // Detect if we are talking to an old radio not supporting v2
-            mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-            if (_message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _radio_version_mismatch_count != -1) {
-                if ((mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
-                && !(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
-                    _radio_version_mismatch_count++;
-                }
-            }
+    // Given the current state of SiK Radio firmwares there is no way to make the code below work.
+    // The ArduPilot implementation of SiK Radio firmware always sends MAVLINK_MSG_ID_RADIO_STATUS as a mavlink 1
+    // packet even if the vehicle is sending Mavlink 2.
+
+    // Detect if we are talking to an old radio not supporting v2
+    mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+    if (message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _radio_version_mismatch_count != -1) {
+        if ((mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
+        && !(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
+            _radio_version_mismatch_count++;
+        }
+    }
 
-            if (_radio_version_mismatch_count == 5) {
-                // Warn the user if the radio continues to send v1 while the link uses v2
-                emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Detected radio still using MAVLink v1.0 on a link with MAVLink v2.0 enabled. Please upgrade the radio firmware."));
-                // Set to flag warning already shown
-                _radio_version_mismatch_count = -1;
-                // Flick link back to v1
-                qDebug() << "Switching outbound to mavlink 1.0 due to incoming mavlink 1.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
-                mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-            }
+    if (_radio_version_mismatch_count == 5) {
+        // Warn the user if the radio continues to send v1 while the link uses v2
+        emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Detected radio still using MAVLink v1.0 on a link with MAVLink v2.0 enabled. Please upgrade the radio firmware."));
+        // Set to flag warning already shown
+        _radio_version_mismatch_count = -1;
+        // Flick link back to v1
+        qDebug() << "Switching outbound to mavlink 1.0 due to incoming mavlink 1.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
+        mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    }
 #endif
 
-            // Update MAVLink status on every 32th packet
-            if ((totalReceiveCounter[mavlinkChannel] & 0x1F) == 0) {
-                emit mavlinkMessageStatus(_message.sysid, totalSent, totalReceiveCounter[mavlinkChannel], totalLossCounter[mavlinkChannel], receiveLossPercent);
-            }
+    // Update MAVLink status on every 32th packet
+    if ((totalReceiveCounter[mavlinkChannel] & 0x1F) == 0) {
+        emit mavlinkMessageStatus(message.sysid, totalSent, totalReceiveCounter[mavlinkChannel], totalLossCounter[mavlinkChannel], receiveLossPercent);
+    }
 
-            // The packet is emitted as a whole, as it is only 255 - 261 bytes short
-            // kind of inefficient, but no issue for a groundstation pc.
-            // It buys as reentrancy for the whole code over all threads
-            emit messageReceived(link, _message);
-            // Reset message parsing
-            memset(&_status,  0, sizeof(_status));
-            memset(&_message, 0, sizeof(_message));
-        } else if (!link->decodedFirstMavlinkPacket()) {
-            // No formed message yet
-            nonmavlinkCount++;
-            if (nonmavlinkCount > 1000 && !warnedUserNonMavlink) {
-                // 1000 bytes with no mavlink message. Are we connected to a mavlink capable device?
-                if (!checkedUserNonMavlink) {
-                    link->requestReset();
-                    checkedUserNonMavlink = true;
-                } else {
-                    warnedUserNonMavlink = true;
-                    // Disconnect the link since it's some other device and
-                    // QGC clinging on to it and feeding it data might have unintended
-                    // side effects (e.g. if its a modem)
-                    qDebug() << "disconnected link" << link->getName() << "as it contained no MAVLink data";
-                    QMetaObject::invokeMethod(_linkMgr, "disconnectLink", Q_ARG( LinkInterface*, link ) );
-                    return;
-                }
-            }
-        }
+    _messageDispatcher.dispatch(link, message);
+
+    // The packet is emitted as a whole, as it is only 255 - 261 bytes short
+    // kind of inefficient, but no issue for a groundstation pc.
+    // It buys as reentrancy for the whole code over all threads
+    static const QMetaMethod messageReceivedSignal = QMetaMethod::fromSignal(&MAVLinkProtocol::messageReceived);
+    if (isSignalConnected(messageReceivedSignal)) {
+        emit messageReceived(link, message);
     }
 }
 
@@ -16,9 +16,13 @@
 #include <QFile>
 #include <QMap>
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 
 #include "LinkInterface.h"
+#include "MAVLinkBlockParser.h"
+#include "MAVLinkMessageDispatcher.h"
+#include "MAVLinkReceiveQueue.h"
 #include "QGCMAVLink.h"
 #include "QGC.h"
 #include "QGCTemporaryFile.h"
@@ -77,6 +81,23 @@ public:
     // Override from QGCTool
     virtual void setToolbox(QGCToolbox *toolbox);
 
+    /// Registry used to route received messages only to the handlers which want them. Preferred over connecting
+    /// to messageReceived, which is only emitted while something is connected to it.
+    MAVLinkMessageDispatcher* messageDispatcher(void) { return &_messageDispatcher; }
+
+    /// Sets up the receive queue for a link which parses on its own thread. Must be called on the main thread
+    /// before the link is connected. The queue and parser state are owned by the link.
+    void setupThreadedParsing(LinkInterface* link);
+
+    /// Parses bytes on the calling link thread and queues the decoded messages for dispatch on the main thread.
+    /// Only used for links set up through setupThreadedParsing, connected to bytesReceived using Qt::DirectConnection.
+    /// Only parsing moves off the main thread, messageReceived and the dispatcher handlers are still called on the
+    /// main thread since they update Vehicle and Fact objects which live there.
+    void receiveBytesOnLinkThread(LinkInterface* link, QByteArray b);
+
+    /// @return Time from parsing on a link thread to the messageReceived handlers having completed, for all links using threaded parsing
+    const MAVLinkLatencyHistogram& receiveLatencyHistogram(void) const { return _receiveLatencyHistogram; }
+
 public slots:
     /** @brief Receive bytes from a communication interface */
     void receiveBytes(LinkInterface* link, QByteArray b);
@@ -121,7 +142,7 @@ signals:
     /// Heartbeat received on link
     void vehicleHeartbeatInfo(LinkInterface* link, int vehicleId, int componentId, int vehicleFirmwareType, int vehicleType);
 
-    /** @brief Message received and directly copied via signal */
+    /** @brief Message received and directly copied via signal. Use messageDispatcher() instead unless all messages are needed. */
     void messageReceived(LinkInterface* link, mavlink_message_t message);
     /** @brief Emitted if version check is enabled / disabled */
     void versionCheckChanged(bool enabled);
@@ -152,10 +173,19 @@ signals:
     /// Emitted when a telemetry log is started to save.
     void checkTelemetrySavePath(void);
 
+    /// Signalled from a link thread when messages are waiting in the link's receive queue
+    void _receiveQueueReady(LinkInterface* link);
+
 private slots:
     void _vehicleCountChanged(void);
+    void _drainReceiveQueue(LinkInterface* link);
     
 private:
+    void                        _receiveBytesBlock          (LinkInterface* link, const QByteArray& b);
+    void                        _handleMessage              (LinkInterface* link, const mavlink_message_t& message, LinkInterface* forwardingLink);
+    bool                        _nonMavlinkBytesReceived    (LinkInterface* link, int byteCount);
+    SharedLinkInterfacePointer  _forwardingLink             (void);
+
     bool _closeLogFile(void);
     void _startLogging(void);
     void _stopLogging(void);
@@ -170,5 +200,20 @@ private:
 
     LinkManager*            _linkMgr;
     MultiVehicleManager*    _multiVehicleManager;
+
+    MAVLinkMessageDispatcher    _messageDispatcher;
+
+    MAVLinkBlockParser  _blockParsers[MAVLINK_COMM_NUM_BUFFERS];   ///< Per channel parser state for links using block parsing on the main thread
+
+    static const int    _blockMessagesReserve = 32;                 ///< Initial message capacity for a single parsed block
+
+    QElapsedTimer           _receiveTimer;                                  ///< Shared time base for receive latency across threads
+    MAVLinkLatencyHistogram _receiveLatencyHistogram;
+    qint64                  _receiveLatencyLogNSecs;                        ///< Time the latency histogram was last logged
+    qint64                  _receiveDropLogNSecs;                           ///< Time receive queue drops were last logged
+
+    static const int    _receiveQueueCapacity =     4096;               ///< Messages, ~1 second of a busy link
+    static const qint64 _receiveLatencyLogIntervalNSecs = 10000000000LL; ///< Log latency histogram every 10 seconds
+    static const qint64 _receiveDropLogIntervalNSecs =     1000000000LL; ///< Log receive queue drops at most once a second
 };
 
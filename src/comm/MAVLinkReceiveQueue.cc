@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkReceiveQueue.h"
+
+#include <string.h>
+
+MAVLinkReceiveQueue::MAVLinkReceiveQueue(int capacity)
+    : _head         (0)
+    , _tail         (0)
+    , _drainPending (false)
+    , _droppedCount (0)
+{
+    uint32_t size = 1;
+    while (size < static_cast<uint32_t>(capacity)) {
+        size <<= 1;
+    }
+    _entries.resize(static_cast<int>(size));
+    _mask = size - 1;
+}
+
+bool MAVLinkReceiveQueue::push(const mavlink_message_t& message, qint64 receiveTimeNSecs)
+{
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) > _mask) {
+        _droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Entry_t& entry = _entries[static_cast<int>(tail & _mask)];
+    entry.message           = message;
+    entry.receiveTimeNSecs  = receiveTimeNSecs;
+
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+const MAVLinkReceiveQueue::Entry_t* MAVLinkReceiveQueue::front(void) const
+{
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &_entries[static_cast<int>(head & _mask)];
+}
+
+void MAVLinkReceiveQueue::popFront(void)
+{
+    _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+MAVLinkLatencyHistogram::MAVLinkLatencyHistogram(void)
+{
+    reset();
+}
+
+void MAVLinkLatencyHistogram::reset(void)
+{
+    memset(_buckets, 0, sizeof(_buckets));
+    _sampleCount    = 0;
+    _maxNSecs       = 0;
+}
+
+void MAVLinkLatencyHistogram::addSample(qint64 latencyNSecs)
+{
+    qint64  usecs   = latencyNSecs / 1000;
+    int     bucket  = 0;
+    while (bucket < bucketCount - 1 && usecs >= (Q_INT64_C(1) << bucket)) {
+        bucket++;
+    }
+    _buckets[bucket]++;
+    _sampleCount++;
+    _maxNSecs = qMax(_maxNSecs, latencyNSecs);
+}
+
+qint64 MAVLinkLatencyHistogram::percentileUSecs(double percent) const
+{
+    quint64 threshold   = static_cast<quint64>(_sampleCount * percent / 100.0);
+    quint64 count       = 0;
+    for (int i=0; i<bucketCount; i++) {
+        count += _buckets[i];
+        if (count >= threshold && count != 0) {
+            return i == bucketCount - 1 ? _maxNSecs / 1000 : (Q_INT64_C(1) << i);
+        }
+    }
+    return 0;
+}
+
+QString MAVLinkLatencyHistogram::toString(void) const
+{
+    QString result = QStringLiteral("samples:%1 p50:<%2us p90:<%3us p99:<%4us max:%5us buckets:")
+            .arg(_sampleCount)
+            .arg(percentileUSecs(50))
+            .arg(percentileUSecs(90))
+            .arg(percentileUSecs(99))
+            .arg(_maxNSecs / 1000);
+    for (int i=0; i<bucketCount; i++) {
+        result += QStringLiteral(" %1").arg(_buckets[i]);
+    }
+    return result;
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QVector>
+#include <QString>
+
+#include <atomic>
+
+#include "QGCMAVLink.h"
+
+/// Lock-free single producer/single consumer queue of decoded MAVLink messages.
+///
+/// Used by links which parse on their own thread: the link thread is the only producer, the main thread
+/// which dispatches the messages is the only consumer. Messages which do not fit are dropped and counted.
+class MAVLinkReceiveQueue
+{
+public:
+    typedef struct {
+        mavlink_message_t   message;
+        qint64              receiveTimeNSecs;   ///< MAVLinkProtocol::elapsedNSecs at the time the bytes were parsed
+    } Entry_t;
+
+    /// @param capacity Maximum number of queued messages, rounded up to a power of two
+    MAVLinkReceiveQueue(int capacity);
+
+    // Producer side
+
+    /// @return false: queue full, message dropped
+    bool push(const mavlink_message_t& message, qint64 receiveTimeNSecs);
+
+    /// Should be called after pushing a set of messages.
+    ///     @return true: caller must schedule a drain of the queue, false: a drain is already pending
+    bool requestDrain(void) { return !_drainPending.exchange(true, std::memory_order_acq_rel); }
+
+    // Consumer side
+
+    /// Must be called before draining so that messages pushed during the drain schedule a new one
+    void drainStarted(void) { _drainPending.store(false, std::memory_order_release); }
+
+    /// @return Oldest entry in the queue, nullptr if empty. Stays valid until popFront is called.
+    const Entry_t* front(void) const;
+    void popFront(void);
+
+    uint32_t droppedCount(void) const { return _droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    QVector<Entry_t>        _entries;
+    uint32_t                _mask;
+    std::atomic<uint32_t>   _head;          ///< Next entry to read, only written by consumer
+    std::atomic<uint32_t>   _tail;          ///< Next entry to write, only written by producer
+    std::atomic<bool>       _drainPending;
+    std::atomic<uint32_t>   _droppedCount;
+};
+
+/// Histogram of message receive to Fact update latency using power of two microsecond buckets.
+class MAVLinkLatencyHistogram
+{
+public:
+    MAVLinkLatencyHistogram(void);
+
+    void        addSample   (qint64 latencyNSecs);
+    void        reset       (void);
+    quint64     sampleCount (void) const { return _sampleCount; }
+    qint64      maxNSecs    (void) const { return _maxNSecs; }
+
+    /// @return Approximate latency in usecs below which the specified percentage of samples fall
+    qint64      percentileUSecs(double percent) const;
+
+    QString     toString    (void) const;
+
+    static const int bucketCount = 22;      ///< Bucket i holds samples < 2^i usecs, last bucket holds everything above
+
+private:
+    quint64 _buckets[bucketCount];
+    quint64 _sampleCount;
+    qint64  _maxNSecs;
+};
@@ -405,7 +405,27 @@ void MockLink::respondWithMavlinkMessage(const mavlink_message_t& msg)
 
     int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
     QByteArray bytes((char *)buffer, cBuffer);
-    emit bytesReceived(this, bytes);
+
+    if (_simulatedLoss()) {
+        return;
+    }
+    if (_simulatedLatencyMSecs > 0) {
+        QTimer::singleShot(_simulatedLatencyMSecs, this, [this, bytes]() { emit bytesReceived(this, bytes); });
+    } else {
+        emit bytesReceived(this, bytes);
+    }
+}
+
+void MockLink::setLinkSimulation(int latencyMSecs, int lossPercent)
+{
+    _simulatedLatencyMSecs  = latencyMSecs;
+    _simulatedLossPercent   = lossPercent;
+    _simulatedLossRandom.seed(1);
+}
+
+bool MockLink::_simulatedLoss(void)
+{
+    return _simulatedLossPercent > 0 && static_cast<int>(_simulatedLossRandom.bounded(100)) < _simulatedLossPercent;
 }
 
 /// @brief Called when QGC wants to write bytes to the MAV
@@ -425,7 +445,14 @@ void MockLink::_writeBytesQueued(const QByteArray bytes)
             _handleIncomingNSHBytes(&bytes.constData()[3], bytes.count() - 3);
         }
 
-        _handleIncomingMavlinkBytes((uint8_t *)bytes.constData(), bytes.count());
+        if (_simulatedLoss()) {
+            return;
+        }
+        if (_simulatedLatencyMSecs > 0) {
+            QTimer::singleShot(_simulatedLatencyMSecs, this, [this, bytes]() { _handleIncomingMavlinkBytes((uint8_t *)bytes.constData(), bytes.count()); });
+        } else {
+            _handleIncomingMavlinkBytes((uint8_t *)bytes.constData(), bytes.count());
+        }
     }
 }
 
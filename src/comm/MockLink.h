@@ -11,6 +11,7 @@
 #pragma once
 
 #include <QElapsedTimer>
+#include <QRandomGenerator>
 #include <QMap>
 #include <QLoggingCategory>
 #include <QGeoCoordinate>
@@ -151,6 +152,14 @@ public:
     /// Reset the state of the MissionItemHandler to no items, no transactions in progress.
     void resetMissionItemHandler(void) { _missionItemHandler.reset(); }
 
+    /// Makes the simulated vehicle tolerate windowed mission transfers, see PlanManager::setTransferWindow
+    void setMissionTransferWindow(int transferWindow) { _missionItemHandler.setTransferWindow(transferWindow); }
+
+    /// Simulates a slow lossy telemetry radio. Messages in both directions are delayed by latencyMSecs and dropped
+    /// with a lossPercent chance. Drops are repeatable from run to run.
+    void setLinkSimulation(int latencyMSecs, int lossPercent);
+    int  simulatedLossPercent(void) const { return _simulatedLossPercent; }
+
     /// Returns the filename for the simulated log file. Only available after a download is requested.
     QString logDownloadFile(void) { return _logDownloadFilename; }
 
@@ -195,6 +204,7 @@ private:
     // From LinkInterface
     bool _connect(void) final;
     void _disconnect(void) final;
+    int  _writeBatchBytes(void) const final { return 0; }   ///< Keeps write boundaries for NSH detection and per message loss simulation
 
     // QThread override
     void run(void) final;
@@ -234,6 +244,7 @@ private:
     void _moveADSBVehicle               (void);
     void _sendVersionMetaData           (void);
     void _sendParameterMetaData         (void);
+    bool _simulatedLoss                 (void);
 
     static MockLink* _startMockLinkWorker(QString configName, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType, bool sendStatusText, MockConfiguration::FailureMode_t failureMode);
     static MockLink* _startMockLink(MockConfiguration* mockConfig);
@@ -290,6 +301,10 @@ private:
 
     RequestMessageFailureMode_t _requestMessageFailureMode = FailRequestMessageNone;
 
+    int                 _simulatedLatencyMSecs =    0;
+    int                 _simulatedLossPercent =     0;
+    QRandomGenerator    _simulatedLossRandom;
+
     static double       _defaultVehicleLatitude;
     static double       _defaultVehicleLongitude;
     static double       _defaultVehicleAltitude;
@@ -10,6 +10,7 @@
 
 #include "MockLinkFTP.h"
 #include "MockLink.h"
+#include "QGC.h"
 
 const MockLinkFTP::ErrorMode_t MockLinkFTP::rgFailureModes[] = {
     MockLinkFTP::errModeNoResponse,
@@ -97,6 +98,22 @@ void MockLinkFTP::_listCommand(uint8_t senderSystemId, uint8_t senderComponentId
     }
 }
 
+QString MockLinkFTP::_filenameForPath(const QString& path)
+{
+    QString sizePrefix = sizeFilenamePrefix;
+    if (path.startsWith(sizePrefix)) {
+        QString sizeString = path.right(path.length() - sizePrefix.length());
+        return _createTestTempFile(sizeString.toInt());
+    } else if (path == "/version.json") {
+        return ":MockLink/Version.MetaData.json";
+    } else if (path == "/version.json.gz") {
+        return ":MockLink/Version.MetaData.json.gz";
+    } else if (path == "/parameter.json") {
+        return ":MockLink/Parameter.MetaData.json";
+    }
+    return QString();
+}
+
 void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
 {
     MavlinkFTP::Request response;
@@ -111,38 +128,38 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
     Q_UNUSED(cchPath); // Fix initialized-but-not-referenced warning on release builds
     path = (char *)request->data;
 
-    _currentFile.close();
-
-    QString sizePrefix = sizeFilenamePrefix;
-    if (path.startsWith(sizePrefix)) {
-        QString sizeString = path.right(path.length() - sizePrefix.length());
-        tmpFilename = _createTestTempFile(sizeString.toInt());
-    } else if (path == "/version.json") {
-        tmpFilename = ":MockLink/Version.MetaData.json";
-    } else if (path == "/version.json.gz") {
-        tmpFilename = ":MockLink/Version.MetaData.json.gz";
-    } else if (path == "/parameter.json") {
-        tmpFilename = ":MockLink/Parameter.MetaData.json";
+    if (_sessions.count() >= _maxSessions) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrNoSessionsAvailable, outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+        return;
     }
 
-    if (!tmpFilename.isEmpty()) {
-        _currentFile.setFileName(tmpFilename);
-        if (!_currentFile.open(QIODevice::ReadOnly)) {
-            _sendNakErrno(senderSystemId, senderComponentId, _currentFile.error(), outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
-            return;
-        }
-    } else {
+    tmpFilename = _filenameForPath(path);
+    if (tmpFilename.isEmpty()) {
         _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFailFileNotFound, outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
         return;
     }
+
+    QFile* file = new QFile(tmpFilename, this);
+    if (!file->open(QIODevice::ReadOnly)) {
+        _sendNakErrno(senderSystemId, senderComponentId, file->error(), outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+        delete file;
+        return;
+    }
+
+    // Lowest free session id, like PX4 the first one is 0
+    uint8_t session = 0;
+    while (_sessions.contains(session)) {
+        session++;
+    }
+    _sessions[session] = file;
     
     response.hdr.opcode     = MavlinkFTP::kRspAck;
     response.hdr.req_opcode = MavlinkFTP::kCmdOpenFileRO;
-    response.hdr.session    = _sessionId;
+    response.hdr.session    = session;
     
     // Data contains file length
     response.hdr.size = sizeof(uint32_t);
-    response.openFileLength = _currentFile.size();
+    response.openFileLength = file->size();
     
     _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
 }
@@ -151,9 +168,11 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
 {
     MavlinkFTP::Request	response;
     uint16_t			outgoingSeqNumber = _nextSeqNumber(seqNumber);
+    uint8_t             session = request->hdr.session;
+    QFile*              file = _sessions.value(session, nullptr);
 
-    if (request->hdr.session != _sessionId) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
+    if (!file) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdReadFile, session);
         return;
     }
     
@@ -163,7 +182,7 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
         // If we get here it means the client is requesting additional data past the first request
         if (_errMode == errModeNakSecondResponse) {
             // Nak error all subsequent requests
-            _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
+            _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdReadFile, session);
             return;
         } else if (_errMode == errModeNoSecondResponse) {
             // No rsponse for all subsequent requests
@@ -171,20 +190,20 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
         }
     }
     
-    if (readOffset >= _currentFile.size()) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
+    if (readOffset >= file->size()) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdReadFile, session);
         return;
     }
     
-    uint8_t cBytesToRead = (uint8_t)qMin((qint64)sizeof(response.data), _currentFile.size() - readOffset);
-    _currentFile.seek(readOffset);
-    QByteArray bytes = _currentFile.read(cBytesToRead);
+    uint8_t cBytesToRead = (uint8_t)qMin((qint64)sizeof(response.data), file->size() - readOffset);
+    file->seek(readOffset);
+    QByteArray bytes = file->read(cBytesToRead);
     memcpy(response.data, bytes.constData(), cBytesToRead);
     
     // We should always have written something, otherwise there is something wrong with the code above
     Q_ASSERT(cBytesToRead);
     
-    response.hdr.session    = _sessionId;
+    response.hdr.session    = session;
     response.hdr.size       = cBytesToRead;
     response.hdr.offset     = request->hdr.offset;
     response.hdr.opcode     = MavlinkFTP::kRspAck;
@@ -197,9 +216,11 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
 {
     uint16_t            outgoingSeqNumber = _nextSeqNumber(seqNumber);
     MavlinkFTP::Request response;
+    uint8_t             session = request->hdr.session;
+    QFile*              file = _sessions.value(session, nullptr);
 
-    if (request->hdr.session != _sessionId) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile);
+    if (!file) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile, session);
         return;
     }
     
@@ -207,18 +228,18 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
     int         burstCount  = 1;
     uint32_t    burstOffset = request->hdr.offset;
     
-    while (burstOffset < _currentFile.size() && burstCount++ < burstMax) {
-        _currentFile.seek(burstOffset);
+    while (burstOffset < file->size() && burstCount++ < burstMax) {
+        file->seek(burstOffset);
 
-        uint8_t     cBytes  = (uint8_t)qMin((qint64)sizeof(response.data), _currentFile.size() - burstOffset);
-        QByteArray  bytes   = _currentFile.read(cBytes);
+        uint8_t     cBytes  = (uint8_t)qMin((qint64)sizeof(response.data), file->size() - burstOffset);
+        QByteArray  bytes   = file->read(cBytes);
 
         // We should always have written something, otherwise there is something wrong with the code above
         Q_ASSERT(cBytes);
 
         memcpy(response.data, bytes.constData(), cBytes);
 
-        response.hdr.session        = _sessionId;
+        response.hdr.session        = session;
         response.hdr.size           = cBytes;
         response.hdr.offset         = burstOffset;
         response.hdr.opcode         = MavlinkFTP::kRspAck;
@@ -231,18 +252,22 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
         burstOffset += cBytes;
     }
 
-    _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile);
+    if (burstOffset >= file->size()) {
+        // Like a vehicle, only signal EOF once the burst has reached the end of the file
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile, session);
+    }
 }
 
 void MockLinkFTP::_terminateCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
 {
     uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    if (request->hdr.session != _sessionId) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
+    if (!_sessions.contains(request->hdr.session)) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession, request->hdr.session);
         return;
     }
-    
+
+    _closeSession(request->hdr.session);
     _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
 
     emit terminateCommandReceived();
@@ -252,13 +277,61 @@ void MockLinkFTP::_resetCommand(uint8_t senderSystemId, uint8_t senderComponentI
 {
     uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
     
-    _currentFile.close();
-    _currentFile.remove();
+    while (_sessions.count()) {
+        _closeSession(_sessions.firstKey());
+    }
     _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdResetSessions);
     
     emit resetCommandReceived();
 }
 
+void MockLinkFTP::_closeSession(uint8_t session)
+{
+    QFile* file = _sessions.take(session);
+
+    if (file) {
+        // Removes the size based temp files, resource files are left alone
+        file->close();
+        file->remove();
+        delete file;
+    }
+}
+
+void MockLinkFTP::_calcFileCRC32Command(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
+{
+    MavlinkFTP::Request response;
+    uint16_t            outgoingSeqNumber = _nextSeqNumber(seqNumber);
+
+    ensureNullTemination(request);
+
+    QString path        = (char *)request->data;
+    QString filename    = _filenameForPath(path);
+    if (filename.isEmpty()) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFailFileNotFound, outgoingSeqNumber, MavlinkFTP::kCmdCalcFileCRC32);
+        return;
+    }
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        _sendNakErrno(senderSystemId, senderComponentId, file.error(), outgoingSeqNumber, MavlinkFTP::kCmdCalcFileCRC32);
+        return;
+    }
+    QByteArray  bytes   = file.readAll();
+    uint32_t    crc32   = QGC::crc32(reinterpret_cast<const quint8*>(bytes.constData()), bytes.size(), 0);
+    file.close();
+    if (path.startsWith(sizeFilenamePrefix)) {
+        file.remove();
+    }
+
+    response.hdr.opcode     = MavlinkFTP::kRspAck;
+    response.hdr.req_opcode = MavlinkFTP::kCmdCalcFileCRC32;
+    response.hdr.session    = 0;
+    response.hdr.size       = sizeof(uint32_t);
+    memcpy(response.data, &crc32, sizeof(crc32));
+
+    _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
+}
+
 void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t& message)
 {
     if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
@@ -338,6 +411,10 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t& message)
         _resetCommand(message.sysid, message.compid, incomingSeqNumber);
         break;
 
+    case MavlinkFTP::kCmdCalcFileCRC32:
+        _calcFileCRC32Command(message.sysid, message.compid, request, incomingSeqNumber);
+        break;
+
     default:
         // nack for all NYI opcodes
         _sendNak(message.sysid, message.compid, MavlinkFTP::kErrUnknownCommand, outgoingSeqNumber, (MavlinkFTP::OpCode_t)request->hdr.opcode);
@@ -358,13 +435,13 @@ void MockLinkFTP::_sendAck(uint8_t targetSystemId, uint8_t targetComponentId, ui
     _sendResponse(targetSystemId, targetComponentId, &ackResponse, seqNumber);
 }
 
-void MockLinkFTP::_sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode)
+void MockLinkFTP::_sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode, uint8_t session)
 {
     MavlinkFTP::Request nakResponse;
 
     nakResponse.hdr.opcode      = MavlinkFTP::kRspNak;
     nakResponse.hdr.req_opcode  = reqOpcode;
-    nakResponse.hdr.session     = 0;
+    nakResponse.hdr.session     = session;
     nakResponse.hdr.size        = 1;
     nakResponse.data[0]         = error;
     
@@ -427,9 +504,11 @@ QString MockLinkFTP::_createTestTempFile(int size)
 {
     QGCTemporaryFile tmpFile("MockLinkFTPTestCase");
     tmpFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    QByteArray bytes(size, 0);
     for (int i=0; i<size; i++) {
-        tmpFile.write(QByteArray(1, i % 255));
+        bytes[i] = static_cast<char>(i % 255);
     }
+    tmpFile.write(bytes);
     tmpFile.close();
     return tmpFile.fileName();
 }
@@ -14,6 +14,7 @@
 
 #include <QStringList>
 #include <QFile>
+#include <QMap>
 
 class MockLink;
 
@@ -66,7 +67,7 @@ signals:
     
 private:
     void        _sendAck                (uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
-    void        _sendNak                (uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
+    void        _sendNak                (uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode, uint8_t session = 0);
     void        _sendNakErrno           (uint8_t targetSystemId, uint8_t targetComponentId, uint8_t nakErrno, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
     void        _sendResponse           (uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _listCommand            (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
@@ -75,6 +76,9 @@ private:
     void        _burstReadCommand          (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _terminateCommand       (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _resetCommand           (uint8_t senderSystemId, uint8_t senderComponentId, uint16_t seqNumber);
+    void        _calcFileCRC32Command   (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    QString     _filenameForPath        (const QString& path);
+    void        _closeSession           (uint8_t session);
     uint16_t    _nextSeqNumber          (uint16_t seqNumber);
     QString     _createTestTempFile     (int size);
     
@@ -83,7 +87,7 @@ private:
 
     QStringList _fileList;  ///< List of files returned by List command
     
-    QFile                   _currentFile;
+    QMap<uint8_t, QFile*>   _sessions;                          ///< Open files by session id
     ErrorMode_t             _errMode            = errModeNone;  ///< Currently set error mode, as specified by setErrorMode
     const uint8_t           _systemIdServer;                    ///< System ID for server
     const uint8_t           _componentIdServer;                 ///< Component ID for server
@@ -93,6 +97,6 @@ private:
     mavlink_message_t       _lastReply;
     bool                    _randomDropsEnabled = false;
 
-    static const uint8_t    _sessionId          = 1;    ///< We only support a single fixed session
+    static const int        _maxSessions        = 4;
 };
 
@@ -303,6 +303,7 @@ void MockLinkMissionItemHandler::_handleMissionCount(const mavlink_message_t& ms
         }
         _failWriteMissionCountFirstResponse = true;
         _writeSequenceIndex = 0;
+        _writeSentEnd = _writeWindowEnd = _transferWindow - 1;
         _requestNextMissionItem(_writeSequenceIndex);
     }
 }
@@ -405,6 +406,22 @@ void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg
         break;
     }
 
+    if (_transferWindow > 1) {
+        // Skip over everything which has already arrived and only ask again once the window has been sent
+        MissionItemList_t& writeItems = _writeItemList();
+        while (_writeSequenceIndex < _writeSequenceCount && writeItems.contains(_writeSequenceIndex)) {
+            _writeSequenceIndex++;
+        }
+        if (_writeSequenceIndex >= _writeSequenceCount) {
+            _sendAck(MAV_MISSION_ACCEPTED);
+        } else if (seq >= _writeWindowEnd || seq >= _writeSequenceCount - 1) {
+            _requestNextMissingMissionItem();
+        } else {
+            _startMissionItemResponseTimer();
+        }
+        return;
+    }
+
     _writeSequenceIndex++;
     if (_writeSequenceIndex < _writeSequenceCount) {
         if (_failureMode == FailWriteFinalAckMissingRequests && _writeSequenceIndex == 3) {
@@ -427,10 +444,44 @@ void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg
 
 void MockLinkMissionItemHandler::_missionItemResponseTimeout(void)
 {
+    if (_transferWindow > 1 || _mockLink->simulatedLossPercent() > 0) {
+        // Either the request or the item was lost, ask again
+        qCDebug(MockLinkMissionItemHandlerLog) << "Timeout waiting for next MISSION_ITEM, requesting again" << _writeSequenceIndex;
+        _missionItemResponseTimer->stop();
+        if (_writeSequenceIndex < _writeSequenceCount) {
+            _requestNextMissingMissionItem();
+        }
+        return;
+    }
+
     qWarning() << "Timeout waiting for next MISSION_ITEM";
     Q_ASSERT(false);
 }
 
+void MockLinkMissionItemHandler::_requestNextMissingMissionItem(void)
+{
+    // The ground station only sends ahead items it has not sent yet, so a request for a lost item may only bring back that one item
+    int windowEnd = _writeSequenceIndex + _transferWindow - 1;
+    if (windowEnd > _writeSentEnd) {
+        _writeSentEnd = _writeWindowEnd = windowEnd;
+    } else {
+        _writeWindowEnd = _writeSequenceIndex;
+    }
+    _requestNextMissionItem(_writeSequenceIndex);
+}
+
+MockLinkMissionItemHandler::MissionItemList_t& MockLinkMissionItemHandler::_writeItemList(void)
+{
+    switch (_requestType) {
+    case MAV_MISSION_TYPE_FENCE:
+        return _fenceItems;
+    case MAV_MISSION_TYPE_RALLY:
+        return _rallyItems;
+    default:
+        return _missionItems;
+    }
+}
+
 void MockLinkMissionItemHandler::sendUnexpectedMissionAck(MAV_MISSION_RESULT ackType)
 {
     _sendAck(ackType);
@@ -80,6 +80,10 @@ public:
 
     void setSendHomePositionOnEmptyList(bool sendHomePositionOnEmptyList) { _sendHomePositionOnEmptyList = sendHomePositionOnEmptyList; }
 
+    /// Number of items the ground station sends for each MISSION_REQUEST during a write. Items which arrive without
+    /// being requested are kept and only missing items are requested.
+    void setTransferWindow(int transferWindow) { _transferWindow = transferWindow; }
+
 private slots:
     void _missionItemResponseTimeout(void);
 
@@ -92,6 +96,7 @@ private:
     void _requestNextMissionItem(int sequenceNumber);
     void _sendAck(MAV_MISSION_RESULT ackType);
     void _startMissionItemResponseTimer(void);
+    void _requestNextMissingMissionItem(void);
 
 private:
     MockLink* _mockLink;
@@ -114,6 +119,12 @@ private:
     MissionItemList_t   _fenceItems;
     MissionItemList_t   _rallyItems;
 
+    MissionItemList_t&  _writeItemList(void);
+
+    int                 _transferWindow =   1;
+    int                 _writeWindowEnd =   0;  ///< Last item expected from the ground station before requesting again
+    int                 _writeSentEnd =     0;  ///< Highest item the ground station has been asked to send
+
     QTimer*             _missionItemResponseTimer;
     FailureMode_t       _failureMode;
     MAV_MISSION_RESULT  _failureAckResult;
@@ -25,6 +25,14 @@
 #include <iostream>
 #include <QHostInfo>
 
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#define UDP_BATCH_RECEIVE 1
+#include <sys/socket.h>
+#include <netinet/in.h>
+#else
+#define UDP_BATCH_RECEIVE 0
+#endif
+
 #include "UDPLink.h"
 #include "QGC.h"
 #include "QGCApplication.h"
@@ -35,6 +43,19 @@
 
 static const char* kZeroconfRegistration = "_qgroundcontrol._udp";
 
+// Datagrams are read into a preallocated pool of fixed size slots. A datagram which does not fit its slot is cut off and
+// already gone from the socket by the time a batched read returns, so each slot holds the largest possible UDP payload.
+// Only the pages datagrams are actually written to get backed by memory, the rest of the pool is just address space.
+static const int kReceiveSlotSize       = 65536;
+#if UDP_BATCH_RECEIVE
+static const int kReceiveBatchSize      = 32;
+#else
+static const int kReceiveBatchSize      = 1;
+#endif
+static const int kReceiveEmitThreshold  = 10 * 1024;
+static const int kReceiveBufferSize     = kReceiveEmitThreshold + 2048;  ///< Room for the datagram which crosses the threshold
+static const int kMaxKnownSenders       = 1024;
+
 static bool is_ip(const QString& address)
 {
     int a,b,c,d;
@@ -93,6 +114,7 @@ UDPLink::UDPLink(SharedLinkConfigurationPointer& config)
     for (const QHostAddress &address: QNetworkInterface::allAddresses()) {
         _localAddress.append(QHostAddress(address));
     }
+    _receivePool.resize(kReceiveBatchSize * kReceiveSlotSize);
     moveToThread(this);
 }
 
@@ -205,40 +227,121 @@ void UDPLink::readBytes()
     if (!_socket) {
         return;
     }
-    QByteArray databuffer;
+    QByteArray  databuffer;
+    quint64     totalBytes = 0;
+    databuffer.reserve(kReceiveBufferSize);
     while (_socket->hasPendingDatagrams())
     {
-        QByteArray datagram;
-        datagram.resize(_socket->pendingDatagramSize());
+        // The first datagram of each wakeup is always read through Qt, that is what re-arms its read notifier
+        qint64 pendingSize = _socket->pendingDatagramSize();
+        if (pendingSize > _receivePool.size()) {
+            _receivePool.resize(static_cast<int>(pendingSize));
+        }
         QHostAddress sender;
         quint16 senderPort;
         //-- Note: This call is broken in Qt 5.9.3 on Windows. It always returns a blank sender and 0 for the port.
-        _socket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
-        databuffer.append(datagram);
-        //-- Wait a bit before sending it over
-        if(databuffer.size() > 10 * 1024) {
-            emit bytesReceived(this, databuffer);
-            databuffer.clear();
-        }
-        _logInputDataRate(datagram.length(), QDateTime::currentMSecsSinceEpoch());
-        // TODO: This doesn't validade the sender. Anything sending UDP packets to this port gets
-        // added to the list and will start receiving datagrams from here. Even a port scanner
-        // would trigger this.
-        // Add host to broadcast list if not yet present, or update its port
-        QHostAddress asender = sender;
-        if(_isIpLocal(sender)) {
-            asender = QHostAddress(QString("127.0.0.1"));
-        }
-        if(!contains_target(_sessionTargets, asender, senderPort)) {
-            qDebug() << "Adding target" << asender << senderPort;
-            UDPCLient* target = new UDPCLient(asender, senderPort);
-            _sessionTargets.append(target);
+        qint64 size = _socket->readDatagram(_receivePool.data(), _receivePool.size(), &sender, &senderPort);
+        if (size < 0) {
+            break;
         }
+        _receivedDatagram(databuffer, _receivePool.constData(), size, sender.toIPv4Address(), senderPort);
+        totalBytes += static_cast<quint64>(size);
+        _readDatagramBatches(databuffer, totalBytes);
     }
     //-- Send whatever is left
     if(databuffer.size()) {
         emit bytesReceived(this, databuffer);
     }
+    // Sampled once per wakeup, not per datagram
+    if (totalBytes) {
+        _logInputDataRate(totalBytes, QDateTime::currentMSecsSinceEpoch());
+    }
+}
+
+/// Drains whatever else is queued on the socket with as few system calls as possible
+void UDPLink::_readDatagramBatches(QByteArray& databuffer, quint64& totalBytes)
+{
+#if UDP_BATCH_RECEIVE
+    struct mmsghdr      msgs[kReceiveBatchSize];
+    struct iovec        iovecs[kReceiveBatchSize];
+    struct sockaddr_in  senders[kReceiveBatchSize];
+
+    int     fd      = static_cast<int>(_socket->socketDescriptor());
+    char*   pool    = _receivePool.data();
+    for (int i=0; i<kReceiveBatchSize; i++) {
+        iovecs[i].iov_base = pool + (i * kReceiveSlotSize);
+        iovecs[i].iov_len = kReceiveSlotSize;
+    }
+
+    forever {
+        memset(msgs, 0, sizeof(msgs));
+        for (int i=0; i<kReceiveBatchSize; i++) {
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &senders[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(senders[i]);
+        }
+
+        int count = recvmmsg(fd, msgs, kReceiveBatchSize, MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            // EAGAIN: socket is drained
+            return;
+        }
+        for (int i=0; i<count; i++) {
+            if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                qWarning() << "UDPLink: Dropped truncated datagram";
+                continue;
+            }
+            _receivedDatagram(databuffer,
+                              static_cast<const char*>(iovecs[i].iov_base),
+                              msgs[i].msg_len,
+                              ntohl(senders[i].sin_addr.s_addr),
+                              ntohs(senders[i].sin_port));
+            totalBytes += msgs[i].msg_len;
+        }
+        if (count < kReceiveBatchSize) {
+            return;
+        }
+    }
+#else
+    Q_UNUSED(databuffer);
+    Q_UNUSED(totalBytes);
+#endif
+}
+
+void UDPLink::_receivedDatagram(QByteArray& databuffer, const char* data, qint64 size, quint32 senderIPv4, quint16 senderPort)
+{
+    databuffer.append(data, static_cast<int>(size));
+    //-- Wait a bit before sending it over
+    if(databuffer.size() > kReceiveEmitThreshold) {
+        emit bytesReceived(this, databuffer);
+        databuffer.clear();
+        databuffer.reserve(kReceiveBufferSize);
+    }
+    // Senders are only looked up the first time they are seen
+    quint64 senderKey = (static_cast<quint64>(senderIPv4) << 16) | senderPort;
+    if (_knownSenders.contains(senderKey)) {
+        return;
+    }
+    if (_knownSenders.count() >= kMaxKnownSenders) {
+        // Only a shortcut past contains_target, so anything sending from ever changing ports can't grow it without bound
+        _knownSenders.clear();
+    }
+    _knownSenders.insert(senderKey);
+    // TODO: This doesn't validade the sender. Anything sending UDP packets to this port gets
+    // added to the list and will start receiving datagrams from here. Even a port scanner
+    // would trigger this.
+    // Add host to broadcast list if not yet present, or update its port
+    QHostAddress sender(senderIPv4);
+    QHostAddress asender = sender;
+    if(_isIpLocal(sender)) {
+        asender = QHostAddress(QString("127.0.0.1"));
+    }
+    if(!contains_target(_sessionTargets, asender, senderPort)) {
+        qDebug() << "Adding target" << asender << senderPort;
+        UDPCLient* target = new UDPCLient(asender, senderPort);
+        _sessionTargets.append(target);
+    }
 }
 
 /**
@@ -24,6 +24,7 @@
 #include <QUdpSocket>
 #include <QMutexLocker>
 #include <QQueue>
+#include <QSet>
 #include <QByteArray>
 
 #if defined(QGC_ZEROCONF_ENABLED)
@@ -157,6 +158,7 @@ class UDPLink : public LinkInterface
 {
     Q_OBJECT
 
+    friend class UDPLinkTest;
     friend class UDPConfiguration;
     friend class LinkManager;
 
@@ -192,6 +194,7 @@ private:
     // From LinkInterface
     bool    _connect                (void) override;
     void    _disconnect             (void) override;
+    int     _writeBatchBytes        (void) const override { return 0; }       ///< One frame per datagram, as peers and routers expect
 
     bool    _isIpLocal              (const QHostAddress& add);
     bool    _hardwareConnect        ();
@@ -199,6 +202,8 @@ private:
     void    _registerZeroconf       (uint16_t port, const std::string& regType);
     void    _deregisterZeroconf     ();
     void    _writeDataGram          (const QByteArray data, const UDPCLient* target);
+    void    _readDatagramBatches    (QByteArray& databuffer, quint64& totalBytes);
+    void    _receivedDatagram       (QByteArray& databuffer, const char* data, qint64 size, quint32 senderIPv4, quint16 senderPort);
 
 #if defined(QGC_ZEROCONF_ENABLED)
     DNSServiceRef  _dnssServiceRef;
@@ -209,7 +214,9 @@ private:
     UDPConfiguration*       _udpConfig;
     bool                    _connectState;
     QList<UDPCLient*>       _sessionTargets;
+    QSet<quint64>           _knownSenders;      ///< IPv4 address and port of every sender already handled for _sessionTargets
     QList<QHostAddress>     _localAddress;
+    QByteArray              _receivePool;       ///< Preallocated datagram slots reused for every read
 
 };
 
@@ -38,8 +38,10 @@
     #include "UnitTest.h"
 #endif
 
+#include "CmdLineOptParser.h"
+#include "LogReplayRunner.h"
+
 #ifdef QT_DEBUG
-    #include "CmdLineOptParser.h"
     #ifdef Q_OS_WIN
         #include <crtdbg.h>
     #endif
@@ -339,6 +341,18 @@ int main(int argc, char *argv[])
 #endif
 #endif // QT_DEBUG
 
+    // Headless max speed log replay for batch analysis: --replay-log:<file> [--replay-facts] [--replay-threaded]
+    bool    replayLog           = false;
+    bool    replayFacts         = false;
+    bool    replayThreaded      = false;
+    QString replayLogFilename;
+    CmdLineOpt_t rgReplayCmdLineOptions[] = {
+        { "--replay-log",       &replayLog,         &replayLogFilename },
+        { "--replay-facts",     &replayFacts,       nullptr },
+        { "--replay-threaded",  &replayThreaded,    nullptr },
+    };
+    ParseCmdLineOptions(argc, argv, rgReplayCmdLineOptions, sizeof(rgReplayCmdLineOptions)/sizeof(rgReplayCmdLineOptions[0]), false);
+
     QCoreApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
     QGCApplication* app = new QGCApplication(argc, argv, runUnitTests);
     Q_CHECK_PTR(app);
@@ -384,7 +398,11 @@ int main(int argc, char *argv[])
         }
     } else
 #endif
-    {
+    if (replayLog) {
+        // No QML is created, run with QT_QPA_PLATFORM=offscreen when there is no display
+        LogReplayRunner replayRunner(replayLogFilename, replayFacts, replayThreaded);
+        exitCode = replayRunner.run();
+    } else {
 
 #ifdef __android__
         checkAndroidWritePermission();
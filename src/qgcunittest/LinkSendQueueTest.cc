@@ -0,0 +1,108 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkSendQueueTest.h"
+#include "LinkSendQueue.h"
+
+#include <QtConcurrent>
+#include <QThread>
+
+LinkSendQueueTest::LinkSendQueueTest(void)
+{
+
+}
+
+void LinkSendQueueTest::_pushPop_test(void)
+{
+    LinkSendQueue queue(3);
+
+    // Capacity is rounded up to a power of two
+    QVERIFY(queue.front() == nullptr);
+    for (char i=0; i<4; i++) {
+        QVERIFY(queue.push(&i, 1));
+    }
+    QCOMPARE(queue.push("x", 1), false);
+    QCOMPARE(queue.droppedCount(), 1u);
+    QCOMPARE(queue.depth(), 4);
+    QCOMPARE(queue.maxDepth(), 4);
+
+    // A drain is only requested once until the consumer starts draining
+    QCOMPARE(queue.requestDrain(), true);
+    QCOMPARE(queue.requestDrain(), false);
+    queue.drainStarted();
+    QCOMPARE(queue.requestDrain(), true);
+
+    // Frames come out in order and slots are reused once read
+    for (char i=0; i<4; i++) {
+        const LinkSendQueue::Slot_t* slot = queue.front();
+        QVERIFY(slot);
+        QCOMPARE(slot->length, 1);
+        QCOMPARE(slot->bytes[0], i);
+        queue.popFront();
+    }
+    QVERIFY(queue.front() == nullptr);
+    QVERIFY(queue.push("abc", 3));
+    QCOMPARE(QByteArray(queue.front()->bytes, queue.front()->length), QByteArray("abc"));
+}
+
+void LinkSendQueueTest::_multipleProducers_test(void)
+{
+    LinkSendQueue queue(256);
+
+    // Each frame carries the producer and a per producer sequence number, producers retry while the queue is full
+    QList<QFuture<void>> producers;
+    for (int producer=0; producer<_producerCount; producer++) {
+        producers.append(QtConcurrent::run([&queue, producer]() {
+            for (int sequence=0; sequence<_framesPerProducer; sequence++) {
+                int frame[2] = { producer, sequence };
+                while (!queue.push(reinterpret_cast<const char*>(frame), sizeof(frame))) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }));
+    }
+
+    // No frame may be lost, duplicated or reordered within a producer. Mismatches are only recorded here so the
+    // producers, which reference the queue, are always joined before comparing.
+    QVector<int>    nextSequence(_producerCount, 0);
+    int             received    = 0;
+    int             badFrames   = 0;
+    int             outOfOrder  = 0;
+    while (received < _producerCount * _framesPerProducer) {
+        const LinkSendQueue::Slot_t* slot = queue.front();
+        if (!slot) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        int frame[2];
+        if (slot->length != static_cast<int>(sizeof(frame))) {
+            badFrames++;
+        } else {
+            memcpy(frame, slot->bytes, sizeof(frame));
+            if (frame[0] < 0 || frame[0] >= _producerCount) {
+                badFrames++;
+            } else {
+                if (frame[1] != nextSequence[frame[0]]) {
+                    outOfOrder++;
+                }
+                nextSequence[frame[0]] = frame[1] + 1;
+            }
+        }
+        received++;
+        queue.popFront();
+    }
+
+    for (QFuture<void>& producer: producers) {
+        producer.waitForFinished();
+    }
+
+    QCOMPARE(badFrames, 0);
+    QCOMPARE(outOfOrder, 0);
+    QVERIFY(queue.front() == nullptr);
+}
@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// @file
+///     @brief LinkSendQueue unit test
+
+class LinkSendQueueTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LinkSendQueueTest(void);
+
+private slots:
+    void _pushPop_test              (void);
+    void _multipleProducers_test    (void);
+
+private:
+    static const int _producerCount         = 4;
+    static const int _framesPerProducer     = 100000;
+};
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogReplayRunnerTest.h"
+#include "LogReplayRunner.h"
+#include "QGCMAVLink.h"
+
+#include <QTemporaryDir>
+#include <QDateTime>
+#include <QtEndian>
+
+LogReplayRunnerTest::LogReplayRunnerTest(void)
+{
+
+}
+
+/// Writes a tlog of heartbeats: each record is a big endian usec timestamp followed by the mavlink frame
+void LogReplayRunnerTest::_writeLog(const QString& logFilename)
+{
+    QFile logFile(logFilename);
+    QVERIFY(logFile.open(QFile::WriteOnly));
+
+    quint64 timestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() - 3600 * 1000) * 1000;
+    for (int i=0; i<_logMessageCount; i++) {
+        mavlink_message_t   message;
+        uint8_t             buffer[MAVLINK_MAX_PACKET_LEN];
+
+        mavlink_msg_heartbeat_pack(_logSystemId, MAV_COMP_ID_MISSIONPLANNER, &message, MAV_TYPE_GCS, MAV_AUTOPILOT_INVALID, 0, 0, MAV_STATE_ACTIVE);
+        uint16_t length = mavlink_msg_to_send_buffer(buffer, &message);
+
+        uchar bigEndianTimestamp[sizeof(quint64)];
+        qToBigEndian(timestamp, bigEndianTimestamp);
+        QCOMPARE(logFile.write(reinterpret_cast<const char*>(bigEndianTimestamp), sizeof(bigEndianTimestamp)), static_cast<qint64>(sizeof(bigEndianTimestamp)));
+        QCOMPARE(logFile.write(reinterpret_cast<const char*>(buffer), length), static_cast<qint64>(length));
+
+        timestamp += _logMessageIntervalUSecs;
+    }
+}
+
+void LogReplayRunnerTest::_replayWorker(bool threadedParsing)
+{
+    QTemporaryDir tempDir;
+    QString logFilename = tempDir.filePath(QStringLiteral("LogReplayRunnerTest.tlog"));
+    _writeLog(logFilename);
+
+    LogReplayRunner runner(logFilename, false /* dumpFacts */, threadedParsing);
+    QSignalSpy      spyFinished(&runner, &LogReplayRunner::finished);
+
+    QVERIFY(runner.start());
+    QVERIFY(spyFinished.wait(10000));
+    QCOMPARE(spyFinished.count(), 1);
+    QCOMPARE(spyFinished[0][0].toInt(), 0);
+
+    // Every message in the log made it through the receive path, and the stats signalled at the start of playback
+    // were not missed
+    QCOMPARE(runner.messageCount(), static_cast<quint64>(_logMessageCount));
+    QCOMPARE(runner.logDurationSecs(), ((_logMessageCount - 1) * _logMessageIntervalUSecs) / 1000000);
+}
+
+void LogReplayRunnerTest::_replay_test(void)
+{
+    _replayWorker(false /* threadedParsing */);
+}
+
+void LogReplayRunnerTest::_replayThreaded_test(void)
+{
+    _replayWorker(true /* threadedParsing */);
+}
+
+void LogReplayRunnerTest::_missingLog_test(void)
+{
+    QTemporaryDir   tempDir;
+    LogReplayRunner runner(tempDir.filePath(QStringLiteral("Missing.tlog")), false /* dumpFacts */, false /* threadedParsing */);
+
+    QVERIFY(!runner.start());
+}
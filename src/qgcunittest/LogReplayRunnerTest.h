@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// @file
+///     @brief Headless max speed replay of a small generated telemetry log
+
+class LogReplayRunnerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LogReplayRunnerTest(void);
+
+private slots:
+    void _replay_test           (void);
+    void _replayThreaded_test   (void);
+    void _missingLog_test       (void);
+
+private:
+    void _replayWorker  (bool threadedParsing);
+    void _writeLog      (const QString& logFilename);
+
+    static const int    _logMessageCount        = 100;
+    static const int    _logMessageIntervalUSecs = 100000;
+    static const int    _logSystemId            = 200;      ///< Heartbeats come from a GCS so no Vehicle is created
+};
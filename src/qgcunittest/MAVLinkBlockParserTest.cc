@@ -0,0 +1,208 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkBlockParserTest.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtEndian>
+
+MAVLinkBlockParserTest::MAVLinkBlockParserTest(void)
+{
+
+}
+
+/// Appends a single message to the stream. Message type and version vary by index. If logFormat is true the
+/// message is prefixed with a timestamp in the same format as a .mavlink telemetry log.
+void MAVLinkBlockParserTest::_appendMessage(QByteArray& stream, int index, bool logFormat)
+{
+    mavlink_message_t   msg;
+    uint8_t             buffer[MAVLINK_MAX_PACKET_LEN];
+
+    mavlink_status_t*   status      = mavlink_get_channel_status(MAVLINK_COMM_0);
+    uint8_t             savedFlags  = status->flags;
+
+    // Every 7th message goes out as MAVLink 1
+    if (index % 7 == 0) {
+        status->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    } else {
+        status->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    }
+
+    uint8_t sysid = static_cast<uint8_t>(1 + (index % 3));
+    switch (index % 4) {
+    case 0:
+        mavlink_msg_heartbeat_pack(sysid, MAV_COMP_ID_AUTOPILOT1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, MAV_MODE_FLAG_CUSTOM_MODE_ENABLED, 0, MAV_STATE_ACTIVE);
+        break;
+    case 1:
+        mavlink_msg_attitude_pack(sysid, MAV_COMP_ID_AUTOPILOT1, &msg, static_cast<uint32_t>(index), 0.1f * index, 0.2f, -0.3f, 0.01f, 0.02f, 0.03f);
+        break;
+    case 2:
+        mavlink_msg_gps_raw_int_pack(sysid, MAV_COMP_ID_AUTOPILOT1, &msg, static_cast<uint64_t>(index) * 1000, GPS_FIX_TYPE_3D_FIX, 473977418 + index, 85455938, 488000, 100, 100, 500, 9000, 12, 0, 0, 0, 0, 0, 0);
+        break;
+    default:
+        // Mostly zero payload, exercises MAVLink 2 payload truncation
+        mavlink_msg_sys_status_pack(sysid, MAV_COMP_ID_AUTOPILOT1, &msg, 0, 0, 0, 0, 12600, -1, 80, 0, 0, 0, 0, 0, 0);
+        break;
+    }
+
+    status->flags = savedFlags;
+
+    if (logFormat) {
+        uint8_t timestamp[sizeof(quint64)];
+        qToBigEndian(static_cast<quint64>(index) * 1000, timestamp);
+        stream.append(reinterpret_cast<const char*>(timestamp), sizeof(timestamp));
+    }
+
+    uint16_t len = mavlink_msg_to_send_buffer(buffer, &msg);
+    stream.append(reinterpret_cast<const char*>(buffer), len);
+}
+
+QByteArray MAVLinkBlockParserTest::_buildStream(int messageCount, bool logFormat, bool corrupt)
+{
+    QByteArray stream;
+
+    for (int i=0; i<messageCount; i++) {
+        if (corrupt && i % 11 == 5) {
+            // Non-MAVLink noise which does not contain a start-of-frame marker
+            stream.append(QByteArray(13, 0x55));
+        }
+        _appendMessage(stream, i, logFormat);
+        if (corrupt && i % 13 == 6) {
+            // Flip a bit in the last byte of the checksum so the frame is dropped by both parsers
+            stream[stream.count() - 1] = static_cast<char>(stream[stream.count() - 1] ^ 0x01);
+        }
+    }
+
+    return stream;
+}
+
+int MAVLinkBlockParserTest::_parseBytewise(const QByteArray& bytes, int blockSize, QVector<mavlink_message_t>& messages)
+{
+    mavlink_message_t   rxMessage   = {};
+    mavlink_status_t    rxStatus    = {};
+    mavlink_message_t   message     = {};
+    mavlink_status_t    status      = {};
+    int                 count       = 0;
+
+    for (int blockStart=0; blockStart<bytes.count(); blockStart+=blockSize) {
+        int blockEnd = qMin(blockStart + blockSize, bytes.count());
+        for (int i=blockStart; i<blockEnd; i++) {
+            if (mavlink_frame_char_buffer(&rxMessage, &rxStatus, static_cast<uint8_t>(bytes[i]), &message, &status) == MAVLINK_FRAMING_OK) {
+                messages.append(message);
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+int MAVLinkBlockParserTest::_parseBlockwise(const QByteArray& bytes, int blockSize, QVector<mavlink_message_t>& messages)
+{
+    MAVLinkBlockParser  parser;
+    int                 count = 0;
+
+    for (int blockStart=0; blockStart<bytes.count(); blockStart+=blockSize) {
+        count += parser.parse(bytes.mid(blockStart, blockSize), messages);
+    }
+
+    return count;
+}
+
+void MAVLinkBlockParserTest::_compareMessages(const QVector<mavlink_message_t>& expected, const QVector<mavlink_message_t>& actual)
+{
+    QCOMPARE(actual.count(), expected.count());
+    for (int i=0; i<expected.count(); i++) {
+        const mavlink_message_t& e = expected[i];
+        const mavlink_message_t& a = actual[i];
+
+        QCOMPARE(a.magic,       e.magic);
+        QCOMPARE(a.msgid,       e.msgid);
+        QCOMPARE(a.sysid,       e.sysid);
+        QCOMPARE(a.compid,      e.compid);
+        QCOMPARE(a.seq,         e.seq);
+        QCOMPARE(a.len,         e.len);
+        QCOMPARE(a.checksum,    e.checksum);
+
+        // Compare the full decoded payload, which includes the zero filled portion of truncated payloads
+        const mavlink_msg_entry_t* msgEntry = mavlink_get_msg_entry(e.msgid);
+        QVERIFY(msgEntry);
+        QVERIFY(memcmp(_MAV_PAYLOAD(&a), _MAV_PAYLOAD(&e), msgEntry->max_msg_len) == 0);
+    }
+}
+
+void MAVLinkBlockParserTest::_matchesCharParser_test(void)
+{
+    QByteArray stream = _buildStream(500, false /* logFormat */, true /* corrupt */);
+
+    QVector<mavlink_message_t> expected;
+    QVector<mavlink_message_t> actual;
+    _parseBytewise(stream, stream.count(), expected);
+    _parseBlockwise(stream, stream.count(), actual);
+
+    QVERIFY(expected.count() > 400);
+    _compareMessages(expected, actual);
+}
+
+void MAVLinkBlockParserTest::_splitFrames_test(void)
+{
+    QByteArray stream = _buildStream(200, false /* logFormat */, false /* corrupt */);
+
+    QVector<mavlink_message_t> expected;
+    _parseBytewise(stream, stream.count(), expected);
+    QCOMPARE(expected.count(), 200);
+
+    // Block sizes chosen so that frames are split at every possible position, including inside the header
+    for (int blockSize: { 1, 3, 7, 64, 263 }) {
+        QVector<mavlink_message_t> actual;
+        QCOMPARE(_parseBlockwise(stream, blockSize, actual), expected.count());
+        _compareMessages(expected, actual);
+    }
+}
+
+void MAVLinkBlockParserTest::_throughputBenchmark_test(void)
+{
+    UT_BENCHMARK();
+
+    // A recorded telemetry log can be specified through the environment, otherwise a synthetic one is used
+    QByteArray  log;
+    QString     logFile = QString::fromLocal8Bit(qgetenv("QGC_MAVLINK_BENCHMARK_LOG"));
+    if (!logFile.isEmpty()) {
+        QFile file(logFile);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        log = file.readAll();
+    } else {
+        log = _buildStream(200000, true /* logFormat */, false /* corrupt */);
+    }
+
+    QVector<mavlink_message_t> bytewiseMessages;
+    QVector<mavlink_message_t> blockwiseMessages;
+    bytewiseMessages.reserve(log.count() / 20);
+    blockwiseMessages.reserve(log.count() / 20);
+
+    QElapsedTimer timer;
+
+    timer.start();
+    int bytewiseCount = _parseBytewise(log, _benchmarkBlockSize, bytewiseMessages);
+    qint64 bytewiseNSecs = timer.nsecsElapsed();
+
+    timer.start();
+    int blockwiseCount = _parseBlockwise(log, _benchmarkBlockSize, blockwiseMessages);
+    qint64 blockwiseNSecs = timer.nsecsElapsed();
+
+    // Timestamps in a log can contain start-of-frame markers which cause the byte parser to swallow the following
+    // frame. The block parser resyncs inside the bogus frame so it never finds fewer messages.
+    QVERIFY(bytewiseCount > 0);
+    QVERIFY(blockwiseCount >= bytewiseCount);
+
+    qDebug() << "MAVLinkBlockParser benchmark bytes:messages" << log.count() << blockwiseCount;
+    qDebug() << "    mavlink_parse_char msgs/sec" << static_cast<qint64>(bytewiseCount / (bytewiseNSecs / 1e9));
+    qDebug() << "    MAVLinkBlockParser msgs/sec" << static_cast<qint64>(blockwiseCount / (blockwiseNSecs / 1e9));
+}
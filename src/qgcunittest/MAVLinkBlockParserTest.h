@@ -0,0 +1,38 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "MAVLinkBlockParser.h"
+
+/// @file
+///     @brief MAVLinkBlockParser unit test and throughput benchmark against mavlink_parse_char
+
+class MAVLinkBlockParserTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkBlockParserTest(void);
+
+private slots:
+    void _matchesCharParser_test    (void);
+    void _splitFrames_test          (void);
+    void _throughputBenchmark_test  (void);
+
+private:
+    QByteArray  _buildStream            (int messageCount, bool logFormat, bool corrupt);
+    void        _appendMessage          (QByteArray& stream, int index, bool logFormat);
+    int         _parseBytewise          (const QByteArray& bytes, int blockSize, QVector<mavlink_message_t>& messages);
+    int         _parseBlockwise         (const QByteArray& bytes, int blockSize, QVector<mavlink_message_t>& messages);
+    void        _compareMessages        (const QVector<mavlink_message_t>& expected, const QVector<mavlink_message_t>& actual);
+
+    static const int _benchmarkBlockSize = 1024;    ///< Roughly what UDP/Serial links hand out per read
+};
@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageDispatcherTest.h"
+
+MAVLinkMessageDispatcherTest::MAVLinkMessageDispatcherTest(void)
+{
+
+}
+
+mavlink_message_t MAVLinkMessageDispatcherTest::_message(int sysid, int compid, int msgid)
+{
+    mavlink_message_t message = {};
+
+    message.sysid   = static_cast<uint8_t>(sysid);
+    message.compid  = static_cast<uint8_t>(compid);
+    message.msgid   = static_cast<uint32_t>(msgid);
+
+    return message;
+}
+
+void MAVLinkMessageDispatcherTest::_routing_test(void)
+{
+    MAVLinkMessageDispatcher    dispatcher;
+    QObject                     owner;
+    int                         exactCount      = 0;
+    int                         vehicleCount    = 0;
+    int                         msgIdCount      = 0;
+    int                         allCount        = 0;
+    const int                   anyId           = MAVLinkMessageDispatcher::anyId;
+
+    dispatcher.registerHandler(&owner, 1, 1, MAVLINK_MSG_ID_ATTITUDE,   [&](LinkInterface*, const mavlink_message_t&) { exactCount++; });
+    dispatcher.registerHandler(&owner, 1, anyId, anyId,                 [&](LinkInterface*, const mavlink_message_t&) { vehicleCount++; });
+    dispatcher.registerHandler(&owner, anyId, anyId, MAVLINK_MSG_ID_HEARTBEAT, [&](LinkInterface*, const mavlink_message_t&) { msgIdCount++; });
+
+    // Nobody wants messages from system 2 other than heartbeats
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(2, 1, MAVLINK_MSG_ID_ATTITUDE)), 0);
+
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(1, 1, MAVLINK_MSG_ID_ATTITUDE)), 2);
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(1, 2, MAVLINK_MSG_ID_ATTITUDE)), 1);
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(2, 1, MAVLINK_MSG_ID_HEARTBEAT)), 1);
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(1, 1, MAVLINK_MSG_ID_HEARTBEAT)), 2);
+    QCOMPARE(exactCount,    1);
+    QCOMPARE(vehicleCount,  3);
+    QCOMPARE(msgIdCount,    2);
+
+    int allId = dispatcher.registerHandler(&owner, anyId, anyId, anyId, [&](LinkInterface*, const mavlink_message_t&) { allCount++; });
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(3, 3, MAVLINK_MSG_ID_SYS_STATUS)), 1);
+    QCOMPARE(allCount, 1);
+
+    dispatcher.unregisterHandler(allId);
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(3, 3, MAVLINK_MSG_ID_SYS_STATUS)), 0);
+
+    dispatcher.unregisterHandlers(&owner);
+    QVERIFY(dispatcher.isEmpty());
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(1, 1, MAVLINK_MSG_ID_ATTITUDE)), 0);
+}
+
+void MAVLinkMessageDispatcherTest::_unregisterDuringDispatch_test(void)
+{
+    MAVLinkMessageDispatcher    dispatcher;
+    QObject                     owner;
+    int                         firstCount  = 0;
+    int                         secondCount = 0;
+    int                         secondId    = 0;
+
+    dispatcher.registerHandler(&owner, 1, 1, MAVLINK_MSG_ID_HEARTBEAT, [&](LinkInterface*, const mavlink_message_t&) {
+        firstCount++;
+        dispatcher.unregisterHandler(secondId);
+    });
+    secondId = dispatcher.registerHandler(&owner, 1, 1, MAVLINK_MSG_ID_HEARTBEAT, [&](LinkInterface*, const mavlink_message_t&) { secondCount++; });
+
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(1, 1, MAVLINK_MSG_ID_HEARTBEAT)), 1);
+    QCOMPARE(firstCount,    1);
+    QCOMPARE(secondCount,   0);
+}
+
+void MAVLinkMessageDispatcherTest::_ownerDestroyed_test(void)
+{
+    MAVLinkMessageDispatcher    dispatcher;
+    QObject*                    owner = new QObject();
+    int                         count = 0;
+
+    dispatcher.registerHandler(owner, 1, 1, MAVLINK_MSG_ID_HEARTBEAT, [&](LinkInterface*, const mavlink_message_t&) { count++; });
+    delete owner;
+
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(1, 1, MAVLINK_MSG_ID_HEARTBEAT)), 0);
+    QCOMPARE(count, 0);
+    QVERIFY(dispatcher.isEmpty());
+}
+
+void MAVLinkMessageDispatcherTest::_subscriberCalledOnce_test(void)
+{
+    MAVLinkMessageDispatcher    dispatcher;
+    QObject                     owner;
+    int                         subscriberCount = 0;
+    int                         otherCount      = 0;
+    const int                   anyId           = MAVLinkMessageDispatcher::anyId;
+
+    // Same keys as a vehicle: its own messages, broadcasts and radio status from anyone
+    QList<MAVLinkMessageDispatcher::Key_t> keys({ { 1, anyId, anyId }, { 0, anyId, anyId }, { anyId, anyId, MAVLINK_MSG_ID_RADIO_STATUS } });
+    dispatcher.registerHandler(&owner, keys, [&](LinkInterface*, const mavlink_message_t&) { subscriberCount++; });
+    dispatcher.registerHandler(&owner, anyId, anyId, MAVLINK_MSG_ID_RADIO_STATUS, [&](LinkInterface*, const mavlink_message_t&) { otherCount++; });
+
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(1, 1, MAVLINK_MSG_ID_RADIO_STATUS)), 2);
+    QCOMPARE(subscriberCount,   1);
+    QCOMPARE(otherCount,        1);
+
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(2, 1, MAVLINK_MSG_ID_RADIO_STATUS)), 2);
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(2, 1, MAVLINK_MSG_ID_HEARTBEAT)), 0);
+    QCOMPARE(dispatcher.dispatch(nullptr, _message(0, 1, MAVLINK_MSG_ID_HEARTBEAT)), 1);
+    QCOMPARE(subscriberCount,   3);
+    QCOMPARE(otherCount,        2);
+}
@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "MAVLinkMessageDispatcher.h"
+
+/// @file
+///     @brief MAVLinkMessageDispatcher unit test
+
+class MAVLinkMessageDispatcherTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkMessageDispatcherTest(void);
+
+private slots:
+    void _routing_test                  (void);
+    void _unregisterDuringDispatch_test (void);
+    void _ownerDestroyed_test           (void);
+    void _subscriberCalledOnce_test     (void);
+
+private:
+    mavlink_message_t _message(int sysid, int compid, int msgid);
+};
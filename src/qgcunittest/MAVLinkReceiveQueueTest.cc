@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkReceiveQueueTest.h"
+#include "MAVLinkReceiveQueue.h"
+
+#include <QtConcurrent>
+#include <QThread>
+
+MAVLinkReceiveQueueTest::MAVLinkReceiveQueueTest(void)
+{
+
+}
+
+void MAVLinkReceiveQueueTest::_pushPop_test(void)
+{
+    MAVLinkReceiveQueue queue(3);
+    mavlink_message_t   message;
+    memset(&message, 0, sizeof(message));
+
+    // Capacity is rounded up to a power of two, messages which don't fit are dropped and counted
+    QVERIFY(queue.front() == nullptr);
+    for (uint8_t i=0; i<4; i++) {
+        message.seq = i;
+        QVERIFY(queue.push(message, i * 1000));
+    }
+    QCOMPARE(queue.push(message, 0), false);
+    QCOMPARE(queue.push(message, 0), false);
+    QCOMPARE(queue.droppedCount(), 2u);
+
+    // A drain is only requested once until the consumer starts draining
+    QCOMPARE(queue.requestDrain(), true);
+    QCOMPARE(queue.requestDrain(), false);
+    queue.drainStarted();
+    QCOMPARE(queue.requestDrain(), true);
+
+    // Messages come out in order with their receive time, entries are reused once read
+    for (uint8_t i=0; i<4; i++) {
+        const MAVLinkReceiveQueue::Entry_t* entry = queue.front();
+        QVERIFY(entry);
+        QCOMPARE(entry->message.seq, i);
+        QCOMPARE(entry->receiveTimeNSecs, static_cast<qint64>(i * 1000));
+        queue.popFront();
+    }
+    QVERIFY(queue.front() == nullptr);
+    message.seq = 42;
+    QVERIFY(queue.push(message, 0));
+    QCOMPARE(queue.front()->message.seq, static_cast<uint8_t>(42));
+    QCOMPARE(queue.droppedCount(), 2u);
+}
+
+void MAVLinkReceiveQueueTest::_producerThread_test(void)
+{
+    MAVLinkReceiveQueue queue(64);
+
+    // The producer retries while the queue is full so nothing is dropped
+    QFuture<void> producer = QtConcurrent::run([&queue]() {
+        mavlink_message_t message;
+        memset(&message, 0, sizeof(message));
+        for (int i=0; i<_producerMessageCount; i++) {
+            message.msgid = static_cast<uint32_t>(i);
+            while (!queue.push(message, i)) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    });
+
+    // Mismatches are only recorded here so the producer is always joined before comparing
+    int received    = 0;
+    int outOfOrder  = 0;
+    while (received < _producerMessageCount) {
+        const MAVLinkReceiveQueue::Entry_t* entry = queue.front();
+        if (!entry) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        if (entry->message.msgid != static_cast<uint32_t>(received) || entry->receiveTimeNSecs != received) {
+            outOfOrder++;
+        }
+        received++;
+        queue.popFront();
+    }
+    producer.waitForFinished();
+
+    QCOMPARE(outOfOrder, 0);
+    QCOMPARE(queue.droppedCount(), 0u);
+    QVERIFY(queue.front() == nullptr);
+}
+
+void MAVLinkReceiveQueueTest::_histogram_test(void)
+{
+    MAVLinkLatencyHistogram histogram;
+
+    QCOMPARE(histogram.sampleCount(), static_cast<quint64>(0));
+    QCOMPARE(histogram.percentileUSecs(50), static_cast<qint64>(0));
+
+    // 90 samples under 1us, 9 at 3us and one far past the last bucket
+    for (int i=0; i<90; i++) {
+        histogram.addSample(500);
+    }
+    for (int i=0; i<9; i++) {
+        histogram.addSample(3000);
+    }
+    const qint64 outlierNSecs = Q_INT64_C(10000000000);
+    histogram.addSample(outlierNSecs);
+
+    QCOMPARE(histogram.sampleCount(), static_cast<quint64>(100));
+    QCOMPARE(histogram.maxNSecs(), outlierNSecs);
+    QCOMPARE(histogram.percentileUSecs(50), static_cast<qint64>(1));
+    QCOMPARE(histogram.percentileUSecs(90), static_cast<qint64>(1));
+    QCOMPARE(histogram.percentileUSecs(99), static_cast<qint64>(4));
+
+    // The last bucket is open ended so its percentile is the max seen
+    QCOMPARE(histogram.percentileUSecs(100), outlierNSecs / 1000);
+    QVERIFY(histogram.toString().startsWith(QStringLiteral("samples:100 p50:<1us p90:<1us p99:<4us")));
+
+    histogram.reset();
+    QCOMPARE(histogram.sampleCount(), static_cast<quint64>(0));
+    QCOMPARE(histogram.maxNSecs(), static_cast<qint64>(0));
+    QCOMPARE(histogram.percentileUSecs(99), static_cast<qint64>(0));
+}
@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// @file
+///     @brief MAVLinkReceiveQueue and MAVLinkLatencyHistogram unit test
+
+class MAVLinkReceiveQueueTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkReceiveQueueTest(void);
+
+private slots:
+    void _pushPop_test          (void);
+    void _producerThread_test   (void);
+    void _histogram_test        (void);
+
+private:
+    static const int _producerMessageCount = 100000;
+};
@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UDPLinkTest.h"
+
+#include <QUdpSocket>
+#include <QElapsedTimer>
+
+UDPLinkTest::UDPLinkTest(void)
+    : _link         (nullptr)
+    , _receivedBytes(0)
+    , _keepReceived (true)
+{
+
+}
+
+// Called before every test
+void UDPLinkTest::init(void)
+{
+    UnitTest::init();
+
+    UDPConfiguration* udpConfig = new UDPConfiguration("MockUDP");
+    udpConfig->setLocalPort(_localPort);
+    _sharedConfig = SharedLinkConfigurationPointer(udpConfig);
+    _link = new UDPLink(_sharedConfig);
+    connect(_link, &LinkInterface::bytesReceived, this, &UDPLinkTest::_bytesReceived);
+
+    _received.clear();
+    _receivedBytes = 0;
+    _keepReceived = true;
+
+    QSignalSpy spyConnected(_link, &LinkInterface::connected);
+    QCOMPARE(_link->_connect(), true);
+    QTRY_COMPARE_WITH_TIMEOUT(spyConnected.count(), 1, 5000);
+}
+
+// Called after every test
+void UDPLinkTest::cleanup(void)
+{
+    delete _link;
+    _link = nullptr;
+    _sharedConfig.clear();
+
+    UnitTest::cleanup();
+}
+
+void UDPLinkTest::_bytesReceived(LinkInterface* /*link*/, QByteArray bytes)
+{
+    _receivedBytes += bytes.count();
+    if (_keepReceived) {
+        _received.append(bytes);
+    }
+}
+
+void UDPLinkTest::_receive_test(void)
+{
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    // Datagrams arrive in order and concatenated
+    sender.writeDatagram(QByteArray("abc"), QHostAddress::LocalHost, _localPort);
+    sender.writeDatagram(QByteArray("def"), QHostAddress::LocalHost, _localPort);
+    sender.writeDatagram(QByteArray("ghi"), QHostAddress::LocalHost, _localPort);
+    QTRY_COMPARE_WITH_TIMEOUT(_received, QByteArray("abcdefghi"), 5000);
+
+    // The sender is added as a session target only once and is sent whatever the link writes
+    QCOMPARE(_link->_sessionTargets.count(), 1);
+    _link->writeBytesThreadSafe("xyz", 3);
+    QTRY_VERIFY_WITH_TIMEOUT(sender.hasPendingDatagrams(), 5000);
+    QByteArray reply(static_cast<int>(sender.pendingDatagramSize()), 0);
+    sender.readDatagram(reply.data(), reply.size());
+    QCOMPARE(reply, QByteArray("xyz"));
+
+    // Datagrams larger than a typical MTU make it through batched reads as well
+    QByteArray large(8000, 'x');
+    _received.clear();
+    sender.writeDatagram(QByteArray("abc"), QHostAddress::LocalHost, _localPort);
+    sender.writeDatagram(large, QHostAddress::LocalHost, _localPort);
+    sender.writeDatagram(QByteArray("def"), QHostAddress::LocalHost, _localPort);
+    QTRY_COMPARE_WITH_TIMEOUT(_received, QByteArray("abc") + large + QByteArray("def"), 5000);
+}
+
+void UDPLinkTest::_receiveBenchmark_test(void)
+{
+    UT_BENCHMARK();
+
+    QUdpSocket      sender;
+    QElapsedTimer   timer;
+    QByteArray      datagram(_benchmarkDatagramSize, 'x');
+    const qint64    totalBytes = static_cast<qint64>(_benchmarkDatagramCount) * _benchmarkDatagramSize;
+
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+    _keepReceived = false;
+
+    // The sender keeps a window of datagrams in flight so nothing is dropped by the socket buffer
+    int sent = 0;
+    timer.start();
+    while (_receivedBytes < totalBytes) {
+        while (sent < _benchmarkDatagramCount && sent - (_receivedBytes / _benchmarkDatagramSize) < _benchmarkWindow) {
+            sender.writeDatagram(datagram, QHostAddress::LocalHost, _localPort);
+            sent++;
+        }
+        QCoreApplication::processEvents();
+        QVERIFY2(timer.elapsed() < 60000, "Timed out waiting for datagrams");
+    }
+    qint64 elapsedMSecs = qMax(timer.elapsed(), static_cast<qint64>(1));
+
+    qDebug() << "UDPLink received" << _benchmarkDatagramCount << "datagrams in" << elapsedMSecs << "msecs," << (_benchmarkDatagramCount * 1000LL) / elapsedMSecs << "datagrams/sec";
+}
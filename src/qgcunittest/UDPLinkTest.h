@@ -0,0 +1,45 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "UDPLink.h"
+
+/// @file
+///     @brief UDPLink receive path unit test and loopback throughput benchmark
+
+class UDPLinkTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    UDPLinkTest(void);
+
+private slots:
+    void init(void);
+    void cleanup(void);
+
+    void _receive_test              (void);
+    void _receiveBenchmark_test     (void);
+
+private:
+    void _bytesReceived(LinkInterface* link, QByteArray bytes);
+
+    SharedLinkConfigurationPointer  _sharedConfig;
+    UDPLink*                        _link;
+    QByteArray                      _received;
+    qint64                          _receivedBytes;
+    bool                            _keepReceived;
+
+    static const quint16    _localPort                  = 14599;
+    static const int        _benchmarkDatagramCount     = 200000;
+    static const int        _benchmarkDatagramSize      = 64;   ///< Typical telemetry message size
+    static const int        _benchmarkWindow            = 4096; ///< Datagrams in flight, keeps well within the socket buffer
+};
@@ -80,6 +80,11 @@ QList<QObject*>& UnitTest::_testList(void)
 	return tests;
 }
 
+bool UnitTest::benchmarksEnabled(void)
+{
+    return qEnvironmentVariableIntValue("QGC_UNITTEST_BENCHMARKS") != 0;
+}
+
 int UnitTest::run(QString& singleTest)
 {
     int ret = 0;
@@ -28,6 +28,14 @@
 
 #define UT_REGISTER_TEST(className) static UnitTestWrapper<className> className(#className);
 
+/// Skips the calling benchmark test unless benchmarks are enabled, see UnitTest::benchmarksEnabled
+#define UT_BENCHMARK() \
+    do { \
+        if (!UnitTest::benchmarksEnabled()) { \
+            QSKIP("Benchmark, set QGC_UNITTEST_BENCHMARKS=1 to run"); \
+        } \
+    } while (0)
+
 class QGCMessageBox;
 class QGCQFileDialog;
 class LinkManager;
@@ -85,6 +93,10 @@ public:
     /// @brief Adds a unit test to the list. Should only be called by UnitTestWrapper.
     static void _addTest(QObject* test);
 
+    /// Benchmarks are long running and only report timings, so they are left out of the regular unit test run
+    /// @return true: QGC_UNITTEST_BENCHMARKS is set in the environment
+    static bool benchmarksEnabled(void);
+
     /// Creates a file with random contents of the specified size.
     /// @return Fully qualified path to created file
     static QString createRandomFile(uint32_t byteCount);
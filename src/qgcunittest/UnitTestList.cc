@@ -13,9 +13,15 @@
 
 #include "FactSystemTestGeneric.h"
 #include "FactSystemTestPX4.h"
+#include "FactTelemetryTest.h"
 //#include "FileDialogTest.h"
 #include "GeoTest.h"
 #include "LinkManagerTest.h"
+#include "LinkSendQueueTest.h"
+#include "LogReplayRunnerTest.h"
+#include "MAVLinkBlockParserTest.h"
+#include "MAVLinkMessageDispatcherTest.h"
+#include "MAVLinkReceiveQueueTest.h"
 //#include "MessageBoxTest.h"
 #include "MissionItemTest.h"
 #include "SimpleMissionItemTest.h"
@@ -27,8 +33,12 @@
 //#include "MainWindowTest.h"
 //#include "FileManagerTest.h"
 #include "TCPLinkTest.h"
+#include "UDPLinkTest.h"
 #include "ParameterManagerTest.h"
+#include "ParameterCacheFileTest.h"
+#include "ParameterMetaDataBundleTest.h"
 #include "MissionCommandTreeTest.h"
+#include "LogDownloadDataTest.h"
 //#include "LogDownloadTest.h"
 #include "SendMavCommandWithSignallingTest.h"
 #include "SendMavCommandWithHandlerTest.h"
@@ -48,27 +58,45 @@
 #include "RequestMessageTest.h"
 #include "InitialConnectTest.h"
 #include "FTPManagerTest.h"
+#include "TelemetryHistoryTest.h"
+#include "QGCMapEngineTest.h"
+#include "QGCTileCacheWorkerTest.h"
+#include "TerrainTileTest.h"
 
 UT_REGISTER_TEST(FactSystemTestGeneric)
 UT_REGISTER_TEST(FactSystemTestPX4)
+UT_REGISTER_TEST(FactTelemetryTest)
 //UT_REGISTER_TEST(FileDialogTest)
 UT_REGISTER_TEST(GeoTest)
 UT_REGISTER_TEST(LinkManagerTest)
+UT_REGISTER_TEST(LinkSendQueueTest)
+UT_REGISTER_TEST(LogReplayRunnerTest)
+UT_REGISTER_TEST(MAVLinkBlockParserTest)
+UT_REGISTER_TEST(MAVLinkMessageDispatcherTest)
+UT_REGISTER_TEST(MAVLinkReceiveQueueTest)
 //UT_REGISTER_TEST(MessageBoxTest)
 UT_REGISTER_TEST(SendMavCommandWithSignallingTest)
 UT_REGISTER_TEST(SendMavCommandWithHandlerTest)
 UT_REGISTER_TEST(RequestMessageTest)
 UT_REGISTER_TEST(FTPManagerTest)
 UT_REGISTER_TEST(InitialConnectTest)
+UT_REGISTER_TEST(TelemetryHistoryTest)
+UT_REGISTER_TEST(QGCMapEngineTest)
+UT_REGISTER_TEST(QGCTileCacheWorkerTest)
+UT_REGISTER_TEST(TerrainTileTest)
 UT_REGISTER_TEST(MissionItemTest)
 UT_REGISTER_TEST(SimpleMissionItemTest)
 UT_REGISTER_TEST(MissionControllerTest)
 UT_REGISTER_TEST(MissionManagerTest)
 //UT_REGISTER_TEST(RadioConfigTest)
 UT_REGISTER_TEST(TCPLinkTest)
+UT_REGISTER_TEST(UDPLinkTest)
 //UT_REGISTER_TEST(FileManagerTest)
 UT_REGISTER_TEST(ParameterManagerTest)
+UT_REGISTER_TEST(ParameterCacheFileTest)
+UT_REGISTER_TEST(ParameterMetaDataBundleTest)
 UT_REGISTER_TEST(MissionCommandTreeTest)
+UT_REGISTER_TEST(LogDownloadDataTest)
 //UT_REGISTER_TEST(LogDownloadTest)
 UT_REGISTER_TEST(SurveyComplexItemTest)
 UT_REGISTER_TEST(CameraSectionTest)
@@ -94,8 +94,6 @@ signals:
       */
     void valueChanged(const int uasid, const QString& name, const QString& unit, const QVariant &value,const quint64 msecs);
 
-    void parameterUpdate(int uas, int component, QString parameterName, int parameterCount, int parameterId, int type, QVariant value);
-
     /**
      * @brief The battery status has been updated
      *
@@ -326,6 +326,34 @@ Rectangle {
                                         checked = editConfig.highLatency
                                 }
                             }
+                            QGCCheckBox {
+                                text:               qsTr("Block MAVLink Parsing")
+                                checked:            false
+                                enabled:            editConfig ? true : false
+                                onCheckedChanged: {
+                                    if(editConfig) {
+                                        editConfig.blockParsing = checked
+                                    }
+                                }
+                                Component.onCompleted: {
+                                    if(editConfig)
+                                        checked = editConfig.blockParsing
+                                }
+                            }
+                            QGCCheckBox {
+                                text:               qsTr("Parse MAVLink On Link Thread")
+                                checked:            false
+                                enabled:            editConfig ? true : false
+                                onCheckedChanged: {
+                                    if(editConfig) {
+                                        editConfig.threadedParsing = checked
+                                    }
+                                }
+                                Component.onCompleted: {
+                                    if(editConfig)
+                                        checked = editConfig.threadedParsing
+                                }
+                            }
                         }
                     }
                     Item {